@@ -4,7 +4,7 @@
 #include "ddk750_power.h"
 #include "ddk750_sw2d.h"
 #include "ddk750_2d.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 #include "ddk750_regde.h"
 
 
@@ -22,11 +22,11 @@
  * This function must be called before other 2D functions.
  * Assumption: A specific video mode has been properly set up.
  */
-void ddk750_deInit(void)
+void ddk750_deInit(ddk750_context_t *pCtx)
 {
-    enable2DEngine(1);
+    enable2DEngine(pCtx, 1);
 
-    deReset(); /* Just be sure no left-over operations from other applications */
+    deReset(pCtx); /* Just be sure no left-over operations from other applications */
 
     /* Set up 2D registers that won't change for a specific mode. */
 
@@ -45,8 +45,8 @@ void ddk750_deInit(void)
         FIELD_VALUE(0, DE_STRETCH_FORMAT, SOURCE_HEIGHT,3));
 
     /* Clipping and transparent are disable after INIT */
-    deSetClipping(0, 0, 0, 0, 0);
-    deSetTransparency(0, 0, 0, 0);
+    deSetClipping(pCtx, 0, 0, 0, 0, 0);
+    deSetTransparency(pCtx, 0, 0, 0, 0);
 }
 
 /*
@@ -54,7 +54,7 @@ void ddk750_deInit(void)
  * 1) Aborting the current 2D operation.
  * 2) Re-enable 2D engine to normal state.
  */
-void deReset()
+void deReset(ddk750_context_t *pCtx)
 {
     unsigned long sysCtrl;
 	logical_chip_type_t chipType = ddk750_getChipType();
@@ -92,7 +92,7 @@ void deReset()
  * Return: 0 = return because engine is idle and normal.
  *        -1 = return because time out (2D engine may have problem).
  */
-long deWaitForNotBusy(void)
+long deWaitForNotBusy(ddk750_context_t *pCtx)
 {
 	unsigned long dwVal;
 	logical_chip_type_t chipType;
@@ -199,13 +199,14 @@ long deWaitIdle(unsigned long i)
  * 
  */
 long deSetClipping(
+ddk750_context_t *pCtx,
 unsigned long enable, /* 0 = disable clipping, 1 = enable clipping */
 unsigned long x1,     /* x1, y1 is the upper left corner of the clipping area */
 unsigned long y1,     /* Note that the region includes x1 and y1 */
 unsigned long x2,     /* x2, y2 is the lower right corner of the clippiing area */
 unsigned long y2)     /* Note that the region will not include x2 and y2 */
 {
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -246,6 +247,7 @@ unsigned long y2)     /* Note that the region will not include x2 and y2 */
  * If not match, the destination pixel will be updated.
  */
 long deSetTransparency(
+ddk750_context_t *pCtx,
 unsigned long enable,     /* 0 = disable, 1 = enable transparency feature */
 unsigned long tSelect,    /* 0 = compare source, 1 = compare destination */
 unsigned long tMatch,     /* 0 = Opaque mode, 1 = transparent mode */
@@ -253,7 +255,7 @@ unsigned long ulColor)    /* Color to compare. */
 {
     unsigned long de_ctrl;
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -313,7 +315,7 @@ unsigned long ulColor)    /* Color to compare. */
  * It returns a double word with the transparent fields properly set,
  * while other fields are 0.
  */
-unsigned long deGetTransparency(void)
+unsigned long deGetTransparency(ddk750_context_t *pCtx)
 {
     unsigned long de_ctrl;
 
@@ -331,6 +333,7 @@ unsigned long deGetTransparency(void)
  * This function sets the pixel format that will apply to the 2D Engine.
  */
 void deSetPixelFormat(
+    ddk750_context_t *pCtx,
     unsigned long bpp
 )
 {
@@ -359,7 +362,7 @@ void deSetPixelFormat(
  * This function uses 2D engine to fill a rectangular area with a specific color.
  * The filled area includes the starting points.
  */
-long deRectFill( /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
+long deRectFill(ddk750_context_t *pCtx,  /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
 unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
 unsigned long dPitch, /* Pitch value of destination surface in BYTES */
 unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -374,7 +377,7 @@ unsigned long rop2)   /* ROP value */
 
     bytePerPixel = bpp/8;
     
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -410,7 +413,7 @@ unsigned long rop2)   /* ROP value */
     POKE_32(DE_FOREGROUND, color);
 
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
 #ifdef ENABLE_192_BYTES_PATCH
     /* Workaround for 192 byte requirement when ROP is not COPY */
@@ -425,7 +428,7 @@ unsigned long rop2)   /* ROP value */
 
         while (1)
         {
-            deWaitForNotBusy();
+            deWaitForNotBusy(pCtx);
             
             POKE_32(DE_DESTINATION,
                 FIELD_SET  (0, DE_DESTINATION, WRAP, DISABLE) |
@@ -444,7 +447,7 @@ unsigned long rop2)   /* ROP value */
                 FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
                 FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -478,7 +481,7 @@ unsigned long rop2)   /* ROP value */
             FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
             FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     }
     
     return 0;
@@ -489,6 +492,7 @@ unsigned long rop2)   /* ROP value */
  * The filled area includes the starting points.
  */
 long deStartTrapezoidFill(
+    ddk750_context_t *pCtx,
     unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch, /* Pitch value of destination surface in BYTES */
     unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -508,7 +512,7 @@ long deStartTrapezoidFill(
         FIELD_SET  (0, DE_CONTROL, ROP_SELECT,  ROP2)            |
         FIELD_VALUE(0, DE_CONTROL, ROP,         rop2);
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -551,7 +555,7 @@ long deStartTrapezoidFill(
         FIELD_VALUE(0, DE_DESTINATION, Y,    y));
     
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
     
     /* Set the line length and width */
     POKE_32(DE_DIMENSION,
@@ -559,7 +563,7 @@ long deStartTrapezoidFill(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, 0));
 
     /* Enable the 2D Engine. */
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     
     return 0;
 }
@@ -568,11 +572,12 @@ long deStartTrapezoidFill(
  * Function to continue drawing a line using Trapezoid Fill method.
  */
 long deNextTrapezoidFill(
+    ddk750_context_t *pCtx,
     unsigned long x,            /* Starting X location. */
     unsigned long length        /* Line length */
 )
 {
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -601,9 +606,9 @@ long deNextTrapezoidFill(
  * This function has to be called to end the Trapezoid Fill drawing.
  * Otherwise, the next 2D function might still use this function.
  */
-long deStopTrapezoidFill(void)
+long deStopTrapezoidFill(ddk750_context_t *pCtx)
 {
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -629,6 +634,7 @@ long deStopTrapezoidFill(void)
  *        mono expansion.
  */
 long ddk750_deVideoMem2VideoMemBlt(
+ddk750_context_t *pCtx,
 unsigned long sBase,  /* Address of source: offset in frame buffer */
 unsigned long sPitch, /* Pitch value of source surface in BYTE */
 unsigned long sx,
@@ -645,7 +651,7 @@ unsigned long rop2)   /* ROP value */
     unsigned long nDirection, de_ctrl, bytePerPixel;
     long opSign;
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -764,7 +770,7 @@ unsigned long rop2)   /* ROP value */
         FIELD_VALUE(0, DE_WINDOW_WIDTH, SOURCE,      (sPitch/bytePerPixel)));
 
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
     
 #ifdef ENABLE_192_BYTES_PATCH
     /* This bug is fixed in SM718 for 16 and 32 bpp. However, in 8-bpp, the problem still exists. 
@@ -786,7 +792,7 @@ unsigned long rop2)   /* ROP value */
 
         while (1)
         {
-            deWaitForNotBusy();
+            deWaitForNotBusy(pCtx);
             POKE_32(DE_SOURCE,
                 FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
                 FIELD_VALUE(0, DE_SOURCE, X_K1, sx)   |
@@ -808,7 +814,7 @@ unsigned long rop2)   /* ROP value */
                 : FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT)) |
                 FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -826,7 +832,7 @@ unsigned long rop2)   /* ROP value */
     else
 #endif
     {
-        deWaitForNotBusy();
+        deWaitForNotBusy(pCtx);
 
         POKE_32(DE_SOURCE,
             FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
@@ -849,7 +855,7 @@ unsigned long rop2)   /* ROP value */
             : FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT)) |
             FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     }
 
     return 0;
@@ -860,6 +866,7 @@ unsigned long rop2)   /* ROP value */
  * Only works in D, S, ~D, and ~S ROP.
  */
 long deSystemMem2VideoMemBusMasterBlt(
+    ddk750_context_t *pCtx,
     unsigned char *pSBase,  /* Address of source in the system memory.
                                The memory must be a continuous physical address. */
     unsigned long sPitch,   /* Pitch value of source surface in BYTE */
@@ -878,7 +885,7 @@ long deSystemMem2VideoMemBusMasterBlt(
     unsigned long de_ctrl, bytePerPixel;
     unsigned long value, pciMasterBaseAddress;
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -930,7 +937,7 @@ long deSystemMem2VideoMemBusMasterBlt(
         FIELD_VALUE(0, DE_WINDOW_WIDTH, SOURCE,      (sPitch/bytePerPixel)));
 
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
     
 #ifdef ENABLE_192_BYTES_PATCH
     /* This bug is fixed in SM718 for 16 and 32 bpp. However, in 8-bpp, the problem still exists. 
@@ -952,7 +959,7 @@ long deSystemMem2VideoMemBusMasterBlt(
 
         while (1)
         {
-            deWaitForNotBusy();
+            deWaitForNotBusy(pCtx);
             POKE_32(DE_SOURCE,
                 FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
                 FIELD_VALUE(0, DE_SOURCE, X_K1, sx)   |
@@ -974,7 +981,7 @@ long deSystemMem2VideoMemBusMasterBlt(
                 FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT) |
                 FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -992,7 +999,7 @@ long deSystemMem2VideoMemBusMasterBlt(
     else
 #endif
     {
-        deWaitForNotBusy();
+        deWaitForNotBusy(pCtx);
 
         POKE_32(DE_SOURCE,
             FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
@@ -1013,7 +1020,7 @@ long deSystemMem2VideoMemBusMasterBlt(
             FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT) |
             FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     }
 
     return 0;
@@ -1027,6 +1034,7 @@ long deSystemMem2VideoMemBusMasterBlt(
  *        mono expansion.
  */
 long deSystemMem2VideoMemBlt(
+    ddk750_context_t *pCtx,
     unsigned char *pSrcbuf, /* pointer to source data in system memory */
     long srcDelta,          /* width (in Bytes) of the source data, +ive means top down and -ive mean button up */
     unsigned long dBase,    /* Address of destination: offset in frame buffer */
@@ -1061,7 +1069,7 @@ long deSystemMem2VideoMemBlt(
     ulBytesRemain = ulBytesPerScan & 7;
 
     /* Program 2D Drawing Engine */
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1116,7 +1124,7 @@ long deSystemMem2VideoMemBlt(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, height));
         
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = 
         FIELD_VALUE(0, DE_CONTROL, ROP, rop2)         |
@@ -1125,7 +1133,7 @@ long deSystemMem2VideoMemBlt(
         FIELD_SET(0, DE_CONTROL, HOST, COLOR)         |
         FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
     /* Write bitmap/image data (line by line) to 2D Engine data port */
     for (i = 0; i < height; i++)
@@ -1153,6 +1161,7 @@ long deSystemMem2VideoMemBlt(
  * This function expands the monochrome data to color image in video memory.
  */
 long deSystemMem2VideoMemMonoBlt(
+ddk750_context_t *pCtx,
 unsigned char *pSrcbuf, /* pointer to start of source buffer in system memory */
 long srcDelta,          /* Pitch value (in bytes) of the source buffer, +ive means top down and -ive mean button up */
 unsigned long startBit, /* Mono data can start at any bit in a byte, this value should be 0 to 7 */
@@ -1182,7 +1191,7 @@ unsigned long rop2)     /* ROP value */
     ul4BytesPerScan = ulBytesPerScan & ~3;
     ulBytesRemain = ulBytesPerScan & 3;
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1239,7 +1248,7 @@ unsigned long rop2)     /* ROP value */
     POKE_32(DE_BACKGROUND, bColor);
     
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = FIELD_VALUE(0, DE_CONTROL, ROP, rop2)         |
               FIELD_SET(0, DE_CONTROL, ROP_SELECT, ROP2)    |
@@ -1247,7 +1256,7 @@ unsigned long rop2)     /* ROP value */
               FIELD_SET(0, DE_CONTROL, HOST, MONO)          |
               FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
     /* Write MONO data (line by line) to 2D Engine data port */
     for (i=0; i<height; i++)
@@ -1408,6 +1417,7 @@ long deSystemMem2VideoMemMonoBusMasterBlt(
  * Input source points to the starting location of the font character.
  */
 long deVideoMem2VideoMemMonoBlt(
+ddk750_context_t *pCtx,
 unsigned long sBase,  /* Address of mono-chrome source data in frame buffer */
 unsigned long dBase,  /* Base address of destination in frame buffer */
 unsigned long dPitch, /* Pitch value of destination surface in BYTE */
@@ -1439,7 +1449,7 @@ unsigned long rop2)   /* ROP value */
             packed = DE_CONTROL_MONO_DATA_NOT_PACKED;
     }
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1500,7 +1510,7 @@ unsigned long rop2)   /* ROP value */
     POKE_32(DE_COLOR_COMPARE, bColor);
     
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = 
         FIELD_VALUE(0, DE_CONTROL, ROP, rop2) |
@@ -1510,7 +1520,7 @@ unsigned long rop2)   /* ROP value */
         FIELD_VALUE(0, DE_CONTROL, MONO_DATA, packed) |
         FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
     return 0;
 }
@@ -1525,6 +1535,7 @@ unsigned long rop2)   /* ROP value */
  *    DE_WINDOW_WIDTH, where they are set to 0 in deVideoMem2VideoMemMonoBlt().
  */
 long deFontCacheTblMonoBlt(
+ddk750_context_t *pCtx,
 unsigned long fontTblBase,/* Base address of monochrome font table in frame buffer */
 unsigned long fontNumber, /* Which character in the font table, starting from 0 */
 unsigned long dBase,      /* Base address of destination in frame buffer */
@@ -1570,7 +1581,7 @@ unsigned long rop2)       /* ROP value */
             packed = DE_CONTROL_MONO_DATA_NOT_PACKED;
     }
 
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1628,7 +1639,7 @@ unsigned long rop2)       /* ROP value */
     POKE_32(DE_COLOR_COMPARE, bColor);
     
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = 
         FIELD_VALUE(0, DE_CONTROL, ROP, rop2) |
@@ -1638,7 +1649,7 @@ unsigned long rop2)       /* ROP value */
         FIELD_VALUE(0, DE_CONTROL, MONO_DATA, packed) |
         FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
     return 0;
 }
@@ -1653,6 +1664,7 @@ unsigned long rop2)       /* ROP value */
  *
  */
 void deRotate(
+    ddk750_context_t *pCtx,
     unsigned long sx,               /* X Coordinate of the source */
     unsigned long sy,               /* Y Coordinate of the source */
     unsigned long dx,               /* X Coordinate of the destination */
@@ -1663,7 +1675,7 @@ void deRotate(
 )
 {
     /* Wait until the engine is not busy */
-    deWaitForNotBusy();
+    deWaitForNotBusy(pCtx);
                 
     /* Set the source coordinate */
     POKE_32(DE_SOURCE,
@@ -1713,6 +1725,7 @@ void deRotate(
  *         This might be deleted in the future as necessary.
  */
 long deVideoMem2VideoMemRotateBlt(
+    ddk750_context_t *pCtx,
     unsigned long sBase,            /* Source Base Address */
     unsigned long sPitch,           /* Source pitch */
     unsigned long sx,               /* X Coordinate of the source */
@@ -1737,7 +1750,7 @@ long deVideoMem2VideoMemRotateBlt(
     maxRotationWidth = 32 / BYTE_PER_PIXEL(bpp);
 
     /* Wait for the engine to be idle */
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1779,7 +1792,7 @@ long deVideoMem2VideoMemRotateBlt(
         FIELD_VALUE(0, DE_WINDOW_WIDTH, SOURCE,      sPitch / BYTE_PER_PIXEL(bpp)));
         
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
        
     /* Setup Control Register */
     de_ctrl = FIELD_SET(0, DE_CONTROL, STATUS, START)    |
@@ -1789,7 +1802,7 @@ long deVideoMem2VideoMemRotateBlt(
               ((repeatEnable == 1) ? 
                     FIELD_SET(0, DE_CONTROL, REPEAT_ROTATE, ENABLE) :
                     FIELD_SET(0, DE_CONTROL, REPEAT_ROTATE, DISABLE)) |
-              deGetTransparency();
+              deGetTransparency(pCtx);
        
     /* 501 Hardware cannot handle rotblits > 32 bytes. Therefore the rotation 
        should be done part by part. Note on each rotation case. */
@@ -1809,7 +1822,7 @@ long deVideoMem2VideoMemRotateBlt(
              * by calling the normal bit BLT. Calling the rotation with 0 degree
              * will cause the hardware to rotate it 270 degree. 
              */
-            return(ddk750_deVideoMem2VideoMemBlt(
+            return(ddk750_deVideoMem2VideoMemBlt(pCtx, 
                     sBase,
                     sPitch,
                     sx,
@@ -1833,7 +1846,7 @@ long deVideoMem2VideoMemRotateBlt(
             de_ctrl |= (FIELD_SET(0, DE_CONTROL, STEP_X, NEGATIVE) |
                         FIELD_SET(0, DE_CONTROL, STEP_Y, NEGATIVE));
 
-            deRotate(sx, sy, dx, dy, width, height, de_ctrl);
+            deRotate(pCtx, sx, sy, dx, dy, width, height, de_ctrl);
             break;
 
         case ROTATE_90_DEGREE:
@@ -1861,7 +1874,7 @@ long deVideoMem2VideoMemRotateBlt(
             /* Do rotation part by part based on the maxRotationWidth */
             while (width > maxRotationWidth)
 	        {
-                deRotate(sx, sy, dx, dy, maxRotationWidth, height, de_ctrl);
+                deRotate(pCtx, sx, sy, dx, dy, maxRotationWidth, height, de_ctrl);
 
                 width -= maxRotationWidth;
                 sx    += maxRotationWidth;
@@ -1870,7 +1883,7 @@ long deVideoMem2VideoMemRotateBlt(
 #endif
             /* Rotate the rest of the segment */
             if (width > 0)
-                deRotate(sx, sy, dx, dy, width, height, de_ctrl);
+                deRotate(pCtx, sx, sy, dx, dy, width, height, de_ctrl);
                 
             break;
         
@@ -1894,7 +1907,7 @@ long deVideoMem2VideoMemRotateBlt(
             /* Do rotation part by part based on the maxRotationWidth */            
             while (width > maxRotationWidth)
 	        {
-                deRotate(sx, sy, dx, dy, maxRotationWidth, height, de_ctrl);
+                deRotate(pCtx, sx, sy, dx, dy, maxRotationWidth, height, de_ctrl);
                
                 width -= maxRotationWidth;
                 sx    += maxRotationWidth;
@@ -1903,7 +1916,7 @@ long deVideoMem2VideoMemRotateBlt(
 #endif            
             /* Update the rest of the segment */
             if (width > 0)
-                deRotate(sx, sy, dx, dy, width, height, de_ctrl);
+                deRotate(pCtx, sx, sy, dx, dy, width, height, de_ctrl);
             break;
     }
 
@@ -1917,6 +1930,7 @@ long deVideoMem2VideoMemRotateBlt(
  *      This function is using Short Stroke line
  */
 long deVerticalLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -1929,7 +1943,7 @@ long deVerticalLine(
 {
     unsigned long de_ctrl;
     
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1977,7 +1991,7 @@ long deVerticalLine(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, length));
         
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     /* Set the control register. For the Vertical line Short Stroke, the Direction Control
        should be set to 0 (which is defined as Left to Right). */
@@ -1992,7 +2006,7 @@ long deVerticalLine(
         FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)          |
         FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
     return 0;
 }
@@ -2004,6 +2018,7 @@ long deVerticalLine(
  *      This function is using Short Stroke line
  */
 long deHorizontalLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -2016,7 +2031,7 @@ long deHorizontalLine(
 {
     unsigned long de_ctrl;
     
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -2064,7 +2079,7 @@ long deHorizontalLine(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, 1));
         
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
     /* Set the control register. For the Horizontal line Short Stroke, the Direction Control
        should be set to 1 (which is defined as Right to Left). */
@@ -2079,7 +2094,7 @@ long deHorizontalLine(
         FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)          |
         FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     
     return 0;
 }
@@ -2092,6 +2107,7 @@ long deHorizontalLine(
  *      Diagonal line. Other line are drawn using the Line Draw Command.
  */
 long deLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -2115,7 +2131,7 @@ long deLine(
 
     unsigned long dx, dy;
     
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -2170,11 +2186,11 @@ long deLine(
      
     /* Vertical line? */
     if (x0 == x1)
-        deVerticalLine(dBase, dPitch, bpp, x0, (y0 < y1) ? y0 : y1, dy + 1, color, rop2);
+        deVerticalLine(pCtx, dBase, dPitch, bpp, x0, (y0 < y1) ? y0 : y1, dy + 1, color, rop2);
 
     /* Horizontal line? */
     else if (y0 == y1)
-        deHorizontalLine(dBase, dPitch, bpp, (x0 < x1) ? x0 : x1, y0, dx + 1, color, rop2);
+        deHorizontalLine(pCtx, dBase, dPitch, bpp, (x0 < x1) ? x0 : x1, y0, dx + 1, color, rop2);
 
     else 
     {
@@ -2212,7 +2228,7 @@ long deLine(
             FIELD_VALUE(0, DE_DESTINATION, Y,    y0));
         
         /* Set the pixel format of the destination */
-        deSetPixelFormat(bpp);
+        deSetPixelFormat(pCtx, bpp);
     
         /* Diagonal line? */
         if (dx == dy)
@@ -2225,7 +2241,7 @@ long deLine(
             /* Set the command register. */
             de_ctrl = FIELD_SET(de_ctrl, DE_CONTROL, COMMAND, SHORT_STROKE);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());            
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));            
         }
 
         /* Generic line */
@@ -2279,7 +2295,7 @@ long deLine(
             /* Set the control register. */
             de_ctrl = FIELD_SET(de_ctrl, DE_CONTROL, COMMAND, LINE_DRAW);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
         }
     }
     
@@ -2621,6 +2637,7 @@ long deStopLineStrip()
  * This function blends the source with the destination image.
  */
 long deVideoMem2VideoMemAlphaBlendBlt(
+    ddk750_context_t *pCtx,
     unsigned long sBase,            /* Source Base Address */
     unsigned long sPitch,           /* Source pitch */
     unsigned long sx,               /* X Coordinate of the source */
@@ -2645,7 +2662,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
     bytePerPixel = bpp/8; 
     
     /* Wait for the engine to be idle */
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -2664,7 +2681,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
 #ifdef ALPHA_BLEND_BLOCK_TRANSPARENCY
     /* Get the transparency settings. The transparency does not work with Alpha Blend,
        therefore, save the transparency setting, disable, and restore it back later. */
-    transparency = deGetTransparency();
+    transparency = deGetTransparency(pCtx);
 #endif
 
     /* 2D Source Base.
@@ -2701,7 +2718,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
         FIELD_VALUE(0, DE_ALPHA, VALUE, alphaValue));
 
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
 #ifdef ENABLE_192_BYTES_PATCH
     /* Workaround for 192 byte requirement */
@@ -2714,7 +2731,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
 
         while (1)
         {
-            deWaitForNotBusy();
+            deWaitForNotBusy(pCtx);
             
             /* Set the source coordinate */    
             POKE_32(DE_SOURCE,
@@ -2761,7 +2778,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
     else
 #endif
     {
-        deWaitForNotBusy();
+        deWaitForNotBusy(pCtx);
             
         /* Set the source coordinate */    
         POKE_32(DE_SOURCE,
@@ -2794,7 +2811,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
 
 #ifdef ALPHA_BLEND_BLOCK_TRANSPARENCY
     /* Restore back the transparency */
-    deWaitForNotBusy();
+    deWaitForNotBusy(pCtx);
     de_ctrl = PEEK_32(de_ctrl) | transparency;
     POKE_32(DE_CONTROL, de_ctrl);
 #endif
@@ -2806,6 +2823,7 @@ long deVideoMem2VideoMemAlphaBlendBlt(
  * This function sets the monochrome pattern on the pattern registers.
  */
 void deSetPattern(
+    ddk750_context_t *pCtx,
     unsigned long monoPatternLow,
     unsigned long monoPatternHigh
 )
@@ -2819,6 +2837,7 @@ void deSetPattern(
  * The filled area includes the starting points.
  */
 long deRectPatternFill(
+    ddk750_context_t *pCtx,
     unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch, /* Pitch value of destination surface in BYTES */
     unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -2833,7 +2852,7 @@ long deRectPatternFill(
 
     bytePerPixel = bpp/8;
     
-    if (deWaitForNotBusy() != 0)
+    if (deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -2869,7 +2888,7 @@ long deRectPatternFill(
     POKE_32(DE_FOREGROUND, color);
     
     /* Set the pixel format of the destination */
-    deSetPixelFormat(bpp);
+    deSetPixelFormat(pCtx, bpp);
 
 #ifdef ENABLE_192_BYTES_PATCH
     /* Workaround for 192 byte requirement when ROP is not COPY */
@@ -2884,7 +2903,7 @@ long deRectPatternFill(
 
         while (1)
         {
-            deWaitForNotBusy();
+            deWaitForNotBusy(pCtx);
             
             POKE_32(DE_DESTINATION,
                 FIELD_SET  (0, DE_DESTINATION, WRAP, DISABLE) |
@@ -2903,7 +2922,7 @@ long deRectPatternFill(
                 FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
                 FIELD_VALUE(0, DE_CONTROL,  ROP,        rop3);
 
-            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -2937,7 +2956,7 @@ long deRectPatternFill(
             FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
             FIELD_VALUE(0, DE_CONTROL,  ROP,        rop3);
 
-        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | deGetTransparency(pCtx));
     }
     
     return 0;
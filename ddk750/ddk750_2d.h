@@ -1,6 +1,8 @@
 #ifndef _2D_H_
 #define _2D_H_
 
+#include "ddk750_help.h"
+
 //#include "csc.h"
 
 #define POKE_8(address, value)          pokeRegisterByte(address, value)
@@ -25,14 +27,14 @@ rotate_dir_t;
  * This function must be called before other 2D functions.
  * Assumption: A specific vidoe mode has been properly set up.
  */
-void ddk750_deInit(void);
+void ddk750_deInit(ddk750_context_t *pCtx);
 
 /*
  * Reset 2D engine by 
  * 1) Aborting the current 2D operation.
  * 2) Re-enable 2D engine to normal state.
  */
-void deReset(void);
+void deReset(ddk750_context_t *pCtx);
  
 /*
  * Wait until 2D engine is not busy.
@@ -41,7 +43,7 @@ void deReset(void);
  * Return: 0 = return because engine is idle and normal.
  *        -1 = return because time out (2D engine may have problem).
  */
-long deWaitForNotBusy(void);
+long deWaitForNotBusy(ddk750_context_t *pCtx);
 
 /* deWaitIdle() function.
  *
@@ -65,6 +67,7 @@ long deWaitIdle(unsigned long i);
  * 
  */
 long deSetClipping(
+ddk750_context_t *pCtx,
 unsigned long enable, /* 0 = disable clipping, 1 = enable clipping */
 unsigned long x1,     /* x1, y1 is the upper left corner of the clipping area */
 unsigned long y1,     /* Note that the region includes x1 and y1 */
@@ -79,6 +82,7 @@ unsigned long y2);    /* Note that the region will not include x2 and y2 */
  * If not match, the destination pixel will be updated.
  */
 long deSetTransparency(
+ddk750_context_t *pCtx,
 unsigned long enable,     /* 0 = disable, 1 = enable transparency feature */
 unsigned long tSelect,    /* 0 = compare source, 1 = compare destination */
 unsigned long tMatch,     /* 0 = Opaque mode, 1 = transparent mode */
@@ -88,7 +92,7 @@ unsigned long ulColor);   /* Color to compare. */
  * This function uses 2D engine to fill a rectangular area with a specific color.
  * The filled area includes the starting points.
  */
-long deRectFill( /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
+long deRectFill(ddk750_context_t *pCtx,  /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
 unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
 unsigned long dPitch, /* Pitch value of destination surface in BYTES */
 unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -107,6 +111,7 @@ unsigned long rop2);  /* ROP value */
  *        mono expansion.
  */
 long ddk750_deVideoMem2VideoMemBlt(
+ddk750_context_t *pCtx,
 unsigned long sBase,  /* Address of source: offset in frame buffer */
 unsigned long sPitch, /* Pitch value of source surface in BYTE */
 unsigned long sx,
@@ -128,6 +133,7 @@ unsigned long rop2);  /* ROP value */
  *        mono expansion.
  */
 long deSystemMem2VideoMemBusMasterBlt(
+    ddk750_context_t *pCtx,
     unsigned char *pSBase,  /* Address of source: offset in frame buffer */
     unsigned long sPitch,   /* Pitch value of source surface in BYTE */
     unsigned long sx,
@@ -150,6 +156,7 @@ long deSystemMem2VideoMemBusMasterBlt(
  *        mono expansion.
  */
 long deSystemMem2VideoMemBlt(
+ddk750_context_t *pCtx,
 unsigned char *pSrcbuf, /* pointer to source data in system memory */
 long srcDelta,          /* width (in Bytes) of the source data, +ive means top down and -ive mean button up */
 unsigned long dBase,    /* Address of destination: offset in frame buffer */
@@ -167,6 +174,7 @@ unsigned long rop2);    /* ROP value */
  * This function expands the monochrome data to color image in video memory.
  */
 long deSystemMem2VideoMemMonoBlt(
+ddk750_context_t *pCtx,
 unsigned char *pSrcbuf, /* pointer to start of source buffer in system memory */
 long srcDelta,          /* Pitch value (in bytes) of the source buffer, +ive means top down and -ive mean button up */
 unsigned long startBit, /* Mono data can start at any bit in a byte, this value should be 0 to 7 */
@@ -242,6 +250,7 @@ unsigned long fbAddr);      /* Destination in Video memory to store the font */
  * Input source points to the starting location of the font character.
  */
 long deVideoMem2VideoMemMonoBlt(
+ddk750_context_t *pCtx,
 unsigned long sBase,  /* Address of mono-chrome source data in frame buffer */
 unsigned long dBase,  /* Base address of destination in frame buffer */
 unsigned long dPitch, /* Pitch value of destination surface in BYTE */
@@ -264,6 +273,7 @@ unsigned long rop2);  /* ROP value */
  *    DE_WINDOW_WIDTH, where they are set to 0 in deVideoMem2VideoMemMonoBlt().
  */
 long deFontCacheTblMonoBlt(
+ddk750_context_t *pCtx,
 unsigned long fontTblBase,/* Base address of monochrome font table in frame buffer */
 unsigned long fontNumber, /* Which character in the font table, starting from 0 */
 unsigned long dBase,      /* Base address of destination in frame buffer */
@@ -307,6 +317,7 @@ long deStretchBlt(
  * 
  */
 long deVideoMem2VideoMemRotateBlt(
+    ddk750_context_t *pCtx,
     unsigned long sBase,            /* Source Base Address */
     unsigned long sPitch,           /* Source pitch */
     unsigned long sx,               /* X Coordinate of the source */
@@ -331,6 +342,7 @@ long deVideoMem2VideoMemRotateBlt(
  *      This function is using Short Stroke line
  */
 long deVerticalLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -348,6 +360,7 @@ long deVerticalLine(
  *      This function is using Short Stroke line
  */
 long deHorizontalLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -366,6 +379,7 @@ long deHorizontalLine(
  *      Diagonal line. Other line are drawn using the Line Draw Command.
  */
 long deLine(
+    ddk750_context_t *pCtx,
     unsigned long dBase,    /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch,   /* Pitch value of destination surface in BYTES */
     unsigned long bpp,      /* Color depth of destination surface: 8, 16 or 32 */
@@ -383,6 +397,7 @@ long deLine(
  * This function blends the source with the destination image.
  */
 long deVideoMem2VideoMemAlphaBlendBlt(
+    ddk750_context_t *pCtx,
     unsigned long sBase,            /* Source Base Address */
     unsigned long sPitch,           /* Source pitch */
     unsigned long sx,               /* X Coordinate of the source */
@@ -442,6 +457,7 @@ long deStopLineStrip();
  * The filled area includes the starting points.
  */
 long deStartTrapezoidFill(
+    ddk750_context_t *pCtx,
     unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch, /* Pitch value of destination surface in BYTES */
     unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -455,6 +471,7 @@ long deStartTrapezoidFill(
  * Function to continue drawing a line using Trapezoid Fill method.
  */
 long deNextTrapezoidFill(
+    ddk750_context_t *pCtx,
     unsigned long x,            /* Starting X location. */
     unsigned long length        /* Line length */
 );
@@ -464,6 +481,6 @@ long deNextTrapezoidFill(
  * This function has to be called to end the Trapezoid Fill drawing.
  * Otherwise, the next 2D function might still use this function.
  */
-long deStopTrapezoidFill(void);
+long deStopTrapezoidFill(ddk750_context_t *pCtx);
 
 #endif /* _2D_H_ */
@@ -4,7 +4,7 @@
 #include "ddk750_power.h"
 #include "ddk750_clock.h"
 #include "ddk750_chip.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 
 /*
  *  Get the default memory clock value used by this DDK
@@ -38,7 +38,7 @@ unsigned long ddk750_getDefaultMemoryClock(void)
 /*
  * This function returns frame buffer memory size in Byte units.
  */
-unsigned long ddk750_getFrameBufSize(void)
+unsigned long ddk750_getFrameBufSize(ddk750_context_t *pCtx)
 {
     unsigned long sizeSymbol, memSize;
 
@@ -70,7 +70,7 @@ logical_chip_type_t ddk750_getChipType()
  *  ddk750_resetFrameBufferMemory
  *      This function resets the Frame Buffer Memory
  */
-void ddk750_resetFrameBufferMemory()
+void ddk750_resetFrameBufferMemory(ddk750_context_t *pCtx)
 {
     unsigned long ulReg;
 	logical_chip_type_t chipType = ddk750_getChipType();
@@ -100,7 +100,7 @@ void ddk750_resetFrameBufferMemory()
  *      Caller needs to call the detectDevice and setCurrentDevice
  *      to set the device before calling this initChipParamEx.
  */
-long ddk750_initChipParamEx(initchip_param_t * pInitParam)
+long ddk750_initChipParamEx(ddk750_context_t *pCtx, initchip_param_t * pInitParam)
 {
     unsigned long ulReg;
 
@@ -112,27 +112,27 @@ long ddk750_initChipParamEx(initchip_param_t * pInitParam)
      */
     if (pInitParam->powerMode > 1) 
         pInitParam->powerMode = 0;
-    setPowerMode(pInitParam->powerMode);
+    setPowerMode(pCtx, pInitParam->powerMode);
     
     /* Set the Main Chip Clock */
-    setChipClock(MHz(pInitParam->chipClock));
+    setChipClock(pCtx, MHz(pInitParam->chipClock));
 
     /* Set up memory clock. */
-    setMemoryClock(MHz(pInitParam->memClock));
+    setMemoryClock(pCtx, MHz(pInitParam->memClock));
 
     /* Set up master clock */
-    setMasterClock(MHz(pInitParam->masterClock));    
+    setMasterClock(pCtx, MHz(pInitParam->masterClock));    
     
     /* Reset the memory controller. If the memory controller is not reset in SM750, 
        the system might hang when sw accesses the memory. 
        The memory should be resetted after changing the MXCLK.
      */
     if (pInitParam->resetMemory == 1)
-        ddk750_resetFrameBufferMemory();    
+        ddk750_resetFrameBufferMemory(pCtx);    
     
     if (pInitParam->setAllEngOff == 1)
     {
-        enable2DEngine(0);
+        enable2DEngine(pCtx, 0);
 
         /* Disable Overlay, if a former application left it on */
         ulReg = peekRegisterDWord(VIDEO_DISPLAY_CTRL);
@@ -202,7 +202,7 @@ long ddk750_initChipParamEx(initchip_param_t * pInitParam)
  *      This function initialize with a default set of parameters.
  *      Use initChipParam() if you don't want default parameters.
  */
-long ddk750_initChip()
+long ddk750_initChip(ddk750_context_t *pCtx)
 {
     initchip_param_t initParam;
     
@@ -219,5 +219,5 @@ long ddk750_initChip()
     initParam.setAllEngOff = 1;
     initParam.resetMemory = 1;
     
-    return(ddk750_initChipParamEx(&initParam));
+    return(ddk750_initChipParamEx(pCtx, &initParam));
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef _CHIP_H_
 #define _CHIP_H_
 
+#include "ddk750_help.h"
+
 /* This is all the chips recognized by this library */
 typedef enum _logical_chip_type_t
 {
@@ -52,7 +54,7 @@ unsigned long ddk750_getDefaultMemoryClock(void);
 /*
  * This function returns frame buffer memory size in Byte units.
  */
-unsigned long ddk750_getFrameBufSize(void);
+unsigned long ddk750_getFrameBufSize(ddk750_context_t *pCtx);
 
 /*
  * This function gets the Frame buffer location.
@@ -76,7 +78,7 @@ char * ddk750_getChipTypeString(void);
  *  resetFrameBufferMemory
  *      This function resets the Frame Buffer Memory
  */
-void ddk750_resetFrameBufferMemory(void);
+void ddk750_resetFrameBufferMemory(ddk750_context_t *pCtx);
 
 /*
  * Initialize a single chip and environment according to input parameters.
@@ -90,7 +92,7 @@ void ddk750_resetFrameBufferMemory(void);
  *      Caller needs to call the detectDevice and setCurrentDevice
  *      to set the device before calling this initChipParamEx.
  */
-long ddk750_initChipParamEx(initchip_param_t * pInitParam);
+long ddk750_initChipParamEx(ddk750_context_t *pCtx, initchip_param_t * pInitParam);
 
 /*
  * Initialize every chip and environment according to input parameters. 
@@ -125,7 +127,7 @@ long ddk750_initChipEx(void);
  * Return: 0 (or NO_ERROR) if successful.
  *        -1 if fail.
  */
-long ddk750_initChip(void);
+long ddk750_initChip(ddk750_context_t *pCtx);
 
 /*******************************************************************
  * Scratch Data implementation (To be used by DDK library only)
@@ -1,3 +1,6 @@
+#include <linux/math64.h>
+#include <linux/spinlock.h>
+
 #include "ddk750_defs.h"
 //#include "ddk750_hardware.h"
 #include "ddk750_helper.h"
@@ -5,13 +8,32 @@
 #include "ddk750_clock.h"
 #include "ddk750_chip.h"
 #include "ddk750_helper.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 
 //#include "ddkdebug.h"
 
 static unsigned char g_ucMemoryClockDivider[] = { 1, 2, 3, 4 };
 static unsigned char g_ucMasterClockDivider[] = { 3, 4, 6, 8 };
 
+/* Number of solved clocks remembered by calcPllValue() */
+#define PLL_CACHE_SIZE  16
+
+typedef struct _pll_cache_entry_t
+{
+    unsigned long requestClk;   /* 0 for an unused entry */
+    unsigned long actualClk;
+    pll_value_t pll;            /* clockType and inputFreq are part of the key */
+}
+pll_cache_entry_t;
+
+/*
+ * The solution only depends on the PLL type, the reference and the requested
+ * clock, so the cache is shared by all chips. It is direct mapped on the
+ * requested clock.
+ */
+static pll_cache_entry_t pllCache[PLL_CACHE_SIZE];
+static DEFINE_SPINLOCK(pllCacheLock);
+
 /*
  * A local function to calculate the clock value of the given PLL.
  *
@@ -22,7 +44,79 @@ static unsigned char g_ucMasterClockDivider[] = { 3, 4, 6, 8 };
  */
 unsigned long calcPLL(pll_value_t *pPLL)
 {
-    return (pPLL->inputFreq * pPLL->M / pPLL->N / twoToPowerOfx(pPLL->OD) / twoToPowerOfx(pPLL->POD));
+    unsigned long divider = pPLL->N * twoToPowerOfx(pPLL->OD) * twoToPowerOfx(pPLL->POD);
+
+    /* No solution was found */
+    if (divider == 0)
+        return 0;
+
+    return (unsigned long)div_u64((unsigned long long)pPLL->inputFreq * pPLL->M + divider / 2, divider);
+}
+
+/*
+ * Search every POD, OD and N for the M giving the clock closest to the
+ * request. For a given divider the best M is the rounded quotient, so M
+ * is not searched; everything is kept in Hz with 64-bit intermediates.
+ */
+static unsigned long solvePll(unsigned long ulRequestClk, pll_value_t *pPLL)
+{
+    unsigned long long bestDiff = ~0ULL, diff;
+    unsigned long M, N, OD, POD, divider, pllClk;
+
+    /* If the requested clock is higher than 1 GHz, then set it to the maximum, which is
+       1 GHz. */
+    if (ulRequestClk > MHz(1000))
+        ulRequestClk = MHz(1000);
+
+    /* The maximum of post divider is 8. */
+    for (POD=0; POD<=3; POD++)
+    {
+        /* MXCLK_PLL does not have post divider. */
+        if ((POD > 0) && (pPLL->clockType == MXCLK_PLL))
+            break;
+
+        /* OD has only 2 bits [15:14] and its value must between 0 to 3 */
+        for (OD=0; OD<=3; OD++)
+        {
+            /* N has 4 bits [11:8] and its value must between 2 and 15. 
+               The N == 1 will behave differently --> Result is not correct. */
+            for (N=2; N<=15; N++)
+            {
+                /* requestClk = inputFreq * M / divider, so M = requestClk * divider / inputFreq */
+                divider = N * twoToPowerOfx(OD) * twoToPowerOfx(POD);
+                M = (unsigned long)div_u64((unsigned long long)ulRequestClk * divider + pPLL->inputFreq / 2,
+                                           pPLL->inputFreq);
+
+                /* M field has only 8 bits, reject value bigger than 8 bits */
+                if ((M == 0) || (M > 255))
+                    continue;
+
+                /* Calculate the actual clock for a given M & N */
+                pllClk = (unsigned long)div_u64((unsigned long long)pPLL->inputFreq * M + divider / 2, divider);
+
+                /* How much are we different from the requirement */
+                diff = absDiff(pllClk, ulRequestClk);
+
+                if (diff < bestDiff)
+                {
+                    bestDiff = diff;
+
+                    /* Store M and N values */
+                    pPLL->M  = M;
+                    pPLL->N  = N;
+                    pPLL->OD = OD;
+                    pPLL->POD = POD;
+                }
+            }
+        }
+    }
+
+    /* Output debug information */
+//    DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Requested Frequency = %d\n", ulRequestClk));
+//    DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Input CLK = %dHz, M=%d, N=%d, OD=%d, POD=%d\n", pPLL->inputFreq, pPLL->M, pPLL->N, pPLL->OD, pPLL->POD));
+
+    /* Return actual frequency that the PLL can set */
+    return calcPLL(pPLL);
 }
 
 /*
@@ -49,8 +143,8 @@ unsigned long ulRequestClk, /* Required pixel clock in Hz unit */
 pll_value_t *pPLL           /* Structure to hold the value to be set in PLL */
 )
 {
-    unsigned long M, N, OD, POD = 0, diff, pllClk, odPower, podPower, tempRequestClk;
-    unsigned long bestDiff = 0xffffffff; /* biggest 32 bit unsigned number */
+    pll_cache_entry_t *pEntry = &pllCache[(ulRequestClk / 1000) % PLL_CACHE_SIZE];
+    unsigned long ulActualClk, flags;
 
     /* Init PLL structure to know states */
     pPLL->M = 0;
@@ -66,75 +160,41 @@ pll_value_t *pPLL           /* Structure to hold the value to be set in PLL */
         return ulRequestClk;
     }
 
-    /* Convert everything in Khz range in order to avoid calculation overflow */
-    pPLL->inputFreq /= 1000;
-    tempRequestClk = ulRequestClk / 1000;
-
-    /* If the requested clock is higher than 1 GHz, then set it to the maximum, which is
-       1 GHz. */
-    if (tempRequestClk > MHz(1))
-        tempRequestClk = MHz(1);
-
-    /* The maximum of post divider is 8. */
-    for (POD=0; POD<=3; POD++)
+    spin_lock_irqsave(&pllCacheLock, flags);
+    if (pEntry->requestClk == ulRequestClk &&
+        pEntry->pll.clockType == pPLL->clockType &&
+        pEntry->pll.inputFreq == pPLL->inputFreq)
     {
-        /* MXCLK_PLL does not have post divider. */
-        if ((POD > 0) && (pPLL->clockType == MXCLK_PLL))
-            break;
-    
-        /* Work out 2 to the power of POD */
-        podPower = twoToPowerOfx(POD);
-        
-        /* OD has only 2 bits [15:14] and its value must between 0 to 3 */
-        for (OD=0; OD<=3; OD++)
-        {
-            /* Work out 2 to the power of OD */
-            odPower = twoToPowerOfx(OD);            
+        *pPLL = pEntry->pll;
+        ulActualClk = pEntry->actualClk;
+        spin_unlock_irqrestore(&pllCacheLock, flags);
+        return ulActualClk;
+    }
+    spin_unlock_irqrestore(&pllCacheLock, flags);
 
-            /* N has 4 bits [11:8] and its value must between 2 and 15. 
-               The N == 1 will behave differently --> Result is not correct. */
-            for (N=2; N<=15; N++)
-            {
-                /* The formula for PLL is ulRequestClk = inputFreq * M / N / (2^OD)
-                   In the following steps, we try to work out a best M value given the others are known.
-                   To avoid decimal calculation, we use 1000 as multiplier for up to 3 decimal places of accuracy.
-                */
-                M = tempRequestClk * N * odPower * podPower / pPLL->inputFreq;
+    ulActualClk = solvePll(ulRequestClk, pPLL);
 
-                /* M field has only 8 bits, reject value bigger than 8 bits */
-                if (M < 256)
-                {
-                    /* Calculate the actual clock for a given M & N */        
-                    pllClk = pPLL->inputFreq * M / N / odPower / podPower;
+    spin_lock_irqsave(&pllCacheLock, flags);
+    pEntry->requestClk = ulRequestClk;
+    pEntry->actualClk = ulActualClk;
+    pEntry->pll = *pPLL;
+    spin_unlock_irqrestore(&pllCacheLock, flags);
 
-                    /* How much are we different from the requirement */
-                    diff = absDiff(pllClk, tempRequestClk);
-        
-                    if (diff < bestDiff)
-                    {
-                        bestDiff = diff;
-
-                        /* Store M and N values */
-                        pPLL->M  = M;
-                        pPLL->N  = N;
-                        pPLL->OD = OD;
-                        pPLL->POD = POD;
-                    }
-                }
-            }
-        }
-    }
-    
-    /* Restore input frequency from Khz to hz unit */
-    pPLL->inputFreq *= 1000;
+    return ulActualClk;
+}
 
-    /* Output debug information */
-//    DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Requested Frequency = %d\n", ulRequestClk));
-//    DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Input CLK = %dHz, M=%d, N=%d, OD=%d, POD=%d\n", pPLL->inputFreq, pPLL->M, pPLL->N, pPLL->OD, pPLL->POD));
+#ifdef SMI_PLL_TEST
+/* Run the solver for one clock without the cache, for smi_pll_test.c */
+unsigned long ddk750_testPixelPll(unsigned long ulRequestClk)
+{
+    pll_value_t pll;
 
-    /* Return actual frequency that the PLL can set */
-    return calcPLL(pPLL);
+    pll.clockType = PRIMARY_PLL;
+    pll.inputFreq = DEFAULT_INPUT_CLOCK;
+    pll.M = pll.N = pll.OD = pll.POD = 0;
+    return solvePll(ulRequestClk, &pll);
 }
+#endif
 
 /*
  * Set up the corresponding bit field of the programmable PLL register.
@@ -176,7 +236,7 @@ unsigned long formatPllReg(pll_value_t *pPLL)
  *      The actual clock value calculated, together with the values of
  *      PLL register stored in the pPLL pointer.
  */
-unsigned long getPllValue(clock_type_t clockType, pll_value_t *pPLL)
+unsigned long getPllValue(ddk750_context_t *pCtx, clock_type_t clockType, pll_value_t *pPLL)
 {
     unsigned long ulPllReg = 0;
     
@@ -215,7 +275,7 @@ unsigned long getPllValue(clock_type_t clockType, pll_value_t *pPLL)
  *
  * Input: Frequency to be set.
  */
-void setChipClock(unsigned long frequency)
+void setChipClock(ddk750_context_t *pCtx, unsigned long frequency)
 {
     pll_value_t pll;
     unsigned long ulActualMxClk;
@@ -255,7 +315,7 @@ void setChipClock(unsigned long frequency)
  * Output:
  *      The Actual Main Chip clock value.
  */
-unsigned long getChipClock()
+unsigned long getChipClock(ddk750_context_t *pCtx)
 {
     pll_value_t pll;
 
@@ -266,7 +326,7 @@ unsigned long getChipClock()
 		return (MHz(SM750LE_MASTER_CLK));
 #endif 
 
-    return getPllValue(MXCLK_PLL, &pll);
+    return getPllValue(pCtx, MXCLK_PLL, &pll);
 }
 
 /*
@@ -277,7 +337,7 @@ unsigned long getChipClock()
  * NOTE:
  *      The maximum frequency that the DDR Memory clock can be set is 336MHz.
  */
-void setMemoryClock(unsigned long frequency)
+void setMemoryClock(ddk750_context_t *pCtx, unsigned long frequency)
 {
     unsigned long ulReg, divisor;
 
@@ -296,7 +356,7 @@ void setMemoryClock(unsigned long frequency)
             frequency = MHz(336);
         
         /* Calculate the divisor */
-        divisor = (unsigned long) roundedDiv(getChipClock(), frequency);
+        divisor = (unsigned long) roundedDiv(getChipClock(pCtx), frequency);
         
         /* Set the corresponding divisor in the register. */
         ulReg = peekRegisterDWord(CURRENT_GATE);
@@ -317,7 +377,7 @@ void setMemoryClock(unsigned long frequency)
                 break;
         }
         
-        setCurrentGate(ulReg);
+        setCurrentGate(pCtx, ulReg);
     }
 }
 
@@ -329,7 +389,7 @@ void setMemoryClock(unsigned long frequency)
  * NOTE:
  *      The maximum frequency the engine can run is 168MHz.
  */
-void setMasterClock(unsigned long frequency)
+void setMasterClock(ddk750_context_t *pCtx, unsigned long frequency)
 {
     unsigned long ulReg, divisor;
 
@@ -348,7 +408,7 @@ void setMasterClock(unsigned long frequency)
             frequency = MHz(190);
                
         /* Calculate the divisor */
-        divisor = (unsigned long) roundedDiv(getChipClock(), frequency);
+        divisor = (unsigned long) roundedDiv(getChipClock(pCtx), frequency);
         
         /* Set the corresponding divisor in the register. */
         ulReg = peekRegisterDWord(CURRENT_GATE);
@@ -369,7 +429,7 @@ void setMasterClock(unsigned long frequency)
                 break;
         }
         
-        setCurrentGate(ulReg);
+        setCurrentGate(pCtx, ulReg);
     }
 }
 
@@ -379,10 +439,10 @@ void setMasterClock(unsigned long frequency)
  * Output:
  *      The Primary Display Control Pixel Clock value in whole number.
  */
-unsigned long getPrimaryDispCtrlClock()
+unsigned long getPrimaryDispCtrlClock(ddk750_context_t *pCtx)
 {
     pll_value_t pll;
-    return getPllValue(PRIMARY_PLL, &pll);
+    return getPllValue(pCtx, PRIMARY_PLL, &pll);
 }
 
 /*
@@ -391,10 +451,10 @@ unsigned long getPrimaryDispCtrlClock()
  * Output:
  *      The Secondary Display Control Pixel Clock value in whole number.
  */
-unsigned long getSecondaryDispCtrlClock()
+unsigned long getSecondaryDispCtrlClock(ddk750_context_t *pCtx)
 {
     pll_value_t pll;
-    return getPllValue(SECONDARY_PLL, &pll);
+    return getPllValue(pCtx, SECONDARY_PLL, &pll);
 }
 
 /*
@@ -403,7 +463,7 @@ unsigned long getSecondaryDispCtrlClock()
  * Output:
  *      The Master Clock value in whole number.
  */
-unsigned long getMasterClock()
+unsigned long getMasterClock(ddk750_context_t *pCtx)
 {
     unsigned long value, divisor;
 
@@ -432,7 +492,7 @@ unsigned long getMasterClock()
             break;
     }
 
-    return (getChipClock() / divisor);
+    return (getChipClock(pCtx) / divisor);
 }
 
 /*
@@ -441,7 +501,7 @@ unsigned long getMasterClock()
  * Output:
  *      The Memory Clock value in whole number.
  */
-unsigned long getMemoryClock()
+unsigned long getMemoryClock(ddk750_context_t *pCtx)
 {
     unsigned long value, divisor;
 
@@ -470,7 +530,7 @@ unsigned long getMemoryClock()
             break;
     }
 
-    return (getChipClock() / divisor);
+    return (getChipClock(pCtx) / divisor);
 }
 
 /*
@@ -515,13 +575,14 @@ unsigned long getTotalMemoryClockDivider()
  * This function uses the Master Clock PLL clock counter to provide some delay in ms.
  */
 void waitMasterClock(
+    ddk750_context_t *pCtx,
     unsigned long miliseconds
 )
 {
     unsigned long totalClockCount, startCount, endCount, diff, value;
     
     /* Calculate the clock counter needed for the delay */
-    totalClockCount = roundedDiv(getMasterClock(), 1000) * miliseconds;
+    totalClockCount = roundedDiv(getMasterClock(pCtx), 1000) * miliseconds;
     
     /* Enable PLL Clock Count*/
     pokeRegisterDWord(MISC_CTRL, FIELD_SET(peekRegisterDWord(MISC_CTRL), MISC_CTRL, PLL_CLK_COUNT, ON));
@@ -1,6 +1,8 @@
 #ifndef _CLOCK_H_
 #define _CLOCK_H_
 
+#include "ddk750_help.h"
+
 #define DEFAULT_INPUT_CLOCK 14318181 /* Default reference clock */
 #define MHz(x) (x*1000000) /* Don't use this macro if x is fraction number */
 
@@ -66,7 +68,7 @@ unsigned long formatPllReg(pll_value_t *pPLL);
  *
  * Input: Frequency to be set.
  */
-void setChipClock(unsigned long frequency);
+void setChipClock(ddk750_context_t *pCtx, unsigned long frequency);
 
 /*
  * This function gets the Main Chip Clock value.
@@ -74,14 +76,14 @@ void setChipClock(unsigned long frequency);
  * Output:
  *      The Actual Main Chip clock value.
  */
-unsigned long getChipClock(void);
+unsigned long getChipClock(ddk750_context_t *pCtx);
 
 /*
  * This function set up the memory clock.
  *
  * Input: Frequency to be set.
  */
-void setMemoryClock(unsigned long frequency);
+void setMemoryClock(ddk750_context_t *pCtx, unsigned long frequency);
 
 /*
  *  getMemoryClock
@@ -90,14 +92,14 @@ void setMemoryClock(unsigned long frequency);
  *  Output:
  *      The Memory Clock value in whole number.
  */
-unsigned long getMemoryClock(void);
+unsigned long getMemoryClock(ddk750_context_t *pCtx);
 
 /*
  * This function set up the master clock (MCLK).
  *
  * Input: Frequency to be set.
  */
-void setMasterClock(unsigned long frequency);
+void setMasterClock(ddk750_context_t *pCtx, unsigned long frequency);
 
 /*
  *  getMasterClock
@@ -106,7 +108,7 @@ void setMasterClock(unsigned long frequency);
  *  Output:
  *      The Master Clock value in whole number.
  */
-unsigned long getMasterClock(void);
+unsigned long getMasterClock(ddk750_context_t *pCtx);
 
 /*
  * This function get the Primary display control Pixel Clock value.
@@ -114,7 +116,7 @@ unsigned long getMasterClock(void);
  * Output:
  *      The Primary display control Pixel Clock value in whole number.
  */
-unsigned long getPrimaryDispCtrlClock(void);
+unsigned long getPrimaryDispCtrlClock(ddk750_context_t *pCtx);
 
 /*
  * This function get the Secondary display control Pixel Clock value.
@@ -122,7 +124,7 @@ unsigned long getPrimaryDispCtrlClock(void);
  * Output:
  *      The Secondary display control Pixel Clock value in whole number.
  */
-unsigned long getSecondaryDispCtrlClock(void);
+unsigned long getSecondaryDispCtrlClock(ddk750_context_t *pCtx);
 
 /*
  * This function gets the Master Clock Divider Values List.
@@ -154,6 +156,7 @@ unsigned long getTotalMemoryClockDivider(void);
  * This function uses the Master Clock PLL clock counter to provide some delay in ms.
  */
 void waitMasterClock(
+    ddk750_context_t *pCtx,
     unsigned long miliseconds
 );
 
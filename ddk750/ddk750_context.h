@@ -0,0 +1,53 @@
+#ifndef DDK750_CONTEXT_H__
+#define DDK750_CONTEXT_H__
+
+#include "ddk750_help.h"
+#include "ddk750_chip.h"
+#include "ddk750_mode.h"
+
+/*
+ * State the DDK keeps for one SM750 chip. It replaces the file scope
+ * globals and the getCurrentDevice() indexed arrays, which could only
+ * ever address the first card.
+ */
+struct _ddk750_context_t
+{
+    volatile unsigned char __iomem *mmio;   /* Mapped register aperture */
+    unsigned short devId;
+    char revId;
+
+    /* Mode currently programmed on each controller (ddk750_mode.c) */
+    mode_parameter_t primaryCurrentModeParam;
+    mode_parameter_t secondaryCurrentModeParam;
+
+    /* Pixel clock asked for and produced by the PLL on each controller, in Hz (ddk750_mode.c) */
+    unsigned long requestedPixelClock[2];
+    unsigned long actualPixelClock[2];
+
+    /* Semaphore counters for the bus master and PCI burst enable bits (ddk750_power.c) */
+    unsigned long busMasterSemaphoreCounter;
+    unsigned long pciSlaveBurstWriteSemaphoreCounter;
+    unsigned long pciSlaveBurstReadSemaphoreCounter;
+
+    /* GPIO pins and registers used by the software I2C master (ddk750_swi2c.c) */
+    unsigned char i2cClockGPIO;
+    unsigned char i2cDataGPIO;
+    unsigned long i2cClkGPIOMuxReg;
+    unsigned long i2cClkGPIODataReg;
+    unsigned long i2cClkGPIODataDirReg;
+    unsigned long i2cDataGPIOMuxReg;
+    unsigned long i2cDataGPIODataReg;
+    unsigned long i2cDataGPIODataDirReg;
+
+    /* Read-modify-write locks, one per shared register block (smi_lock.h) */
+    struct smi_reg_lock regLock[DDK750_LOCK_COUNT];
+};
+
+/* Lock a register block of the device in scope ("pCtx") around a read-modify-write. */
+#define lockRegisterBlock(lock, flags)      smi_reg_lock_acquire(&pCtx->regLock[lock], flags)
+#define unlockRegisterBlock(lock, flags)    smi_reg_lock_release(&pCtx->regLock[lock], flags)
+
+/* Display controller lock of a display path */
+#define DDK750_LOCK_DC(dispControl)         ((dispControl) == PRIMARY_CTRL ? DDK750_LOCK_DC0 : DDK750_LOCK_DC1)
+
+#endif
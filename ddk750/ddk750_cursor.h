@@ -1,11 +1,14 @@
 #ifndef _CURSOR_H_
 #define _CURSOR_H_
 
+#include "ddk750_help.h"
+
 #include "ddk750_mode.h"
 /*
  * This function initializes the cursor attributes.
  */
 void ddk750_initCursor(
+    ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long base,             /* Base Address */ 
     unsigned long color1,           /* Cursor color 1 in RGB 5:6:5 format */
@@ -17,6 +20,7 @@ void ddk750_initCursor(
  * This function sets the cursor position.
  */
 void ddk750_setCursorPosition(
+    ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long dx,               /* X Coordinate of the cursor */
     unsigned long dy,               /* Y Coordinate of the cursor */
@@ -30,6 +34,7 @@ void ddk750_setCursorPosition(
  * This function enables/disables the cursor.
  */
 void ddk750_enableCursor(
+    ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long enable
 );
@@ -5,7 +5,7 @@
 #include "ddk750_display.h"
 //#include "ddk750/ddk750_dvi.h"
 #include "ddk750_power.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 
 #define Validate_718_AA     1
 
@@ -23,7 +23,7 @@
  *      0   - Not Enable
  *      1   - Enable  
  */
-unsigned char isDualPanelEnable(void)
+unsigned char isDualPanelEnable(ddk750_context_t *pCtx)
 {
     unsigned long value;
 
@@ -38,14 +38,14 @@ unsigned char isDualPanelEnable(void)
  * Output:
  *      panelType   - The type of the panel to be set  
  */
-panel_type_t getPanelType(void)
+panel_type_t getPanelType(ddk750_context_t *pCtx)
 {
     if (FIELD_VAL_GET(peekRegisterDWord(PRIMARY_DISPLAY_CTRL), PRIMARY_DISPLAY_CTRL, DOUBLE_PIXEL) == 
         PRIMARY_DISPLAY_CTRL_DOUBLE_PIXEL_ENABLE)
     {
         return TFT_36BIT;
     }
-    else if (isDualPanelEnable() == 1)
+    else if (isDualPanelEnable(pCtx) == 1)
         return TFT_18BIT;
     else
         return TFT_24BIT;
@@ -58,6 +58,7 @@ panel_type_t getPanelType(void)
  *      panelType   - The type of the panel to be set  
  */
 long setPanelType(
+    ddk750_context_t *pCtx,
     panel_type_t panelType
 )
 {
@@ -99,7 +100,7 @@ long setPanelType(
  * Note:
  *      This function is waiting for the next vertical sync.         
  */
-void waitNextVerticalSync(disp_control_t dispControl, unsigned long vsync_count)
+void waitNextVerticalSync(ddk750_context_t *pCtx, disp_control_t dispControl, unsigned long vsync_count)
 {
     unsigned long status;
     unsigned long ulLoopCount = 0;
@@ -189,18 +190,18 @@ void waitNextVerticalSync(disp_control_t dispControl, unsigned long vsync_count)
  * Use Primary vertical sync as time delay function.
  * Input: Number of vertical sync to wait.
  */
-void primaryWaitVerticalSync(unsigned long vsync_count)
+void primaryWaitVerticalSync(ddk750_context_t *pCtx, unsigned long vsync_count)
 {
-    waitNextVerticalSync(PRIMARY_CTRL, vsync_count);
+    waitNextVerticalSync(pCtx, PRIMARY_CTRL, vsync_count);
 }
 
 /*
  * Use crt vertical sync as time delay function.
  * Input: Number of vertical sync to wait.
  */
-void secondaryWaitVerticalSync(unsigned long vsync_count)
+void secondaryWaitVerticalSync(ddk750_context_t *pCtx, unsigned long vsync_count)
 {
-    waitNextVerticalSync(SECONDARY_CTRL, vsync_count);
+    waitNextVerticalSync(pCtx, SECONDARY_CTRL, vsync_count);
 }
 
 /*
@@ -211,13 +212,13 @@ void secondaryWaitVerticalSync(unsigned long vsync_count)
  *
  * Input: display control (PRIMARY_CTRL or SECONDARY_CTRL)
  */
-void waitVSyncLine(disp_control_t dispControl)
+void waitVSyncLine(ddk750_context_t *pCtx, disp_control_t dispControl)
 {
     unsigned long value;
     mode_parameter_t modeParam;
     
     /* Get the current mode parameter of the specific display control */
-    modeParam = getCurrentModeParam(dispControl);
+    modeParam = getCurrentModeParam(pCtx, dispControl);
     
     do
     {
@@ -230,7 +231,7 @@ void waitVSyncLine(disp_control_t dispControl)
 }
 
 
-void swPanelPowerSequence_SM750LE(disp_state_t dispState, unsigned long vsync_delay)
+void swPanelPowerSequence_SM750LE(ddk750_context_t *pCtx, disp_state_t dispState, unsigned long vsync_delay)
 {
     unsigned long ulDispControl, ulMask;
 
@@ -259,7 +260,7 @@ void swPanelPowerSequence_SM750LE(disp_state_t dispState, unsigned long vsync_de
 /*
  * This functions uses software sequence to turn on/off the panel.
  */
-void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay)
+void swPanelPowerSequence(ddk750_context_t *pCtx, disp_state_t dispState, unsigned long vsync_delay)
 {
     unsigned long primaryControl = peekRegisterDWord(PRIMARY_DISPLAY_CTRL);
 
@@ -270,17 +271,17 @@ void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay)
         /* Turn on FPVDDEN. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, FPVDDEN, HIGH);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn on FPDATA. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, DATA, ENABLE);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn on FPVBIAS. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, VBIASEN, HIGH);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn on FPEN. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, FPEN, HIGH);
@@ -292,17 +293,17 @@ void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay)
         /* Turn off FPEN. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, FPEN, LOW);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn off FPVBIASEN. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, VBIASEN, LOW);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn off FPDATA. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, DATA, DISABLE);
         pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, primaryControl);
-        primaryWaitVerticalSync(vsync_delay);
+        primaryWaitVerticalSync(pCtx, vsync_delay);
 
         /* Turn off FPVDDEN. */
         primaryControl = FIELD_SET(primaryControl, PRIMARY_DISPLAY_CTRL, FPVDDEN, LOW);
@@ -316,7 +317,7 @@ void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay)
  * This function turns on/off the DAC for CRT display control.
  * Input: On or off
  */
-void setDAC(disp_state_t state)
+void setDAC(ddk750_context_t *pCtx, disp_state_t state)
 {
     //DDKDEBUGPRINT((DISPLAY_LEVEL, "setDAC: %s\n", (state == DISP_ON) ? "on" : "off"));
 
@@ -360,13 +361,14 @@ void setDAC(disp_state_t state)
  *      |    OFF    |    ON     | no display and no clock (same as power down)  |
  *      +-----------+-----------+-----------------------------------------------+
  */
-void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
+void setDisplayControl(ddk750_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState)
 {
-    unsigned long ulDisplayCtrlReg, ulReservedBits;
+    unsigned long ulDisplayCtrlReg, ulReservedBits, flags;
 
     /* Set the primary display control */
     if (dispControl == PRIMARY_CTRL)
     {
+        lockRegisterBlock(DDK750_LOCK_DC0, flags);
         ulDisplayCtrlReg = peekRegisterDWord(PRIMARY_DISPLAY_CTRL);
 
         //DDKDEBUGPRINT((DISPLAY_LEVEL, "(setDispCtrl) PRIMARY_DISPLAY_CTRL before set: %x\n", peekRegisterDWord(PRIMARY_DISPLAY_CTRL)));
@@ -394,7 +396,8 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
             /* Somehow the register value on the plane is not set until a few delay. Need to write
                and read it a couple times*/
             pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, ulDisplayCtrlReg);
-            primaryWaitVerticalSync(2);
+            unlockRegisterBlock(DDK750_LOCK_DC0, flags);
+            primaryWaitVerticalSync(pCtx, 2);
         }
         else
         {
@@ -409,6 +412,7 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
 
             ulDisplayCtrlReg = FIELD_SET(ulDisplayCtrlReg, PRIMARY_DISPLAY_CTRL, TIMING, DISABLE);
             pokeRegisterDWord(PRIMARY_DISPLAY_CTRL, ulDisplayCtrlReg);
+            unlockRegisterBlock(DDK750_LOCK_DC0, flags);
         }
 
         //DDKDEBUGPRINT((DISPLAY_LEVEL, "(setDispCtrl) PRIMARY_DISPLAY_CTRL after set: %x\n", peekRegisterDWord(PRIMARY_DISPLAY_CTRL)));
@@ -416,6 +420,7 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
     /* Set the secondary display control */
     else if(dispControl == SECONDARY_CTRL)
     {
+        lockRegisterBlock(DDK750_LOCK_DC1, flags);
         ulDisplayCtrlReg = peekRegisterDWord(SECONDARY_DISPLAY_CTRL);
 
         //DDKDEBUGPRINT((DISPLAY_LEVEL, "(setDispCtrl) SECONDARY_DISPLAY_CTRL before set: %x\n", peekRegisterDWord(SECONDARY_DISPLAY_CTRL)));
@@ -442,7 +447,8 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
             
             
             pokeRegisterDWord(SECONDARY_DISPLAY_CTRL, ulDisplayCtrlReg);
-            secondaryWaitVerticalSync(2);
+            unlockRegisterBlock(DDK750_LOCK_DC1, flags);
+            secondaryWaitVerticalSync(pCtx, 2);
         }
         else
         {
@@ -457,6 +463,7 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
 
             ulDisplayCtrlReg = FIELD_SET(ulDisplayCtrlReg, SECONDARY_DISPLAY_CTRL, TIMING, DISABLE);
             pokeRegisterDWord(SECONDARY_DISPLAY_CTRL, ulDisplayCtrlReg);
+            unlockRegisterBlock(DDK750_LOCK_DC1, flags);
         }
 
         //DDKDEBUGPRINT((DISPLAY_LEVEL, "(setDispCtrl) SECONDARY_DISPLAY_CTRL after set: %x\n", peekRegisterDWord(SECONDARY_DISPLAY_CTRL)));
@@ -471,6 +478,7 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState)
  *     and display output. 
  */
 void setPath(
+    ddk750_context_t *pCtx,
     disp_path_t dispPath, 
     disp_control_t dispControl, 
     disp_state_t dispState
@@ -481,7 +489,7 @@ void setPath(
     unsigned long clock0, clock1, MiscControl;    
 
     /* Get the current mode parameter of the specific display control */
-    modeParam = getCurrentModeParam(dispControl);
+    modeParam = getCurrentModeParam(pCtx, dispControl);
     
     if (dispPath == PANEL_PATH)
     {
@@ -602,6 +610,7 @@ void setPath(
  *                    value. 
  */
 void getCRTDetectThreshold(
+    ddk750_context_t *pCtx,
     unsigned char *pRedValue,
     unsigned char *pGreenValue,
     unsigned char *pBlueValue
@@ -634,6 +643,7 @@ void getCRTDetectThreshold(
  *     -1   - Fail 
  */
 long ddk750_detectCRTMonitor(
+    ddk750_context_t *pCtx,
     unsigned char redValue,
     unsigned char greenValue,
     unsigned char blueValue
@@ -710,6 +720,7 @@ long ddk750_detectCRTMonitor(
  *     -1   - Fail 
  */
 long setLogicalDispOutput(
+ddk750_context_t *pCtx,
 
     disp_output_t output,
     unsigned char dispCtrlUsage
@@ -725,15 +736,15 @@ long setLogicalDispOutput(
         
             /* In here, all the display device has to be turned off first before the
                the display control. */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel */
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
     
-            setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Panel control */
-            setDisplayControl(SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT control */
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Panel control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT control */
 
-            setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel path */
-            setPath(CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT path */
+            setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel path */
+            setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT path */
             break;
         }    
         case LCD1_ONLY:
@@ -746,39 +757,39 @@ long setLogicalDispOutput(
             if (dispCtrlUsage == 0)
             {
                 /* Turn on Primary control */
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on CRT control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off CRT control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use panel data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off CRT control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use panel data */
                 }
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT Path */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT Path */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT Path */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT Path */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }    
         case LCD2_ONLY:
@@ -789,7 +800,7 @@ long setLogicalDispOutput(
              * 1. Check the conditions 
              */
             /* Can not enable LCD22 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -797,33 +808,33 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary control */                
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary control */                
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use primary data */
                 }
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel Path */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel Path */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */                
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use secondary data */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */                
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use secondary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel 1 */
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel 1 */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }
         case CRT2_ONLY:
@@ -835,25 +846,25 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_OFF);        /* Turn off Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn off CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);        /* Turn off Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn off CRT Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use Primary data */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
         case LCD1_CRT2_SIMUL: /* Panel and CRT same content */
@@ -865,33 +876,33 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
                 } 
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn on CRT Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_SIMUL:
@@ -902,7 +913,7 @@ long setLogicalDispOutput(
              * 1. Check the conditions 
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -910,40 +921,40 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {    
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }    
         case CRT2_LCD2_SIMUL:
@@ -954,7 +965,7 @@ long setLogicalDispOutput(
              * 1. Check the conditions 
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -962,33 +973,33 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn on Panel Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn on Panel Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn on Panel Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_CRT2_SIMUL:
@@ -999,7 +1010,7 @@ long setLogicalDispOutput(
              * 1. Check the conditions
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -1007,34 +1018,34 @@ long setLogicalDispOutput(
              */
             if (dispCtrlUsage == 0)
             {            
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
         case LCD1_CRT2_DUAL: /* Panel and CRT different content */
@@ -1052,21 +1063,21 @@ long setLogicalDispOutput(
             /* 
              * 2. Set all the display control and the display path 
              */
-            setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-            setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
 
 
             if (dispCtrlUsage == 0)
             {
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
 
 
             }
             else
             {
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
 
 
             }
@@ -1074,9 +1085,9 @@ long setLogicalDispOutput(
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_DUAL:
@@ -1092,37 +1103,37 @@ long setLogicalDispOutput(
            //     return (-1);
                 
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
              * 2. Set all the display control and the display path 
              */
-            setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-            setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
             if (dispCtrlUsage == 0)
             {
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
             }
             else
             {
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS to drive CRT */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS to drive CRT */
             break;
         }
         case LCD1_LCD2_CRT2_DUAL:
@@ -1138,31 +1149,31 @@ long setLogicalDispOutput(
               //  return (-1);
                 
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
              * 2. Set all the display control and the display path 
              */
-            setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-            setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */            
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */            
             if (dispCtrlUsage == 0)
             {
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
             }
             else
             {
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
     }
@@ -1195,6 +1206,7 @@ long setLogicalDispOutput(
  *     -1   - Fail 
  */
 long setLogicalDispOutputExt(
+    ddk750_context_t *pCtx,
     long isSecondDisplay, 
     disp_output_t output,
     unsigned char dispCtrlUsage
@@ -1210,15 +1222,15 @@ long setLogicalDispOutputExt(
         
             /* In here, all the display device has to be turned off first before the
                the display control. */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel */
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
     
-            setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Panel control */
-            setDisplayControl(SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT control */
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Panel control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT control */
 
-            setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel path */
-            setPath(CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT path */
+            setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel path */
+            setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT path */
             break;
         }    
         case LCD1_ONLY:
@@ -1231,39 +1243,39 @@ long setLogicalDispOutputExt(
             if (dispCtrlUsage == 0)
             {
                 /* Turn on Primary control */
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on CRT control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off CRT control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use panel data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off CRT control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use panel data */
                 }
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT Path */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_OFF);          /* Turn off CRT Path */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT Path */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_OFF);        /* Turn off CRT Path */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }    
         case LCD2_ONLY:
@@ -1274,7 +1286,7 @@ long setLogicalDispOutputExt(
              * 1. Check the conditions 
              */
             /* Can not enable LCD22 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -1282,33 +1294,33 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary control */                
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary control */                
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use primary data */
                 }
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel Path */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn off Panel Path */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */                
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use secondary data */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary control */                
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use secondary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel 1 */
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel 1 */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }
         case CRT2_ONLY:
@@ -1320,25 +1332,25 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_OFF);        /* Turn off Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn off CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);        /* Turn off Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn off CRT Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn off Panel Path */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn off CRT Path and use Primary data */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_OFF, 4);                  /* Turn off Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_OFF, 4);                  /* Turn off Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
         case LCD1_CRT2_SIMUL: /* Panel and CRT same content */
@@ -1350,33 +1362,33 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
                 }            
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);           /* Turn on CRT Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 2. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_SIMUL:
@@ -1387,7 +1399,7 @@ long setLogicalDispOutputExt(
              * 1. Check the conditions 
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -1395,40 +1407,40 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {    
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS */
             break;
         }    
         case CRT2_LCD2_SIMUL:
@@ -1439,7 +1451,7 @@ long setLogicalDispOutputExt(
              * 1. Check the conditions 
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -1447,33 +1459,33 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_OFF);        /* Turn on Panel Path and use Primary data */
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn on Panel Path and use Primary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_OFF);      /* Turn on Panel Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_CRT2_SIMUL:
@@ -1484,7 +1496,7 @@ long setLogicalDispOutputExt(
              * 1. Check the conditions
              */
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
@@ -1492,34 +1504,34 @@ long setLogicalDispOutputExt(
              */
             if (dispCtrlUsage == 0)
             {            
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-                if (isScalingEnabled(PRIMARY_CTRL) == 1)
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);     /* Turn on Secondary control */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
                 }
                 else
                 {
-                    setDisplayControl(SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setDisplayControl(pCtx, SECONDARY_CTRL, DISP_OFF);    /* Turn off Secondary control */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
                 }
             }
             else
             {
-                setDisplayControl(PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_OFF);          /* Turn off Primary Control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);       /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);         /* Turn on CRT Path and use Secondary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
         case LCD1_CRT2_DUAL: /* Panel and CRT different content */
@@ -1531,36 +1543,36 @@ long setLogicalDispOutputExt(
              */
             /* This combination is not valid if panel 1 requires scaling and display
                control is not swapped. */
-            if (isScalingEnabled(PRIMARY_CTRL) == 1)
+            if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 return (-1);
 
             /* 
              * 2. Set all the display control and the display path 
              */
             if(!isSecondDisplay) 
-                setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+                setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
             else
-                setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+                setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
             if (dispCtrlUsage == 0)
             {
                 if(!isSecondDisplay) 
-                    setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                    setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
                 else
-                    setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                    setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
             }
             else
             {
                 if(isSecondDisplay)             
-                    setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                    setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
                 else
-                    setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                    setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
             }
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }    
         case LCD1_LCD2_DUAL:
@@ -1572,41 +1584,41 @@ long setLogicalDispOutputExt(
              */    
             /* This combination is not valid if panel requires scaling and display
                control is not swapped. */
-            if (isScalingEnabled(PRIMARY_CTRL) == 1)
+            if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 return (-1);
                 
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
              * 2. Set all the display control and the display path 
              */
-            setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-            setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */
             if (dispCtrlUsage == 0)
             {
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
             }
             else
             {
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
 #ifdef ENABLE_PANEL_DAC
             /* When using Analog CRT connected to the DVI channel, the DAC needs
                to be turned on. The power is using the same power as CRT DAC. */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
 #else
-            setDAC(DISP_OFF);                                   /* Turn off DAC */
+            setDAC(pCtx, DISP_OFF);                                   /* Turn off DAC */
 #endif
-            setDPMS(DPMS_OFF);                                  /* Turn off DPMS to drive CRT */
+            setDPMS(pCtx, DPMS_OFF);                                  /* Turn off DPMS to drive CRT */
             break;
         }
         case LCD1_LCD2_CRT2_DUAL:
@@ -1618,35 +1630,35 @@ long setLogicalDispOutputExt(
              */    
             /* This combination is not valid if panel requires scaling and display
                control is not swapped. */
-            if (isScalingEnabled(PRIMARY_CTRL) == 1)
+            if (isScalingEnabled(pCtx, PRIMARY_CTRL) == 1)
                 return (-1);
                 
             /* Can not enable PANEL2 when the panel type is not 18-bit panel. */            
-            if (getPanelType() != TFT_18BIT)
+            if (getPanelType(pCtx) != TFT_18BIT)
                 return (-1);
             
             /* 
              * 2. Set all the display control and the display path 
              */
-            setDisplayControl(PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
-            setDisplayControl(SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */            
+            setDisplayControl(pCtx, PRIMARY_CTRL, DISP_ON);           /* Turn on Primary Control */
+            setDisplayControl(pCtx, SECONDARY_CTRL, DISP_ON);         /* Turn on Secondary control */            
             if (dispCtrlUsage == 0)
             {
-                setPath(PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
-                setPath(CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+                setPath(pCtx, PANEL_PATH, PRIMARY_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+                setPath(pCtx, CRT_PATH, SECONDARY_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
             }
             else
             {
-                setPath(PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
-                setPath(CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
+                setPath(pCtx, PANEL_PATH, SECONDARY_CTRL, DISP_ON);   /* Turn on Panel Path and use Secondary data */
+                setPath(pCtx, CRT_PATH, PRIMARY_CTRL, DISP_ON);       /* Turn on CRT Path and use Primary data */
             }
             
             /* 
              * 3. Enable/disable the display devices. 
              */
-            swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-            setDAC(DISP_ON);                                    /* Turn on DAC */
-            setDPMS(DPMS_ON);                                   /* Turn on DPMS to drive CRT */
+            swPanelPowerSequence(pCtx, DISP_ON, 4);                   /* Turn on Panel */
+            setDAC(pCtx, DISP_ON);                                    /* Turn on DAC */
+            setDPMS(pCtx, DPMS_ON);                                   /* Turn on DPMS to drive CRT */
             break;
         }
     }
@@ -1665,6 +1677,7 @@ long setLogicalDispOutputExt(
  *      1   - Scaling is enabled
  */
 unsigned char isScalingEnabled(
+    ddk750_context_t *pCtx,
     disp_control_t dispCtrl
 )
 {
@@ -1,6 +1,8 @@
 #ifndef _DISPLAY_H_
 #define _DISPLAY_H_
 
+#include "ddk750_help.h"
+
 #include "ddk750_mode.h"
 
 typedef enum _disp_path_t
@@ -43,6 +45,7 @@ typedef enum _panel_type_t
 panel_type_t;
 
 void setPath(
+    ddk750_context_t *pCtx,
     disp_path_t dispPath, 
     disp_control_t dispControl, 
     disp_state_t dispState
@@ -55,13 +58,13 @@ void setCRTPath(disp_control_t dispControl);
 /*
  * This functions uses software sequence to turn on/off the panel.
  */
-void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay);
+void swPanelPowerSequence(ddk750_context_t *pCtx, disp_state_t dispState, unsigned long vsync_delay);
 
 /* 
  * This function turns on/off the DAC for CRT display control.
  * Input: On or off
  */
-void setDAC(disp_state_t state);
+void setDAC(ddk750_context_t *pCtx, disp_state_t state);
 
 /*
  * This function turns on/off the display control.
@@ -69,7 +72,7 @@ void setDAC(disp_state_t state);
  * Input: Panel or CRT, or ...
  *        On or Off.
  */
-void setDisplayControl(disp_control_t dispControl, disp_state_t dispState);
+void setDisplayControl(ddk750_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState);
 
 /*
  * This function set the logical display output.
@@ -95,6 +98,7 @@ void setDisplayControl(disp_control_t dispControl, disp_state_t dispState);
  *     -1   - Fail 
  */
 long setLogicalDispOutput(
+    ddk750_context_t *pCtx,
     disp_output_t output,
     unsigned char dispCtrlUsage
 );
@@ -126,6 +130,7 @@ long setLogicalDispOutput(
  *     -1   - Fail 
  */
 long setLogicalDispOutputExt(
+    ddk750_context_t *pCtx,
     long isSecondDisplay,
     disp_output_t output,
     unsigned char dispCtrlUsage
@@ -139,7 +144,7 @@ long setLogicalDispOutputExt(
  * Note:
  *      This function is waiting for the next vertical sync.
  */
-void waitNextVerticalSync(disp_control_t dispControl, unsigned long vsync_count);
+void waitNextVerticalSync(ddk750_context_t *pCtx, disp_control_t dispControl, unsigned long vsync_count);
 
 /*
  * Use panel vertical sync line as time delay function.
@@ -149,7 +154,7 @@ void waitNextVerticalSync(disp_control_t dispControl, unsigned long vsync_count)
  *
  * Input: display control (PRIMARY_CTRL or SECONDARY_CTRL)
  */
-void waitVSyncLine(disp_control_t dispControl);
+void waitVSyncLine(ddk750_context_t *pCtx, disp_control_t dispControl);
 
 /*
  * This function gets the panel type
@@ -157,9 +162,9 @@ void waitVSyncLine(disp_control_t dispControl);
  * Output:
  *      panelType   - The type of the panel to be set  
  */
-panel_type_t getPanelType(void);
+panel_type_t getPanelType(ddk750_context_t *pCtx);
 
-long setPanelType(panel_type_t panelType);
+long setPanelType(ddk750_context_t *pCtx, panel_type_t panelType);
 
 
 /*
@@ -174,6 +179,7 @@ long setPanelType(panel_type_t panelType);
  *                    value. 
  */
 void getCRTDetectThreshold(
+    ddk750_context_t *pCtx,
     unsigned char *pRedValue,
     unsigned char *pGreenValue,
     unsigned char *pBlueValue
@@ -192,6 +198,7 @@ void getCRTDetectThreshold(
  *     -1   - Fail 
  */
 long ddk750_detectCRTMonitor(
+    ddk750_context_t *pCtx,
     unsigned char redValue,
     unsigned char greenValue,
     unsigned char blueValue
@@ -208,6 +215,7 @@ long ddk750_detectCRTMonitor(
  *      1   - Scaling is enabled
  */
 unsigned char isScalingEnabled(
+    ddk750_context_t *pCtx,
     disp_control_t dispCtrl
 );
 
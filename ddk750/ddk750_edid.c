@@ -1083,6 +1083,7 @@ long ddk750_edidReadMonitorEx(
  *      edidSize   - Success and return the edid's size
  */
 long ddk750_edidReadMonitorEx(
+	ddk750_context_t *pCtx,
 	disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -1097,7 +1098,7 @@ long ddk750_edidReadMonitorEx(
     long edidSize = TOTAL_EDID_REGISTERS_128;
 
     /* Initialize the i2c bus */
-    swI2CInit(sclGpio, sdaGpio);
+    swI2CInit(pCtx, sclGpio, sdaGpio);
 
     for (retry = 0; retry < EDID_TOTAL_RETRY_COUNTER; retry++)
     {
@@ -1105,9 +1106,9 @@ long ddk750_edidReadMonitorEx(
 #ifndef  READ_EDID_CONTINUOUS
         /* Read the EDID from the monitor. */
         for (offset = 0; offset < TOTAL_EDID_REGISTERS_128; offset++)
-            edidBuffer[offset] = swI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+            edidBuffer[offset] = swI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
 #else
-        if (!swI2CReadReg_Continuous(EDID_DEVICE_I2C_ADDRESS, 0, TOTAL_EDID_REGISTERS_128, edidBuffer))
+        if (!swI2CReadReg_Continuous(pCtx, EDID_DEVICE_I2C_ADDRESS, 0, TOTAL_EDID_REGISTERS_128, edidBuffer))
             memset(edidBuffer, 0xFF, TOTAL_EDID_REGISTERS_128); /* read error */
 #endif
 
@@ -1115,9 +1116,9 @@ long ddk750_edidReadMonitorEx(
        	 	{
 #ifndef  READ_EDID_CONTINUOUS    
             	for (offset = TOTAL_EDID_REGISTERS_128; offset < TOTAL_EDID_REGISTERS_256; offset++)
-                	edidBuffer[offset] = swI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+                	edidBuffer[offset] = swI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
 #else
-           	if (!swI2CReadReg_Continuous(EDID_DEVICE_I2C_ADDRESS, TOTAL_EDID_REGISTERS_128, TOTAL_EDID_REGISTERS_128, edidBuffer + TOTAL_EDID_REGISTERS_128))
+           	if (!swI2CReadReg_Continuous(pCtx, EDID_DEVICE_I2C_ADDRESS, TOTAL_EDID_REGISTERS_128, TOTAL_EDID_REGISTERS_128, edidBuffer + TOTAL_EDID_REGISTERS_128))
                 	memset(edidBuffer + TOTAL_EDID_REGISTERS_128, 0xFF, TOTAL_EDID_REGISTERS_128); /* read error */
 #endif
         	edidSize = TOTAL_EDID_REGISTERS_256;
@@ -1157,6 +1158,7 @@ long ddk750_edidReadMonitorEx(
 #endif
 
 long ddk750_edidReadMonitorEx_HW(
+    ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -1169,7 +1171,7 @@ long ddk750_edidReadMonitorEx_HW(
 	long edidSize = 0;
     
     /* Initialize the i2c bus */
-    ddk750_hwI2CInit(1);
+    ddk750_hwI2CInit(pCtx, 1);
 
 #if 0
     for (retry = 0; retry < EDID_TOTAL_RETRY_COUNTER; retry++)
@@ -1193,7 +1195,7 @@ long ddk750_edidReadMonitorEx_HW(
         /* Read the EDID from the monitor. */
         for (offset = 0; offset < TOTAL_EDID_REGISTERS_128; offset++)
         {
-            value = ddk750_hwI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+            value = ddk750_hwI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
             if(0xFFFFFFFF == value)
                 break;
             edidBuffer[offset] = (0xFF & value);
@@ -1205,7 +1207,7 @@ long ddk750_edidReadMonitorEx_HW(
             {
                 for (offset = TOTAL_EDID_REGISTERS_128; offset < TOTAL_EDID_REGISTERS_256; offset++)
                 {
-                    value = ddk750_hwI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+                    value = ddk750_hwI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
 
                     if(0xFFFFFFFF == value)
                         break;
@@ -1228,7 +1230,7 @@ long ddk750_edidReadMonitorEx_HW(
 
 #endif
     /* Finish using HW I2C, we can close the device. */
-    ddk750_hwI2CClose();
+    ddk750_hwI2CClose(pCtx);
 
     /* 
      *  The monitor might not be DDC2B compliance. Therefore, need to use DDC1 protocol,
@@ -1285,13 +1287,14 @@ long ddk750_edidReadMonitorEx_HW(
  *     -1   - Fail
  */
 long ddk750_edidReadMonitor(
+    ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
     unsigned char edidExtNo
 )
 {
-    return ddk750_edidReadMonitorEx(displayPath, pEDIDBuffer, bufferSize, edidExtNo, DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
+    return ddk750_edidReadMonitorEx(pCtx, displayPath, pEDIDBuffer, bufferSize, edidExtNo, DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
 }
 
 #define HEADER_EDID_REGISTERS               8
@@ -1342,6 +1345,7 @@ unsigned char ddk750_edidGetHeader(
  *     -1   - Fail
  */
 long ddk750_edidHeaderReadMonitorEx(
+    ddk750_context_t *pCtx,
     unsigned char sclGpio,
     unsigned char sdaGpio
 )
@@ -1351,7 +1355,7 @@ long ddk750_edidHeaderReadMonitorEx(
     
 
     /* Initialize the i2c bus */
-    swI2CInit(sclGpio, sdaGpio);
+    swI2CInit(pCtx, sclGpio, sdaGpio);
 
     for (retry = 0; retry < EDID_TOTAL_RETRY_COUNTER; retry++)
     {
@@ -1360,9 +1364,9 @@ long ddk750_edidHeaderReadMonitorEx(
 #ifndef READ_EDID_CONTINUOUS
 		  /* Read the EDID from the monitor. */
 		  for (offset = 0; offset < HEADER_EDID_REGISTERS; offset++)
-			  edidBuffer[offset] = swI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+			  edidBuffer[offset] = swI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
 #else
- 		  if (!swI2CReadReg_Continuous(EDID_DEVICE_I2C_ADDRESS, 0, HEADER_EDID_REGISTERS, edidBuffer))
+ 		  if (!swI2CReadReg_Continuous(pCtx, EDID_DEVICE_I2C_ADDRESS, 0, HEADER_EDID_REGISTERS, edidBuffer))
  			  memset(edidBuffer, 0xFF, HEADER_EDID_REGISTERS); /* read error */
 #endif
 
@@ -1389,14 +1393,14 @@ long ddk750_edidHeaderReadMonitorEx(
     return 0;
 }
 
-long ddk750_edidHeaderReadMonitorExHwI2C(void)
+long ddk750_edidHeaderReadMonitorExHwI2C(ddk750_context_t *pCtx)
 {
     unsigned char retry;//value,
     unsigned char edidBuffer[10];
     unsigned long offset;
 
     /* Initialize the i2c bus */
-    ddk750_hwI2CInit(1);
+    ddk750_hwI2CInit(pCtx, 1);
 
     for (retry = 0; retry < EDID_TOTAL_RETRY_COUNTER; retry++)
     {
@@ -1404,7 +1408,7 @@ long ddk750_edidHeaderReadMonitorExHwI2C(void)
 
         /* Read the EDID from the monitor. */
         for (offset = 0; offset < HEADER_EDID_REGISTERS; offset++)
-            edidBuffer[offset] = ddk750_hwI2CReadReg(EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
+            edidBuffer[offset] = ddk750_hwI2CReadReg(pCtx, EDID_DEVICE_I2C_ADDRESS, (unsigned char)offset);
 
         /* Check if the EDID header is valid. */
         if (!ddk750_edidGetHeader((unsigned char *)&edidBuffer))
@@ -1412,7 +1416,7 @@ long ddk750_edidHeaderReadMonitorExHwI2C(void)
     }
 
 	/* Finish using HW I2C, we can close the device. */
-    ddk750_hwI2CClose();
+    ddk750_hwI2CClose(pCtx);
 
     /*
      *  The monitor might not be DDC2B compliance. Therefore, need to use DDC1 protocol,
@@ -1,6 +1,8 @@
 #ifndef _EDID_H_
 #define _EDID_H_
 
+#include "ddk750_help.h"
+
 #include "ddk750_display.h"
 #include "vdif.h"
 
@@ -771,6 +773,7 @@ long edidReadMonitor(
  *     -1   - Fail
  */
 long ddk750_edidReadMonitorEx(
+    ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -780,6 +783,7 @@ long ddk750_edidReadMonitorEx(
 );
 
 long ddk750_edidReadMonitorEx_HW(
+    ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -1,13 +1,73 @@
-#include "ddk750_help.h"
+#include <linux/slab.h>
 
-volatile unsigned char __iomem * mmio750 = NULL;
+#include "ddk750_defs.h"
+#include "ddk750_context.h"
+#include "ddk750_swi2c.h"
 
 
 
 /* after driver mapped io registers, use this function first */
-void ddk750_set_mmio(volatile unsigned char * addr,unsigned short devId,char revId)
+ddk750_context_t *ddk750_alloc_context(volatile unsigned char __iomem * addr,unsigned short devId,char revId)
 {
-	mmio750 = addr;
+	ddk750_context_t *pCtx;
+
+	pCtx = kzalloc(sizeof(*pCtx), GFP_KERNEL);
+	if (!pCtx)
+		return NULL;
+
+	pCtx->mmio = addr;
+	pCtx->devId = devId;
+	pCtx->revId = revId;
+
+	/* Software I2C defaults to the DDC pins until a bus is selected. */
+	pCtx->i2cClockGPIO = DEFAULT_I2C_SCL;
+	pCtx->i2cDataGPIO = DEFAULT_I2C_SDA;
+	pCtx->i2cClkGPIOMuxReg = GPIO_MUX;
+	pCtx->i2cClkGPIODataReg = GPIO_DATA;
+	pCtx->i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
+	pCtx->i2cDataGPIOMuxReg = GPIO_MUX;
+	pCtx->i2cDataGPIODataReg = GPIO_DATA;
+	pCtx->i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
+
+	smi_reg_lock_init(&pCtx->regLock[DDK750_LOCK_INT], "int_mask");
+	smi_reg_lock_init(&pCtx->regLock[DDK750_LOCK_GPIO], "gpio");
+	smi_reg_lock_init(&pCtx->regLock[DDK750_LOCK_DC0], "primary");
+	smi_reg_lock_init(&pCtx->regLock[DDK750_LOCK_DC1], "secondary");
+
 	printk("Found SM750 Chip\n");
+	return pCtx;
+}
+
+void ddk750_free_context(ddk750_context_t *pCtx)
+{
+	kfree(pCtx);
+}
+
+struct smi_reg_lock *ddk750_getRegLock(ddk750_context_t *pCtx, int lock)
+{
+	if (lock < 0 || lock >= DDK750_LOCK_COUNT)
+		return NULL;
+
+	return &pCtx->regLock[lock];
 }
 
+/* 
+ * Find the lock of the register block an MMIO offset belongs to.
+ * Returns NULL when the register is not shared with another context.
+ */
+struct smi_reg_lock *ddk750_findRegLock(ddk750_context_t *pCtx, unsigned long offset)
+{
+	if (offset == INT_MASK)
+		return &pCtx->regLock[DDK750_LOCK_INT];
+
+	if (offset == GPIO_MUX || offset == GPIO_DATA || offset == GPIO_DATA_DIRECTION)
+		return &pCtx->regLock[DDK750_LOCK_GPIO];
+
+	if (offset >= PRIMARY_DISPLAY_CTRL && offset < SECONDARY_DISPLAY_CTRL)
+		return &pCtx->regLock[DDK750_LOCK_DC0];
+
+	if (offset >= SECONDARY_DISPLAY_CTRL && offset < SECONDARY_DISPLAY_CTRL + 0x200)
+		return &pCtx->regLock[DDK750_LOCK_DC1];
+
+	return NULL;
+}
@@ -1,32 +1,54 @@
 #ifndef DDK750_HELP_H__
 #define DDK750_HELP_H__
-#include "ddk750_chip.h"
+
+/*
+ * Per-device DDK state. Every DDK function that touches the hardware takes
+ * the context of the chip it works on as first argument, so that several
+ * SM750 cards can be driven from the same module. The layout is only visible
+ * to the DDK itself (ddk750_context.h).
+ */
+typedef struct _ddk750_context_t ddk750_context_t;
+
 #ifndef USE_INTERNAL_REGISTER_ACCESS
 
 #include <linux/ioport.h>
 #include <linux/io.h>
 #include <linux/uaccess.h>
-#include "ddk750_mode.h"
+
+#include "../smi_lock.h"
 
 
-#define PEEK32(addr) readl((addr)+mmio750)
-#define POKE32(addr,data) writel((data),(addr)+mmio750)
-#define peekRegisterDWord PEEK32
-#define pokeRegisterDWord POKE32
+/* The register access macros expect the device context "pCtx" in scope. */
+#define PEEK32(addr) readl((addr)+pCtx->mmio)
+#define POKE32(addr,data) writel((data),(addr)+pCtx->mmio)
+#define peekRegisterDWord(addr) readl((addr)+pCtx->mmio)
+#define pokeRegisterDWord(addr,data) writel((data),(addr)+pCtx->mmio)
 
 
-#define peekRegisterByte(addr) readb((addr)+mmio750)
-#define pokeRegisterByte(addr,data) writeb((data),(addr)+mmio750)
+#define peekRegisterByte(addr) readb((addr)+pCtx->mmio)
+#define pokeRegisterByte(addr,data) writeb((data),(addr)+pCtx->mmio)
 
 
 
-extern volatile unsigned  char __iomem * mmio750;
+ddk750_context_t *ddk750_alloc_context(volatile unsigned char __iomem *,unsigned short,char);
+void ddk750_free_context(ddk750_context_t *pCtx);
 
-void ddk750_set_mmio(volatile unsigned char *,unsigned short,char);
+/* Register blocks that have their own lock in the context (see smi_lock.h). */
+typedef enum _ddk750_reg_lock_t
+{
+    DDK750_LOCK_INT = 0,     /* Interrupt mask */
+    DDK750_LOCK_GPIO,        /* GPIO mux, data and direction */
+    DDK750_LOCK_DC0,         /* Primary display controller */
+    DDK750_LOCK_DC1,         /* Secondary display controller */
+    DDK750_LOCK_COUNT
+}
+ddk750_reg_lock_t;
+
+struct smi_reg_lock *ddk750_getRegLock(ddk750_context_t *pCtx, int lock);
+struct smi_reg_lock *ddk750_findRegLock(ddk750_context_t *pCtx, unsigned long offset);
 
 #else
 /* implement if you want use it*/
 #endif
 
 #endif
-
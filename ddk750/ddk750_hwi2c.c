@@ -1,7 +1,7 @@
 #include "ddk750_defs.h"
 #include "ddk750_hardware.h"
 #include "ddk750_power.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 #include "ddk750_hwi2c.h"
 
 
@@ -9,12 +9,14 @@
 
 
 static unsigned long hwI2CWriteData(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress,
     unsigned long length,
     unsigned char *pBuffer
 );
 
 static unsigned long hwI2CReadData(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress,
     unsigned long length,
     unsigned char *pBuffer
@@ -23,6 +25,9 @@ static unsigned long hwI2CReadData(
 static int ddk750_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg msgs[],
                            int num)
 {
+    struct smi_connector *connector = i2c_get_adapdata(adap);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk750_context_t *pCtx = sdev->ddk750_ctx;
     unsigned long ret;
     int i, count = 0;
 
@@ -38,7 +43,7 @@ static int ddk750_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg msgs[],
 		msgs->addr = msgs->addr << 1;
         if (!(msgs->flags & I2C_M_RD))
         {
-            ret = hwI2CWriteData(
+            ret = hwI2CWriteData(pCtx, 
                 msgs->addr,
                 msgs->len,
                 msgs->buf);
@@ -50,7 +55,7 @@ static int ddk750_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg msgs[],
         }
         else
         {
-            ret = hwI2CReadData(
+            ret = hwI2CReadData(pCtx, 
                 msgs->addr,
                 msgs->len,
                 msgs->buf);
@@ -99,21 +104,24 @@ static const struct i2c_algorithm ddk750_i2c_algo = {
  *      -1   - Fail to initialize i2c
  */
 long ddk750_hwI2CInit(
+    ddk750_context_t *pCtx,
     unsigned char busSpeedMode
 )
 {
-    unsigned long value;
+    unsigned long value, flags;
     
     /* Enable GPIO 30 & 31 as IIC clock & data */
+	lockRegisterBlock(DDK750_LOCK_GPIO, flags);
 	value = peekRegisterDWord(GPIO_MUX);
     value = FIELD_SET(value, GPIO_MUX, 30, I2C) |
 			FIELD_SET(0, GPIO_MUX, 31, I2C);
 	pokeRegisterDWord(GPIO_MUX, value);
+	unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
               
     /* Enable Hardware I2C power.
        TODO: Check if we need to enable GPIO power?
      */
-    enableI2C(1);
+    enableI2C(pCtx, 1);
     
     /* Enable the I2C Controller and set the bus speed mode */
     value = peekRegisterByte(I2C_CTRL);
@@ -127,11 +135,11 @@ long ddk750_hwI2CInit(
     return 0;
 }
 
-long ddk750_AdaptHWI2CInit(struct smi_connector *connector)
+long ddk750_AdaptHWI2CInit(ddk750_context_t *pCtx, struct smi_connector *connector)
 {
     int ret;
 
-    ddk750_hwI2CInit(1);
+    ddk750_hwI2CInit(pCtx, 1);
 
     connector->adapter.owner = THIS_MODULE;
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
@@ -155,9 +163,9 @@ long ddk750_AdaptHWI2CInit(struct smi_connector *connector)
 /*
  *  This function closes the hardware i2c.
  */
-void ddk750_hwI2CClose()
+void ddk750_hwI2CClose(ddk750_context_t *pCtx)
 {
-    unsigned long value;
+    unsigned long value, flags;
     
     /* Disable I2C controller */
     value = peekRegisterByte(I2C_CTRL);
@@ -165,18 +173,20 @@ void ddk750_hwI2CClose()
     pokeRegisterByte(I2C_CTRL, value);
 
     /* Disable I2C Power */
-    enableI2C(0);
+    enableI2C(pCtx, 0);
 
     /* Set GPIO 30 & 31 back as GPIO pins */
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
     value = peekRegisterDWord(GPIO_MUX);
     value = FIELD_SET(value, GPIO_MUX, 30, GPIO);
     value = FIELD_SET(value, GPIO_MUX, 31, GPIO);
     pokeRegisterDWord(GPIO_MUX, value);
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 }
 
-long ddk750_AdaptHWI2CCleanBus(struct smi_connector *connector)
+long ddk750_AdaptHWI2CCleanBus(ddk750_context_t *pCtx, struct smi_connector *connector)
 {
-	ddk750_hwI2CClose();
+	ddk750_hwI2CClose(pCtx);
 	return 0;
 }
 
@@ -188,7 +198,7 @@ long ddk750_AdaptHWI2CCleanBus(struct smi_connector *connector)
  *      -1   - Tranfer is not successful (timeout)
  */
 #define HWI2C_WAIT_TIMEOUT              0xF0000
-static long hwI2CWaitTXDone(void)
+static long hwI2CWaitTXDone(ddk750_context_t *pCtx)
 {
     unsigned long timeout;
 
@@ -217,6 +227,7 @@ static long hwI2CWaitTXDone(void)
  *      Total number of bytes those are actually written.
  */
 static unsigned long hwI2CWriteData(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress,
     unsigned long length,
     unsigned char *pBuffer
@@ -252,7 +263,7 @@ static unsigned long hwI2CWriteData(
         pokeRegisterByte(I2C_CTRL, FIELD_SET(peekRegisterByte(I2C_CTRL), I2C_CTRL, CTRL, START));
         
         /* Wait until the transfer is completed. */
-        if (hwI2CWaitTXDone() != 0)
+        if (hwI2CWaitTXDone(pCtx) != 0)
             break;
     
         /* Substract length */
@@ -281,6 +292,7 @@ static unsigned long hwI2CWriteData(
  *      Total number of actual bytes read from the slave device
  */
 static unsigned long hwI2CReadData(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress,
     unsigned long length,
     unsigned char *pBuffer
@@ -312,7 +324,7 @@ static unsigned long hwI2CReadData(
         pokeRegisterByte(I2C_CTRL, FIELD_SET(peekRegisterByte(I2C_CTRL), I2C_CTRL, CTRL, START));
         
         /* Wait until transaction done. */
-        if (hwI2CWaitTXDone() != 0)
+        if (hwI2CWaitTXDone(pCtx) != 0)
             break;
 
         /* Save the data to the given buffer */
@@ -343,14 +355,15 @@ static unsigned long hwI2CReadData(
  *      Register value
  */
 unsigned char ddk750_hwI2CReadReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 )
 {
     unsigned char value = (0xFF);
 
-    if (hwI2CWriteData(deviceAddress, 1, &registerIndex) == 1)
-        hwI2CReadData(deviceAddress, 1, &value);
+    if (hwI2CWriteData(pCtx, deviceAddress, 1, &registerIndex) == 1)
+        hwI2CReadData(pCtx, deviceAddress, 1, &value);
 
     return value;
 }
@@ -369,6 +382,7 @@ unsigned char ddk750_hwI2CReadReg(
  *         -1   - Fail
  */
 long ddk750_hwI2CWriteReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
@@ -378,7 +392,7 @@ long ddk750_hwI2CWriteReg(
     
     value[0] = registerIndex;
     value[1] = data;
-    if (hwI2CWriteData(deviceAddress, 2, value) == 2)
+    if (hwI2CWriteData(pCtx, deviceAddress, 2, value) == 2)
         return 0;
 
     return (-1);
@@ -1,6 +1,8 @@
 #ifndef _HWI2C_H_
 #define _HWI2C_H_
 
+#include "ddk750_help.h"
+
 #include "../smi_drv.h"
 
 
@@ -17,13 +19,14 @@
  *      -1   - Fail to initialize i2c
  */
 long ddk750_hwI2CInit(
+    ddk750_context_t *pCtx,
     unsigned char busSpeedMode
 );
 
 /* 
  * This function close the hardware i2c 
  */
-void ddk750_hwI2CClose(void);
+void ddk750_hwI2CClose(ddk750_context_t *pCtx);
 
 /* 
  * This function read the i2c device register value
@@ -35,6 +38,7 @@ void ddk750_hwI2CClose(void);
  *          The value of the register being read.
  */
 unsigned char ddk750_hwI2CReadReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 );
@@ -51,14 +55,15 @@ unsigned char ddk750_hwI2CReadReg(
  *         -1   - Fail
  */
 long ddk750_hwI2CWriteReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
 );
 
 
-long ddk750_AdaptHWI2CInit(struct smi_connector *connector);
-long ddk750_AdaptHWI2CCleanBus(struct smi_connector *connector);
+long ddk750_AdaptHWI2CInit(ddk750_context_t *pCtx, struct smi_connector *connector);
+long ddk750_AdaptHWI2CCleanBus(ddk750_context_t *pCtx, struct smi_connector *connector);
 
 
 
@@ -6,7 +6,7 @@
 #include "ddk750_helper.h"
 #include "ddk750_power.h"
 #include "ddk750_mode.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 
 //#include "ddk750_os.h"
 
@@ -247,10 +247,6 @@ static mode_parameter_t gSecondaryModeParamTable[MAX_SMI_DEVICE][MAX_MODE_TABLE_
 };
 #endif
 
-/* Static variable to store the mode information. */
-static mode_parameter_t gPrimaryCurrentModeParam[MAX_SMI_DEVICE];
-static mode_parameter_t gSecondaryCurrentModeParam[MAX_SMI_DEVICE];
-
 /*
  *  getUserDataSignature
  *      This function gets the user data mode signature
@@ -451,13 +447,34 @@ unsigned long getStockModeParamTableSizeEx(
  * This function returns the current mode.
  */
 mode_parameter_t getCurrentModeParam(
+    ddk750_context_t *pCtx,
     disp_control_t dispCtrl
 )
 {
     if (dispCtrl == PRIMARY_CTRL)
-        return gPrimaryCurrentModeParam[getCurrentDevice()];
+        return pCtx->primaryCurrentModeParam;
     else
-        return gSecondaryCurrentModeParam[getCurrentDevice()];
+        return pCtx->secondaryCurrentModeParam;
+}
+
+/*
+ * Return in Hz the pixel clock last asked for on a controller and what the
+ * PLL makes of it. Returns -1 if no mode was set on the controller yet.
+ */
+long ddk750_getPixelClock(
+    ddk750_context_t *pCtx,
+    int dispCtrl,
+    unsigned long *pRequested,
+    unsigned long *pActual
+)
+{
+    if (dispCtrl < PRIMARY_CTRL || dispCtrl > SECONDARY_CTRL ||
+        pCtx->requestedPixelClock[dispCtrl] == 0)
+        return -1;
+
+    *pRequested = pCtx->requestedPixelClock[dispCtrl];
+    *pActual = pCtx->actualPixelClock[dispCtrl];
+    return 0;
 }
 
 /*
@@ -567,6 +584,7 @@ unsigned long ulPClk         /* real pixel clock feasible by SM750 */
  *     -1   - Display is not pending
  */
 long isCurrentDisplayPending(
+    ddk750_context_t *pCtx,
     disp_control_t dispControl
 )
 {
@@ -593,6 +611,7 @@ long isCurrentDisplayPending(
  *		ulBaseAddress	- Base Address value to be set.
  */
 void setDisplayBaseAddress(
+	ddk750_context_t *pCtx,
 	disp_control_t dispControl,
 	unsigned long ulBaseAddress
 )
@@ -620,6 +639,7 @@ void setDisplayBaseAddress(
  * Program the hardware for a specific video mode
  */
 void programModeRegisters(
+ddk750_context_t *pCtx,
 mode_parameter_t *pModeParam,   /* mode information about pixel clock, horizontal total, etc. */
 unsigned long ulBpp,            /* Color depth for this mode */
 unsigned long ulBaseAddress,    /* Offset in frame buffer */
@@ -635,7 +655,7 @@ pll_value_t *pPLL               /* Pre-calculated values for the PLL */
     /* Enable display power gate */
     ulTmpValue = peekRegisterDWord(CURRENT_GATE);
     ulTmpValue = FIELD_SET(ulTmpValue, CURRENT_GATE, DISPLAY, ON);
-    setCurrentGate(ulTmpValue);
+    setCurrentGate(pCtx, ulTmpValue);
 
     if (pPLL->clockType == SECONDARY_PLL)
     {
@@ -707,7 +727,7 @@ pll_value_t *pPLL               /* Pre-calculated values for the PLL */
         palette_ram = SECONDARY_PALETTE_RAM;
         
         /* Save the current mode param */
-        gSecondaryCurrentModeParam[getCurrentDevice()] = *pModeParam;
+        pCtx->secondaryCurrentModeParam = *pModeParam;
     }
     else 
     {
@@ -820,7 +840,7 @@ pll_value_t *pPLL               /* Pre-calculated values for the PLL */
         palette_ram = PRIMARY_PALETTE_RAM;
         
         /* Save the current mode param */
-        gPrimaryCurrentModeParam[getCurrentDevice()] = *pModeParam;
+        pCtx->primaryCurrentModeParam = *pModeParam;
     }
 
     /* In case of 8-bpp, fill palette */
@@ -920,6 +940,7 @@ clock_type_t getClockType(disp_control_t dispCtrl)
  *         -1 if any set mode error.
  */
 long setCustomMode(
+	ddk750_context_t *pCtx,
 	logicalMode_t *pLogicalMode, 
 	mode_parameter_t *pUserModeParam
 )
@@ -932,7 +953,7 @@ long setCustomMode(
      * Minimum check on mode base address.
      * At least it shouldn't be bigger than the size of frame buffer.
      */
-    if (ddk750_getFrameBufSize() <= pLogicalMode->baseAddress)
+    if (ddk750_getFrameBufSize(pCtx) <= pLogicalMode->baseAddress)
     	{printk("in func [%s], line[%d], return error\n", __func__, __LINE__);
         return -1;
     	}
@@ -951,6 +972,8 @@ long setCustomMode(
      * Return value from calcPllValue() gives the actual possible pixel clock.
      */
     ulActualPixelClk = calcPllValue(pUserModeParam->pixel_clock, &pll);
+    pCtx->requestedPixelClock[pLogicalMode->dispCtrl] = pUserModeParam->pixel_clock;
+    pCtx->actualPixelClock[pLogicalMode->dispCtrl] = ulActualPixelClk;
     //DDKDEBUGPRINT((DISPLAY_LEVEL, "Actual Pixel Clock: %d\n", ulActualPixelClk));
 
     /* 
@@ -985,7 +1008,7 @@ long setCustomMode(
 	//printk("func[%s], ulPitch=[%d]\n", __func__, pLogicalMode->pitch);
 
     /* Program the hardware to set up the mode. */
-    programModeRegisters( 
+    programModeRegisters(pCtx,  
         &pModeParam,
         pLogicalMode->bpp, 
         pLogicalMode->baseAddress, 
@@ -1010,6 +1033,7 @@ long setCustomMode(
  *         -1 if any set mode error.
  */
 long setCustomModeEx(
+	ddk750_context_t *pCtx,
 	logicalMode_t *pLogicalMode, 
 	mode_parameter_t *pUserModeParam
 )
@@ -1043,7 +1067,7 @@ long setCustomModeEx(
     	}
     
     /* Set the mode first */
-    returnValue = setCustomMode(pLogicalMode, pUserModeParam);
+    returnValue = setCustomMode(pCtx, pLogicalMode, pUserModeParam);
 
     
     return (returnValue);
@@ -1063,6 +1087,7 @@ long setCustomModeEx(
  *         -1 if any set mode error.
  */
 long setModeEx(
+	ddk750_context_t *pCtx,
 	logicalMode_t *pLogicalMode
 )
 {
@@ -1119,7 +1144,7 @@ long setModeEx(
         return -1;
     	}
 
-    return(setCustomModeEx(pLogicalMode, pModeParam));
+    return(setCustomModeEx(pCtx, pLogicalMode, pModeParam));
 }
 
 /*
@@ -1133,6 +1158,7 @@ long setModeEx(
  *         -1 if any set mode error.
  */
 long setMode(
+	ddk750_context_t *pCtx,
 	logicalMode_t *pLogicalMode
 )
 {
@@ -1142,7 +1168,7 @@ long setMode(
     pLogicalMode->userData = (void *)0;
 
     /* Call the setModeEx to set the mode. */
-    return setModeEx(pLogicalMode);
+    return setModeEx(pCtx, pLogicalMode);
 }
 
 /*
@@ -1156,6 +1182,7 @@ long setMode(
  *      enableVertInterpolation - Flag to enable/disable Vertical interpolation
  */
 void setInterpolation(
+    ddk750_context_t *pCtx,
     unsigned long enableHorzInterpolation,
     unsigned long enableVertInterpolation
 )
@@ -1,6 +1,8 @@
 #ifndef _MODE_H_
 #define _MODE_H_
 
+#include "ddk750_help.h"
+
 /* Maximum parameters those can be saved in the mode table. */
 #define MAX_MODE_TABLE_ENTRIES              60
 
@@ -264,9 +266,21 @@ unsigned long getStockModeParamTableSizeEx(
  * This function returns the current mode.
  */
 mode_parameter_t getCurrentModeParam(
+    ddk750_context_t *pCtx,
     disp_control_t dispCtrl
 );
 
+/*
+ * This function returns the pixel clock requested for a controller and the
+ * one the PLL actually produces, in Hz.
+ */
+long ddk750_getPixelClock(
+    ddk750_context_t *pCtx,
+    int dispCtrl,
+    unsigned long *pRequested,
+    unsigned long *pActual
+);
+
 /*
  *  getMaximumModeEntries
  *      This function gets the maximum entries that can be stored in the mode table.
@@ -291,6 +305,7 @@ unsigned long getMaximumModeEntries(void);
  *         -1 if any set mode error.
  */
 long setCustomMode(
+    ddk750_context_t *pCtx,
     logicalMode_t *pLogicalMode, 
     mode_parameter_t *pUserModeParam
 );
@@ -310,6 +325,7 @@ long setCustomMode(
  *         -1 if any set mode error.
  */
 long setCustomModeEx(
+    ddk750_context_t *pCtx,
     logicalMode_t *pLogicalMode, 
     mode_parameter_t *pUserModeParam
 );
@@ -325,6 +341,7 @@ long setCustomModeEx(
  *         -1 if any set mode error.
  */
 long setMode(
+    ddk750_context_t *pCtx,
     logicalMode_t *pLogicalMode
 );
 
@@ -341,6 +358,7 @@ long setMode(
  *         -1 if any set mode error.
  */
 long setModeEx(
+    ddk750_context_t *pCtx,
     logicalMode_t *pLogicalMode
 );
 
@@ -356,6 +374,7 @@ long setModeEx(
  *      enableVertInterpolation - Flag to enable/disable Vertical interpolation
  */
 void setInterpolation(
+    ddk750_context_t *pCtx,
     unsigned long enableHorzInterpolation,
     unsigned long enableVertInterpolation
 );
@@ -533,6 +552,7 @@ long isEdidPreferredTiming(
  *		ulBaseAddress	- Base Address value to be set.
  */
 void setDisplayBaseAddress(
+	ddk750_context_t *pCtx,
 	disp_control_t dispControl,
 	unsigned long ulBaseAddress
 );
@@ -548,6 +568,7 @@ void setDisplayBaseAddress(
  *     -1   - Display is not pending
  */
 long isCurrentDisplayPending(
+    ddk750_context_t *pCtx,
     disp_control_t dispControl
 );
 
@@ -3,17 +3,12 @@
 #include "ddk750_clock.h"
 #include "ddk750_hardware.h"
 #include "ddk750_power.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 
 //#include "ddkdebug.h"
 
-/* Semaphore Counter for Bus Master Enable Bit */
-unsigned long g_ulBusMasterSemaphoreCounter[MAX_SMI_DEVICE] = { 0, 0, 0, 0};
-unsigned long g_ulPCISlaveBurstWriteSemaphoreCounter[MAX_SMI_DEVICE] = { 0, 0, 0, 0};
-unsigned long g_ulPCISlaveBurstReadSemaphoreCounter[MAX_SMI_DEVICE] = { 0, 0, 0, 0};
-
 /* Set DPMS state */
-void setDPMS(DPMS_t state)
+void setDPMS(ddk750_context_t *pCtx, DPMS_t state)
 {
     unsigned long value;
 
@@ -71,7 +66,7 @@ void setDPMS(DPMS_t state)
  * This function gets the power mode, one of three modes: 0, 1 or Sleep.
  * On hardware reset, power mode 0 is default.
  */
-unsigned long getPowerMode()
+unsigned long getPowerMode(ddk750_context_t *pCtx)
 {
 
     return (FIELD_VAL_GET(peekRegisterDWord(POWER_MODE_CTRL), POWER_MODE_CTRL, MODE));
@@ -81,7 +76,7 @@ unsigned long getPowerMode()
  * SM750/SM718 can operate in one of three modes: 0, 1 or Sleep.
  * On hardware reset, power mode 0 is default.
  */
-void setPowerMode(unsigned long powerMode)
+void setPowerMode(ddk750_context_t *pCtx, unsigned long powerMode)
 {
     unsigned long control_value = 0, previousPowerState;
 
@@ -129,20 +124,20 @@ void setPowerMode(unsigned long powerMode)
         /* Switching power mode between power mode 0 and 1 */
         
         /* Need a minimum of 16ms between power mode switching */
-        waitMasterClock(16);
+        waitMasterClock(pCtx, 16);
         
         /* Reset Memory. */
-        ddk750_resetFrameBufferMemory();
+        ddk750_resetFrameBufferMemory(pCtx);
     }
 }
 
-void setCurrentGate(unsigned long gate)
+void setCurrentGate(ddk750_context_t *pCtx, unsigned long gate)
 {
     unsigned long gate_reg;
     unsigned long mode;
 
     /* Get current power mode. */
-    mode = getPowerMode();
+    mode = getPowerMode(pCtx);
 
     switch (mode)
     {
@@ -164,12 +159,12 @@ void setCurrentGate(unsigned long gate)
 /*
  * This function enable/disable Bus Master
  */
-void enableBusMaster(unsigned long enable)
+void enableBusMaster(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long busMasterCounter, value;
 
     /* Enable Bus Master as necessary.*/
-	busMasterCounter = g_ulBusMasterSemaphoreCounter[getCurrentDevice()];
+	busMasterCounter = pCtx->busMasterSemaphoreCounter;
 	value = peekRegisterDWord(SYSTEM_CTRL);
 
     /* Currently, only SM718 needs to enable the Bus Master enable bit. 
@@ -190,7 +185,7 @@ void enableBusMaster(unsigned long enable)
             pokeRegisterDWord(SYSTEM_CTRL, FIELD_SET(peekRegisterDWord(SYSTEM_CTRL), SYSTEM_CTRL, PCI_MASTER, OFF));
     }
 
-    g_ulBusMasterSemaphoreCounter[getCurrentDevice()] = busMasterCounter;
+    pCtx->busMasterSemaphoreCounter = busMasterCounter;
 }
 
 /* 
@@ -205,6 +200,7 @@ void enableBusMaster(unsigned long enable)
  *		The memory address to be set in the register.  
  */
 unsigned long setPCIMasterBaseAddress(
+	ddk750_context_t *pCtx,
 	unsigned long physicalSystemMemAddress
 )
 {
@@ -247,13 +243,14 @@ unsigned long setPCIMasterBaseAddress(
  *			enable		- Enable/Disable the PCI Slave Burst Write (0 = disable, 1 = enable)
  */
 void enablePCISlaveBurstWrite(
+	ddk750_context_t *pCtx,
 	unsigned long enable
 )
 {
 	unsigned long pciSlaveBurstWriteCounter, value;
 
     /* Enable PCI Slave Burst Write */
-	pciSlaveBurstWriteCounter = g_ulPCISlaveBurstWriteSemaphoreCounter[getCurrentDevice()];
+	pciSlaveBurstWriteCounter = pCtx->pciSlaveBurstWriteSemaphoreCounter;
 	value = peekRegisterDWord(SYSTEM_CTRL);
 
     if (enable != 0)
@@ -280,7 +277,7 @@ void enablePCISlaveBurstWrite(
 		}
     }
 
-	g_ulPCISlaveBurstWriteSemaphoreCounter[getCurrentDevice()] = pciSlaveBurstWriteCounter;
+	pCtx->pciSlaveBurstWriteSemaphoreCounter = pciSlaveBurstWriteCounter;
 }
 
 /*
@@ -291,6 +288,7 @@ void enablePCISlaveBurstWrite(
  *			burstReadSize	- Burst Read Size in 32-words (valid values are 1, 2, 4, and 8)
  */
 void enablePCISlaveBurstRead(
+	ddk750_context_t *pCtx,
 	unsigned long enable,
 	unsigned long burstReadSize
 )
@@ -299,7 +297,7 @@ void enablePCISlaveBurstRead(
 
     /* Currently, only SM718 needs to enable the Bus Master enable bit. 
        The Bus Master in SM750 is enabled by default, without programming any bits. */
-	pciSlaveBurstReadCounter = g_ulPCISlaveBurstReadSemaphoreCounter[getCurrentDevice()];
+	pciSlaveBurstReadCounter = pCtx->pciSlaveBurstReadSemaphoreCounter;
 	value = peekRegisterDWord(SYSTEM_CTRL);
 
     if (enable != 0)
@@ -346,13 +344,13 @@ void enablePCISlaveBurstRead(
 		}
     }
 
-	g_ulPCISlaveBurstReadSemaphoreCounter[getCurrentDevice()] = pciSlaveBurstReadCounter;
+	pCtx->pciSlaveBurstReadSemaphoreCounter = pciSlaveBurstReadCounter;
 }
 
 /* 
  * This function enable/disable the 2D engine.
  */
-void enable2DEngine(unsigned long enable)
+void enable2DEngine(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
 
@@ -368,13 +366,13 @@ void enable2DEngine(unsigned long enable)
         gate = FIELD_SET(gate, CURRENT_GATE, CSC, OFF);
     }
 
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the ZV Port.
  */
-void enableZVPort(unsigned long enable)
+void enableZVPort(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -395,13 +393,13 @@ void enableZVPort(unsigned long enable)
         gate = FIELD_SET(gate, CURRENT_GATE, ZVPORT, OFF);
     }
     
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the SSP.
  */
-void enableSSP(unsigned long enable)
+void enableSSP(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -412,13 +410,13 @@ void enableSSP(unsigned long enable)
     else
         gate = FIELD_SET(gate, CURRENT_GATE, SSP, OFF);
     
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the DMA Engine
  */
-void enableDMA(unsigned long enable)
+void enableDMA(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -429,13 +427,13 @@ void enableDMA(unsigned long enable)
     else
         gate = FIELD_SET(gate, CURRENT_GATE, DMA, OFF);
 
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the GPIO Engine
  */
-void enableGPIO(unsigned long enable)
+void enableGPIO(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -446,13 +444,13 @@ void enableGPIO(unsigned long enable)
     else
         gate = FIELD_SET(gate, CURRENT_GATE, GPIO, OFF);
     
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the PWM Engine
  */
-void enablePWM(unsigned long enable)
+void enablePWM(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -463,13 +461,13 @@ void enablePWM(unsigned long enable)
     else
         gate = FIELD_SET(gate, CURRENT_GATE, PWM, OFF);
     
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
 
 /* 
  * This function enable/disable the I2C Engine
  */
-void enableI2C(unsigned long enable)
+void enableI2C(ddk750_context_t *pCtx, unsigned long enable)
 {
     unsigned long gate;
     
@@ -480,5 +478,5 @@ void enableI2C(unsigned long enable)
     else
         gate = FIELD_SET(gate, CURRENT_GATE, I2C, OFF);
     
-    setCurrentGate(gate);
+    setCurrentGate(pCtx, gate);
 }
@@ -1,6 +1,8 @@
 #ifndef _POWER_H_
 #define _POWER_H_
 
+#include "ddk750_help.h"
+
 typedef enum _DPMS_t
 {
     DPMS_ON,
@@ -13,27 +15,27 @@ DPMS_t;
 /*
  * This function sets the DPMS state 
  */
-void setDPMS(DPMS_t state);
+void setDPMS(ddk750_context_t *pCtx, DPMS_t state);
 
 /* 
  * This function gets the current power mode 
  */
-unsigned long getPowerMode(void);
+unsigned long getPowerMode(ddk750_context_t *pCtx);
 
 /* 
  * This function sets the current power mode
  */
-void setPowerMode(unsigned long powerMode);
+void setPowerMode(ddk750_context_t *pCtx, unsigned long powerMode);
 
 /* 
  * This function sets current gate 
  */
-void setCurrentGate(unsigned long gate);
+void setCurrentGate(ddk750_context_t *pCtx, unsigned long gate);
 
 /*
  * This function enable/disable Bus Master
  */
-void enableBusMaster(unsigned long enable);
+void enableBusMaster(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  *	setPCIMasterBaseAddress
@@ -47,6 +49,7 @@ void enableBusMaster(unsigned long enable);
  *		The memory address to be set in the register.  
  */
 unsigned long setPCIMasterBaseAddress(
+	ddk750_context_t *pCtx,
 	unsigned long physicalSystemMemAddress
 );
 
@@ -57,6 +60,7 @@ unsigned long setPCIMasterBaseAddress(
  *			enable		- Enable/Disable the PCI Slave Burst Write (0 = disable, 1 = enable)
  */
 void enablePCISlaveBurstWrite(
+	ddk750_context_t *pCtx,
 	unsigned long enable
 );
 
@@ -68,6 +72,7 @@ void enablePCISlaveBurstWrite(
  *			burstReadSize	- Burst Read Size in 32-words (valid values are 1, 2, 4, and 8)
  */
 void enablePCISlaveBurstRead(
+	ddk750_context_t *pCtx,
 	unsigned long enable,
 	unsigned long burstReadSize
 );
@@ -75,36 +80,36 @@ void enablePCISlaveBurstRead(
 /* 
  * This function enable/disable the 2D engine.
  */
-void enable2DEngine(unsigned long enable);
+void enable2DEngine(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the ZV Port 
  */
-void enableZVPort(unsigned long enable);
+void enableZVPort(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the DMA Engine
  */
-void enableDMA(unsigned long enable);
+void enableDMA(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the GPIO Engine
  */
-void enableGPIO(unsigned long enable);
+void enableGPIO(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the PWM Engine
  */
-void enablePWM(unsigned long enable);
+void enablePWM(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the I2C Engine
  */
-void enableI2C(unsigned long enable);
+void enableI2C(ddk750_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the SSP.
  */
-void enableSSP(unsigned long enable);
+void enableSSP(ddk750_context_t *pCtx, unsigned long enable);
 
 #endif /* _POWER_H_ */
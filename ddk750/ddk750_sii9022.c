@@ -14,9 +14,6 @@
 
 #define SII9022_DEVICE_ID					0xb0
 
-#define i2cWriteReg swI2CWriteReg
-#define i2cReadReg  swI2CReadReg
-
 
 
 unsigned char sii9022xIsConnected(void)	
@@ -30,11 +27,12 @@ __attribute__((unused)) static void dump9022a(uint8_t reg)
 	printk("reg%x=%x\n",reg,i2cReadReg(SII9022A_I2C_ADDRESS,reg));
 #endif
 }
-int sii9022xSetMode(int num)
+int sii9022xSetMode(ddk750_context_t *pCtx, int num)
 {
 	int ret;
 
-	swI2CInit(DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
+	siHdmiTx.pCtx = pCtx;
+	swI2CInit(pCtx, DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
 	siHdmiTx_VideoSel(num);
 	siHdmiTx_AudioSel(0x02);
 	siHdmiTx_TPI_Init();
@@ -43,11 +41,12 @@ int sii9022xSetMode(int num)
 	return ret;
 }
 
-int sii9022xInitChip(void)
+int sii9022xInitChip(ddk750_context_t *pCtx)
 {
 	int  rcc,retries = 10;
     
-	swI2CInit(DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
+	siHdmiTx.pCtx = pCtx;
+	swI2CInit(pCtx, DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
 	
 	/* enter TPI mode */
     	i2cWriteReg(SII9022A_I2C_ADDRESS,0xc7,0);
@@ -65,10 +64,11 @@ int sii9022xInitChip(void)
 
 byte SysCtrlReg;
 
-int ddk750_GetDDC_9022Access(void)
+int ddk750_GetDDC_9022Access(ddk750_context_t *pCtx)
 {
 	int ret = 0;
-	swI2CInit(DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
+	siHdmiTx.pCtx = pCtx;
+	swI2CInit(pCtx, DEFAULT_I2C_SCL, DEFAULT_I2C_SDA);
 	ret = GetDDC_Access(&SysCtrlReg);
 	return ret;	
 }
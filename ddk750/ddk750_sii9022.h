@@ -1,7 +1,8 @@
-int sii9022xInitChip(void);
-int sii9022xSetMode(int);
+#include "ddk750_help.h"
+int sii9022xInitChip(ddk750_context_t *pCtx);
+int sii9022xSetMode(ddk750_context_t *pCtx, int);
 unsigned char sii9022xIsConnected(void);
-int ddk750_GetDDC_9022Access(void);
+int ddk750_GetDDC_9022Access(ddk750_context_t *pCtx);
 int ddk750_Release9022DDC(void);
 void ddk750_DoEdidRead(void);
 
@@ -3,7 +3,7 @@
 #include "ddk750_defs.h"
 #include "ddk750_hardware.h"
 #include "ddk750_power.h"
-#include "ddk750_help.h"
+#include "ddk750_context.h"
 #include "ddk750_swi2c.h"
 
 
@@ -45,31 +45,6 @@
  *                                  
  ******************************************************************/
 
-/* GPIO pins used for this I2C. It ranges from 0 to 63. */
-static unsigned char g_i2cClockGPIO = DEFAULT_I2C_SCL;
-static unsigned char g_i2cDataGPIO = DEFAULT_I2C_SDA;
-
-/*
- *  Below is the variable declaration for the GPIO pin register usage
- *  for the i2c Clock and i2c Data.
- *
- *  Note:
- *      Notice that the GPIO usage for the i2c clock and i2c Data are
- *      separated. This is to make this code flexible enough when 
- *      two separate GPIO pins for the clock and data are located
- *      in two different GPIO register set (worst case).
- */
-
-/* i2c Clock GPIO Register usage */
-static unsigned long g_i2cClkGPIOMuxReg = GPIO_MUX;
-static unsigned long g_i2cClkGPIODataReg = GPIO_DATA;
-static unsigned long g_i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
-
-/* i2c Data GPIO Register usage */
-static unsigned long g_i2cDataGPIOMuxReg = GPIO_MUX;
-static unsigned long g_i2cDataGPIODataReg = GPIO_DATA;
-static unsigned long g_i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
-
 /*
  *  This function puts a delay between command
  */        
@@ -96,29 +71,32 @@ static void swI2CWait(void)
  *      signal because the i2c will fail when other device try to drive the
  *      signal due to SM50x will drive the signal to always high.
  */ 
-void swI2CSCL(unsigned char value)
+void swI2CSCL(ddk750_context_t *pCtx, unsigned char value)
 {
     unsigned long ulGPIOData;
     unsigned long ulGPIODirection;
+    unsigned long flags;
 
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cClkGPIODataDirReg);
     if (value)      /* High */
     {
         /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << g_i2cClockGPIO);	
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        ulGPIODirection &= ~(1 << pCtx->i2cClockGPIO);	
+        pokeRegisterDWord(pCtx->i2cClkGPIODataDirReg, ulGPIODirection);
     }
     else            /* Low */
     {
         /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
-        ulGPIOData &= ~(1 << g_i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataReg, ulGPIOData);
+        ulGPIOData = peekRegisterDWord(pCtx->i2cClkGPIODataReg);
+        ulGPIOData &= ~(1 << pCtx->i2cClockGPIO);
+        pokeRegisterDWord(pCtx->i2cClkGPIODataReg, ulGPIOData);
 
         /* Set direction as output */
-        ulGPIODirection |= (1 << g_i2cClockGPIO);		
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        ulGPIODirection |= (1 << pCtx->i2cClockGPIO);		
+        pokeRegisterDWord(pCtx->i2cClkGPIODataDirReg, ulGPIODirection);
     }
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 }
 
 /*
@@ -133,29 +111,32 @@ void swI2CSCL(unsigned char value)
  *      signal because the i2c will fail when other device try to drive the
  *      signal due to SM50x will drive the signal to always high.
  */
-void swI2CSDA(unsigned char value)
+void swI2CSDA(ddk750_context_t *pCtx, unsigned char value)
 {
     unsigned long ulGPIOData;
     unsigned long ulGPIODirection;
+    unsigned long flags;
 
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cDataGPIODataDirReg);
     if (value)      /* High */
     {
         /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << g_i2cDataGPIO);	
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        ulGPIODirection &= ~(1 << pCtx->i2cDataGPIO);	
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
     else            /* Low */
     {
         /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
-        ulGPIOData &= ~(1 << g_i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataReg, ulGPIOData);
+        ulGPIOData = peekRegisterDWord(pCtx->i2cDataGPIODataReg);
+        ulGPIOData &= ~(1 << pCtx->i2cDataGPIO);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataReg, ulGPIOData);
 
         /* Set direction as output */
-        ulGPIODirection |= (1 << g_i2cDataGPIO);		
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        ulGPIODirection |= (1 << pCtx->i2cDataGPIO);		
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 }
 
 /*
@@ -164,22 +145,26 @@ void swI2CSDA(unsigned char value)
  *  Return Value:
  *      The SDA data bit sent by the Slave
  */
-static unsigned char swI2CReadSDA(void)
+static unsigned char swI2CReadSDA(ddk750_context_t *pCtx)
 {
     unsigned long ulGPIODirection;
     unsigned long ulGPIOData;
+    unsigned long flags;
 
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
     /* Make sure that the direction is input (High) */
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
-    if ((ulGPIODirection & (1 << g_i2cDataGPIO)) != (~(1 << g_i2cDataGPIO)))
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cDataGPIODataDirReg);
+    if ((ulGPIODirection & (1 << pCtx->i2cDataGPIO)) != (~(1 << pCtx->i2cDataGPIO)))
     {
-        ulGPIODirection &= ~(1 << g_i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        ulGPIODirection &= ~(1 << pCtx->i2cDataGPIO);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
 
     /* Now read the SDA line */
-    ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
-    if (ulGPIOData & (1 << g_i2cDataGPIO)) 
+    ulGPIOData = peekRegisterDWord(pCtx->i2cDataGPIODataReg);
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
+
+    if (ulGPIOData & (1 << pCtx->i2cDataGPIO)) 
         return 1;
     else 
         return 0;
@@ -191,28 +176,28 @@ static unsigned char swI2CReadSDA(void)
 /*
  *  This function sends ACK signal
  */
-static void swI2CAck(unsigned char ack)
+static void swI2CAck(ddk750_context_t *pCtx, unsigned char ack)
 {
 	if(ack)
     {
-        swI2CSCL(0);
-        swI2CSDA(0);
+        swI2CSCL(pCtx, 0);
+        swI2CSDA(pCtx, 0);
         swI2CWait();
-        swI2CSCL(1);
+        swI2CSCL(pCtx, 1);
         swI2CWait();
-        swI2CSCL(0);
-        swI2CSDA(0);
+        swI2CSCL(pCtx, 0);
+        swI2CSDA(pCtx, 0);
         swI2CWait();
     }
     else
     {
-        swI2CSCL(0);
-        swI2CSDA(1);
+        swI2CSCL(pCtx, 0);
+        swI2CSDA(pCtx, 1);
         swI2CWait();
-        swI2CSCL(1);
+        swI2CSCL(pCtx, 1);
         swI2CWait();
-        swI2CSCL(0);
-        swI2CSDA(0);
+        swI2CSCL(pCtx, 0);
+        swI2CSDA(pCtx, 0);
         swI2CWait();
     }
     return;  /* Single byte read is ok without it. */
@@ -221,23 +206,23 @@ static void swI2CAck(unsigned char ack)
 /*
  *  This function sends the start command to the slave device
  */
-void swI2CStart(void)
+void swI2CStart(ddk750_context_t *pCtx)
 {
     /* Start I2C */
-    swI2CSDA(1);
-    swI2CSCL(1);
-    swI2CSDA(0);
+    swI2CSDA(pCtx, 1);
+    swI2CSCL(pCtx, 1);
+    swI2CSDA(pCtx, 0);
 }
 
 /*
  *  This function sends the stop command to the slave device
  */
-void swI2CStop(void)
+void swI2CStop(ddk750_context_t *pCtx)
 {
     /* Stop the I2C */
-    swI2CSCL(1);
-    swI2CSDA(0);
-    swI2CSDA(1);
+    swI2CSCL(pCtx, 1);
+    swI2CSDA(pCtx, 0);
+    swI2CSDA(pCtx, 1);
 }
 
 /*
@@ -250,7 +235,7 @@ void swI2CStop(void)
  *       0   - Success
  *      -1   - Fail to write byte
  */
-long swI2CWriteByte(unsigned char data) 
+long swI2CWriteByte(ddk750_context_t *pCtx, unsigned char data) 
 {
     unsigned char value = data;
     int i;
@@ -259,43 +244,43 @@ long swI2CWriteByte(unsigned char data)
     for (i=0; i<8; i++)
     {
         /* Set SCL to low */
-        swI2CSCL(0);
+        swI2CSCL(pCtx, 0);
 
         /* Send data bit */
         if ((value & 0x80) != 0)
-            swI2CSDA(1);
+            swI2CSDA(pCtx, 1);
         else
-            swI2CSDA(0);
+            swI2CSDA(pCtx, 0);
 
         swI2CWait();
 
         /* Toggle clk line to one */
-        swI2CSCL(1);
+        swI2CSCL(pCtx, 1);
 
         /* Shift byte to be sent */
         value = value << 1;
     }
 
     /* Set the SCL Low and SDA High (prepare to get input) */
-    swI2CSCL(0);
-    swI2CSDA(1);
+    swI2CSCL(pCtx, 0);
+    swI2CSDA(pCtx, 1);
 
     /* Set the SCL High for ack */
     swI2CWait();
-    swI2CSCL(1);
+    swI2CSCL(pCtx, 1);
 
     /* Read SDA, until SDA==0 */
     for(i=0; i<0xff; i++) 
     {
         swI2CWait();
         swI2CWait();
-        if (!swI2CReadSDA())
+        if (!swI2CReadSDA(pCtx))
             break;
     }
 
     /* Set the SCL Low and SDA High */
-    swI2CSCL(0);
-    swI2CSDA(1);
+    swI2CSCL(pCtx, 0);
+    swI2CSDA(pCtx, 1);
 
     if (i<0xff)
         return 0;
@@ -313,7 +298,7 @@ long swI2CWriteByte(unsigned char data)
  *  Return Value:
  *      One byte data read from the Slave device
  */
-unsigned char swI2CReadByte(unsigned char ack)
+unsigned char swI2CReadByte(ddk750_context_t *pCtx, unsigned char ack)
 {
     int i;
     unsigned char data = 0;
@@ -321,19 +306,19 @@ unsigned char swI2CReadByte(unsigned char ack)
     for(i=7; i>=0; i--)
     {
         /* Set the SCL to Low and SDA to High (Input) */
-        swI2CSCL(0);
-        swI2CSDA(1);
+        swI2CSCL(pCtx, 0);
+        swI2CSDA(pCtx, 1);
         swI2CWait();
 
         /* Set the SCL High */
-        swI2CSCL(1);
+        swI2CSCL(pCtx, 1);
         swI2CWait();
 
         /* Read data bits from SDA */
-        data |= (swI2CReadSDA() << i);
+        data |= (swI2CReadSDA(pCtx) << i);
     }
 
-	swI2CAck(ack);
+	swI2CAck(pCtx, ack);
 
     return data;
 }
@@ -351,10 +336,12 @@ unsigned char swI2CReadByte(unsigned char ack)
  *       0   - Success
  */
 long swI2CInit(
+    ddk750_context_t *pCtx,
     unsigned char i2cClkGPIO, 
     unsigned char i2cDataGPIO
 )
 {
+    unsigned long flags;
     int i;
     
     /* Return 0 if the GPIO pins to be used is out of range. The range is only from [0..63] */
@@ -362,33 +349,35 @@ long swI2CInit(
         return (-1);
     
     /* Initialize the GPIO pin for the i2c Clock Register */
-    g_i2cClkGPIOMuxReg = GPIO_MUX;   
-    g_i2cClkGPIODataReg = GPIO_DATA;    
-    g_i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cClkGPIOMuxReg = GPIO_MUX;   
+    pCtx->i2cClkGPIODataReg = GPIO_DATA;    
+    pCtx->i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
     
     /* Initialize the Clock GPIO Offset */
-    g_i2cClockGPIO = i2cClkGPIO;
+    pCtx->i2cClockGPIO = i2cClkGPIO;
     
     /* Initialize the GPIO pin for the i2c Data Register */
-    g_i2cDataGPIOMuxReg = GPIO_MUX;    
-    g_i2cDataGPIODataReg = GPIO_DATA;    
-    g_i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cDataGPIOMuxReg = GPIO_MUX;    
+    pCtx->i2cDataGPIODataReg = GPIO_DATA;    
+    pCtx->i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
     
     /* Initialize the Data GPIO Offset */
-    g_i2cDataGPIO = i2cDataGPIO;
+    pCtx->i2cDataGPIO = i2cDataGPIO;
 
     /* Enable the GPIO pins for the i2c Clock and Data (GPIO MUX) */
-    pokeRegisterDWord(g_i2cClkGPIOMuxReg, 
-                      peekRegisterDWord(g_i2cClkGPIOMuxReg) & ~(1 << g_i2cClockGPIO));
-    pokeRegisterDWord(g_i2cDataGPIOMuxReg, 
-                      peekRegisterDWord(g_i2cDataGPIOMuxReg) & ~(1 << g_i2cDataGPIO));
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    pokeRegisterDWord(pCtx->i2cClkGPIOMuxReg, 
+                      peekRegisterDWord(pCtx->i2cClkGPIOMuxReg) & ~(1 << pCtx->i2cClockGPIO));
+    pokeRegisterDWord(pCtx->i2cDataGPIOMuxReg, 
+                      peekRegisterDWord(pCtx->i2cDataGPIOMuxReg) & ~(1 << pCtx->i2cDataGPIO));
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 
     /* Enable GPIO power */
-    enableGPIO(1);
+    enableGPIO(pCtx, 1);
 
     /* Clear the i2c lines. */
     for(i=0; i<9; i++) 
-        swI2CStop();
+        swI2CStop(pCtx);
 
     return 0;
 }
@@ -405,6 +394,7 @@ long swI2CInit(
  *      Register value
  */
 unsigned char swI2CReadReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 )
@@ -412,21 +402,21 @@ unsigned char swI2CReadReg(
     unsigned char data;
 
     /* Send the Start signal */
-    swI2CStart();
+    swI2CStart(pCtx);
 
     /* Send the device address */
-    swI2CWriteByte(deviceAddress);                                                  
+    swI2CWriteByte(pCtx, deviceAddress);                                                  
 
     /* Send the register index */
-    swI2CWriteByte(registerIndex);               
+    swI2CWriteByte(pCtx, registerIndex);               
 
     /* Get the bus again and get the data from the device read address */
-    swI2CStart();
-    swI2CWriteByte(deviceAddress + 1);
-    data = swI2CReadByte(0);
+    swI2CStart(pCtx);
+    swI2CWriteByte(pCtx, deviceAddress + 1);
+    data = swI2CReadByte(pCtx, 0);
 
     /* Stop swI2C and release the bus */
-    swI2CStop();
+    swI2CStop(pCtx);
 
     return data;
 }
@@ -447,6 +437,7 @@ unsigned char swI2CReadReg(
 *
 */
 long swI2CReadReg_Continuous(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char start_registerIndex,
     unsigned long length,
@@ -456,23 +447,23 @@ long swI2CReadReg_Continuous(
     long ret = 128;
 	int i;
     /* Send the Start signal */
-    swI2CStart();
+    swI2CStart(pCtx);
 
     /* Send the device address */
-    ret = swI2CWriteByte(deviceAddress);  
+    ret = swI2CWriteByte(pCtx, deviceAddress);  
     /* if failed to write, there is no necessary continuing */
     if(-1 == ret)
         return 0;
     
     /* Send the register index */
-    ret = swI2CWriteByte(start_registerIndex);               
+    ret = swI2CWriteByte(pCtx, start_registerIndex);               
     /* if failed to write, there is no necessary continuing */
     if(-1 == ret)
         return 0;
 
     /* Get the bus again and get the data from the device read address */
-    swI2CStart();
-    ret = swI2CWriteByte(deviceAddress + 1);
+    swI2CStart(pCtx);
+    ret = swI2CWriteByte(pCtx, deviceAddress + 1);
     /* if failed to write, there is no necessary continuing */
     if(-1 == ret)
         return 0;
@@ -480,12 +471,12 @@ long swI2CReadReg_Continuous(
 	
     for(i = 0;i<(length-1);i++)
     {
-        dest[i] = swI2CReadByte(1);
+        dest[i] = swI2CReadByte(pCtx, 1);
     }
 
-    dest[length-1] =  swI2CReadByte(0);
+    dest[length-1] =  swI2CReadByte(pCtx, 0);
     /* Stop swI2C and release the bus */
-    swI2CStop();
+    swI2CStop(pCtx);
 
     ret = length;
 
@@ -509,6 +500,7 @@ long swI2CReadReg_Continuous(
  *         -1   - Fail
  */
 long swI2CWriteReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
@@ -517,35 +509,37 @@ long swI2CWriteReg(
     long returnValue = 0;
     
     /* Send the Start signal */
-    swI2CStart();
+    swI2CStart(pCtx);
 #ifndef USE_HDMICHIP  
     /* Send the device address and read the data. All should return success
        in order for the writing processed to be successful
      */
-    if ((swI2CWriteByte(deviceAddress) != 0) ||
-        (swI2CWriteByte(registerIndex) != 0) ||
-        (swI2CWriteByte(data) != 0))
+    if ((swI2CWriteByte(pCtx, deviceAddress) != 0) ||
+        (swI2CWriteByte(pCtx, registerIndex) != 0) ||
+        (swI2CWriteByte(pCtx, data) != 0))
     {
         returnValue = -1;
     }
 #else
 
-	swI2CWriteByte(deviceAddress);
-	swI2CWriteByte(registerIndex);
-	swI2CWriteByte(data);
+	swI2CWriteByte(pCtx, deviceAddress);
+	swI2CWriteByte(pCtx, registerIndex);
+	swI2CWriteByte(pCtx, data);
 #endif
 
     /* Stop i2c and release the bus */
-    swI2CStop();
+    swI2CStop(pCtx);
 
     return returnValue;
 }
 
 long adapterI2CInit(
+    ddk750_context_t *pCtx,
     unsigned char i2cClkGPIO, 
     unsigned char i2cDataGPIO
 )
 {
+    unsigned long flags;
     int i;
     
     /* Return 0 if the GPIO pins to be used is out of range. The range is only from [0..63] */
@@ -553,60 +547,65 @@ long adapterI2CInit(
         return (-1);
     
     /* Initialize the GPIO pin for the i2c Clock Register */
-    g_i2cClkGPIOMuxReg = GPIO_MUX;   
-    g_i2cClkGPIODataReg = GPIO_DATA;    
-    g_i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cClkGPIOMuxReg = GPIO_MUX;   
+    pCtx->i2cClkGPIODataReg = GPIO_DATA;    
+    pCtx->i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
     
     /* Initialize the Clock GPIO Offset */
 //    g_i2cClockGPIO = i2cClkGPIO;
     
     /* Initialize the GPIO pin for the i2c Data Register */
-    g_i2cDataGPIOMuxReg = GPIO_MUX;    
-    g_i2cDataGPIODataReg = GPIO_DATA;    
-    g_i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cDataGPIOMuxReg = GPIO_MUX;    
+    pCtx->i2cDataGPIODataReg = GPIO_DATA;    
+    pCtx->i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
     
     /* Initialize the Data GPIO Offset */
 //    g_i2cDataGPIO = i2cDataGPIO;
 
     /* Enable the GPIO pins for the i2c Clock and Data (GPIO MUX) */
-    pokeRegisterDWord(g_i2cClkGPIOMuxReg, 
-                      peekRegisterDWord(g_i2cClkGPIOMuxReg) & ~(1 << i2cClkGPIO));
-    pokeRegisterDWord(g_i2cDataGPIOMuxReg, 
-                      peekRegisterDWord(g_i2cDataGPIOMuxReg) & ~(1 << i2cDataGPIO));
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    pokeRegisterDWord(pCtx->i2cClkGPIOMuxReg, 
+                      peekRegisterDWord(pCtx->i2cClkGPIOMuxReg) & ~(1 << i2cClkGPIO));
+    pokeRegisterDWord(pCtx->i2cDataGPIOMuxReg, 
+                      peekRegisterDWord(pCtx->i2cDataGPIOMuxReg) & ~(1 << i2cDataGPIO));
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 
     /* Enable GPIO power */
-    enableGPIO(1);
+    enableGPIO(pCtx, 1);
 
     /* Clear the i2c lines. */
     for(i=0; i<9; i++) 
-        swI2CStop();
+        swI2CStop(pCtx);
 
     return 0;
 }
 
-static void adapterI2CSCL(unsigned char value, unsigned char i2cClockGPIO)
+static void adapterI2CSCL(ddk750_context_t *pCtx, unsigned char value, unsigned char i2cClockGPIO)
 {
     unsigned long ulGPIOData;
     unsigned long ulGPIODirection;
+    unsigned long flags;
 
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cClkGPIODataDirReg);
     if (value) /* High */
     {
         /* Set direction as input. This will automatically pull the signal up. */
         ulGPIODirection &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cClkGPIODataDirReg, ulGPIODirection);
     }
     else /* Low */
     {
         /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
+        ulGPIOData = peekRegisterDWord(pCtx->i2cClkGPIODataReg);
         ulGPIOData &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataReg, ulGPIOData);
+        pokeRegisterDWord(pCtx->i2cClkGPIODataReg, ulGPIOData);
 
         /* Set direction as output */
         ulGPIODirection |= (1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cClkGPIODataDirReg, ulGPIODirection);
     }
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 }
 
 /*
@@ -615,23 +614,27 @@ static void adapterI2CSCL(unsigned char value, unsigned char i2cClockGPIO)
  *  Return Value:
  *      The SDA data bit sent by the Slave
  */
-static unsigned char adapterI2CReadSCL(unsigned char i2cClockGPIO)
+static unsigned char adapterI2CReadSCL(ddk750_context_t *pCtx, unsigned char i2cClockGPIO)
 {
     unsigned long ulGPIODirection;
     unsigned long ulGPIOData;
+    unsigned long flags;
 
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
     /* Make sure that the direction is input (High) */
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cClkGPIODataDirReg);
     if ((ulGPIODirection & (1 << i2cClockGPIO)) != (~(1 << i2cClockGPIO)))
     {
         ulGPIODirection &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cClkGPIODataDirReg, ulGPIODirection);
     }
 
 
 
     /* Now read the SCL line */
-    ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
+    ulGPIOData = peekRegisterDWord(pCtx->i2cClkGPIODataReg);
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
+
     if (ulGPIOData & (1 << i2cClockGPIO))
     {
         return 1;
@@ -642,29 +645,32 @@ static unsigned char adapterI2CReadSCL(unsigned char i2cClockGPIO)
     }
 }
 
-static void adapterI2CSDA(unsigned char value, unsigned char i2cDataGPIO)
+static void adapterI2CSDA(ddk750_context_t *pCtx, unsigned char value, unsigned char i2cDataGPIO)
 {
     unsigned long ulGPIOData;
     unsigned long ulGPIODirection;
+    unsigned long flags;
 
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cDataGPIODataDirReg);
     if (value) /* High */
     {
         /* Set direction as input. This will automatically pull the signal up. */
         ulGPIODirection &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
     else /* Low */
     {
         /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
+        ulGPIOData = peekRegisterDWord(pCtx->i2cDataGPIODataReg);
         ulGPIOData &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataReg, ulGPIOData);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataReg, ulGPIOData);
 
         /* Set direction as output */
         ulGPIODirection |= (1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
 }
 
 /*
@@ -673,21 +679,25 @@ static void adapterI2CSDA(unsigned char value, unsigned char i2cDataGPIO)
  *  Return Value:
  *      The SDA data bit sent by the Slave
  */
-static unsigned char adapterI2CReadSDA(unsigned char i2cDataGPIO)
+static unsigned char adapterI2CReadSDA(ddk750_context_t *pCtx, unsigned char i2cDataGPIO)
 {
     unsigned long ulGPIODirection;
     unsigned long ulGPIOData;
+    unsigned long flags;
 
+    lockRegisterBlock(DDK750_LOCK_GPIO, flags);
     /* Make sure that the direction is input (High) */
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
+    ulGPIODirection = peekRegisterDWord(pCtx->i2cDataGPIODataDirReg);
     if ((ulGPIODirection & (1 << i2cDataGPIO)) != (~(1 << i2cDataGPIO)))
     {
         ulGPIODirection &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
+        pokeRegisterDWord(pCtx->i2cDataGPIODataDirReg, ulGPIODirection);
     }
 
     /* Now read the SDA line */
-    ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
+    ulGPIOData = peekRegisterDWord(pCtx->i2cDataGPIODataReg);
+    unlockRegisterBlock(DDK750_LOCK_GPIO, flags);
+
     if (ulGPIOData & (1 << i2cDataGPIO))
     {
         return 1;
@@ -701,14 +711,18 @@ static unsigned char adapterI2CReadSDA(unsigned char i2cDataGPIO)
 static void smi_ddc_setsda(void *data, int state)
 {
     struct smi_connector *connector = data;
-    adapterI2CSDA(state, connector->i2c_sda);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk750_context_t *pCtx = sdev->ddk750_ctx;
+    adapterI2CSDA(pCtx, state, connector->i2c_sda);
     /* smi_set_i2c_signal(data, I2C_SDA_MASK, state); */
 }
 
 static void smi_ddc_setscl(void *data, int state)
 {
     struct smi_connector *connector = data;
-    adapterI2CSCL(state, connector->i2c_scl);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk750_context_t *pCtx = sdev->ddk750_ctx;
+    adapterI2CSCL(pCtx, state, connector->i2c_scl);
     /* smi_set_i2c_signal(data, I2C_SCL_MASK, state); */
 }
 
@@ -716,14 +730,18 @@ static int smi_ddc_getsda(void *data)
 {
 
     struct smi_connector *connector = data;
-    return (int)adapterI2CReadSDA(connector->i2c_sda);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk750_context_t *pCtx = sdev->ddk750_ctx;
+    return (int)adapterI2CReadSDA(pCtx, connector->i2c_sda);
     /* return smi_get_i2c_signal(data, I2C_SDA_MASK); */
 }
 
 static int smi_ddc_getscl(void *data)
 {
     struct smi_connector *connector = data;
-    return (int)adapterI2CReadSCL(connector->i2c_scl);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk750_context_t *pCtx = sdev->ddk750_ctx;
+    return (int)adapterI2CReadSCL(pCtx, connector->i2c_scl);
     /* return smi_get_i2c_signal(data, I2C_SCL_MASK); */
 }
 
@@ -754,7 +772,7 @@ static int smi_ddc_create(struct smi_connector *connector)
     return 0;
 }
 
-long ddk750_AdaptSWI2CInit(struct smi_connector *smi_connector)
+long ddk750_AdaptSWI2CInit(ddk750_context_t *pCtx, struct smi_connector *smi_connector)
 {
     struct drm_connector *connector = &smi_connector->base;
     unsigned char i2cClkGPIO;
@@ -778,7 +796,7 @@ long ddk750_AdaptSWI2CInit(struct smi_connector *smi_connector)
     smi_connector->i2c_scl = i2cClkGPIO;
     smi_connector->i2c_sda = i2cDataGPIO;
 
-    if (adapterI2CInit(i2cClkGPIO, i2cDataGPIO))
+    if (adapterI2CInit(pCtx, i2cClkGPIO, i2cDataGPIO))
     {
         return (-1);
     }
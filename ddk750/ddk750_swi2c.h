@@ -1,6 +1,8 @@
 #ifndef _SWI2C_H_
 #define _SWI2C_H_
 
+#include "ddk750_help.h"
+
 #include "../smi_drv.h"
 
 
@@ -20,6 +22,7 @@
  *       0   - Success
  */
 long swI2CInit(
+    ddk750_context_t *pCtx,
     unsigned char i2cClkGPIO, 
     unsigned char i2cDataGPIO
 );
@@ -36,6 +39,7 @@ long swI2CInit(
  *      Register value
  */
 unsigned char swI2CReadReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 );
@@ -55,6 +59,7 @@ unsigned char swI2CReadReg(
  *      actual size
  */
 long swI2CReadReg_Continuous(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char start_registerIndex,
     unsigned long length,
@@ -77,6 +82,7 @@ long swI2CReadReg_Continuous(
  *         -1   - Fail
  */
 long swI2CWriteReg(
+    ddk750_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
@@ -93,7 +99,7 @@ long swI2CWriteReg(
  *  Parameters:
  *      value	- Bit value to set to the SCL or SDA (0 = low, 1 = high)
  */ 
-void swI2CSCL(unsigned char value);
+void swI2CSCL(ddk750_context_t *pCtx, unsigned char value);
 
 /*
  *  This function set/reset the SDA GPIO pin
@@ -101,9 +107,9 @@ void swI2CSCL(unsigned char value);
  *  Parameters:
  *      value	- Bit value to set to the SCL or SDA (0 = low, 1 = high)
  */
-void swI2CSDA(unsigned char value);
+void swI2CSDA(ddk750_context_t *pCtx, unsigned char value);
 
-long ddk750_AdaptSWI2CInit(struct smi_connector *smi_connector);
+long ddk750_AdaptSWI2CInit(ddk750_context_t *pCtx, struct smi_connector *smi_connector);
 
 
 
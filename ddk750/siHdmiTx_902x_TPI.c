@@ -9,9 +9,6 @@
 #include "ddk750_hwi2c.h"
 #include "ddk750_swi2c.h"
 
-#define i2cWriteReg swI2CWriteReg
-#define i2cReadReg  swI2CReadReg
-
 
 
 SIHDMITX_CONFIG		siHdmiTx;
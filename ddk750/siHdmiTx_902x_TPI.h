@@ -1,14 +1,16 @@
 #ifndef _SIHDMITX_902X_TPI_H_
 #define _SIHDMITX_902X_TPI_H_
 
+#include "ddk750_help.h"
+
 /* smi added */
 #define SII9022A_I2C_ADDRESS                  0x72
 #ifdef USE_HW_I2C
-#define i2cWriteReg hwI2CWriteReg
-#define i2cReadReg  hwI2CReadReg
+#define i2cWriteReg(addr, reg, data) hwI2CWriteReg(siHdmiTx.pCtx, addr, reg, data)
+#define i2cReadReg(addr, reg)        hwI2CReadReg(siHdmiTx.pCtx, addr, reg)
 #else
-#define i2cWriteReg swI2CWriteReg
-#define i2cReadReg  swI2CReadReg
+#define i2cWriteReg(addr, reg, data) swI2CWriteReg(siHdmiTx.pCtx, addr, reg, data)
+#define i2cReadReg(addr, reg)        swI2CReadReg(siHdmiTx.pCtx, addr, reg)
 #endif
 
 //--------------------------------------------------------------------
@@ -162,8 +164,11 @@ typedef struct
      						 	//[1]_SD Direction Byte shifted first: 0 = MSB; 1 = LSB
      						 	//[0]_WS to SD First Bit Shift: 0 = Yes; 1 = No
 
+		ddk750_context_t *pCtx;	// device whose I2C bus the transmitter sits on
 }SIHDMITX_CONFIG;
 
+extern SIHDMITX_CONFIG siHdmiTx;
+
 //====================================================
 typedef struct
 {
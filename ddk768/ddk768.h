@@ -2,7 +2,7 @@
 #define DDK768_H__
 
 #include "ddk768_reg.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 #include "ddk768_mode.h"
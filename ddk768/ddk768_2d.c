@@ -4,7 +4,7 @@
 #include "ddk768_chip.h"
 #include "ddk768_power.h"
 #include "ddk768_2d.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 /* Blt Direction definitions */
 #define TOP_TO_BOTTOM 0
@@ -28,9 +28,9 @@
  * This function must be called before other 2D functions.
  * Assumption: A specific video mode has been properly set up.
  */
-void ddk768_deInit()
+void ddk768_deInit(ddk768_context_t *pCtx)
 {
-    ddk768_enable2DEngine(1);
+    ddk768_enable2DEngine(pCtx, 1);
 
     ddk768_deReset(); /* Just be sure no left-over operations from other applications */
 
@@ -51,8 +51,8 @@ void ddk768_deInit()
         FIELD_VALUE(0, DE_STRETCH_FORMAT, SOURCE_HEIGHT,3));
 
     /* Clipping and transparent are disable after INIT */
-    ddk768_deSetClipping(0, 0, 0, 0, 0);
-    ddk768_deSetTransparency(0, 0, 0, 0);
+    ddk768_deSetClipping(pCtx, 0, 0, 0, 0, 0);
+    ddk768_deSetTransparency(pCtx, 0, 0, 0, 0);
 }
 
 /*
@@ -100,7 +100,7 @@ void ddk768_deReset()
  * Return: 0 = return because engine is idle and normal.
  *        -1 = return because time out (2D engine may have problem).
  */
-long ddk768_deWaitForNotBusy(void)
+long ddk768_deWaitForNotBusy(ddk768_context_t *pCtx)
 {
 	unsigned long dwVal;
     unsigned long i = 0x100000;
@@ -124,13 +124,14 @@ long ddk768_deWaitForNotBusy(void)
  * 
  */
 long ddk768_deSetClipping(
+ddk768_context_t *pCtx,
 unsigned long enable, /* 0 = disable clipping, 1 = enable clipping */
 unsigned long x1,     /* x1, y1 is the upper left corner of the clipping area */
 unsigned long y1,     /* Note that the region includes x1 and y1 */
 unsigned long x2,     /* x2, y2 is the lower right corner of the clippiing area */
 unsigned long y2)     /* Note that the region will not include x2 and y2 */
 {
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -171,6 +172,7 @@ unsigned long y2)     /* Note that the region will not include x2 and y2 */
  * If not match, the destination pixel will be updated.
  */
 long ddk768_deSetTransparency(
+ddk768_context_t *pCtx,
 unsigned long enable,     /* 0 = disable, 1 = enable transparency feature */
 unsigned long tSelect,    /* 0 = compare source, 1 = compare destination */
 unsigned long tMatch,     /* 0 = Opaque mode, 1 = transparent mode */
@@ -178,7 +180,7 @@ unsigned long ulColor)    /* Color to compare. */
 {
     unsigned long de_ctrl;
 
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -238,7 +240,7 @@ unsigned long ulColor)    /* Color to compare. */
  * It returns a double word with the transparent fields properly set,
  * while other fields are 0.
  */
-unsigned long ddk768_deGetTransparency(void)
+unsigned long ddk768_deGetTransparency(ddk768_context_t *pCtx)
 {
     unsigned long de_ctrl;
 
@@ -256,6 +258,7 @@ unsigned long ddk768_deGetTransparency(void)
  * This function sets the pixel format that will apply to the 2D Engine.
  */
 void ddk768_deSetPixelFormat(
+    ddk768_context_t *pCtx,
     unsigned long bpp
 )
 {
@@ -284,7 +287,7 @@ void ddk768_deSetPixelFormat(
  * This function uses 2D engine to fill a rectangular area with a specific color.
  * The filled area includes the starting points.
  */
-long ddk768_deRectFill( /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
+long ddk768_deRectFill(ddk768_context_t *pCtx,  /*resolution_t resolution, point_t p0, point_t p1, unsigned long color, unsigned long rop2)*/
 unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
 unsigned long dPitch, /* Pitch value of destination surface in BYTES */
 unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -299,7 +302,7 @@ unsigned long rop2)   /* ROP value */
 
     bytePerPixel = bpp/8;
     
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -335,7 +338,7 @@ unsigned long rop2)   /* ROP value */
     POKE_32(DE_FOREGROUND, color);
 
     /* Set the pixel format of the destination */
-    ddk768_deSetPixelFormat(bpp);
+    ddk768_deSetPixelFormat(pCtx, bpp);
 
 #ifdef ENABLE_192_BYTES_PATCH
     /* Workaround for 192 byte requirement when ROP is not COPY */
@@ -350,7 +353,7 @@ unsigned long rop2)   /* ROP value */
 
         while (1)
         {
-            ddk768_deWaitForNotBusy();
+            ddk768_deWaitForNotBusy(pCtx);
             
             POKE_32(DE_DESTINATION,
                 FIELD_SET  (0, DE_DESTINATION, WRAP, DISABLE) |
@@ -369,7 +372,7 @@ unsigned long rop2)   /* ROP value */
                 FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
                 FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-            POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -403,7 +406,7 @@ unsigned long rop2)   /* ROP value */
             FIELD_SET  (0, DE_CONTROL,  ROP_SELECT, ROP2)           |
             FIELD_VALUE(0, DE_CONTROL,  ROP,        rop2);
 
-        POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
     }
     
     return 0;
@@ -414,6 +417,7 @@ unsigned long rop2)   /* ROP value */
  * The filled area includes the starting points.
  */
 long ddk768_deStartTrapezoidFill(
+    ddk768_context_t *pCtx,
     unsigned long dBase,  /* Base address of destination surface counted from beginning of video frame buffer */
     unsigned long dPitch, /* Pitch value of destination surface in BYTES */
     unsigned long bpp,    /* Color depth of destination surface: 8, 16 or 32 */
@@ -433,7 +437,7 @@ long ddk768_deStartTrapezoidFill(
         FIELD_SET  (0, DE_CONTROL, ROP_SELECT,  ROP2)            |
         FIELD_VALUE(0, DE_CONTROL, ROP,         rop2);
 
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -476,7 +480,7 @@ long ddk768_deStartTrapezoidFill(
         FIELD_VALUE(0, DE_DESTINATION, Y,    y));
     
     /* Set the pixel format of the destination */
-    ddk768_deSetPixelFormat(bpp);
+    ddk768_deSetPixelFormat(pCtx, bpp);
     
     /* Set the line length and width */
     POKE_32(DE_DIMENSION,
@@ -484,7 +488,7 @@ long ddk768_deStartTrapezoidFill(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, 0));
 
     /* Enable the 2D Engine. */
-    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
     
     return 0;
 }
@@ -493,11 +497,12 @@ long ddk768_deStartTrapezoidFill(
  * Function to continue drawing a line using Trapezoid Fill method.
  */
 long ddk768_deNextTrapezoidFill(
+    ddk768_context_t *pCtx,
     unsigned long x,            /* Starting X location. */
     unsigned long length        /* Line length */
 )
 {
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -526,9 +531,9 @@ long ddk768_deNextTrapezoidFill(
  * This function has to be called to end the Trapezoid Fill drawing.
  * Otherwise, the next 2D function might still use this function.
  */
-long ddk768_deStopTrapezoidFill()
+long ddk768_deStopTrapezoidFill(ddk768_context_t *pCtx)
 {
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -554,6 +559,7 @@ long ddk768_deStopTrapezoidFill()
  *        mono expansion.
  */
 long ddk768_deVideoMem2VideoMemBlt(
+ddk768_context_t *pCtx,
 unsigned long sBase,  /* Address of source: offset in frame buffer */
 unsigned long sPitch, /* Pitch value of source surface in BYTE */
 unsigned long sx,
@@ -570,7 +576,7 @@ unsigned long rop2)   /* ROP value */
     unsigned long nDirection, de_ctrl, bytePerPixel;
     long opSign;
 
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -689,7 +695,7 @@ unsigned long rop2)   /* ROP value */
         FIELD_VALUE(0, DE_WINDOW_WIDTH, SOURCE,      (sPitch/bytePerPixel)));
 
     /* Set the pixel format of the destination */
-    ddk768_deSetPixelFormat(bpp);
+    ddk768_deSetPixelFormat(pCtx, bpp);
     
 #ifdef ENABLE_192_BYTES_PATCH
     /* This bug is fixed in SM718 for 16 and 32 bpp. However, in 8-bpp, the problem still exists. 
@@ -711,7 +717,7 @@ unsigned long rop2)   /* ROP value */
 
         while (1)
         {
-            ddk768_deWaitForNotBusy();
+            ddk768_deWaitForNotBusy(pCtx);
             POKE_32(DE_SOURCE,
                 FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
                 FIELD_VALUE(0, DE_SOURCE, X_K1, sx)   |
@@ -733,7 +739,7 @@ unsigned long rop2)   /* ROP value */
                 : FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT)) |
                 FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-            POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+            POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
 
             if (xChunk == width) break;
 
@@ -751,7 +757,7 @@ unsigned long rop2)   /* ROP value */
     else
 #endif
     {
-        ddk768_deWaitForNotBusy();
+        ddk768_deWaitForNotBusy(pCtx);
 
         POKE_32(DE_SOURCE,
             FIELD_SET  (0, DE_SOURCE, WRAP, DISABLE) |
@@ -774,7 +780,7 @@ unsigned long rop2)   /* ROP value */
             : FIELD_SET(0, DE_CONTROL, DIRECTION, LEFT_TO_RIGHT)) |
             FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-        POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+        POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
     }
 
     return 0;
@@ -953,6 +959,7 @@ long ddk768_deSystemMem2VideoMemBusMasterBlt(
  *        mono expansion.
  */
 long ddk768_deSystemMem2VideoMemBlt(
+    ddk768_context_t *pCtx,
     unsigned char *pSrcbuf, /* pointer to source data in system memory */
     long srcDelta,          /* width (in Bytes) of the source data, +ive means top down and -ive mean button up */
     unsigned long dBase,    /* Address of destination: offset in frame buffer */
@@ -988,7 +995,7 @@ long ddk768_deSystemMem2VideoMemBlt(
     ulBytesRemain = ulBytesPerScan & 7;
 
     /* Program 2D Drawing Engine */
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1043,7 +1050,7 @@ long ddk768_deSystemMem2VideoMemBlt(
         FIELD_VALUE(0, DE_DIMENSION, Y_ET, height));
         
     /* Set the pixel format of the destination */
-    ddk768_deSetPixelFormat(bpp);
+    ddk768_deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = 
         FIELD_VALUE(0, DE_CONTROL, ROP, rop2)         |
@@ -1052,7 +1059,7 @@ long ddk768_deSystemMem2VideoMemBlt(
         FIELD_SET(0, DE_CONTROL, HOST, COLOR)         |
         FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
 
     /* Write bitmap/image data (line by line) to 2D Engine data port */
     for (i = 0; i < height; i++)
@@ -1080,6 +1087,7 @@ long ddk768_deSystemMem2VideoMemBlt(
  * This function expands the monochrome data to color image in video memory.
  */
 long ddk768_deSystemMem2VideoMemMonoBlt(
+ddk768_context_t *pCtx,
 unsigned char *pSrcbuf, /* pointer to start of source buffer in system memory */
 long srcDelta,          /* Pitch value (in bytes) of the source buffer, +ive means top down and -ive mean button up */
 unsigned long startBit, /* Mono data can start at any bit in a byte, this value should be 0 to 7 */
@@ -1109,7 +1117,7 @@ unsigned long rop2)     /* ROP value */
     ul4BytesPerScan = ulBytesPerScan & ~3;
     ulBytesRemain = ulBytesPerScan & 3;
 
-    if (ddk768_deWaitForNotBusy() != 0)
+    if (ddk768_deWaitForNotBusy(pCtx) != 0)
     {
         /* The 2D engine is always busy for some unknown reason.
            Application can choose to return ERROR, or reset it and
@@ -1166,7 +1174,7 @@ unsigned long rop2)     /* ROP value */
     POKE_32(DE_BACKGROUND, bColor);
     
     /* Set the pixel format of the destination */
-    ddk768_deSetPixelFormat(bpp);
+    ddk768_deSetPixelFormat(pCtx, bpp);
 
     de_ctrl = FIELD_VALUE(0, DE_CONTROL, ROP, rop2)         |
               FIELD_SET(0, DE_CONTROL, ROP_SELECT, ROP2)    |
@@ -1174,7 +1182,7 @@ unsigned long rop2)     /* ROP value */
               FIELD_SET(0, DE_CONTROL, HOST, MONO)          |
               FIELD_SET(0, DE_CONTROL, STATUS, START);
 
-    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency());
+    POKE_32(DE_CONTROL, de_ctrl | ddk768_deGetTransparency(pCtx));
 
     /* Write MONO data (line by line) to 2D Engine data port */
     for (i=0; i<height; i++)
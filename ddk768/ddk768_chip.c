@@ -3,7 +3,7 @@
 #include "ddk768_power.h"
 #include "ddk768_clock.h"
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 /* Size of SM768 MMIO and memory */
@@ -11,7 +11,7 @@
 #define SMI_MEMORY_SIZE_SM768     (128<<20)  
 
 
-unsigned int ddk768_getCrystalType(void)
+unsigned int ddk768_getCrystalType(ddk768_context_t *pCtx)
 {
 	unsigned int strapPin;
 		
@@ -27,7 +27,7 @@ unsigned int ddk768_getCrystalType(void)
 	}
 }
 
-unsigned int ddk768_getPixelType(void)
+unsigned int ddk768_getPixelType(ddk768_context_t *pCtx)
 {
 	unsigned int strapPin;
 		
@@ -46,7 +46,7 @@ unsigned int ddk768_getPixelType(void)
 /*
  * This function returns frame buffer memory size in Byte units.
  */
-unsigned long ddk768_getFrameBufSize()
+unsigned long ddk768_getFrameBufSize(ddk768_context_t *pCtx)
 {
 #if 1
 	return SMI_MEMORY_SIZE_SM768;
@@ -123,7 +123,7 @@ char *ddk768_getChipTypeString()
  *        -1 if fail.
  *
  */
-long ddk768_initChipParamEx(initchip_param_t * pInitParam)
+long ddk768_initChipParamEx(ddk768_context_t *pCtx, initchip_param_t * pInitParam)
 {
     unsigned long ulReg;
 
@@ -165,7 +165,7 @@ long ddk768_initChipParamEx(initchip_param_t * pInitParam)
  * Return: 0 (or NO_ERROR) if successful.
  *        -1 if fail.
  */
-long ddk768_initChip()
+long ddk768_initChip(ddk768_context_t *pCtx)
 {
     initchip_param_t initParam;
     
@@ -174,7 +174,7 @@ long ddk768_initChip()
     initParam.setAllEngOff = 1;
     
     
-    return(ddk768_initChipParamEx(&initParam));
+    return(ddk768_initChipParamEx(pCtx, &initParam));
 }
 
 #if 0
@@ -1,6 +1,8 @@
 #ifndef _DDK768_CHIP_H_
 #define _DDK768_CHIP_H_
 
+#include "ddk768_help.h"
+
 /* This is all the chips recognized by this library */
 typedef enum _logical_chip_type_t
 {
@@ -24,15 +26,15 @@ initchip_param_t;
 
 
 
-unsigned int ddk768_getCrystalType(void);
-unsigned int ddk768_getPixelType(void);
+unsigned int ddk768_getCrystalType(ddk768_context_t *pCtx);
+unsigned int ddk768_getPixelType(ddk768_context_t *pCtx);
 
 
 
 /*
  * This function returns frame buffer memory size in Byte units.
  */
-unsigned long ddk768_getFrameBufSize(void);
+unsigned long ddk768_getFrameBufSize(ddk768_context_t *pCtx);
 
 
 
@@ -58,7 +60,7 @@ char * ddk768_getChipTypeString(void);
  *        -1 if fail.
  *
  */
-long ddk768_initChipParamEx(initchip_param_t * pInitParam);
+long ddk768_initChipParamEx(ddk768_context_t *pCtx, initchip_param_t * pInitParam);
 
 /*
  * Initialize the chip with default parameters.
@@ -68,7 +70,7 @@ long ddk768_initChipParamEx(initchip_param_t * pInitParam);
  * Return: 0 (or NO_ERROR) if successful.
  *        -1 if fail.
  */
-long ddk768_initChip(void);
+long ddk768_initChip(ddk768_context_t *pCtx);
 
 #define MB(x) (x<<20) /* Macro for Mega Bytes */
 
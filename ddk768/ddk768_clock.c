@@ -1,3 +1,6 @@
+#include <linux/math64.h>
+#include <linux/spinlock.h>
+
 #include "ddk768_reg.h"
 
 #include "ddk768_chip.h"
@@ -6,31 +9,111 @@
 #include "ddk768_mode.h"
 
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_helper.h"
 
+/* Number of solved clocks remembered by ddk768_calcPllValue() */
+#define PLL_CACHE_SIZE  16
+
+typedef struct _pll_cache_entry_t
+{
+    unsigned long requestClk;   /* 0 for an unused entry */
+    unsigned long actualClk;
+    pll_value_t pll;            /* inputFreq is part of the key */
+}
+pll_cache_entry_t;
+
+/*
+ * The solution only depends on the crystal and the requested clock, so the
+ * cache is shared by all chips. It is direct mapped on the requested clock.
+ */
+static pll_cache_entry_t pllCache[PLL_CACHE_SIZE];
+static DEFINE_SPINLOCK(pllCacheLock);
+
 /*
  * A local function to calculate the output frequency of a given PLL structure.
  *
+ * Output = inputFreq * (INT + FRAC / 2^15) / 2^(VCO + 1), rounded to the Hz.
  */
 unsigned long ddk768_calcPLL(pll_value_t *pPLL)
 {
-    unsigned long pllClk, vcoPower;
-    unsigned long fifteenPower = ddk768_twoToPowerOfx(15); /* 2^15 */
-
-    /* Convert everything in Khz range in order to avoid calculation overflow */
-    pPLL->inputFreq /= 1000;
-    
-    /* Work out 2 to the power of (VCO + 1) */
-    vcoPower = ddk768_twoToPowerOfx(pPLL->VCO + 1);
-    
-    pllClk = (pPLL->inputFreq * pPLL->INT + pPLL->inputFreq * pPLL->FRAC / fifteenPower) / vcoPower;
-    
-    /* Restore input frequency from Khz to hz unit */
-    pPLL->inputFreq *= 1000;
-    pllClk *= 1000;
-
-    return pllClk;
+    unsigned long long ratio = ((unsigned long long)pPLL->INT << 15) + pPLL->FRAC;
+    unsigned long shift = 15 + pPLL->VCO + 1;
+
+    return (unsigned long)(((unsigned long long)pPLL->inputFreq * ratio + (1ULL << (shift - 1))) >> shift);
+}
+
+/*
+ * Search every legal VCO (0..5) and INT (28..56) for the INT.FRAC closest
+ * to the requested clock. For a given VCO the ideal INT.FRAC is a fixed
+ * point number with 15 fractional bits, so rounding it gives the best FRAC
+ * directly; everything is kept in Hz with 64-bit intermediates.
+ */
+static unsigned long ddk768_solvePll(unsigned long ulRequestClk, pll_value_t *pPLL)
+{
+    unsigned long long ratio, bestDiff = ~0ULL, diff;
+    unsigned long VCO, INTEGER, FRAC, shift, pllClk;
+
+    /* Init PLL structure to known states */
+    pPLL->INT = 0;
+    pPLL->FRAC = 0;
+    pPLL->VCO = 0;
+    pPLL->BS = 0;
+
+    /* If the requested clock is higher than 1 GHz, then set it to the maximum, which is
+       1 GHz. */
+    if (ulRequestClk > GHz(1))
+        ulRequestClk = GHz(1);
+
+    /* The maximum of VCO is 5. */
+    for (VCO = 0; VCO <= 5; VCO++)
+    {
+        shift = 15 + VCO + 1;
+
+        /* INT.FRAC = requestClk * 2^(VCO + 1) / inputFreq, in 1/2^15 units */
+        ratio = div_u64(((unsigned long long)ulRequestClk << shift) + pPLL->inputFreq / 2,
+                        pPLL->inputFreq);
+        INTEGER = (unsigned long)(ratio >> 15);
+        FRAC = (unsigned long)(ratio & (FRAC_MAX - 1));
+
+        /* 28 <= INT <= 56 */
+        if ((INTEGER < 28) || (INTEGER > 56))
+            continue;
+
+        pllClk = (unsigned long)(((unsigned long long)pPLL->inputFreq * ratio + (1ULL << (shift - 1))) >> shift);
+        diff = ddk768_absDiff(pllClk, ulRequestClk);
+
+        if (diff < bestDiff)
+        {
+            bestDiff = diff;
+
+            /* Store INT and FRAC values */
+            pPLL->INT  = INTEGER;
+            pPLL->FRAC = FRAC;
+            pPLL->VCO = VCO;
+        }
+    }
+
+    /* Calculate BS value */
+    if ((pPLL->INT >= 28) && (pPLL->INT < 35))
+    {
+        pPLL->BS = 0;
+    }
+    else if ((pPLL->INT >=35) && (pPLL->INT < 42))
+    {
+        pPLL->BS = 1;
+    }
+    else if ((pPLL->INT >= 42) && (pPLL->INT < 49))
+    {
+        pPLL->BS = 2;
+    }
+    else if ((pPLL->INT >= 49) && (pPLL->INT <= 56))
+    {
+        pPLL->BS = 3;
+    }
+
+    /* Return actual frequency that the PLL can set */
+    return ddk768_calcPLL(pPLL);
 }
 
 /*
@@ -50,96 +133,40 @@ unsigned long ulRequestClk, /* Required pixel clock in Hz unit */
 pll_value_t *pPLL           /* Structure to hold the value to be set in PLL */
 )
 {
+    pll_cache_entry_t *pEntry = &pllCache[(ulRequestClk / 1000) % PLL_CACHE_SIZE];
+    unsigned long ulActualClk, flags;
+
+    spin_lock_irqsave(&pllCacheLock, flags);
+    if (pEntry->requestClk == ulRequestClk && pEntry->pll.inputFreq == pPLL->inputFreq)
+    {
+        *pPLL = pEntry->pll;
+        ulActualClk = pEntry->actualClk;
+        spin_unlock_irqrestore(&pllCacheLock, flags);
+        return ulActualClk;
+    }
+    spin_unlock_irqrestore(&pllCacheLock, flags);
+
+    ulActualClk = ddk768_solvePll(ulRequestClk, pPLL);
+
+    spin_lock_irqsave(&pllCacheLock, flags);
+    pEntry->requestClk = ulRequestClk;
+    pEntry->actualClk = ulActualClk;
+    pEntry->pll = *pPLL;
+    spin_unlock_irqrestore(&pllCacheLock, flags);
+
+    return ulActualClk;
+}
+
+#ifdef SMI_PLL_TEST
+/* Run the solver for one clock without the cache, for smi_pll_test.c */
+unsigned long ddk768_testPixelPll(unsigned long inputFreq, unsigned long ulRequestClk)
+{
+    pll_value_t pll;
 
-		unsigned long INTEGER, FRAC, VCO,  diff, pllClk, vcoPower, tempRequestClk;
-		unsigned long bestDiff = 0xffffffff; /* biggest 32 bit unsigned number */
-		unsigned long fifteenPower = ddk768_twoToPowerOfx(15); /* 2^15 */
-	
-		/* Init PLL structure to known states */
-		pPLL->INT = 0;
-		pPLL->FRAC = 0;
-		pPLL->VCO = 0;
-		pPLL->BS = 0;
-	
-		/* Convert everything in Khz range in order to avoid calculation overflow */
-		pPLL->inputFreq /= 1000;
-		tempRequestClk = ulRequestClk / 1000;
-	
-		/* If the requested clock is higher than 1 GHz, then set it to the maximum, which is
-		   1 GHz. */
-		if (tempRequestClk > MHz(1))
-			tempRequestClk = MHz(1);
-	
-		/* The maximum of VCO is 5. */
-		for (VCO=0; VCO<=5; VCO++)
-		{
-			/* Work out 2 to the power of (VCO + 1) */
-			vcoPower = ddk768_twoToPowerOfx(VCO + 1);
-	
-			INTEGER = tempRequestClk * vcoPower / pPLL->inputFreq;
-	
-			/* 28 <= INT <= 56 */
-			if ((INTEGER >= 28) && (INTEGER <=56))
-			{
-				/* FRAC = (requestClk * vcoPower / inputFreq - INT ) * (2^15)
-				  Use formula as following to avoid decimal calculation:
-				  FRAC = (requestClk * vcoPower - INT * inputFreq) * (2^15) / inputFreq
-				*/
-				FRAC = ((tempRequestClk * vcoPower) - (INTEGER * pPLL->inputFreq)) * fifteenPower / pPLL->inputFreq;
-	
-				/* FRAC field has 15 bits, reject value bigger than 15 bits */
-				if (FRAC < FRAC_MAX)
-				{
-					/* Calculate the actual clock for a given INT & FRAC */
-					pllClk = (pPLL->inputFreq * INTEGER + pPLL->inputFreq * FRAC / fifteenPower) / vcoPower;
-					
-					/* How much are we different from the requirement */
-					diff = ddk768_absDiff(pllClk, tempRequestClk);
-	
-					if (diff < bestDiff)
-					{
-						bestDiff = diff;
-	
-						/* Store INT and FRAC values */
-						pPLL->INT  = INTEGER;
-						pPLL->FRAC = FRAC;
-						pPLL->VCO = VCO;
-					}
-				}
-			}
-		}
-	
-		/* Calculate BS value */
-		if ((pPLL->INT >= 28) && (pPLL->INT < 35))
-		{
-			pPLL->BS = 0;
-		}
-		else if ((pPLL->INT >=35) && (pPLL->INT < 42))
-		{
-			pPLL->BS = 1;
-		}
-		else if ((pPLL->INT >= 42) && (pPLL->INT < 49))
-		{
-			pPLL->BS = 2;
-		}
-		else if ((pPLL->INT >= 49) && (pPLL->INT <= 56))
-		{
-			pPLL->BS = 3;
-		}
-		
-		/* Restore input frequency from Khz to hz unit */
-		pPLL->inputFreq *= 1000;
-#if 0	
-		/* Output debug information */
-		DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Requested Frequency = %d\n", ulRequestClk));
-		DDKDEBUGPRINT((DISPLAY_LEVEL, "calcPllValue: Input CLK = %dHz, INT=%d, FRAC=%d, VCO=%d, BS=%d\n", 
-							pPLL->inputFreq, pPLL->INT, pPLL->FRAC, pPLL->VCO, pPLL->BS));
-#endif	
-		/* Return actual frequency that the PLL can set */
-		return ddk768_calcPLL(pPLL);
-
-    
+    pll.inputFreq = inputFreq;
+    return ddk768_solvePll(ulRequestClk, &pll);
 }
+#endif
 
 /*
  * Set up the corresponding bit field of the programmable PLL register.
@@ -169,3 +196,34 @@ unsigned long ddk768_formatPllReg(pll_value_t *pPLL)
 
 
 
+
+/*
+ * This function returns the memory clock in Hz.
+ *
+ * MCLK_PLL has the same INT/VCO layout as the video PLLs, without the
+ * fractional part, and runs from the same half crystal input. If the PLL
+ * is powered down or was never programmed, the power on default is
+ * returned instead.
+ */
+unsigned long ddk768_getMemoryClock(ddk768_context_t *pCtx)
+{
+    unsigned long value;
+    pll_value_t pll;
+
+    value = peekRegisterDWord(MCLK_PLL);
+    if (FIELD_VAL_GET(value, MCLK_PLL, POWER) == MCLK_PLL_POWER_DOWN ||
+        FIELD_VAL_GET(value, MCLK_PLL, INT) == 0)
+        return DEFAULT_MEMORY_CLK;
+
+    if (FIELD_VAL_GET(peekRegisterDWord(STRAP_PINS), STRAP_PINS, CRYSTAL_CONFIG) == STRAP_PINS_CRYSTAL_CONFIG_24576)
+        pll.inputFreq = (24576000 / 2);
+    else
+        pll.inputFreq = (24000000 / 2);
+
+    pll.INT = FIELD_VAL_GET(value, MCLK_PLL, INT);
+    pll.FRAC = 0;
+    pll.VCO = FIELD_VAL_GET(value, MCLK_PLL, VCO);
+    pll.BS = 0;
+
+    return ddk768_calcPLL(&pll);
+}
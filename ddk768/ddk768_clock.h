@@ -7,6 +7,9 @@
 #define GHz(x) (x*1000000000)   //1000000000HZ  = 1(Ghz)
 #define FRAC_MAX    32768
 
+/* MCLK the chip comes out of reset with */
+#define DEFAULT_MEMORY_CLK  MHz(333)
+
 typedef struct pll_value_t
 {
     unsigned long inputFreq; /* Input clock frequency to the PLL */
@@ -17,6 +20,11 @@ typedef struct pll_value_t
 }
 pll_value_t;
 
+/*
+ * Calculate the output frequency in Hz of a given PLL structure.
+ */
+unsigned long ddk768_calcPLL(pll_value_t *pPLL);
+
 /*
  * Given a requested clock frequency, this function calculates the 
  * best INT, FRAC, VCO and BS values for the PLL.
@@ -49,6 +57,11 @@ unsigned long ddk768_formatPllReg(pll_value_t *pPLL);
 
 long ddk768_setVclock(unsigned dispCtrl, unsigned long pixelClock);
 
+/*
+ * This function returns the memory clock in Hz.
+ */
+unsigned long ddk768_getMemoryClock(ddk768_context_t *pCtx);
+
 
 
 
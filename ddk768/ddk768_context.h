@@ -0,0 +1,83 @@
+#ifndef _DDK768_CONTEXT_H_
+#define _DDK768_CONTEXT_H_
+
+#include <linux/completion.h>
+#include <linux/mutex.h>
+
+#include "ddk768_help.h"
+#include "ddk768_mode.h"
+
+/*
+ * State the DDK keeps for one SM768 chip. It used to live in file scope
+ * globals, which made a second card overwrite the registers and mode of
+ * the first one.
+ */
+struct _ddk768_context_t
+{
+    volatile unsigned char __iomem *mmio;   /* Mapped register aperture */
+    unsigned short devId;
+    char revId;
+
+    /* Mode currently programmed on each channel (ddk768_mode.c) */
+    mode_parameter_t channel0CurrentModeParam;
+    mode_parameter_t channel1CurrentModeParam;
+    /* Pixel clock asked for and produced by the PLL on each channel, in Hz (ddk768_mode.c) */
+    unsigned long requestedPixelClock[2];
+    unsigned long actualPixelClock[2];
+
+    /* GPIO pins and registers used by the software I2C master (ddk768_swi2c.c) */
+    unsigned char i2cClockGPIO;
+    unsigned char i2cDataGPIO;
+    unsigned long i2cClkGPIOMuxReg;
+    unsigned long i2cClkGPIODataReg;
+    unsigned long i2cClkGPIODataDirReg;
+    unsigned long i2cDataGPIOMuxReg;
+    unsigned long i2cDataGPIODataReg;
+    unsigned long i2cDataGPIODataDirReg;
+    unsigned long i2cHalfPeriod;        /* Half SCL period in ns */
+
+    /* Last values written to GPIO_DATA and GPIO_DATA_DIRECTION (ddk768_help.c) */
+    unsigned long gpioData;
+    unsigned long gpioDirection;
+
+    /* One transaction at a time on each hardware I2C controller (ddk768_hwi2c.c) */
+    struct mutex hwI2CLock[2];
+
+    /* Counter values programmed in the timers (ddk768_timer.c) */
+    unsigned long timerCounter[4];
+
+    /* Video overlay source and scaling adjustment (ddk768_video.c) */
+    short videoWidthAdjustment;
+    short videoHeightAdjustment;
+    unsigned long srcVideoWidth;
+    unsigned long srcVideoHeight;
+
+    /* PWM whose interrupt is being serviced (ddk768_pwm.c) */
+    unsigned long pwm;
+
+    /* HDMI controller state (ddk768_hdmi.c, hw768.c) */
+    unsigned char hdmiInt94h;
+    unsigned char hdmiInt95h;
+    unsigned char hdmiPowerMode;
+    unsigned char hdmiEdidRead;
+    unsigned char hdmiAudioMode;
+    unsigned long hdmiAudioRate;        /* I2S sample rate, 0 for the crystal's default */
+    mode_parameter_t hdmiModeParam;     /* Last mode set, for the audio clock regeneration */
+    unsigned char hdmiEdidBuffer[256];
+    int hdmiIntStatus;
+    unsigned char hdmiHotplugInt;       /* Hot plug interrupt wanted by the driver */
+    int hdmiEdidWaiting;                /* An EDID read waits for hdmiEdidDone (hw768.c) */
+    struct completion hdmiEdidDone;
+
+    /* Read-modify-write locks, one per shared register block (smi_lock.h) */
+    struct smi_reg_lock regLock[DDK768_LOCK_COUNT];
+};
+
+/* Lock a register block of the device in scope ("pCtx") around a read-modify-write. */
+#define lockRegisterBlock(lock, flags)      smi_reg_lock_acquire(&pCtx->regLock[lock], flags)
+#define unlockRegisterBlock(lock, flags)    smi_reg_lock_release(&pCtx->regLock[lock], flags)
+
+/* Display controller lock of a channel */
+#define DDK768_LOCK_DC(dispControl)         ((dispControl) == CHANNEL0_CTRL ? DDK768_LOCK_DC0 : DDK768_LOCK_DC1)
+
+#endif /* _DDK768_CONTEXT_H_ */
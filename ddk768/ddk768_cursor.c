@@ -6,6 +6,7 @@
  * This function initializes the cursor attributes.
  */
 void ddk768_initCursor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long base,             /* Base Address */ 
     unsigned long color1,           /* Cursor color 1 in RGB 5:6:5 format */
@@ -37,6 +38,7 @@ void ddk768_initCursor(
  * This function sets the cursor position.
  */
 void ddk768_setCursorPosition(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long dx,               /* X Coordinate of the cursor */
     unsigned long dy,               /* Y Coordinate of the cursor */
@@ -74,6 +76,7 @@ void ddk768_setCursorPosition(
  * This function enables/disables the cursor.
  */
 void ddk768_enableCursor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl, /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long mode			/* Cursor type - 00 disable, 0x01 mask cursor, 0x02 mono, 0x03 alpha cursor */
 )
@@ -1,6 +1,8 @@
 #ifndef _DDK768_CURSOR_H_
 #define _DDK768_CURSOR_H_
 
+#include "ddk768_help.h"
+
 #include "ddk768_mode.h"
 
 #define CURSOR_DISABLE	0x00
@@ -12,6 +14,7 @@
  * This function initializes the cursor attributes.
  */
 void ddk768_initCursor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long base,             /* Base Address */ 
     unsigned long color1,           /* Cursor color 1 in RGB 5:6:5 format */
@@ -23,6 +26,7 @@ void ddk768_initCursor(
  * This function sets the cursor position.
  */
 void ddk768_setCursorPosition(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long dx,               /* X Coordinate of the cursor */
     unsigned long dy,               /* Y Coordinate of the cursor */
@@ -36,6 +40,7 @@ void ddk768_setCursorPosition(
  * This function enables/disables the cursor.
  */
 void ddk768_enableCursor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long enable
 );
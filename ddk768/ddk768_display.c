@@ -6,7 +6,7 @@
 #include "ddk768_display.h"
 #include "ddk768_timer.h"
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 
@@ -45,15 +45,18 @@ long initDisplay()
  * while display channel are still active.
  */
 void setDisplayDPMS(
+   ddk768_context_t *pCtx,
    disp_control_t dispControl, /* Channel 0 or Channel 1) */
    DISP_DPMS_t state /* DPMS state */
    )
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
 	/* Get the control register for channel 0 or 1. */
     ulDispCtrlAddr = (dispControl == CHANNEL0_CTRL)? DISPLAY_CTRL : (DISPLAY_CTRL+CHANNEL_OFFSET);
+    lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
     ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
 
     switch (state)
@@ -76,6 +79,8 @@ void setDisplayDPMS(
     }
 
     pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
+
+    unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 }
 
 /* 
@@ -89,14 +94,16 @@ void setDisplayDPMS(
  * Return: 0 is OK, -1 is error.
  */
 long setDisplayFormat(
+   ddk768_context_t *pCtx,
    disp_control_t outputInterface, /* Use the output of channel 0 or 1 */
    disp_control_t dataPath,        /* Use the data path from channel 0 or 1 */
    disp_format_t dispFormat         /* 24 bit single or 48 bit double pixel */
    )
 {
-   unsigned long ulDispCtrlAddr, ulDispCtrlReg;
+   unsigned long ulDispCtrlAddr, ulDispCtrlReg, flags;
 
    ulDispCtrlAddr = (outputInterface == CHANNEL0_CTRL)? DISPLAY_CTRL : (DISPLAY_CTRL+CHANNEL_OFFSET);
+   lockRegisterBlock(DDK768_LOCK_DC(outputInterface), flags);
    ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
 
    if (dispFormat == DOUBLE_PIXEL_48BIT)
@@ -121,6 +128,7 @@ long setDisplayFormat(
    }
 
    pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
+   unlockRegisterBlock(DDK768_LOCK_DC(outputInterface), flags);
 
    return 0;
 }
@@ -135,7 +143,7 @@ long setDisplayFormat(
  * Note:
  *      This function is waiting for the next vertical sync.         
  */
-void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount)
+void waitDispVerticalSync(ddk768_context_t *pCtx, disp_control_t dispControl, unsigned long vSyncCount)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long status;
@@ -177,7 +185,7 @@ void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount)
         {
             status = FIELD_VAL_GET(peekRegisterDWord(ulDispCtrlAddr), DISPLAY_CTRL, VSYNC);
             //Insert delay to reduce number of Vsync checks
-            timerWaitTicks(3, 0xffff);
+            timerWaitTicks(pCtx, 3, 0xffff);
             if(ulLoopCount++ > ulDeadLoopCount) break;
         }
         while (status == DISPLAY_CTRL_VSYNC_ACTIVE);
@@ -187,7 +195,7 @@ void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount)
         do
         {
             status = FIELD_VAL_GET(peekRegisterDWord(ulDispCtrlAddr), DISPLAY_CTRL, VSYNC);
-            timerWaitTicks(3, 0xffff);
+            timerWaitTicks(pCtx, 3, 0xffff);
             if(ulLoopCount++ > ulDeadLoopCount) break;
         }
         while (status == DISPLAY_CTRL_VSYNC_INACTIVE);
@@ -202,7 +210,7 @@ void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount)
  *
  * Input: display control (CHANNEL0_CTRL or CHANNEL1_CTRL)
  */
-void ddk768_waitVSyncLine(disp_control_t dispControl)
+void ddk768_waitVSyncLine(ddk768_context_t *pCtx, disp_control_t dispControl)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long value;
@@ -211,7 +219,7 @@ void ddk768_waitVSyncLine(disp_control_t dispControl)
     ulDispCtrlAddr = (dispControl == CHANNEL0_CTRL)? CURRENT_LINE : (CURRENT_LINE+CHANNEL_OFFSET);
 
     /* Get the current mode parameter of the specific display control */
-    modeParam = ddk768_getCurrentModeParam(dispControl);
+    modeParam = ddk768_getCurrentModeParam(pCtx, dispControl);
     
     do
     {
@@ -223,7 +231,7 @@ void ddk768_waitVSyncLine(disp_control_t dispControl)
 /*
  * Get current display line number
  */
-unsigned long getDisplayLine(disp_control_t dispControl)
+unsigned long getDisplayLine(ddk768_context_t *pCtx, disp_control_t dispControl)
 {
     unsigned long ulRegAddr;
     unsigned long ulRegValue;
@@ -237,7 +245,7 @@ unsigned long getDisplayLine(disp_control_t dispControl)
 /*
  * This functions uses software sequence to turn on/off the panel of the digital interface.
  */
-void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispState, unsigned long vSyncDelay)
+void ddk768_swPanelPowerSequence(ddk768_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState, unsigned long vSyncDelay)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
@@ -255,17 +263,17 @@ void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispSt
         /* Turn on FPVDDEN. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, FPVDDEN, HIGH);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
         /* Turn on FPDATA. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, DATA, ENABLE);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
         /* Turn on FPVBIAS. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, VBIASEN, HIGH);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
         /* Turn on FPEN. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, FPEN, HIGH);
@@ -279,18 +287,18 @@ void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispSt
         /* Turn off FPEN. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, FPEN, LOW);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
 
         /* Turn off FPVBIASEN. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, VBIASEN, LOW);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
         /* Turn off FPDATA. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, DATA, DISABLE);
         pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
-		waitDispVerticalSync(dispControl, vSyncDelay);
+		waitDispVerticalSync(pCtx, dispControl, vSyncDelay);
 
         /* Turn off FPVDDEN. */
         ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, FPVDDEN, LOW);
@@ -303,7 +311,7 @@ void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispSt
  * This function turns on/off the DAC for CRT display control.
  * Input: On or off
  */
-void ddk768_setDAC(disp_state_t state)
+void ddk768_setDAC(ddk768_context_t *pCtx, disp_state_t state)
 {
 
 #if 1
@@ -338,14 +346,17 @@ void ddk768_setDAC(disp_state_t state)
  */
 //Cheok(10/18/2013): New function similar to setDisplayControl()
 void ddk768_setDisplayEnable(
+   ddk768_context_t *pCtx,
    disp_control_t dispControl, /* Channel 0 or Channel 1) */
    disp_state_t dispState      /* ON or OFF */
 )
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
     ulDispCtrlAddr = (dispControl == CHANNEL0_CTRL)? DISPLAY_CTRL : (DISPLAY_CTRL+CHANNEL_OFFSET);
+    lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
     ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
 
 
@@ -381,7 +392,7 @@ void ddk768_setDisplayEnable(
 
     }
 
-
+    unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 }
 
 
@@ -391,20 +402,24 @@ void ddk768_setDisplayEnable(
  */
 
 void setDataDirection(
+   ddk768_context_t *pCtx,
    disp_control_t dispControl, /* Channel 0 or Channel 1) */
    disp_state_t dispState      /* ON or OFF */
 )
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
     if (dispState == DISP_ON)
     {
          ulDispCtrlAddr = (dispControl == CHANNEL0_CTRL)? DISPLAY_CTRL : (DISPLAY_CTRL+CHANNEL_OFFSET);
+         lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
          ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
 
          /*set data direction */ 
          ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, DIRECTION, INPUT); 
          pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
+         unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 
 
      }
@@ -426,6 +441,7 @@ void setDataDirection(
  *     -1   - Fail 
  */
 long ddk768_detectCRTMonitor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl, 
     unsigned char redValue,
     unsigned char greenValue,
@@ -465,7 +481,7 @@ long ddk768_detectCRTMonitor(
     /* Add some delay here. Otherwise, the detection is not stable.
        SM768 has internal timer. It's better than SW countdown loop.
     */
-    timerWaitTicks(3, 0x7ffff);
+    timerWaitTicks(pCtx, 3, 0x7ffff);
     
     /* Check if the monitor is detected. */
     if (FIELD_VAL_GET(peekRegisterDWord(ulMonitorDetectAddr), CRT_DETECT, CRT) ==
@@ -492,15 +508,16 @@ long ddk768_detectCRTMonitor(
  *
  */
 long setDisplayView(
+	ddk768_context_t *pCtx,
 	disp_control_t dispOutput, 		/* Monitor 0 or 1 */
 	disp_state_t dispState,				/* On or off */
 	disp_control_t dataPath,			/* Use the data path of channel 0 or channel 1 (optional when OFF) */
 	disp_format_t dispFormat)			/* 24 or 48 bit digital interface (optional when OFF */
 {
 
-	ddk768_setDisplayEnable(dispOutput, dispState);         /* Enable or disable Channel output timing */
-	ddk768_swPanelPowerSequence(dispOutput, dispState, 4);  /* Turn on or off output power */
-	setDisplayFormat(dispOutput, dataPath, dispFormat); /* Set dataPath and output pixel format */
+	ddk768_setDisplayEnable(pCtx, dispOutput, dispState);         /* Enable or disable Channel output timing */
+	ddk768_swPanelPowerSequence(pCtx, dispOutput, dispState, 4);  /* Turn on or off output power */
+	setDisplayFormat(pCtx, dispOutput, dataPath, dispFormat); /* Set dataPath and output pixel format */
 
 #if 0
 	if (dispState == DISP_ON)
@@ -512,9 +529,9 @@ long setDisplayView(
 /*
  * Convenient function to trun on single view 
  */
-long setSingleViewOn(disp_control_t dispOutput)
+long setSingleViewOn(ddk768_context_t *pCtx, disp_control_t dispOutput)
 {
-	setDisplayView(
+	setDisplayView(pCtx, 
 		dispOutput, 			/* Output monitor */
 		DISP_ON, 				/* Turn On */
 		dispOutput,				/* Assume monitor 0 is using data path 0, and monitor 1 is using data path 1 */
@@ -526,9 +543,9 @@ long setSingleViewOn(disp_control_t dispOutput)
 /*
  * Convenient function to trun off single view 
  */
-long setSingleViewOff(disp_control_t dispOutput)
+long setSingleViewOff(ddk768_context_t *pCtx, disp_control_t dispOutput)
 {
-	setDisplayView(
+	setDisplayView(pCtx, 
 		dispOutput, 	      /* Output monitor */
 		DISP_OFF, 		      /* Turn Off */
 		dispOutput,				/* Assume monitor 0 is using data path 0, and monitor 1 is using data path 1 */
@@ -540,15 +557,15 @@ long setSingleViewOff(disp_control_t dispOutput)
 /*
  * Convenient function to trun on clone view 
  */
-long setCloneViewOn(disp_control_t dataPath)
+long setCloneViewOn(ddk768_context_t *pCtx, disp_control_t dataPath)
 {
-	setDisplayView(
+	setDisplayView(pCtx, 
 		CHANNEL0_CTRL,			/* For Clone view, monitor 0 has to be ON */
 		DISP_ON, 
 		dataPath,				/* Use this data path for monitor 0 */
 		SINGLE_PIXEL_24BIT);	/* Default to 24 bit single pixel, the most used case */
 
-	setDisplayView(
+	setDisplayView(pCtx, 
 		CHANNEL1_CTRL,			/* For Clone view, monitor 1 has to be ON */
 		DISP_ON, 
 		dataPath,				/* Use this data path for monitor 1 */
@@ -560,10 +577,10 @@ long setCloneViewOn(disp_control_t dataPath)
 /*
  * Convenient function to trun on dual view 
  */
-long setDualViewOn()
+long setDualViewOn(ddk768_context_t *pCtx)
 {
-	setSingleViewOn(CHANNEL0_CTRL);
-	setSingleViewOn(CHANNEL1_CTRL);
+	setSingleViewOn(pCtx, CHANNEL0_CTRL);
+	setSingleViewOn(pCtx, CHANNEL1_CTRL);
 
 	return 0;
 }
@@ -571,10 +588,10 @@ long setDualViewOn()
 /*
  * Convenient function to trun off all views
  */
-long setAllViewOff()
+long setAllViewOff(ddk768_context_t *pCtx)
 {
-	setSingleViewOff(CHANNEL0_CTRL);	/* Turn Off monitor 0 */
-	setSingleViewOff(CHANNEL1_CTRL);	/* Turn Off monitor 1 */
+	setSingleViewOff(pCtx, CHANNEL0_CTRL);	/* Turn Off monitor 0 */
+	setSingleViewOff(pCtx, CHANNEL1_CTRL);	/* Turn Off monitor 1 */
 
 	return 0;
 }
@@ -583,11 +600,13 @@ long setAllViewOff()
  * Disable double pixel clock. 
  * This is a temporary function, used to patch for the random fuzzy font problem. 
  */
-void DisableDoublePixel(disp_control_t dispControl)
+void DisableDoublePixel(ddk768_context_t *pCtx, disp_control_t dispControl)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
+	lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 	if(dispControl == CHANNEL0_CTRL) {
 	    ulDispCtrlAddr = DISPLAY_CTRL;
 	    ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
@@ -599,16 +618,19 @@ void DisableDoublePixel(disp_control_t dispControl)
 	    ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, DOUBLE_PIXEL_CLOCK, DISABLE);
 	    pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
 	}
+	unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 }
 
 
 
 
-void EnableDoublePixel(disp_control_t dispControl)
+void EnableDoublePixel(ddk768_context_t *pCtx, disp_control_t dispControl)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
+	lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 	if(dispControl == CHANNEL0_CTRL) {
 	    ulDispCtrlAddr = DISPLAY_CTRL;
 	    ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
@@ -620,9 +642,11 @@ void EnableDoublePixel(disp_control_t dispControl)
 	    ulDispCtrlReg = FIELD_SET(ulDispCtrlReg, DISPLAY_CTRL, DOUBLE_PIXEL_CLOCK, ENABLE);
 	    pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
 	}
+	unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
 }
 
 void enableLVDS(
+	ddk768_context_t *pCtx,
 	unsigned short lvds, //LVDS 1 or 2
 	unsigned short on    //On =1, and off = 0
 )
@@ -649,7 +673,7 @@ void enableLVDS(
 
 
 
-void setupLVDS(unsigned short lvds)
+void setupLVDS(ddk768_context_t *pCtx, unsigned short lvds)
 {
     unsigned long ulTmpValue;
 
@@ -698,7 +722,7 @@ void setupLVDS(unsigned short lvds)
 /*
  *  Set up 48 bit LVDS output with the input DC channel.
  */
-long set48bitLVDS(disp_control_t dataPath)
+long set48bitLVDS(ddk768_context_t *pCtx, disp_control_t dataPath)
 {
     unsigned long ulTmpValue;
     unsigned long offset;
@@ -758,15 +782,15 @@ long set48bitLVDS(disp_control_t dataPath)
 	//printf( "0x80024 = %08x\n", ulTmpValue);
     pokeRegisterDWord(CRT_DETECT+offset, ulTmpValue);
 
-	setupLVDS(3);
+	setupLVDS(pCtx, 3);
 
 	//Wait for LVDS PLL to settle before enable it.
-    waitDispVerticalSync(dataPath, 3);
+    waitDispVerticalSync(pCtx, dataPath, 3);
 
 	// program 0x8002c again
 	//bit 31:0 = 0x750fed02
-	enableLVDS(1, 1);
-	enableLVDS(2, 1);
+	enableLVDS(pCtx, 1, 1);
+	enableLVDS(pCtx, 2, 1);
 
 	return 0;
 }
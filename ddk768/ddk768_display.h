@@ -1,5 +1,7 @@
 #ifndef _DDK768_DISPLAY_H_
 #define _DDK768_DISPLAY_H_
+
+#include "ddk768_help.h"
 #include "ddk768_mode.h"
 typedef enum _disp_path_t
 {
@@ -77,6 +79,7 @@ long initDisplay(void);
  * while display channel are still active.
  */
 void setDisplayDPMS(
+   ddk768_context_t *pCtx,
    disp_control_t dispControl, /* Channel 0 or Channel 1) */
    DISP_DPMS_t state /* DPMS state */
    );
@@ -91,6 +94,7 @@ void setDisplayDPMS(
  * Return: 0 is OK, -1 is error.
  */
 long setDisplayFormat(
+   ddk768_context_t *pCtx,
    disp_control_t outputInterface, /* Use the output of channel 0 or 1 */
    disp_control_t dataPath,        /* Use the data path from channel 0 or 1 */
    disp_format_t dispFormat         /* 24 bit single or 48 bit double pixel */
@@ -104,7 +108,7 @@ void setCRTPath(disp_control_t dispControl);
 /*
  * This functions uses software sequence to turn on/off the panel.
  */
-void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispState, unsigned long vsync_delay);
+void ddk768_swPanelPowerSequence(ddk768_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState, unsigned long vsync_delay);
 
 /*
  * This functions uses software sequence to turn on/off the digital interface.
@@ -115,7 +119,7 @@ void swDispPowerSequence(disp_control_t dispControl, disp_state_t dispState, uns
  * This function turns on/off the DAC for CRT display control.
  * Input: On or off
  */
-void ddk768_setDAC(disp_state_t state);
+void ddk768_setDAC(ddk768_context_t *pCtx, disp_state_t state);
 
 /*
  * Wait number of Vertical Vsync
@@ -127,7 +131,7 @@ void ddk768_setDAC(disp_state_t state);
  * Note:
  *      This function is waiting for the next vertical sync.         
  */
-void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount);
+void waitDispVerticalSync(ddk768_context_t *pCtx, disp_control_t dispControl, unsigned long vSyncCount);
 
 /*
  * Use panel vertical sync line as time delay function.
@@ -137,7 +141,7 @@ void waitDispVerticalSync(disp_control_t dispControl, unsigned long vSyncCount);
  *
  * Input: display control (CHANNEL0_CTRL or CHANNEL1_CTRL)
  */
-void ddk768_waitVSyncLine(disp_control_t dispControl);
+void ddk768_waitVSyncLine(ddk768_context_t *pCtx, disp_control_t dispControl);
 
 /*
  * This function detects if the CRT monitor is attached.
@@ -152,6 +156,7 @@ void ddk768_waitVSyncLine(disp_control_t dispControl);
  *     -1   - Fail 
  */
 long ddk768_detectCRTMonitor(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl, 
     unsigned char redValue,
     unsigned char greenValue,
@@ -170,6 +175,7 @@ long ddk768_detectCRTMonitor(
  *      is the description of the timing and plane combination setting.
  */
 void ddk768_setDisplayEnable(
+ddk768_context_t *pCtx,
 disp_control_t dispControl, /* Channel 0 or Channel 1) */
 disp_state_t dispState /* ON or OFF */
 );
@@ -182,6 +188,7 @@ disp_state_t dispState /* ON or OFF */
  *
  */
 long setDisplayView(
+	ddk768_context_t *pCtx,
 	disp_control_t dispOutput, 			/* Monitor 0 or 1 */
 	disp_state_t dispState,				/* On or off */
 	disp_control_t dataPath,			/* Use the data path of channel 0 or channel 1 (optional when OFF) */
@@ -190,47 +197,48 @@ long setDisplayView(
 /*
  * Convenient function to trun on single view 
  */
-long setSingleViewOn(disp_control_t dispOutput);
+long setSingleViewOn(ddk768_context_t *pCtx, disp_control_t dispOutput);
 
 /*
  * Convenient function to trun off single view 
  */
-long setSingleViewOff(disp_control_t dispOutput);
+long setSingleViewOff(ddk768_context_t *pCtx, disp_control_t dispOutput);
 
 /*
  * Convenient function to trun on clone view 
  */
-long setCloneViewOn(disp_control_t dataPath);
+long setCloneViewOn(ddk768_context_t *pCtx, disp_control_t dataPath);
 
 /*
  * Convenient function to trun on dual view 
  */
-long setDualViewOn(void);
+long setDualViewOn(ddk768_context_t *pCtx);
 
 /*
  * Convenient function to trun off all views
  */
-long setAllViewOff(void);
+long setAllViewOff(ddk768_context_t *pCtx);
 
 
 /*
  * Disable double pixel clock. 
  * This is a teporary function, used to patch for the random fuzzy font problem. 
  */
-void DisableDoublePixel(disp_control_t dispControl);
-void EnableDoublePixel(disp_control_t dispControl);
+void DisableDoublePixel(ddk768_context_t *pCtx, disp_control_t dispControl);
+void EnableDoublePixel(ddk768_context_t *pCtx, disp_control_t dispControl);
 
 
 void enableLVDS(
+	ddk768_context_t *pCtx,
 	unsigned short lvds, //LVDS 1 or 2
 	unsigned short on    //On =1, and off = 0
 );
 
 
-void setupLVDS(unsigned short lvds);
+void setupLVDS(ddk768_context_t *pCtx, unsigned short lvds);
 
 
-long set48bitLVDS(disp_control_t dataPath);
+long set48bitLVDS(ddk768_context_t *pCtx, disp_control_t dataPath);
 
 
 #endif /* _DISPLAY_H_ */
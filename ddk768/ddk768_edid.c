@@ -1,4 +1,4 @@
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_helper.h"
 #include "ddk768_hwi2c.h"
 #include "ddk768_swi2c.h"
@@ -16,7 +16,7 @@
 #include "../ddk750/ddk750_swi2c.h"
 
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_display.h"
 #include "ddk768_reg.h"
 
@@ -34,7 +34,7 @@
 
 int is_SM768 = 0;
 
-void EP952_Register_Message(void);
+void EP952_Register_Message(struct smi_device *sdev);
 
 
 
@@ -49,15 +49,15 @@ unsigned char is_RSEN;
 unsigned char Cache_EP952_DE_Control;
 
 // Private Functions
-static unsigned char IIC_Write(unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
-static unsigned char IIC_Read(unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
+static unsigned char IIC_Write(struct smi_device *sdev, unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
+static unsigned char IIC_Read(struct smi_device *sdev, unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
 
 //==================================================================================================
 //
 // Private Functions
 //
 
-static unsigned char IIC_Write(unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
+static unsigned char IIC_Write(struct smi_device *sdev, unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // return 0; for success
@@ -72,15 +72,15 @@ static unsigned char IIC_Write(unsigned char IICAddr, unsigned char ByteAddr, un
     for (i = 0; i < Size; i++)
     {
 		if(is_SM768)
-        	ddk768_swI2CWriteReg(IICAddr, (ByteAddr + i), *(Data + i));
+        	ddk768_swI2CWriteReg(sdev->ddk768_ctx, IICAddr, (ByteAddr + i), *(Data + i));
 		else
-			swI2CWriteReg(IICAddr, (ByteAddr + i), *(Data + i));
+			swI2CWriteReg(sdev->ddk750_ctx, IICAddr, (ByteAddr + i), *(Data + i));
 	}
     return status;
 
 }
 
-static unsigned char IIC_Read(unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
+static unsigned char IIC_Read(struct smi_device *sdev, unsigned char IICAddr, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // return 0; for success
@@ -94,9 +94,9 @@ static unsigned char IIC_Read(unsigned char IICAddr, unsigned char ByteAddr, uns
     for (i = 0; i < Size; i++)
     {
     	if(is_SM768)
-        	*(Data + i) = ddk768_swI2CReadReg(IICAddr,(ByteAddr + i));
+        	*(Data + i) = ddk768_swI2CReadReg(sdev->ddk768_ctx, IICAddr,(ByteAddr + i));
 		else
-			*(Data + i) = swI2CReadReg(IICAddr,(ByteAddr + i));
+			*(Data + i) = swI2CReadReg(sdev->ddk750_ctx, IICAddr,(ByteAddr + i));
 	}	
 
     return status;
@@ -107,27 +107,27 @@ static unsigned char IIC_Read(unsigned char IICAddr, unsigned char ByteAddr, uns
 // Hardware Interface
 //
 
-unsigned char EP952_Reg_Read(unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
+unsigned char EP952_Reg_Read(struct smi_device *sdev, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
 {
-    return IIC_Read(IIC_EP952_Addr, ByteAddr, Data, Size);
+    return IIC_Read(sdev, IIC_EP952_Addr, ByteAddr, Data, Size);
 }
 
-unsigned char EP952_Reg_Write(unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
+unsigned char EP952_Reg_Write(struct smi_device *sdev, unsigned char ByteAddr, unsigned char *Data, unsigned int Size)
 {
-    return IIC_Write(IIC_EP952_Addr, ByteAddr, Data, Size);
+    return IIC_Write(sdev, IIC_EP952_Addr, ByteAddr, Data, Size);
 }
 
-unsigned char EP952_Reg_Set_Bit(unsigned char ByteAddr, unsigned char BitMask)
+unsigned char EP952_Reg_Set_Bit(struct smi_device *sdev, unsigned char ByteAddr, unsigned char BitMask)
 {
     int result = 1;
 	unsigned char Temp_Data[15] = {0};
-    result = IIC_Read(IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
+    result = IIC_Read(sdev, IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
     if(result == 0)
     {
         // Write back to Reg Reg_Addr
         Temp_Data[0] |= BitMask;
 
-        return IIC_Write(IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
+        return IIC_Write(sdev, IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
     }
     else
     {
@@ -135,17 +135,17 @@ unsigned char EP952_Reg_Set_Bit(unsigned char ByteAddr, unsigned char BitMask)
     }
 }
 
-unsigned char EP952_Reg_Clear_Bit(unsigned char ByteAddr, unsigned char BitMask)
+unsigned char EP952_Reg_Clear_Bit(struct smi_device *sdev, unsigned char ByteAddr, unsigned char BitMask)
 {
     int result = 1;
 	unsigned char Temp_Data[15] = {0};
-    result = IIC_Read(IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
+    result = IIC_Read(sdev, IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
     if(result == 0)
     {
         // Write back to Reg Reg_Addr
         Temp_Data[0] &= ~BitMask;
 
-        return IIC_Write(IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
+        return IIC_Write(sdev, IIC_EP952_Addr, ByteAddr, Temp_Data, 1);
     }
     else
     {
@@ -161,7 +161,7 @@ unsigned char EP952_Reg_Clear_Bit(unsigned char ByteAddr, unsigned char BitMask)
 //--------------------------------------------------------------------------------------------------
 // Hardware Interface
 
-void EP952_IIC_Initial()
+void EP952_IIC_Initial(struct smi_device *sdev)
 {
 	unsigned char Temp_Data[15] = {0};
     IIC_EP952_Addr = 0x52;	  // EP952 slave address
@@ -170,15 +170,15 @@ void EP952_IIC_Initial()
 
     // Initial Variables
     Temp_Data[0] = EP952_TX_PHY_Control_0__TERM_ON;
-    EP952_Reg_Write(EP952_TX_PHY_Control_0, Temp_Data, 1);
+    EP952_Reg_Write(sdev, EP952_TX_PHY_Control_0, Temp_Data, 1);
 
     Temp_Data[0] = 0;
-    EP952_Reg_Write(EP952_TX_PHY_Control_1, Temp_Data, 1);
+    EP952_Reg_Write(sdev, EP952_TX_PHY_Control_1, Temp_Data, 1);
 
 	
 }
 
-void EP952_Info_Reset(void)
+void EP952_Info_Reset(struct smi_device *sdev)
 {
     int i;
 	unsigned char Temp_Data[15] = {0};
@@ -187,8 +187,8 @@ void EP952_Info_Reset(void)
     Cache_EP952_DE_Control = 0x03;
 
     // Initial Settings
-    EP952_Reg_Set_Bit(EP952_Packet_Control, EP952_Packet_Control__VTX0);
-    EP952_Reg_Set_Bit(EP952_General_Control_1, EP952_General_Control_1__INT_OD);
+    EP952_Reg_Set_Bit(sdev, EP952_Packet_Control, EP952_Packet_Control__VTX0);
+    EP952_Reg_Set_Bit(sdev, EP952_General_Control_1, EP952_General_Control_1__INT_OD);
 
     //
     // Set Default AVI Info Frame
@@ -209,7 +209,7 @@ void EP952_Info_Reset(void)
     	Temp_Data[0] += Temp_Data[i];
     }
     Temp_Data[0] = ~(Temp_Data[0] - 1);
-    EP952_Reg_Write(EP952_AVI_Packet, Temp_Data, 14);
+    EP952_Reg_Write(sdev, EP952_AVI_Packet, Temp_Data, 14);
 
     //
     // Set Default ADO Info Frame
@@ -222,14 +222,14 @@ void EP952_Info_Reset(void)
     	Temp_Data[0] += Temp_Data[i];
     }
     Temp_Data[0] = ~(Temp_Data[0] - 1);
-    EP952_Reg_Write(EP952_ADO_Packet, Temp_Data, 6);
+    EP952_Reg_Write(sdev, EP952_ADO_Packet, Temp_Data, 6);
 
     //
     // Set Default CS Info Frame
     //
     memset(Temp_Data, 0x00, 5);
     	
-    EP952_Reg_Write(EP952_Channel_Status, Temp_Data, 5);
+    EP952_Reg_Write(sdev, EP952_Channel_Status, Temp_Data, 5);
 /*
     //
     // clear Packet_1 Info Frame
@@ -266,34 +266,34 @@ PEP952C_REGISTER_MAP pEP952C_Registers;
 //------------------------------------
 // Special for config
 
-void HDMI_Tx_AMute_Enable(void)
+void HDMI_Tx_AMute_Enable(struct smi_device *sdev)
 {
-	EP952_Reg_Set_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__AMUTE);
-	EP952_Reg_Set_Bit(EP952_Pixel_Repetition_Control, EP952_Pixel_Repetition_Control__CTS_M);
+	EP952_Reg_Set_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__AMUTE);
+	EP952_Reg_Set_Bit(sdev, EP952_Pixel_Repetition_Control, EP952_Pixel_Repetition_Control__CTS_M);
 
-	EP952_Reg_Clear_Bit(EP952_IIS_Control, EP952_IIS_Control__ADO_EN);		
-	EP952_Reg_Clear_Bit(EP952_IIS_Control, EP952_IIS_Control__AUDIO_EN);	
+	EP952_Reg_Clear_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__ADO_EN);		
+	EP952_Reg_Clear_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__AUDIO_EN);	
 }
 
-void HDMI_Tx_AMute_Disable(void)
+void HDMI_Tx_AMute_Disable(struct smi_device *sdev)
 {
-	EP952_Reg_Clear_Bit(EP952_Pixel_Repetition_Control, EP952_Pixel_Repetition_Control__CTS_M);
-	EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__AVMUTE);
-	EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__AMUTE);
+	EP952_Reg_Clear_Bit(sdev, EP952_Pixel_Repetition_Control, EP952_Pixel_Repetition_Control__CTS_M);
+	EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__AVMUTE);
+	EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__AMUTE);
 
-	EP952_Reg_Set_Bit(EP952_IIS_Control, EP952_IIS_Control__ADO_EN);	
-	EP952_Reg_Set_Bit(EP952_IIS_Control, EP952_IIS_Control__AUDIO_EN);
+	EP952_Reg_Set_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__ADO_EN);	
+	EP952_Reg_Set_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__AUDIO_EN);
 }
 
-void HDMI_Tx_VMute_Enable(void)
+void HDMI_Tx_VMute_Enable(struct smi_device *sdev)
 {		
-	EP952_Reg_Set_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__VMUTE);
+	EP952_Reg_Set_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__VMUTE);
 }
 
-void HDMI_Tx_VMute_Disable(void)
+void HDMI_Tx_VMute_Disable(struct smi_device *sdev)
 {
-	EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__AVMUTE);
-	EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__VMUTE);
+	EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__AVMUTE);
+	EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__VMUTE);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -301,43 +301,43 @@ void HDMI_Tx_VMute_Disable(void)
 // HDMI Transmiter (EP952-Tx Implementation)
 //
 
-void HDMI_Tx_HDMI(void)
+void HDMI_Tx_HDMI(struct smi_device *sdev)
 {
-	EP952_Reg_Set_Bit(EP952_General_Control_4, EP952_General_Control_4__HDMI);
+	EP952_Reg_Set_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__HDMI);
 }
 
-void HDMI_Tx_DVI(void)
+void HDMI_Tx_DVI(struct smi_device *sdev)
 {
-	EP952_Reg_Clear_Bit(EP952_General_Control_4, EP952_General_Control_4__HDMI);
+	EP952_Reg_Clear_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__HDMI);
 }
 
-void HDMI_Tx_Power_Down(void)
+void HDMI_Tx_Power_Down(struct smi_device *sdev)
 {
 	// Software power down
-	EP952_Reg_Clear_Bit(EP952_General_Control_1, EP952_General_Control_1__PU);
+	EP952_Reg_Clear_Bit(sdev, EP952_General_Control_1, EP952_General_Control_1__PU);
 }
 
-void HDMI_Tx_Power_Up(void)
+void HDMI_Tx_Power_Up(struct smi_device *sdev)
 {
 	// Software power up
-	EP952_Reg_Set_Bit(EP952_General_Control_1, EP952_General_Control_1__PU);	
+	EP952_Reg_Set_Bit(sdev, EP952_General_Control_1, EP952_General_Control_1__PU);	
 }
 
-void HDMI_Tx_Mute_Enable(void)
+void HDMI_Tx_Mute_Enable(struct smi_device *sdev)
 {
-	HDMI_Tx_AMute_Enable();
-	HDMI_Tx_VMute_Enable();	
+	HDMI_Tx_AMute_Enable(sdev);
+	HDMI_Tx_VMute_Enable(sdev);	
 }
 
-void HDMI_Tx_Mute_Disable(void)
+void HDMI_Tx_Mute_Disable(struct smi_device *sdev)
 {
-	HDMI_Tx_VMute_Disable();	
-	HDMI_Tx_AMute_Disable();
+	HDMI_Tx_VMute_Disable(sdev);	
+	HDMI_Tx_AMute_Disable(sdev);
 }
 
-void HDMI_Tx_HDCP_Disable(void)
+void HDMI_Tx_HDCP_Disable(struct smi_device *sdev)
 {
-	EP952_Reg_Clear_Bit(EP952_General_Control_5, EP952_General_Control_5__ENC_EN);
+	EP952_Reg_Clear_Bit(sdev, EP952_General_Control_5, EP952_General_Control_5__ENC_EN);
 }
 
 void EP952_HDCP_Reset(void)
@@ -389,42 +389,42 @@ VDO_SETTINGS EP952_VDO_Settings[] = {
 
 unsigned char EP952_VDO_Settings_Max = (sizeof(EP952_VDO_Settings)/sizeof(EP952_VDO_Settings[0]));
 
-void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
+void HDMI_Tx_Video_Config(struct smi_device *sdev, PVDO_PARAMS Params)
 {
     int i;
 	unsigned char Temp_Data[15] = {0};
 
     // Disable auto transmission AVI packet 
-    EP952_Reg_Clear_Bit(EP952_IIS_Control, EP952_IIS_Control__AVI_EN);
+    EP952_Reg_Clear_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__AVI_EN);
 
     ////////////////////////////////////////////////////////
     // Video Interface
 
     // De_Skew
-    EP952_Reg_Read(EP952_General_Control_3, Temp_Data, 1);
+    EP952_Reg_Read(sdev, EP952_General_Control_3, Temp_Data, 1);
     Temp_Data[0] &= ~0xF0;
     Temp_Data[0] |= Params->Interface & 0xF0;
-    EP952_Reg_Write(EP952_General_Control_3, Temp_Data, 1);	
+    EP952_Reg_Write(sdev, EP952_General_Control_3, Temp_Data, 1);	
 
     // input DSEL BSEL EDGE
-    EP952_Reg_Read(EP952_General_Control_1, Temp_Data, 1);
+    EP952_Reg_Read(sdev, EP952_General_Control_1, Temp_Data, 1);
     Temp_Data[0] &= ~0x0E;
     Temp_Data[0] |= Params->Interface & 0x0E;
 	if(is_Cap_dsel)
     	Temp_Data[0] |= 0x08;   // DSEL = 1
     else
 		Temp_Data[0] &= 0xf7;   // DSEL = 0
-    EP952_Reg_Write(EP952_General_Control_1, Temp_Data, 1);	
+    EP952_Reg_Write(sdev, EP952_General_Control_1, Temp_Data, 1);	
 
     if(Params->Interface & 0x01) {
-        EP952_Reg_Set_Bit(EP952_General_Control_4, EP952_General_Control_4__FMT12);
+        EP952_Reg_Set_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__FMT12);
     }
     else {
-        EP952_Reg_Clear_Bit(EP952_General_Control_4, EP952_General_Control_4__FMT12);
+        EP952_Reg_Clear_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__FMT12);
     }
 
     // update HVPol
-    EP952_Reg_Read(EP952_General_Control_4, Temp_Data, 1);
+    EP952_Reg_Read(sdev, EP952_General_Control_4, Temp_Data, 1);
     Params->HVPol = Temp_Data[0] & (EP952_DE_Control__VSO_POL | EP952_DE_Control__HSO_POL);	
 
     ////////////////////////////////////////////////////////
@@ -433,7 +433,7 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
         default:
         case SYNCMODE_HVDE:
             // Disable E_SYNC
-            EP952_Reg_Clear_Bit(EP952_General_Control_4, EP952_General_Control_4__E_SYNC);
+            EP952_Reg_Clear_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__E_SYNC);
             // Disable DE_GEN
             Cache_EP952_DE_Control &= ~EP952_DE_Control__DE_GEN;
 
@@ -454,7 +454,7 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
 
         case SYNCMODE_HV:
             // Disable E_SYNC
-            EP952_Reg_Clear_Bit(EP952_General_Control_4, EP952_General_Control_4__E_SYNC);
+            EP952_Reg_Clear_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__E_SYNC);
             // Enable DE_GEN
             Cache_EP952_DE_Control |= EP952_DE_Control__DE_GEN;
 
@@ -479,35 +479,35 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
 #ifdef Little_Endian
                 Cache_EP952_DE_Control |= ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_DLY)[1];
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_DLY)[0];
-                EP952_Reg_Write(EP952_DE_DLY, Temp_Data, 1);
+                EP952_Reg_Write(sdev, EP952_DE_DLY, Temp_Data, 1);
 #else	// Big Endian
                 Cache_EP952_DE_Control |= ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_DLY)[0];
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_DLY)[1];
-                EP952_Reg_Write(EP952_DE_DLY, Temp_Data, 1);
+                EP952_Reg_Write(sdev, EP952_DE_DLY, Temp_Data, 1);
 #endif
 
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_TOP)[0];
-                EP952_Reg_Write(EP952_DE_TOP, Temp_Data, 1);
+                EP952_Reg_Write(sdev, EP952_DE_TOP, Temp_Data, 1);
 
 #ifdef Little_Endian
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_CNT)[0];
                 Temp_Data[1] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_CNT)[1];
-                EP952_Reg_Write(EP952_DE_CNT, Temp_Data, 2);
+                EP952_Reg_Write(sdev, EP952_DE_CNT, Temp_Data, 2);
 #else	// Big Endian
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_CNT)[1];
                 Temp_Data[1] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_CNT)[0];
-                EP952_Reg_Write(EP952_DE_CNT, Temp_Data, 2);
+                EP952_Reg_Write(sdev, EP952_DE_CNT, Temp_Data, 2);
 #endif
 
 
 #ifdef Little_Endian
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_LIN)[1];
                 Temp_Data[1] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_LIN)[0];
-                EP952_Reg_Write(EP952_DE_LIN, Temp_Data, 2);
+                EP952_Reg_Write(sdev, EP952_DE_LIN, Temp_Data, 2);
 #else	// Big Endian
                 Temp_Data[0] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_LIN)[1];
                 Temp_Data[1] = ((unsigned char *)&EP952_VDO_Settings[Params->VideoSettingIndex].DE_Gen.DE_LIN)[0];
-                EP952_Reg_Write(EP952_DE_LIN, Temp_Data, 2);
+                EP952_Reg_Write(sdev, EP952_DE_LIN, Temp_Data, 2);
 #endif
 
             }
@@ -516,27 +516,27 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
             }
             break;
     }
-    EP952_Reg_Write(EP952_DE_Control, &Cache_EP952_DE_Control, 1);
+    EP952_Reg_Write(sdev, EP952_DE_Control, &Cache_EP952_DE_Control, 1);
 	
     ////////////////////////////////////////////////////////
     // Pixel Repetition
-    EP952_Reg_Read(EP952_Pixel_Repetition_Control, Temp_Data, 1);
+    EP952_Reg_Read(sdev, EP952_Pixel_Repetition_Control, Temp_Data, 1);
     Temp_Data[0] &= ~EP952_Pixel_Repetition_Control__PR;
     if(Params->VideoSettingIndex < EP952_VDO_Settings_Max) {
         Temp_Data[0] |= EP952_VDO_Settings[Params->VideoSettingIndex].AR_PR & 0x03;
     }
-    EP952_Reg_Write(EP952_Pixel_Repetition_Control, Temp_Data, 1);
+    EP952_Reg_Write(sdev, EP952_Pixel_Repetition_Control, Temp_Data, 1);
 
     ////////////////////////////////////////////////////////
     // Color Space
     // Set to RGB
-    EP952_Reg_Clear_Bit(EP952_General_Control_4, EP952_General_Control_4__YCC_IN | EP952_General_Control_4__422_IN);
+    EP952_Reg_Clear_Bit(sdev, EP952_General_Control_4, EP952_General_Control_4__YCC_IN | EP952_General_Control_4__422_IN);
     if(Params->VideoSettingIndex < EP952_VDO_Settings_IT_Start) { // CE Timing
-        EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_OUT | EP952_Color_Space_Control__422_OUT);
-        EP952_Reg_Set_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_Range); // Output limit range RGB
+        EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_OUT | EP952_Color_Space_Control__422_OUT);
+        EP952_Reg_Set_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_Range); // Output limit range RGB
     }
     else { // IT Timing
-        EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_OUT | EP952_Color_Space_Control__422_OUT | EP952_Color_Space_Control__YCC_Range);
+        EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__YCC_OUT | EP952_Color_Space_Control__422_OUT | EP952_Color_Space_Control__YCC_Range);
     }
 
     // Color Space
@@ -544,12 +544,12 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
         default:
         case COLORSPACE_601:
             // Set to 601
-            EP952_Reg_Clear_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__COLOR);
+            EP952_Reg_Clear_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__COLOR);
             break;
 
         case COLORSPACE_709:
             // Set to 709
-            EP952_Reg_Set_Bit(EP952_Color_Space_Control, EP952_Color_Space_Control__COLOR);
+            EP952_Reg_Set_Bit(sdev, EP952_Color_Space_Control, EP952_Color_Space_Control__COLOR);
             break;
     }
 
@@ -616,34 +616,34 @@ void HDMI_Tx_Video_Config(PVDO_PARAMS Params)
     Temp_Data[0] = ~(Temp_Data[0] - 1);	// checksum
 	
     // Write AVI InfoFrame Data Byte
-    EP952_Reg_Write(EP952_AVI_Packet, Temp_Data, 14);
+    EP952_Reg_Write(sdev, EP952_AVI_Packet, Temp_Data, 14);
 
     // Enable auto transmission AVI packet 
-    EP952_Reg_Set_Bit(EP952_IIS_Control, EP952_IIS_Control__AVI_EN | EP952_IIS_Control__GC_EN);
+    EP952_Reg_Set_Bit(sdev, EP952_IIS_Control, EP952_IIS_Control__AVI_EN | EP952_IIS_Control__GC_EN);
 
 
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 
-void EP952Controller_Initial(PEP952C_REGISTER_MAP pEP952C_RegMap)
+void EP952Controller_Initial(struct smi_device *sdev, PEP952C_REGISTER_MAP pEP952C_RegMap)
 {		
     // Save the Logical Hardware Assignment
     pEP952C_Registers = pEP952C_RegMap;
 
     // Initial IIC address
     if(is_SM768)
-    	ddk768_swI2CInit(30, 31);
+    	ddk768_swI2CInit(sdev->ddk768_ctx, 30, 31);
 	else
-		swI2CInit(30, 31);
+		swI2CInit(sdev->ddk750_ctx, 30, 31);
 	
-    EP952_IIC_Initial();
+    EP952_IIC_Initial(sdev);
 
     // Software power down
-    HDMI_Tx_Power_Down();
+    HDMI_Tx_Power_Down(sdev);
 
     // Enable Audio Mute and Video Mute
-    HDMI_Tx_Mute_Enable();	
+    HDMI_Tx_Mute_Enable(sdev);	
 
     // Reset Variables
     is_Cap_HDMI = 0;
@@ -667,13 +667,13 @@ void EP952Controller_Initial(PEP952C_REGISTER_MAP pEP952C_RegMap)
     pEP952C_Registers->Video_Output_Format = 0x03;	    // Forced set RGB out
 
     // Disable HDCP
-    HDMI_Tx_HDCP_Disable();
+    HDMI_Tx_HDCP_Disable(sdev);
 
     // HDCP KEY reset
     EP952_HDCP_Reset();
 
     // Info Frame Reset
-    EP952_Info_Reset();
+    EP952_Info_Reset(sdev);
 }
 
 
@@ -724,30 +724,30 @@ void EP_HDMI_DumpRegister(void)
     printk("    -----\r\n");
 }
 #endif
-void EP_HDMI_Init(int chipID)
+void EP_HDMI_Init(struct smi_device *sdev, int chipID)
 {
 	if(chipID)
 		is_SM768 = 1;
 	else
 		is_SM768 = 0;
 	
-    EP952Controller_Initial(&EP952C_Registers);
+    EP952Controller_Initial(sdev, &EP952C_Registers);
 }
 
-void EP952_Video_reg_set(void)
+void EP952_Video_reg_set(struct smi_device *sdev)
 {
     // Mute Control
-    HDMI_Tx_Mute_Enable();
+    HDMI_Tx_Mute_Enable(sdev);
 
     //if(pEP952C_Registers->Video_Input_Format[0] != 0)
     {
         // HDMI Mode
         if(!is_Cap_HDMI ) {
-            HDMI_Tx_DVI();	// Set to DVI output mode (The Info Frame and Audio Packets would not be send)
+            HDMI_Tx_DVI(sdev);	// Set to DVI output mode (The Info Frame and Audio Packets would not be send)
             is_Forced_Output_RGB = 1;
         }
         else {
-            HDMI_Tx_HDMI();	// Set to HDMI output mode
+            HDMI_Tx_HDMI(sdev);	// Set to HDMI output mode
         }
 
     	///////////////////////////////////////////////////////////////////////
@@ -829,10 +829,10 @@ void EP952_Video_reg_set(void)
     	Video_Params.SCAN = SCAN_NoData;
 
     	// Update EP952 Video Registers 
-    	HDMI_Tx_Video_Config(&Video_Params);
+    	HDMI_Tx_Video_Config(sdev, &Video_Params);
 
     	// mute control
-    	HDMI_Tx_Mute_Disable();
+    	HDMI_Tx_Mute_Disable(sdev);
     }
 
     // clear flag
@@ -840,7 +840,7 @@ void EP952_Video_reg_set(void)
 
 }
 
-void EP_HDMI_Set_Video_Timing(unsigned int isHDMI, unsigned int dsel) //(logicalMode_t *pLogicalMode, unsigned int isHDMI)
+void EP_HDMI_Set_Video_Timing(struct smi_device *sdev, unsigned int isHDMI, unsigned int dsel) //(logicalMode_t *pLogicalMode, unsigned int isHDMI)
 {
     /////////////////////////////////////////////////////////////////////////
     //
@@ -876,21 +876,21 @@ void EP_HDMI_Set_Video_Timing(unsigned int isHDMI, unsigned int dsel) //(logical
         is_Cap_dsel = 0;
 
     // power down Tx
-    HDMI_Tx_Power_Down();
+    HDMI_Tx_Power_Down(sdev);
 
     // update EP952 register setting
     //EP952_Audio_reg_set();
-    EP952_Video_reg_set();
+    EP952_Video_reg_set(sdev);
 
     EP952_Debug = 1;
     	
     // Power Up Tx
-    HDMI_Tx_Power_Up();
+    HDMI_Tx_Power_Up(sdev);
 
     TX_State = TXS_Stream;
 }
 
-void EP952_Register_Message(void)
+void EP952_Register_Message(struct smi_device *sdev)
 {
 	unsigned char temp[0x90] = {0};
     unsigned char reg_addr = 0;
@@ -904,7 +904,7 @@ void EP952_Register_Message(void)
     printk(KERN_INFO " \t-----------------------------------------------");
     for(reg_addr=0; reg_addr<=0x88; reg_addr++)
     {
-        EP952_Reg_Read(reg_addr, &temp[reg_addr], 1);
+        EP952_Reg_Read(sdev, reg_addr, &temp[reg_addr], 1);
     }
 	print_hex_dump(KERN_INFO, " \t", DUMP_PREFIX_NONE, 16, 1, temp, 0x90, false);
     printk(KERN_INFO " \t-----------------------------------------------");
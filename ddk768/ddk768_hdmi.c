@@ -1,7 +1,7 @@
 #include <linux/delay.h>
 #include <linux/timer.h>
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_hdmi.h"
 #include "ddk768_reg.h"
 #include "ddk768_power.h"
@@ -61,17 +61,6 @@ static hdmi_vic_param_t gHdmiVICParamTable[] =
     {0, 0, 0,0},
 };
 
-//-----------------------------------------------------------------------------
-// Global Variable
-//-----------------------------------------------------------------------------
-
-BYTE g_INT_94h = 0;
-BYTE g_INT_95h = 0;
-BYTE PowerMode = PowerMode_A;
-BYTE g_ucHDMIedidRead=0;
-BYTE AudioMode = 0;
-BYTE gEdidBuffer[256] = {0};
-
 
 /* Find mode VIC parameer from the table according to Width & Height*/
 hdmi_vic_param_t *FindVicParam(unsigned long Width, unsigned long Height)
@@ -117,6 +106,7 @@ static hdmi_interrupt_t *g_pHdmiIntHandlers = ((hdmi_interrupt_t *)0);
 
 /* HDMI Interrupt Service Routine */
 void hdmiISR(
+    ddk768_context_t *pCtx,
     unsigned long status
 )
 {
@@ -129,18 +119,18 @@ void hdmiISR(
             pfnHandler->handler();
         
         // Save interrupt status value for further usage. 
-        if (PowerMode == PowerMode_A)
+        if (pCtx->hdmiPowerMode == PowerMode_A)
         {
             // PS mode a->b
-            HDMI_System_PD(PowerMode_B);
+            HDMI_System_PD(pCtx, PowerMode_B);
             DelayMs(1);
         }
-        g_INT_94h = readHDMIRegister (X94_INT1_ST);
-        g_INT_95h = readHDMIRegister (X95_INT2_ST);
+        pCtx->hdmiInt94h = readHDMIRegister (pCtx, X94_INT1_ST);
+        pCtx->hdmiInt95h = readHDMIRegister (pCtx, X95_INT2_ST);
 
         // clear all interrupt status
-        writeHDMIRegister (X94_INT1_ST, 0xFF);
-        writeHDMIRegister (X95_INT2_ST, 0xFF);
+        writeHDMIRegister (pCtx, X94_INT1_ST, 0xFF);
+        writeHDMIRegister (pCtx, X95_INT2_ST, 0xFF);
     }            
 }
 
@@ -245,7 +235,7 @@ long unhookHDMIInterrupt(
  *  (MMIO base + 0x800C0) = 0x00008245
  *
  */
-void writeHDMIRegister(unsigned char addr, unsigned char value)
+void writeHDMIRegister(ddk768_context_t *pCtx, unsigned char addr, unsigned char value)
 {
 
     pokeRegisterDWord(HDMI_CONFIG, 
@@ -279,7 +269,7 @@ void writeHDMIRegister(unsigned char addr, unsigned char value)
  *  Value = (MMIO base + 0x800C0) =0x1845
  *
  */
-unsigned char readHDMIRegister(unsigned char addr)
+unsigned char readHDMIRegister(ddk768_context_t *pCtx, unsigned char addr)
 {
     unsigned long value;
 
@@ -310,7 +300,7 @@ unsigned char readHDMIRegister(unsigned char addr)
  *      None
  *  
  */
-void writeHDMIControlRegister(unsigned char value)
+void writeHDMIControlRegister(ddk768_context_t *pCtx, unsigned char value)
 {
 
     pokeRegisterDWord(HDMI_CONTROL, value); 
@@ -329,7 +319,7 @@ void writeHDMIControlRegister(unsigned char value)
  *      register value
  *
  */
-unsigned char readHDMIControlRegister(void)
+unsigned char readHDMIControlRegister(ddk768_context_t *pCtx)
 {
     unsigned long value;
 
@@ -358,14 +348,14 @@ unsigned char readHDMIControlRegister(void)
  *      None
  *
  */
-void writeHdmiPHYRegister(unsigned char addr, unsigned char value)
+void writeHdmiPHYRegister(ddk768_context_t *pCtx, unsigned char addr, unsigned char value)
 {
-    writeHDMIRegister(addr, value);
+    writeHDMIRegister(pCtx, addr, value);
     
-    writeHDMIControlRegister(0x2D);     // PLLA/B reset
+    writeHDMIControlRegister(pCtx, 0x2D);     // PLLA/B reset
     DelayMs(1);     // wait 100us
 
-    writeHDMIControlRegister(0x21);     // PLLA/B release
+    writeHDMIControlRegister(pCtx, 0x21);     // PLLA/B release
     DelayMs(1);     // wait 1ms for PLL lock
 }
 
@@ -381,7 +371,7 @@ void writeHdmiPHYRegister(unsigned char addr, unsigned char value)
  *      None
  *
  */
-void setHDMIChannel(unsigned char Channel)
+void setHDMIChannel(ddk768_context_t *pCtx, unsigned char Channel)
 {
     unsigned long value;
 
@@ -400,32 +390,32 @@ void setHDMIChannel(unsigned char Channel)
 }
 
 /* Send clear AVMute to HDMI Sink for one time. Not send Clear AVMute and Set AVMute in General Control Packet when display. */
-void HDMI_Clear_AVMute(void)
+void HDMI_Clear_AVMute(ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
-    temp = readHDMIRegister(X45_VIDEO2);
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
     temp = FIELD_SET(temp, X45_VIDEO2, CLR_AVMUTE, EN) |
            FIELD_SET(temp, X45_VIDEO2, SET_AVMUTE, DIS);
-    writeHDMIRegister(X45_VIDEO2, temp);
-    writeHDMIRegister(X40_CTRL_PKT_EN, 0x80);  // Send General Control Packet once
+    writeHDMIRegister(pCtx, X45_VIDEO2, temp);
+    writeHDMIRegister(pCtx, X40_CTRL_PKT_EN, 0x80);  // Send General Control Packet once
 
     /* In display period, Clear AVMute and Set AVMute should not be sent in General Control Packet. */
-    temp = readHDMIRegister(X45_VIDEO2);
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
     temp = FIELD_SET(temp, X45_VIDEO2, CLR_AVMUTE, DIS) |
            FIELD_SET(temp, X45_VIDEO2, SET_AVMUTE, DIS);
-    writeHDMIRegister(X45_VIDEO2, temp);
-    writeHDMIRegister(X40_CTRL_PKT_EN, 0x80); // Send General Control Packet once
+    writeHDMIRegister(pCtx, X45_VIDEO2, temp);
+    writeHDMIRegister(pCtx, X40_CTRL_PKT_EN, 0x80); // Send General Control Packet once
 }
 
 /* Before set HDMI IP mode, send AVMute to HDMI Sink in General Control Packet. */
-void HDMI_Set_AVMute(void)
+void HDMI_Set_AVMute(ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
-    temp = readHDMIRegister(X45_VIDEO2);
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
     temp = FIELD_SET(temp, X45_VIDEO2, CLR_AVMUTE, DIS) |
            FIELD_SET(temp, X45_VIDEO2, SET_AVMUTE, EN);
-    writeHDMIRegister(X45_VIDEO2, temp);
-    writeHDMIRegister(X40_CTRL_PKT_EN, 0x80); // Send General Control Packet once
+    writeHDMIRegister(pCtx, X45_VIDEO2, temp);
+    writeHDMIRegister(pCtx, X40_CTRL_PKT_EN, 0x80); // Send General Control Packet once
 }
 
 
@@ -441,7 +431,7 @@ void HDMI_Set_AVMute(void)
  *      None
  *
  */
-void enableHdmI2C(unsigned long enable)
+void enableHdmI2C(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long value;
 
@@ -467,7 +457,7 @@ void enableHdmI2C(unsigned long enable)
  *
  *  Linda: for debug purpose only
  */
-void HDMI_Dump_Registers (void)
+void HDMI_Dump_Registers (ddk768_context_t *pCtx)
 {
     unsigned char i = 0, j = 0;
 
@@ -477,7 +467,7 @@ void HDMI_Dump_Registers (void)
     {
         printk("Offset 0x%02x:  ", (i * 8));
         for (j = 0; j < 8; j++)
-            printk("%02x  ", readHDMIRegister((j + i * 8)));
+            printk("%02x  ", readHDMIRegister(pCtx, (j + i * 8)));
         printk("\n");
     }
 }
@@ -491,18 +481,18 @@ void HDMI_Dump_Registers (void)
 // Parameters   : unsigned char mode. 4 modes available.
 //                  MODE_A (sleep), MODE_B (register access), MODE_D (clock), MODE_E (active).
 //
-void HDMI_System_PD (unsigned char mode) 
+void HDMI_System_PD (ddk768_context_t *pCtx, unsigned char mode) 
 {
-    PowerMode = mode;
+    pCtx->hdmiPowerMode = mode;
 
     // PLL A/B Reset
-    if (PowerMode != PowerMode_A)
+    if (pCtx->hdmiPowerMode != PowerMode_A)
     {
-        writeHDMIControlRegister (mode | 0x0C);
+        writeHDMIControlRegister (pCtx, mode | 0x0C);
        	DelayMs(8);    // wait 8ms
     }
     // PLL A/B Release
-    writeHDMIControlRegister (mode);
+    writeHDMIControlRegister (pCtx, mode);
     DelayMs(10);    // wait 10ms
 
 
@@ -519,68 +509,72 @@ void HDMI_System_PD (unsigned char mode)
  *      None
  *
  */
-void HDMI_Init(void)
+void HDMI_Init(ddk768_context_t *pCtx)
 {
     unsigned char temp;
 
     // Enable HDMI clock
-     ddk768_enableHDMI(1);
+     ddk768_enableHDMI(pCtx, 1);
     
     // select channel 0 to HDMI by default
-    setHDMIChannel(0);
+    setHDMIChannel(pCtx, 0);
     
     // set INT polarity to Active High
-    temp = readHDMIControlRegister();
-    writeHDMIControlRegister (temp | 0x01);
+    temp = readHDMIControlRegister(pCtx);
+    writeHDMIControlRegister (pCtx, temp | 0x01);
     
     // Set AVMute to Sink
-    HDMI_Set_AVMute();
+    HDMI_Set_AVMute(pCtx);
     
     // Set to power mode B, in order to read/write to registers
-    HDMI_System_PD (PowerMode_B);
+    HDMI_System_PD (pCtx, PowerMode_B);
     DelayMs(1);
 
     // Setting AVI InfoFrame
-    writeHDMIRegister (X5F_PACKET_INDEX, AVI_INFO_PACKET); // Index.6 AVI InfoFrame
+    writeHDMIRegister (pCtx, X5F_PACKET_INDEX, AVI_INFO_PACKET); // Index.6 AVI InfoFrame
     // HB0 for generic control packet
-    writeHDMIRegister (X41_SEND_CPKT_AUTO, 0x10);
-    writeHDMIRegister (X60_PACKET_HB0, 0x82); // HB0
-    writeHDMIRegister (X61_PACKET_HB1, 0x02); // HB1
-    writeHDMIRegister (X62_PACKET_HB2, 0x0D); // HB2
-    writeHDMIRegister (X63_PACKET_PB0, 0x16); // PB0
-    writeHDMIRegister (X64_PACKET_PB1, 0x00); // PB1
-    writeHDMIRegister (X65_PACKET_PB2, 0x00); // PB2
-    writeHDMIRegister (X66_PACKET_PB3, 0x12); // PB3
-    writeHDMIRegister (X67_PACKET_PB4, 0x00); // PB4
-    writeHDMIRegister (X68_PACKET_PB5, 0x00); // PB5
-    writeHDMIRegister (X69_PACKET_PB6, 0xe4); // PB6
-    writeHDMIRegister (X6A_PACKET_PB7, 0xb5); // PB7
-    writeHDMIRegister (X6B_PACKET_PB8, 0x4e); // PB8
-    writeHDMIRegister (X6C_PACKET_PB9, 0x59); // PB9
-    writeHDMIRegister (X6D_PACKET_PB10, 0xd2); // PB10
-    writeHDMIRegister (X6E_PACKET_PB11, 0xeb); // PB11
-    writeHDMIRegister (X6F_PACKET_PB12, 0x18); // PB12
-    writeHDMIRegister (X70_PACKET_PB13, 0x1d); // PB13
+    writeHDMIRegister (pCtx, X41_SEND_CPKT_AUTO, 0x10);
+    writeHDMIRegister (pCtx, X60_PACKET_HB0, 0x82); // HB0
+    writeHDMIRegister (pCtx, X61_PACKET_HB1, 0x02); // HB1
+    writeHDMIRegister (pCtx, X62_PACKET_HB2, 0x0D); // HB2
+    writeHDMIRegister (pCtx, X63_PACKET_PB0, 0x16); // PB0
+    writeHDMIRegister (pCtx, X64_PACKET_PB1, 0x00); // PB1
+    writeHDMIRegister (pCtx, X65_PACKET_PB2, 0x00); // PB2
+    writeHDMIRegister (pCtx, X66_PACKET_PB3, 0x12); // PB3
+    writeHDMIRegister (pCtx, X67_PACKET_PB4, 0x00); // PB4
+    writeHDMIRegister (pCtx, X68_PACKET_PB5, 0x00); // PB5
+    writeHDMIRegister (pCtx, X69_PACKET_PB6, 0xe4); // PB6
+    writeHDMIRegister (pCtx, X6A_PACKET_PB7, 0xb5); // PB7
+    writeHDMIRegister (pCtx, X6B_PACKET_PB8, 0x4e); // PB8
+    writeHDMIRegister (pCtx, X6C_PACKET_PB9, 0x59); // PB9
+    writeHDMIRegister (pCtx, X6D_PACKET_PB10, 0xd2); // PB10
+    writeHDMIRegister (pCtx, X6E_PACKET_PB11, 0xeb); // PB11
+    writeHDMIRegister (pCtx, X6F_PACKET_PB12, 0x18); // PB12
+    writeHDMIRegister (pCtx, X70_PACKET_PB13, 0x1d); // PB13
 
     // Setting Audio InfoFrame
-    writeHDMIRegister (X5F_PACKET_INDEX, AUDIO_INFO_PACKET); // Index.8 Audio
-    writeHDMIRegister (X60_PACKET_HB0, 0x84); // HB0
-    writeHDMIRegister (X61_PACKET_HB1, 0x01); // HB1
-    writeHDMIRegister (X62_PACKET_HB2, 0x0A); // HB2
-    writeHDMIRegister (X63_PACKET_PB0, 0x70); // PB0
-    writeHDMIRegister (X64_PACKET_PB1, 0x01); // PB1
-    writeHDMIRegister (X65_PACKET_PB2, 0x00); // PB2
-    writeHDMIRegister (X66_PACKET_PB3, 0x00); // PB3
-    writeHDMIRegister (X67_PACKET_PB4, 0x00); // PB4
-    writeHDMIRegister (X68_PACKET_PB5, 0x00); // PB5
+    writeHDMIRegister (pCtx, X5F_PACKET_INDEX, AUDIO_INFO_PACKET); // Index.8 Audio
+    writeHDMIRegister (pCtx, X60_PACKET_HB0, 0x84); // HB0
+    writeHDMIRegister (pCtx, X61_PACKET_HB1, 0x01); // HB1
+    writeHDMIRegister (pCtx, X62_PACKET_HB2, 0x0A); // HB2
+    writeHDMIRegister (pCtx, X63_PACKET_PB0, 0x70); // PB0
+    writeHDMIRegister (pCtx, X64_PACKET_PB1, 0x01); // PB1
+    writeHDMIRegister (pCtx, X65_PACKET_PB2, 0x00); // PB2
+    writeHDMIRegister (pCtx, X66_PACKET_PB3, 0x00); // PB3
+    writeHDMIRegister (pCtx, X67_PACKET_PB4, 0x00); // PB4
+    writeHDMIRegister (pCtx, X68_PACKET_PB5, 0x00); // PB5
 
     // init DDC bus frequency
-    writeHDMIRegister (X81_ISRC2_PB0, 0x20);
-    writeHDMIRegister (X82_ISRC2_PB1, 0x00);
+    writeHDMIRegister (pCtx, X81_ISRC2_PB0, 0x20);
+    writeHDMIRegister (pCtx, X82_ISRC2_PB1, 0x00);
 
     // Unmask MSENS detect interrupt. Hot plug interrupt is enough for hot-plug
     // detection, we don't need to detect both at the same time.
     // writeHDMIRegister (X92_INT_MASK1, 0x80);
+
+    // Re-arm the hot plug interrupt if the driver had it enabled.
+    if (pCtx->hdmiHotplugInt)
+        HDMI_Enable_Hotplug_Interrupt(pCtx, 1);
 }
 
 
@@ -595,23 +589,23 @@ void HDMI_Init(void)
  *      None
  *
  */
-void HDMI_Unplugged (void)
+void HDMI_Unplugged (ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
     
     // disable video & audio output: write 11b to #45h[1:0]
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp | 0x03));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x03));
 
     // audio reset: write 1b to #45h[2], followed by 500us wait time
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp | 0x04));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x04));
     DelayMs(1);
 
     // PS mode e->d->b->a
-    HDMI_System_PD (PowerMode_D);
-    HDMI_System_PD (PowerMode_B);
-    HDMI_System_PD (PowerMode_A);
+    HDMI_System_PD (pCtx, PowerMode_D);
+    HDMI_System_PD (pCtx, PowerMode_B);
+    HDMI_System_PD (pCtx, PowerMode_A);
 }
 
 /*
@@ -628,22 +622,22 @@ void HDMI_Unplugged (void)
  *      None
  *
  */
-void HDMI_Audio_Reset (void)
+void HDMI_Audio_Reset (ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
     
-    if (PowerMode == PowerMode_E)
+    if (pCtx->hdmiPowerMode == PowerMode_E)
     {
         // Audio reset/release
         // Audio is mute after reset of audio is set.
         // Therefore, set it in the following procedures.
         //   Audio:  Save value of now => Audio Reset => Audio Active => Set value again
-        temp = readHDMIRegister(X45_VIDEO2);
-        writeHDMIRegister(X45_VIDEO2, temp | 0x06 );   // Reset
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
+        writeHDMIRegister(pCtx, X45_VIDEO2, temp | 0x06 );   // Reset
         DelayMs(1);                                    // Followed by 1ms wait time
-        writeHDMIRegister(X45_VIDEO2, temp & 0xFB );   // Reset Release and Audio Mute)
+        writeHDMIRegister(pCtx, X45_VIDEO2, temp & 0xFB );   // Reset Release and Audio Mute)
         DelayMs(1);                                    // Followed by 1ms wait time
-        writeHDMIRegister(X45_VIDEO2, temp );   // Reset Release and Audio Mute)
+        writeHDMIRegister(pCtx, X45_VIDEO2, temp );   // Reset Release and Audio Mute)
     }
 }
 
@@ -661,18 +655,18 @@ void HDMI_Audio_Reset (void)
  *      None
  *
  */
-void HDMI_Audio_Mute (void)
+void HDMI_Audio_Mute (ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
     
-    if (PowerMode == PowerMode_E)
+    if (pCtx->hdmiPowerMode == PowerMode_E)
     {
         // disable audio output: write 1b to #45h[1]
-        temp = readHDMIRegister(X45_VIDEO2);
-        writeHDMIRegister(X45_VIDEO2, (temp | 0x02));
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
+        writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x02));
     }
 
-	 AudioMode = Audio_Mute;
+	 pCtx->hdmiAudioMode = Audio_Mute;
 }
 
 /*
@@ -689,26 +683,26 @@ void HDMI_Audio_Mute (void)
  *      None
  *
  */
-void HDMI_Audio_Unmute (void)
+void HDMI_Audio_Unmute (ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
     
-    if (PowerMode == PowerMode_E)
+    if (pCtx->hdmiPowerMode == PowerMode_E)
     {
         // enable audio output: write 0b to #45h[1]
-        temp = readHDMIRegister(X45_VIDEO2);
-        writeHDMIRegister(X45_VIDEO2, (temp & (~0x02)));
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
+        writeHDMIRegister(pCtx, X45_VIDEO2, (temp & (~0x02)));
 
         // Audio reset/release
         // Audio is mute after reset of audio is set.
         // Therefore, set it in the following procedures.
         //   Audio:  Save value of now => Audio Reset => Audio Active => Set value again
-        temp = readHDMIRegister(X45_VIDEO2);
-        writeHDMIRegister(X45_VIDEO2, temp | 0x04 );   // Reset
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
+        writeHDMIRegister(pCtx, X45_VIDEO2, temp | 0x04 );   // Reset
         DelayMs(1);                                    // Followed by 1ms wait time
-        writeHDMIRegister(X45_VIDEO2, temp & (~0x04) );   // Reset Release and Audio Mute)
+        writeHDMIRegister(pCtx, X45_VIDEO2, temp & (~0x04) );   // Reset Release and Audio Mute)
     }
-	AudioMode = Audio_Unmute;
+	pCtx->hdmiAudioMode = Audio_Unmute;
 }
 
 
@@ -724,10 +718,10 @@ void HDMI_Audio_Unmute (void)
  *      None
  *
  */
-void HDMI_Control_Packet_Auto_Send (void)
+void HDMI_Control_Packet_Auto_Send (ddk768_context_t *pCtx)
 {
-    writeHDMIRegister (X42_AUTO_CHECKSUM, 0x01);    // enable auto checksum
-    writeHDMIRegister (X40_CTRL_PKT_EN, 0x00);
+    writeHDMIRegister (pCtx, X42_AUTO_CHECKSUM, 0x01);    // enable auto checksum
+    writeHDMIRegister (pCtx, X40_CTRL_PKT_EN, 0x00);
 }
 
 /*
@@ -744,7 +738,7 @@ void HDMI_Control_Packet_Auto_Send (void)
  *      None
  *
  */
-void HDMI_Audio_Setting_44100Hz (mode_parameter_t *pModeParam)
+void HDMI_Audio_Setting_44100Hz (ddk768_context_t *pCtx, mode_parameter_t *pModeParam)
 {
     unsigned long N = 6272, CTS = 0;    // default N value is 6272
     unsigned char regValue = 0;
@@ -763,44 +757,44 @@ void HDMI_Audio_Setting_44100Hz (mode_parameter_t *pModeParam)
 
     // set N and CTS into registers
     regValue = (unsigned char)((N >> 16) & 0x0F);
-    writeHDMIRegister(X01_N19_16, regValue);
+    writeHDMIRegister(pCtx, X01_N19_16, regValue);
     regValue = (unsigned char)(N >> 8);
-    writeHDMIRegister(X02_N15_8, regValue);
+    writeHDMIRegister(pCtx, X02_N15_8, regValue);
     regValue = (unsigned char)N;
-    writeHDMIRegister(X03_N7_0, regValue);
+    writeHDMIRegister(pCtx, X03_N7_0, regValue);
 
     regValue = (unsigned char)((CTS >> 16) & 0x0F);
-    writeHDMIRegister(X07_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X07_CTS_EXT, regValue);
     regValue = (unsigned char)(CTS >> 8);
-    writeHDMIRegister(X08_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X08_CTS_EXT, regValue);
     regValue = (unsigned char)CTS;
-    writeHDMIRegister(X09_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X09_CTS_EXT, regValue);
 
     // set audio setting registers
-    writeHDMIRegister(X0A_AUDIO_SOURCE, 0x80);      // external CTS
-    writeHDMIRegister(X0B_AUDIO_SET2, 0x40);
-    writeHDMIRegister(X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, 0x80);      // external CTS
+    writeHDMIRegister(pCtx, X0B_AUDIO_SET2, 0x40);
+    writeHDMIRegister(pCtx, X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
     //writeHDMIRegister(X0D_DSD_MODE, 0x00);      // DSD audio disabled
-    writeHDMIRegister(X10_I2S_PINMODE, 0x00);      // I2S input pin swap
-    writeHDMIRegister(X11_ASTATUS1, 0x0F);      // Original Fs = 44.1kHz
-    writeHDMIRegister(X12_ASTATUS2, 0x22);
-    writeHDMIRegister(X13_CAT_CODE, 0x00);
-    writeHDMIRegister(X14_A_SOURCE, 0x51);      // 24 bits word length 
+    writeHDMIRegister(pCtx, X10_I2S_PINMODE, 0x00);      // I2S input pin swap
+    writeHDMIRegister(pCtx, X11_ASTATUS1, 0x0F);      // Original Fs = 44.1kHz
+    writeHDMIRegister(pCtx, X12_ASTATUS2, 0x22);
+    writeHDMIRegister(pCtx, X13_CAT_CODE, 0x00);
+    writeHDMIRegister(pCtx, X14_A_SOURCE, 0x51);      // 24 bits word length 
     
-    regValue = (readHDMIRegister(X15_AVSET1) & 0x0F);       // set freq 44.1kHz
-    writeHDMIRegister(X15_AVSET1, regValue);
+    regValue = (readHDMIRegister(pCtx, X15_AVSET1) & 0x0F);       // set freq 44.1kHz
+    writeHDMIRegister(pCtx, X15_AVSET1, regValue);
 
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0x9F;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0x9F;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
     
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0xF7;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0xF7;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
     
 }
 
 
 
-void HDMI_Audio_Setting_48000Hz (mode_parameter_t *pModeParam)
+void HDMI_Audio_Setting_48000Hz (ddk768_context_t *pCtx, mode_parameter_t *pModeParam)
 {
     unsigned long N = 6144, CTS = 0;    // default N value is 6144
     unsigned char regValue = 0;
@@ -818,45 +812,45 @@ void HDMI_Audio_Setting_48000Hz (mode_parameter_t *pModeParam)
 
     // set N and CTS into registers
     regValue = (unsigned char)((N >> 16) & 0x0F);
-    writeHDMIRegister(X01_N19_16, regValue);
+    writeHDMIRegister(pCtx, X01_N19_16, regValue);
     regValue = (unsigned char)(N >> 8);
-    writeHDMIRegister(X02_N15_8, regValue);
+    writeHDMIRegister(pCtx, X02_N15_8, regValue);
     regValue = (unsigned char)N;
-    writeHDMIRegister(X03_N7_0, regValue);
+    writeHDMIRegister(pCtx, X03_N7_0, regValue);
 
     regValue = (unsigned char)((CTS >> 16) & 0x0F);
-    writeHDMIRegister(X07_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X07_CTS_EXT, regValue);
     regValue = (unsigned char)(CTS >> 8);
-    writeHDMIRegister(X08_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X08_CTS_EXT, regValue);
     regValue = (unsigned char)CTS;
-    writeHDMIRegister(X09_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X09_CTS_EXT, regValue);
 
     // set audio setting registers
-    writeHDMIRegister(X0A_AUDIO_SOURCE, 0x80);      // external CTS
-    writeHDMIRegister(X0B_AUDIO_SET2, 0x40);
-    writeHDMIRegister(X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, 0x80);      // external CTS
+    writeHDMIRegister(pCtx, X0B_AUDIO_SET2, 0x40);
+    writeHDMIRegister(pCtx, X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
     //writeHDMIRegister(X0D_DSD_MODE, 0x00);      // DSD audio disabled
-    writeHDMIRegister(X10_I2S_PINMODE, 0x00);      // I2S input pin swap
-    writeHDMIRegister(X11_ASTATUS1, 0x0D);      // Original Fs = 48kHz
-    writeHDMIRegister(X12_ASTATUS2, 0x22);
-    writeHDMIRegister(X13_CAT_CODE, 0x00);
-    writeHDMIRegister(X14_A_SOURCE, 0x51);      // 24 bits word length 
+    writeHDMIRegister(pCtx, X10_I2S_PINMODE, 0x00);      // I2S input pin swap
+    writeHDMIRegister(pCtx, X11_ASTATUS1, 0x0D);      // Original Fs = 48kHz
+    writeHDMIRegister(pCtx, X12_ASTATUS2, 0x22);
+    writeHDMIRegister(pCtx, X13_CAT_CODE, 0x00);
+    writeHDMIRegister(pCtx, X14_A_SOURCE, 0x51);      // 24 bits word length 
     
-    regValue = ((readHDMIRegister(X15_AVSET1) & 0x0F) | 0x20);       // set freq 48kHz
-    writeHDMIRegister(X15_AVSET1, regValue);
+    regValue = ((readHDMIRegister(pCtx, X15_AVSET1) & 0x0F) | 0x20);       // set freq 48kHz
+    writeHDMIRegister(pCtx, X15_AVSET1, regValue);
 
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0x9F;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0x9F;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
     
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0xF7;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0xF7;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
     
 }
 
 
 
 
-void HDMI_Audio_Setting_32000Hz (mode_parameter_t *pModeParam)
+void HDMI_Audio_Setting_32000Hz (ddk768_context_t *pCtx, mode_parameter_t *pModeParam)
 {
     unsigned long N = 4096, CTS = 0;    // default N value is 4096
     unsigned char regValue = 0;
@@ -870,46 +864,97 @@ void HDMI_Audio_Setting_32000Hz (mode_parameter_t *pModeParam)
     }
     
     // CTS = (fTMDS_clock x N) / (128 x fS)
-    CTS = ((pModeParam->pixel_clock / 1000) * N / 128) * 10 / 480;
+    CTS = ((pModeParam->pixel_clock / 1000) * N / 128) * 10 / 320;
 
     // set N and CTS into registers
     regValue = (unsigned char)((N >> 16) & 0x0F);
-    writeHDMIRegister(X01_N19_16, regValue);
+    writeHDMIRegister(pCtx, X01_N19_16, regValue);
     regValue = (unsigned char)(N >> 8);
-    writeHDMIRegister(X02_N15_8, regValue);
+    writeHDMIRegister(pCtx, X02_N15_8, regValue);
     regValue = (unsigned char)N;
-    writeHDMIRegister(X03_N7_0, regValue);
+    writeHDMIRegister(pCtx, X03_N7_0, regValue);
 
     regValue = (unsigned char)((CTS >> 16) & 0x0F);
-    writeHDMIRegister(X07_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X07_CTS_EXT, regValue);
     regValue = (unsigned char)(CTS >> 8);
-    writeHDMIRegister(X08_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X08_CTS_EXT, regValue);
     regValue = (unsigned char)CTS;
-    writeHDMIRegister(X09_CTS_EXT, regValue);
+    writeHDMIRegister(pCtx, X09_CTS_EXT, regValue);
 
     // set audio setting registers
-    writeHDMIRegister(X0A_AUDIO_SOURCE, 0x80);      // external CTS
-    writeHDMIRegister(X0B_AUDIO_SET2, 0x40);
-    writeHDMIRegister(X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, 0x80);      // external CTS
+    writeHDMIRegister(pCtx, X0B_AUDIO_SET2, 0x40);
+    writeHDMIRegister(pCtx, X0C_I2S_MODE, 0x04);      // I2S 2ch (0x3C for 8ch) + I2S
     //writeHDMIRegister(X0D_DSD_MODE, 0x00);      // DSD audio disabled
-    writeHDMIRegister(X10_I2S_PINMODE, 0x00);      // I2S input pin swap
-    writeHDMIRegister(X11_ASTATUS1, 0x0C);      // Original Fs = 32kHz
-    writeHDMIRegister(X12_ASTATUS2, 0x22);
-    writeHDMIRegister(X13_CAT_CODE, 0x00);
-    writeHDMIRegister(X14_A_SOURCE, 0x51);      // 24 bits word length 
+    writeHDMIRegister(pCtx, X10_I2S_PINMODE, 0x00);      // I2S input pin swap
+    writeHDMIRegister(pCtx, X11_ASTATUS1, 0x0C);      // Original Fs = 32kHz
+    writeHDMIRegister(pCtx, X12_ASTATUS2, 0x22);
+    writeHDMIRegister(pCtx, X13_CAT_CODE, 0x00);
+    writeHDMIRegister(pCtx, X14_A_SOURCE, 0x51);      // 24 bits word length 
     
-    regValue = (readHDMIRegister(X15_AVSET1) & 0x0F);       // set freq 44.1kHz
+    regValue = (readHDMIRegister(pCtx, X15_AVSET1) & 0x0F);       // set freq 44.1kHz
     regValue |= 0x30;                                                               // set freq 32kHz
-    writeHDMIRegister(X15_AVSET1, regValue);
+    writeHDMIRegister(pCtx, X15_AVSET1, regValue);
 
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0x9F;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0x9F;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // dounsampling none (bit 6:5 = 00)
     
-    regValue = readHDMIRegister(X0A_AUDIO_SOURCE) & 0xF7;
-    writeHDMIRegister(X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
+    regValue = readHDMIRegister(pCtx, X0A_AUDIO_SOURCE) & 0xF7;
+    writeHDMIRegister(pCtx, X0A_AUDIO_SOURCE, regValue);      // disable SPDIF
     
 }
 
+/*
+ * Audio clock regeneration for the rate of the I2S stream, or for the
+ * default rate of the crystal when no stream has picked one.
+ */
+static void HDMI_Audio_Setting (ddk768_context_t *pCtx, mode_parameter_t *pModeParam)
+{
+    switch (pCtx->hdmiAudioRate)
+    {
+        case 32000:
+            HDMI_Audio_Setting_32000Hz(pCtx, pModeParam);
+            break;
+        case 44100:
+            HDMI_Audio_Setting_44100Hz(pCtx, pModeParam);
+            break;
+        case 48000:
+            HDMI_Audio_Setting_48000Hz(pCtx, pModeParam);
+            break;
+        default:
+            if (ddk768_getCrystalType(pCtx))
+                HDMI_Audio_Setting_48000Hz(pCtx, pModeParam);
+            else
+                HDMI_Audio_Setting_44100Hz(pCtx, pModeParam);
+    }
+}
+
+/*
+ *  Function:
+ *      HDMI_Audio_Set_Rate
+ *
+ *  Input:
+ *      sampleRate - 32000, 44100 or 48000, 0 for the crystal's default
+ *
+ *  Output:
+ *      None
+ *
+ *  Return:
+ *      None
+ *
+ *  The N/CTS pair is reprogrammed right away if a mode is set, and kept
+ *  for the next modes.
+ */
+void HDMI_Audio_Set_Rate (ddk768_context_t *pCtx, unsigned long sampleRate)
+{
+    if (pCtx->hdmiAudioRate == sampleRate)
+        return;
+
+    pCtx->hdmiAudioRate = sampleRate;
+    if (pCtx->hdmiModeParam.pixel_clock)
+        HDMI_Audio_Setting(pCtx, &pCtx->hdmiModeParam);
+}
+
 
 /*
  *  Function:
@@ -926,13 +971,13 @@ void HDMI_Audio_Setting_32000Hz (mode_parameter_t *pModeParam)
  *      None
  *
  */
-void HDMI_Video_Setting (mode_parameter_t *pModeParam, bool isHDMI)
+void HDMI_Video_Setting (ddk768_context_t *pCtx, mode_parameter_t *pModeParam, bool isHDMI)
 {
     unsigned long temp = 0;
     unsigned char regValue = 0;
 
     // video set timing
-    regValue = readHDMIRegister(X30_EXT_VPARAMS);
+    regValue = readHDMIRegister(pCtx, X30_EXT_VPARAMS);
     regValue &= 0xF2;
     regValue = 
         (pModeParam->vertical_sync_polarity == POS
@@ -942,63 +987,63 @@ void HDMI_Video_Setting (mode_parameter_t *pModeParam, bool isHDMI)
         ? FIELD_SET(regValue, X30_EXT_VPARAMS, HSYNC_PHASE, POS)
         : FIELD_SET(regValue, X30_EXT_VPARAMS, HSYNC_PHASE, NEG))
         | FIELD_SET(regValue, X30_EXT_VPARAMS, USE, EXTERNAL);
-    writeHDMIRegister(X30_EXT_VPARAMS, regValue);
+    writeHDMIRegister(pCtx, X30_EXT_VPARAMS, regValue);
 
-    writeHDMIRegister(X31_EXT_HTOTAL, (pModeParam->horizontal_total & 0xFF));   // horizontal total
-    writeHDMIRegister(X32_EXT_HTOTAL, (pModeParam->horizontal_total & 0xFF00)>>8);
+    writeHDMIRegister(pCtx, X31_EXT_HTOTAL, (pModeParam->horizontal_total & 0xFF));   // horizontal total
+    writeHDMIRegister(pCtx, X32_EXT_HTOTAL, (pModeParam->horizontal_total & 0xFF00)>>8);
 
     temp = pModeParam->horizontal_total - pModeParam->horizontal_display_end;   // horizontal blanking
-    writeHDMIRegister(X33_EXT_HBLANK, (temp & 0xFF));
-    writeHDMIRegister(X34_EXT_HBLANK, (temp & 0xFF00)>>8);
+    writeHDMIRegister(pCtx, X33_EXT_HBLANK, (temp & 0xFF));
+    writeHDMIRegister(pCtx, X34_EXT_HBLANK, (temp & 0xFF00)>>8);
 
     temp = pModeParam->horizontal_total - pModeParam->horizontal_sync_start;    // horizontal delay
-    writeHDMIRegister(X35_EXT_HDLY, (temp & 0xFF));
-    writeHDMIRegister(X36_EXT_HDLY, (temp & 0xFF00)>>8);
+    writeHDMIRegister(pCtx, X35_EXT_HDLY, (temp & 0xFF));
+    writeHDMIRegister(pCtx, X36_EXT_HDLY, (temp & 0xFF00)>>8);
 
-    writeHDMIRegister(X37_EXT_HS_DUR, (pModeParam->horizontal_sync_width & 0xFF));  // horizontal duration
-    writeHDMIRegister(X38_EXT_HS_DUR, (pModeParam->horizontal_sync_width & 0xFF00)>>8);
+    writeHDMIRegister(pCtx, X37_EXT_HS_DUR, (pModeParam->horizontal_sync_width & 0xFF));  // horizontal duration
+    writeHDMIRegister(pCtx, X38_EXT_HS_DUR, (pModeParam->horizontal_sync_width & 0xFF00)>>8);
 
-    writeHDMIRegister(X39_EXT_VTOTAL, (pModeParam->vertical_total & 0xFF)); // vertical total
-    writeHDMIRegister(X3A_EXT_VTOTAL, (pModeParam->vertical_total & 0xFF00)>>8);
+    writeHDMIRegister(pCtx, X39_EXT_VTOTAL, (pModeParam->vertical_total & 0xFF)); // vertical total
+    writeHDMIRegister(pCtx, X3A_EXT_VTOTAL, (pModeParam->vertical_total & 0xFF00)>>8);
 
     temp = pModeParam->vertical_total - pModeParam->vertical_display_end;   // vertical blanking
-    writeHDMIRegister(X3D_EXT_VBLANK, temp);
+    writeHDMIRegister(pCtx, X3D_EXT_VBLANK, temp);
 
     temp = pModeParam->vertical_total - pModeParam->vertical_sync_start;   // vertical delay
-    writeHDMIRegister(X3E_EXT_VDLY, temp);
+    writeHDMIRegister(pCtx, X3E_EXT_VDLY, temp);
 
-    writeHDMIRegister(X3F_EXT_VS_DUR, pModeParam->vertical_sync_height);    // vertical duration
+    writeHDMIRegister(pCtx, X3F_EXT_VS_DUR, pModeParam->vertical_sync_height);    // vertical duration
 
     // video set color - deep_color_8bit
-    regValue = readHDMIRegister(X17_DC_REG);
+    regValue = readHDMIRegister(pCtx, X17_DC_REG);
     regValue = (regValue & 0x3F) | 0x00;
-    writeHDMIRegister(X17_DC_REG, regValue);
+    writeHDMIRegister(pCtx, X17_DC_REG, regValue);
     
-    writeHDMIRegister(X16_VIDEO1, 0x30);
+    writeHDMIRegister(pCtx, X16_VIDEO1, 0x30);
 
     // video set format
-    regValue = (readHDMIRegister(X15_AVSET1) & 0xF0);
+    regValue = (readHDMIRegister(pCtx, X15_AVSET1) & 0xF0);
     regValue |= 0x01;       // set RGB & external DE
-    writeHDMIRegister(X15_AVSET1, regValue);
-    writeHDMIRegister(X3B_AVSET2, 0x40);
+    writeHDMIRegister(pCtx, X15_AVSET1, regValue);
+    writeHDMIRegister(pCtx, X3B_AVSET2, 0x40);
     //writeHDMIRegister(X40_CTRL_PKT_EN, 0x00);
     //writeHDMIRegister(X45_VIDEO2, 0x83);
-    writeHDMIRegister(X46_OUTPUT_OPTION, 0x04);
-    writeHDMIRegister(XD3_CSC_CONFIG1, 0x01);
+    writeHDMIRegister(pCtx, X46_OUTPUT_OPTION, 0x04);
+    writeHDMIRegister(pCtx, XD3_CSC_CONFIG1, 0x01);
 
     // video set output - setting to HDMI/DVI mode
-    regValue = readHDMIRegister(XAF_HDCP_CTRL);
+    regValue = readHDMIRegister(pCtx, XAF_HDCP_CTRL);
     if (isHDMI)
-        writeHDMIRegister(XAF_HDCP_CTRL, (regValue | 0x02));
+        writeHDMIRegister(pCtx, XAF_HDCP_CTRL, (regValue | 0x02));
     else
-        writeHDMIRegister(XAF_HDCP_CTRL, (regValue & 0xFD));
+        writeHDMIRegister(pCtx, XAF_HDCP_CTRL, (regValue & 0xFD));
 
     // set DDC bus access frequency control register based on pixel clock value (400kHz is preferred)
     // At mode_d/mode_e: 
     // DDC Bus access frequency = TDMS_CK input clock frequency / (register value) / 4
     temp = pModeParam ->pixel_clock / 4 / 400000;
-    writeHDMIRegister(X81_ISRC2_PB0, (temp & 0xFF));    // LSB
-    writeHDMIRegister(X82_ISRC2_PB1, (temp & 0xFF00)>>8);   // MSB
+    writeHDMIRegister(pCtx, X81_ISRC2_PB0, (temp & 0xFF));    // LSB
+    writeHDMIRegister(pCtx, X82_ISRC2_PB1, (temp & 0xFF00)>>8);   // MSB
     
 }
 
@@ -1017,7 +1062,7 @@ void HDMI_Video_Setting (mode_parameter_t *pModeParam, bool isHDMI)
  *      -1 - Error 
  *
  */
-long HDMI_PHY_Setting (mode_parameter_t *pModeParam)
+long HDMI_PHY_Setting (ddk768_context_t *pCtx, mode_parameter_t *pModeParam)
 {
     unsigned long clkIndex;
     hdmi_PHY_param_t *pPHYParamTable;
@@ -1056,16 +1101,16 @@ long HDMI_PHY_Setting (mode_parameter_t *pModeParam)
     pPHYParamTable = (hdmi_PHY_param_t *)gHdmiPHYParamTable;
     
     // load PHY parameters into registers
-    writeHdmiPHYRegister(X57_PHY_CTRL, pPHYParamTable[clkIndex].X57_PHY_value);
-    writeHdmiPHYRegister(X58_PHY_CTRL, pPHYParamTable[clkIndex].X58_PHY_value);
-    writeHdmiPHYRegister(X59_PHY_CTRL, pPHYParamTable[clkIndex].X59_PHY_value);
-    writeHdmiPHYRegister(X5A_PHY_CTRL, pPHYParamTable[clkIndex].X5A_PHY_value);
-    writeHdmiPHYRegister(X5B_PHY_CTRL, pPHYParamTable[clkIndex].X5B_PHY_value);
-    writeHdmiPHYRegister(X5C_PHY_CTRL, pPHYParamTable[clkIndex].X5C_PHY_value);
-    writeHdmiPHYRegister(X5D_PHY_CTRL, pPHYParamTable[clkIndex].X5D_PHY_value);
-    writeHdmiPHYRegister(X5E_PHY_CTRL, pPHYParamTable[clkIndex].X5E_PHY_value);
-    writeHdmiPHYRegister(X56_PHY_CTRL, pPHYParamTable[clkIndex].X56_PHY_value);
-    writeHdmiPHYRegister(X17_DC_REG, pPHYParamTable[clkIndex].X17_PHY_value);
+    writeHdmiPHYRegister(pCtx, X57_PHY_CTRL, pPHYParamTable[clkIndex].X57_PHY_value);
+    writeHdmiPHYRegister(pCtx, X58_PHY_CTRL, pPHYParamTable[clkIndex].X58_PHY_value);
+    writeHdmiPHYRegister(pCtx, X59_PHY_CTRL, pPHYParamTable[clkIndex].X59_PHY_value);
+    writeHdmiPHYRegister(pCtx, X5A_PHY_CTRL, pPHYParamTable[clkIndex].X5A_PHY_value);
+    writeHdmiPHYRegister(pCtx, X5B_PHY_CTRL, pPHYParamTable[clkIndex].X5B_PHY_value);
+    writeHdmiPHYRegister(pCtx, X5C_PHY_CTRL, pPHYParamTable[clkIndex].X5C_PHY_value);
+    writeHdmiPHYRegister(pCtx, X5D_PHY_CTRL, pPHYParamTable[clkIndex].X5D_PHY_value);
+    writeHdmiPHYRegister(pCtx, X5E_PHY_CTRL, pPHYParamTable[clkIndex].X5E_PHY_value);
+    writeHdmiPHYRegister(pCtx, X56_PHY_CTRL, pPHYParamTable[clkIndex].X56_PHY_value);
+    writeHdmiPHYRegister(pCtx, X17_DC_REG, pPHYParamTable[clkIndex].X17_PHY_value);
     
     return 0;
 }
@@ -1086,16 +1131,16 @@ long HDMI_PHY_Setting (mode_parameter_t *pModeParam)
  *      -1 - Error 
  *
  */
-long HDMI_Set_Mode (logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, bool isHDMI)
+long HDMI_Set_Mode (ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, bool isHDMI)
 {
     
     unsigned char temp = 0;
     unsigned long ret = 0;
     hdmi_vic_param_t *PBTable;
     // set mode b
-    if (PowerMode != PowerMode_B)
+    if (pCtx->hdmiPowerMode != PowerMode_B)
     {
-        HDMI_System_PD (PowerMode_B);
+        HDMI_System_PD (pCtx, PowerMode_B);
     }
 
 	if (!pLogicalMode->valid_edid)
@@ -1110,95 +1155,93 @@ long HDMI_Set_Mode (logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, b
     if((pLogicalMode->x == 3840) && (pLogicalMode->y == 2160))
     {        
         /* Write 4K specail vic parameters.*/
-        writeHDMIRegister (X5F_PACKET_INDEX, VENDOR_INFO_PACKET); 
-        writeHDMIRegister (X60_PACKET_HB0, 0x81); // HB0 0x82
-        writeHDMIRegister (X61_PACKET_HB1, 0x01); // HB1 0x02
-        writeHDMIRegister (X62_PACKET_HB2, 0x07); // HB2 0x0D
-        writeHDMIRegister (X64_PACKET_PB1, 0x03); // PB1 0x00
-        writeHDMIRegister (X65_PACKET_PB2, 0x0C); // PB2 0x00
-        writeHDMIRegister (X66_PACKET_PB3, 0x00); // PB3 0x12
-        writeHDMIRegister (X67_PACKET_PB4, 0x20); // PB4
-        writeHDMIRegister (X68_PACKET_PB5, 0x01); // PB5 0x00
-        writeHDMIRegister (X69_PACKET_PB6, 0x00); // PB6 0xe4
-        writeHDMIRegister (X6A_PACKET_PB7, 0x00); // PB7 0xb5
+        writeHDMIRegister (pCtx, X5F_PACKET_INDEX, VENDOR_INFO_PACKET); 
+        writeHDMIRegister (pCtx, X60_PACKET_HB0, 0x81); // HB0 0x82
+        writeHDMIRegister (pCtx, X61_PACKET_HB1, 0x01); // HB1 0x02
+        writeHDMIRegister (pCtx, X62_PACKET_HB2, 0x07); // HB2 0x0D
+        writeHDMIRegister (pCtx, X64_PACKET_PB1, 0x03); // PB1 0x00
+        writeHDMIRegister (pCtx, X65_PACKET_PB2, 0x0C); // PB2 0x00
+        writeHDMIRegister (pCtx, X66_PACKET_PB3, 0x00); // PB3 0x12
+        writeHDMIRegister (pCtx, X67_PACKET_PB4, 0x20); // PB4
+        writeHDMIRegister (pCtx, X68_PACKET_PB5, 0x01); // PB5 0x00
+        writeHDMIRegister (pCtx, X69_PACKET_PB6, 0x00); // PB6 0xe4
+        writeHDMIRegister (pCtx, X6A_PACKET_PB7, 0x00); // PB7 0xb5
     }
     else
     {
         PBTable = FindVicParam(pLogicalMode->x, pLogicalMode->y);
-        writeHDMIRegister (X5F_PACKET_INDEX, AVI_INFO_PACKET); 
-        writeHDMIRegister (X67_PACKET_PB4, PBTable->Vic);
+        writeHDMIRegister (pCtx, X5F_PACKET_INDEX, AVI_INFO_PACKET); 
+        writeHDMIRegister (pCtx, X67_PACKET_PB4, PBTable->Vic);
 
 	    /* For un-4k mode, the following registers should be re-write.*/
-	    writeHDMIRegister (X60_PACKET_HB0, 0x82); // HB0
-	    writeHDMIRegister (X61_PACKET_HB1, 0x02); // HB1
-	    writeHDMIRegister (X62_PACKET_HB2, 0x0D); // HB2 
-	    writeHDMIRegister (X64_PACKET_PB1, 0x00); //0x18); // PB1
-	    writeHDMIRegister (X65_PACKET_PB2, PBTable->PB2); //0xc8); // PB2
-	    writeHDMIRegister (X66_PACKET_PB3, 0x12); // PB3
-	    writeHDMIRegister (X68_PACKET_PB5, 0x00); // PB5
-	    writeHDMIRegister (X69_PACKET_PB6, 0xe4); // PB6
-	    writeHDMIRegister (X6A_PACKET_PB7, 0xb5); // PB7
+	    writeHDMIRegister (pCtx, X60_PACKET_HB0, 0x82); // HB0
+	    writeHDMIRegister (pCtx, X61_PACKET_HB1, 0x02); // HB1
+	    writeHDMIRegister (pCtx, X62_PACKET_HB2, 0x0D); // HB2 
+	    writeHDMIRegister (pCtx, X64_PACKET_PB1, 0x00); //0x18); // PB1
+	    writeHDMIRegister (pCtx, X65_PACKET_PB2, PBTable->PB2); //0xc8); // PB2
+	    writeHDMIRegister (pCtx, X66_PACKET_PB3, 0x12); // PB3
+	    writeHDMIRegister (pCtx, X68_PACKET_PB5, 0x00); // PB5
+	    writeHDMIRegister (pCtx, X69_PACKET_PB6, 0xe4); // PB6
+	    writeHDMIRegister (pCtx, X6A_PACKET_PB7, 0xb5); // PB7
         
     }
     // Index.8 Audio
-    writeHDMIRegister(X5F_PACKET_INDEX, AUDIO_INFO_PACKET); 
+    writeHDMIRegister(pCtx, X5F_PACKET_INDEX, AUDIO_INFO_PACKET); 
     
     // set video param
-    HDMI_Video_Setting(pModeParam, isHDMI);
+    HDMI_Video_Setting(pCtx, pModeParam, isHDMI);
 
     // set audio param
-	if (ddk768_getCrystalType())
-    	HDMI_Audio_Setting_48000Hz(pModeParam);
-	else
-		HDMI_Audio_Setting_44100Hz(pModeParam);
+    pCtx->hdmiModeParam = *pModeParam;
+    HDMI_Audio_Setting(pCtx, pModeParam);
     
     // control packet auto send
-    HDMI_Control_Packet_Auto_Send();
+    HDMI_Control_Packet_Auto_Send(pCtx);
 
     // set PHY param
-    ret = HDMI_PHY_Setting(pModeParam);
+    ret = HDMI_PHY_Setting(pCtx, pModeParam);
     if (ret != 0)
     {
         return ret;
     }
 
     // disable video & audio output: write 11b to #45h[1:0]
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp | 0x03));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x03));
 
     // set Channel # to HDMI
-    setHDMIChannel((unsigned char)pLogicalMode->dispCtrl);
+    setHDMIChannel(pCtx, (unsigned char)pLogicalMode->dispCtrl);
     
     // mode b->d: (0x4d, 100us) -> (0x49, 100us) -> 0x41
-    PowerMode = PowerMode_D;
-    writeHDMIControlRegister (PowerMode | 0x0C);
+    pCtx->hdmiPowerMode = PowerMode_D;
+    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode | 0x0C);
     DelayMs (1);
-    writeHDMIControlRegister (PowerMode | 0x08);
+    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode | 0x08);
     DelayMs (1);
-    writeHDMIControlRegister (PowerMode);
+    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode);
     DelayMs (1);
 
     // mode d->e: 0x81
     //HDMI_System_PD (PowerMode_E);
-    PowerMode = PowerMode_E;
-    writeHDMIControlRegister (PowerMode);
+    pCtx->hdmiPowerMode = PowerMode_E;
+    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode);
     DelayMs(10);    // wait 10ms
 
-    if (AudioMode)
+    if (pCtx->hdmiAudioMode)
     {
         // enable video & audio output: write 00b to #45h[1:0]
-        temp = readHDMIRegister(X45_VIDEO2);
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
         temp &= 0xFB;
-        writeHDMIRegister(X45_VIDEO2, (temp & 0xFC));
+        writeHDMIRegister(pCtx, X45_VIDEO2, (temp & 0xFC));
         
-		HDMI_Audio_Reset();
+		HDMI_Audio_Reset(pCtx);
 
     }
     else
     {
         // enable video output: write 0b to #45h[0]
-        temp = readHDMIRegister(X45_VIDEO2);
-        writeHDMIRegister(X45_VIDEO2, (temp & (~0x01)));
+        temp = readHDMIRegister(pCtx, X45_VIDEO2);
+        writeHDMIRegister(pCtx, X45_VIDEO2, (temp & (~0x01)));
     }
 
 
@@ -1208,39 +1251,39 @@ long HDMI_Set_Mode (logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, b
     
     return 0;
 }
-void HDMI_Enable_Output(void)
+void HDMI_Enable_Output(ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
 
-	if (PowerMode == PowerMode_E)
+	if (pCtx->hdmiPowerMode == PowerMode_E)
 		return;
 
-	if (PowerMode == PowerMode_B){
+	if (pCtx->hdmiPowerMode == PowerMode_B){
 	    // mode b->d: (0x4d, 100us) -> (0x49, 100us) -> 0x41
-	    PowerMode = PowerMode_D;
-	    writeHDMIControlRegister (PowerMode | 0x0C);
+	    pCtx->hdmiPowerMode = PowerMode_D;
+	    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode | 0x0C);
 	    DelayMs (1);
-	    writeHDMIControlRegister (PowerMode | 0x08);
+	    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode | 0x08);
 	    DelayMs (1);
-	    writeHDMIControlRegister (PowerMode);
+	    writeHDMIControlRegister (pCtx, pCtx->hdmiPowerMode);
 	    DelayMs (1);
 
 	    // mode d->e: 0x81
-	    HDMI_System_PD (PowerMode_E);
+	    HDMI_System_PD (pCtx, PowerMode_E);
 	}
 
     // enable video & audio output: write 00b to #45h[1:0]
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp & (~0x03)));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp & (~0x03)));
     
     // Audio reset/release
     // Audio is mute after reset of audio is set.
     // Therefore, set it in the following procedures.
     //   Audio:  Save value of now => Audio Reset => Audio Active => Set value again
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, temp | 0x04 );   // Reset
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, temp | 0x04 );   // Reset
     DelayMs(1);                                    // Followed by 1ms wait time
-    writeHDMIRegister(X45_VIDEO2, temp & 0xFB );   // Reset Release and Audio Mute)
+    writeHDMIRegister(pCtx, X45_VIDEO2, temp & 0xFB );   // Reset Release and Audio Mute)
 
 #if 0   // for debug only
     HDMI_Dump_Registers();
@@ -1264,22 +1307,22 @@ void HDMI_Enable_Output(void)
  *      None
  *
  */
-void HDMI_Disable_Output (void)
+void HDMI_Disable_Output (ddk768_context_t *pCtx)
 {
     unsigned char temp = 0;
     
     // disable video & audio output: write 11b to #45h[1:0]
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp | 0x03));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x03));
 
     // audio reset: write 1b to #45h[2], followed by 500us wait time
-    temp = readHDMIRegister(X45_VIDEO2);
-    writeHDMIRegister(X45_VIDEO2, (temp | 0x04));
+    temp = readHDMIRegister(pCtx, X45_VIDEO2);
+    writeHDMIRegister(pCtx, X45_VIDEO2, (temp | 0x04));
     DelayMs(1);
 
     // PS mode e->d->b
-    HDMI_System_PD (PowerMode_D);
-    HDMI_System_PD (PowerMode_B);
+    HDMI_System_PD (pCtx, PowerMode_D);
+    HDMI_System_PD (pCtx, PowerMode_B);
 }
 
 
@@ -1295,7 +1338,7 @@ void HDMI_Disable_Output (void)
  *      Fisrt byte of HDMI EDID FIFO
  *
  */
-unsigned char HDMI_Edid_ReadFirstByte(void)
+unsigned char HDMI_Edid_ReadFirstByte(ddk768_context_t *pCtx)
 {
     unsigned long value;
 
@@ -1347,14 +1390,14 @@ BYTE HDMI_Edid_CheckSum (BYTE* array, unsigned long size)
  *      0 - exist block0 EDID (128 Bytes)
  *      1 - exist block0 & block1 EDID (256 Bytes)
  */
-long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
+long HDMI_Read_Edid(ddk768_context_t *pCtx, BYTE *pEDIDBuffer, unsigned long bufferSize)
 {
     BYTE byEDID_current = 0;
     BYTE byEDID_size = 0;
     BYTE byEDID_finish = 0;
     #define EDID_WORD   ((byEDID_current % 2) ? 0x80 : 0x00)
     #define EDID_SEG    (byEDID_current /2)
-    #define EDID_EXT    (gEdidBuffer[126])
+    #define EDID_EXT    (pCtx->hdmiEdidBuffer[126])
     
     BYTE byChecksum = 0, regValue;
     unsigned long i = 0;
@@ -1367,26 +1410,26 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
     }
     
     // PS mode a -> b if current power mode is in PS mode a
-    if (PowerMode == PowerMode_A)
+    if (pCtx->hdmiPowerMode == PowerMode_A)
     {
-        HDMI_System_PD (PowerMode_B);
+        HDMI_System_PD (pCtx, PowerMode_B);
     }
 
     // clear interrupt status before reading EDID
-    writeHDMIRegister (X94_INT1_ST, 0xFF);
-    writeHDMIRegister (X95_INT2_ST, 0xFF);
+    writeHDMIRegister (pCtx, X94_INT1_ST, 0xFF);
+    writeHDMIRegister (pCtx, X95_INT2_ST, 0xFF);
 
     // Enable EDID interrupt
-    regValue = readHDMIRegister (X92_INT_MASK1);
-    writeHDMIRegister (X92_INT_MASK1, (regValue | 0x06));
+    regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+    writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue | 0x06));
 
     while(byEDID_finish == 0)
     {			
     	// Set EDID word address (set to 00h for the first 128 bytes)
-    	writeHDMIRegister (XC5_EDID_WD_ADDR, EDID_WORD);	
+    	writeHDMIRegister (pCtx, XC5_EDID_WD_ADDR, EDID_WORD);	
     	// Set EDID segment pointer 0
     	// (Regsiter write to XC4_SEG_PTR will start EDID reading)
-    	writeHDMIRegister (XC4_SEG_PTR, EDID_SEG);
+    	writeHDMIRegister (pCtx, XC4_SEG_PTR, EDID_SEG);
         
     	/* Hook the interrupt before going to the while */ 
         //hookHDMIInterrupt(HdmiHandler);
@@ -1396,35 +1439,35 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
     	{		
             retry--;
 
-            g_INT_94h = readHDMIRegister (X94_INT1_ST);
-            g_INT_95h = readHDMIRegister (X95_INT2_ST);	
+            pCtx->hdmiInt94h = readHDMIRegister (pCtx, X94_INT1_ST);
+            pCtx->hdmiInt95h = readHDMIRegister (pCtx, X95_INT2_ST);	
 
             // EDID ERR interrupt, or EDID not ready
-            if ((g_INT_94h & EDID_ERR))
+            if ((pCtx->hdmiInt94h & EDID_ERR))
             {
                 // clear error interrupt 
-                writeHDMIRegister (X94_INT1_ST, 0xFF);
-                writeHDMIRegister (X95_INT2_ST, 0xFF);
+                writeHDMIRegister (pCtx, X94_INT1_ST, 0xFF);
+                writeHDMIRegister (pCtx, X95_INT2_ST, 0xFF);
                 DelayMs(1);
             }
-            else if (g_INT_94h & EDID_RDY)
+            else if (pCtx->hdmiInt94h & EDID_RDY)
             {		
                 // clear ready interrupt 
-                writeHDMIRegister (X94_INT1_ST, 0xFF);
-                writeHDMIRegister (X95_INT2_ST, 0xFF);
+                writeHDMIRegister (pCtx, X94_INT1_ST, 0xFF);
+                writeHDMIRegister (pCtx, X95_INT2_ST, 0xFF);
                 
                 // Read EDID for current block (128bytes)         
-                gEdidBuffer[byEDID_current* 0x80] = HDMI_Edid_ReadFirstByte();
+                pCtx->hdmiEdidBuffer[byEDID_current* 0x80] = HDMI_Edid_ReadFirstByte(pCtx);
                 
                 for(i=1;i<128;i++)
                 {
-                    gEdidBuffer[byEDID_current* 0x80+i] = readHDMIRegister(X80_EDID);
+                    pCtx->hdmiEdidBuffer[byEDID_current* 0x80+i] = readHDMIRegister(pCtx, X80_EDID);
                     DelayMs(1);
                 }
                 printk("EDID read finish\n");
                 
                 // Calculate EDID data byChecksum 
-                byChecksum = HDMI_Edid_CheckSum(gEdidBuffer + (byEDID_current * 0x80), 128);                     
+                byChecksum = HDMI_Edid_CheckSum(pCtx->hdmiEdidBuffer + (byEDID_current * 0x80), 128);                     
               //  printf("checksum = %x\n", byChecksum);
                 
                 if (byChecksum != 0)
@@ -1434,23 +1477,23 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
                     if (byEDID_current == 0)
                     {
                         // Disable EDID interrupt
-                        regValue = readHDMIRegister (X92_INT_MASK1);
-                        writeHDMIRegister (X92_INT_MASK1, (regValue & (~0x06)));
+                        regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+                        writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue & (~0x06)));
 
                         return (-1);
                     }
                     else
                     {
                         // Disable EDID interrupt
-                        regValue = readHDMIRegister (X92_INT_MASK1);
-                        writeHDMIRegister (X92_INT_MASK1, (regValue & (~0x06)));
+                        regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+                        writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue & (~0x06)));
 
                      //   DDKDEBUGPRINT((DISPLAY_LEVEL, "Return the first 128 bytes only.\n"));
                         // Copy 128 bytes data to the given buffer
                         for (i = 0; i < 128; i++)
                         {
                           //  printf("%x ", gEdidBuffer[i]);
-                            pEDIDBuffer[i] = gEdidBuffer[i];
+                            pEDIDBuffer[i] = pCtx->hdmiEdidBuffer[i];
                         }
                         printk("\n");
                         
@@ -1487,8 +1530,8 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
         {
             printk("Read HDMI EDID fail.\n");
             // Disable EDID interrupt
-            regValue = readHDMIRegister (X92_INT_MASK1);
-            writeHDMIRegister (X92_INT_MASK1, (regValue & (~0x06)));
+            regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+            writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue & (~0x06)));
             
             return (-1);
         }
@@ -1497,13 +1540,13 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
     }
                    	
     // Disable EDID interrupt
-    regValue = readHDMIRegister (X92_INT_MASK1);
-    writeHDMIRegister (X92_INT_MASK1, (regValue & (~0x06)));
+    regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+    writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue & (~0x06)));
 
     // Copy data to the given buffer
     for (i = 0; i < bufferSize; i++)
     {
-        pEDIDBuffer[i] = gEdidBuffer[i];
+        pEDIDBuffer[i] = pCtx->hdmiEdidBuffer[i];
     }
 
 #if 0   // for debug only
@@ -1533,6 +1576,115 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
     return byEDID_current;
 }
 
+/*
+ *  Function:
+ *      HDMI_Edid_Start_Block
+ *      Start the EDID engine on one 128-byte block. The engine signals
+ *      EDID_RDY or EDID_ERR in X94_INT1_ST (and raises the HDMI interrupt)
+ *      when it is done, see HDMI_Edid_Status.
+ *
+ *  Input:
+ *      block - EDID block number. Blocks 2 and up are read through the
+ *              E-DDC segment pointer (segment = block / 2).
+ *
+ *  Output:
+ *      None
+ *
+ */
+void HDMI_Edid_Start_Block (ddk768_context_t *pCtx, unsigned int block)
+{
+    unsigned char regValue;
+
+    // PS mode a -> b if current power mode is in PS mode a
+    if (pCtx->hdmiPowerMode == PowerMode_A)
+    {
+        HDMI_System_PD (pCtx, PowerMode_B);
+    }
+
+    // clear the EDID status of a previous read, leave hot plug alone
+    writeHDMIRegister (pCtx, X94_INT1_ST, EDID_RDY | EDID_ERR);
+
+    // Enable EDID interrupt
+    regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+    if ((regValue & (EDID_RDY | EDID_ERR)) != (EDID_RDY | EDID_ERR))
+        writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue | EDID_RDY | EDID_ERR));
+
+    // Set EDID word address (00h for even blocks, 80h for odd blocks)
+    writeHDMIRegister (pCtx, XC5_EDID_WD_ADDR, (block % 2) ? 0x80 : 0x00);
+    // Set EDID segment pointer
+    // (Regsiter write to XC4_SEG_PTR will start EDID reading)
+    writeHDMIRegister (pCtx, XC4_SEG_PTR, block / 2);
+}
+
+/*
+ *  Function:
+ *      HDMI_Edid_Status
+ *
+ *  Input:
+ *      None
+ *
+ *  Output:
+ *      EDID_RDY and/or EDID_ERR if the engine finished, 0 while it is busy.
+ *      The returned bits are cleared.
+ *
+ */
+BYTE HDMI_Edid_Status (ddk768_context_t *pCtx)
+{
+    BYTE status;
+
+    status = readHDMIRegister (pCtx, X94_INT1_ST) & (EDID_RDY | EDID_ERR);
+    if (status)
+        writeHDMIRegister (pCtx, X94_INT1_ST, status);
+
+    return status;
+}
+
+/*
+ *  Function:
+ *      HDMI_Edid_Fetch_Block
+ *      Copy the block read by the EDID engine out of its FIFO.
+ *
+ *  Input:
+ *      pBuffer - Buffer of at least size bytes
+ *      size    - Number of bytes to copy, up to 128
+ *
+ *  Output:
+ *      None
+ *
+ */
+void HDMI_Edid_Fetch_Block (ddk768_context_t *pCtx, BYTE *pBuffer, unsigned long size)
+{
+    unsigned long i;
+
+    if (size == 0)
+        return;
+
+    // Every register access already waits for the FIFO, no extra delay needed
+    pBuffer[0] = HDMI_Edid_ReadFirstByte(pCtx);
+    for (i = 1; i < size; i++)
+        pBuffer[i] = readHDMIRegister(pCtx, X80_EDID);
+}
+
+/*
+ *  Function:
+ *      HDMI_Edid_Stop
+ *      Mask the EDID interrupts again after a read.
+ *
+ *  Input:
+ *      None
+ *
+ *  Output:
+ *      None
+ *
+ */
+void HDMI_Edid_Stop (ddk768_context_t *pCtx)
+{
+    unsigned char regValue;
+
+    regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+    writeHDMIRegister (pCtx, X92_INT_MASK1, (regValue & ~(EDID_RDY | EDID_ERR)));
+}
+
 /*
  *  Function:
  *      HDMI_hotplug_check
@@ -1545,15 +1697,16 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize)
  *      1 - plugged
  * 
  */
-BYTE HDMI_connector_detect(void)
+BYTE HDMI_connector_detect(ddk768_context_t *pCtx)
 {
-	unsigned long value = 0;
+	unsigned long value = 0, flags;
 
 	//enable GPIO
+	lockRegisterBlock(DDK768_LOCK_GPIO, flags);
 	pokeRegisterDWord(GPIO_INTERRUPT_SETUP, 0);
-	value = FIELD_SET(peekRegisterDWord(GPIO_DATA_DIRECTION), GPIO_DATA_DIRECTION, 1, INPUT);
-	pokeRegisterDWord(GPIO_DATA_DIRECTION, value);
+	ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION, 0, FIELD_SET(0, GPIO_DATA_DIRECTION, 1, OUTPUT));
 	value = peekRegisterDWord(GPIO_DATA);
+	unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
 	return (value & (1<<1));
 }
@@ -1570,20 +1723,20 @@ BYTE HDMI_connector_detect(void)
  *      1 - plugged
  * 
  */
-BYTE HDMI_hotplug_check (void)
+BYTE HDMI_hotplug_check (ddk768_context_t *pCtx)
 {
     BYTE STAT_DFh;
 
     // Wait time before check hot plug & MSENS pin status
     DelayMs (15);
 
-    STAT_DFh = readHDMIRegister (XDF_HPG_STATUS);
+    STAT_DFh = readHDMIRegister (pCtx, XDF_HPG_STATUS);
 
     if ((STAT_DFh & HPG_MSENS) == HPG_MSENS)        // HPD & MSENS status both high? 
     {
         // DDC I2C master controller reset ... ddc_ctrl_reset[bit4]
-        writeHDMIRegister (X3B_AVSET2, readHDMIRegister (X3B_AVSET2) | 0x10);
-        writeHDMIRegister (X3B_AVSET2, readHDMIRegister (X3B_AVSET2) & 0xEF);
+        writeHDMIRegister (pCtx, X3B_AVSET2, readHDMIRegister (pCtx, X3B_AVSET2) | 0x10);
+        writeHDMIRegister (pCtx, X3B_AVSET2, readHDMIRegister (pCtx, X3B_AVSET2) & 0xEF);
         
         return 1;
     }
@@ -1594,8 +1747,72 @@ BYTE HDMI_hotplug_check (void)
 
 }
 
+/*
+ *  Function:
+ *      HDMI_Enable_Hotplug_Interrupt
+ *
+ *  Input:
+ *      enable - 1 to unmask the hot plug interrupt, 0 to mask it
+ *
+ *  Output:
+ *      None
+ *
+ */
+void HDMI_Enable_Hotplug_Interrupt (ddk768_context_t *pCtx, int enable)
+{
+    unsigned char regValue;
+
+    pCtx->hdmiHotplugInt = enable ? 1 : 0;
+
+    if (pCtx->hdmiPowerMode == PowerMode_A)
+    {
+        // PS mode a->b
+        HDMI_System_PD(pCtx, PowerMode_B);
+    }
+
+    // Drop any stale status first, it would fire as soon as it is unmasked.
+    writeHDMIRegister (pCtx, X94_INT1_ST, HPG_MSENS);
+
+    regValue = readHDMIRegister (pCtx, X92_INT_MASK1);
+    if (enable)
+        regValue |= HOT_PLUG;
+    else
+        regValue &= ~HOT_PLUG;
+    writeHDMIRegister (pCtx, X92_INT_MASK1, regValue);
+}
+
+/*
+ *  Function:
+ *      HDMI_Hotplug_Ack
+ *      Latch and clear the HDMI interrupt status. Must not be called
+ *      from interrupt context, every register access sleeps.
+ *
+ *  Input:
+ *      None
+ *
+ *  Output:
+ *      The hot plug / MSENS bits of the latched status, 0 if neither changed.
+ *
+ */
+BYTE HDMI_Hotplug_Ack (ddk768_context_t *pCtx)
+{
+    if (pCtx->hdmiPowerMode == PowerMode_A)
+    {
+        // PS mode a->b
+        HDMI_System_PD(pCtx, PowerMode_B);
+    }
+
+    pCtx->hdmiInt94h = readHDMIRegister(pCtx, X94_INT1_ST);
+    pCtx->hdmiInt95h = readHDMIRegister(pCtx, X95_INT2_ST);
+
+    // clear all interrupts, so the line drops before it is unmasked again
+    writeHDMIRegister(pCtx, X94_INT1_ST, 0xFF);
+    writeHDMIRegister(pCtx, X95_INT2_ST, 0xFF);
+
+    return pCtx->hdmiInt94h & HPG_MSENS;
+}
 
-int hdmi_detect(void)
+int hdmi_detect(ddk768_context_t *pCtx)
 {
     unsigned int intStatus;
 
@@ -1606,24 +1823,24 @@ int hdmi_detect(void)
     {
         
 
-        if (PowerMode == PowerMode_A)
+        if (pCtx->hdmiPowerMode == PowerMode_A)
         {
             // PS mode a->b
-            HDMI_System_PD(PowerMode_B);
+            HDMI_System_PD(pCtx, PowerMode_B);
         }
 
         // Save interrupt status from the last interrupt
-        g_INT_94h = readHDMIRegister(X94_INT1_ST);
-        g_INT_95h = readHDMIRegister(X95_INT2_ST);
+        pCtx->hdmiInt94h = readHDMIRegister(pCtx, X94_INT1_ST);
+        pCtx->hdmiInt95h = readHDMIRegister(pCtx, X95_INT2_ST);
 
         // check if plug-in or plug-out detect
-        if ((g_INT_94h & HPG_MSENS) == HPG_MSENS)        // HPD & MSENS status both high? 
+        if ((pCtx->hdmiInt94h & HPG_MSENS) == HPG_MSENS)        // HPD & MSENS status both high? 
         {
             // clear all interrupts
-            writeHDMIRegister(X94_INT1_ST, 0xFF);
-            writeHDMIRegister(X95_INT2_ST, 0xFF);
+            writeHDMIRegister(pCtx, X94_INT1_ST, 0xFF);
+            writeHDMIRegister(pCtx, X95_INT2_ST, 0xFF);
 
-            if (HDMI_hotplug_check())
+            if (HDMI_hotplug_check(pCtx))
             {
                 return 1;
             }
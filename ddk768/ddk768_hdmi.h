@@ -1,6 +1,8 @@
 #ifndef  _HDMI_HEADER_H_
 #define  _HDMI_HEADER_H_
 
+#include "ddk768_help.h"
+
 #include "ddk768_mode.h"
 
 #define SMI_HDMI_LIB_VERSION    ("2.0")
@@ -221,7 +223,7 @@ long unhookHDMIInterrupt(
  *      None
  *
  */
-void writeHDMIRegister(unsigned char addr, unsigned char value);
+void writeHDMIRegister(ddk768_context_t *pCtx, unsigned char addr, unsigned char value);
 
 /*
  *  Function: 
@@ -234,7 +236,7 @@ void writeHDMIRegister(unsigned char addr, unsigned char value);
  *      register value
  *
  */
-unsigned char readHDMIRegister(unsigned char addr);
+unsigned char readHDMIRegister(ddk768_context_t *pCtx, unsigned char addr);
 
 /*
  *  Function: 
@@ -248,7 +250,7 @@ unsigned char readHDMIRegister(unsigned char addr);
  *      None
  *  
  */
-void writeHDMIControlRegister(unsigned char value);
+void writeHDMIControlRegister(ddk768_context_t *pCtx, unsigned char value);
 
 /*
  *  Function: 
@@ -262,7 +264,7 @@ void writeHDMIControlRegister(unsigned char value);
  *      register value
  *
  */
-unsigned char readHDMIControlRegister(void);
+unsigned char readHDMIControlRegister(ddk768_context_t *pCtx);
 
 /*
  *  Function: 
@@ -276,7 +278,7 @@ unsigned char readHDMIControlRegister(void);
  *      None
  *
  */
-void writeHdmiPHYRegister(unsigned char addr, unsigned char value);
+void writeHdmiPHYRegister(ddk768_context_t *pCtx, unsigned char addr, unsigned char value);
 
 /*
  *  Function:
@@ -290,7 +292,7 @@ void writeHdmiPHYRegister(unsigned char addr, unsigned char value);
  *      None
  *
  */
-void setHDMIChannel(unsigned char Channel);
+void setHDMIChannel(ddk768_context_t *pCtx, unsigned char Channel);
 
 /*
  *  Function:
@@ -304,7 +306,7 @@ void setHDMIChannel(unsigned char Channel);
  *      None
  *
  */
-void enableHdmI2C(unsigned long enable);
+void enableHdmI2C(ddk768_context_t *pCtx, unsigned long enable);
 
 /*
  *  Function:
@@ -317,13 +319,13 @@ void enableHdmI2C(unsigned long enable);
  *      None
  *
  */
-void HDMI_Dump_Registers (void);
+void HDMI_Dump_Registers (ddk768_context_t *pCtx);
 
 //
 // Parameters   : unsigned char mode. 4 modes available.
 //                  MODE_A (sleep), MODE_B (register access), MODE_D (clock), MODE_E (active).
 //
-void HDMI_System_PD (unsigned char mode);
+void HDMI_System_PD (ddk768_context_t *pCtx, unsigned char mode);
 
 /*
  *  Function:
@@ -336,7 +338,7 @@ void HDMI_System_PD (unsigned char mode);
  *      None
  *
  */
-void HDMI_Init (void);
+void HDMI_Init (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -354,10 +356,10 @@ void HDMI_Init (void);
  *      -1 - Error 
  *
  */
-long HDMI_Set_Mode (logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, bool isHDMI);
+long HDMI_Set_Mode (ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam, bool isHDMI);
 
 
-void HDMI_Enable_Output(void);
+void HDMI_Enable_Output(ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -373,7 +375,7 @@ void HDMI_Enable_Output(void);
  *      None
  *
  */
-void HDMI_Disable_Output (void);
+void HDMI_Disable_Output (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -386,7 +388,7 @@ void HDMI_Disable_Output (void);
  *      None
  *
  */
-void HDMI_Unplugged (void);
+void HDMI_Unplugged (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -402,7 +404,7 @@ void HDMI_Unplugged (void);
  *      None
  *
  */
-void HDMI_Audio_Reset (void);
+void HDMI_Audio_Reset (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -418,7 +420,7 @@ void HDMI_Audio_Reset (void);
  *      None
  *
  */
-void HDMI_Audio_Mute (void);
+void HDMI_Audio_Mute (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -434,7 +436,22 @@ void HDMI_Audio_Mute (void);
  *      None
  *
  */
-void HDMI_Audio_Unmute (void);
+void HDMI_Audio_Unmute (ddk768_context_t *pCtx);
+
+/*
+ *  Function:
+ *      HDMI_Audio_Set_Rate
+ *
+ *  Input:
+ *      sampleRate - 32000, 44100 or 48000, 0 for the crystal's default
+ *
+ *  Output:
+ *      None
+ *
+ *  Return:
+ *      None
+ */
+void HDMI_Audio_Set_Rate (ddk768_context_t *pCtx, unsigned long sampleRate);
 
 
 
@@ -451,7 +468,24 @@ void HDMI_Audio_Unmute (void);
  *      0 - exist block0 EDID (128 Bytes)
  *      1 - exist block0 & block1 EDID (256 Bytes)
  */
-long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize);
+long HDMI_Read_Edid(ddk768_context_t *pCtx, BYTE *pEDIDBuffer, unsigned long bufferSize);
+
+/*
+ *  Block level access to the EDID engine, for a caller that waits for the
+ *  EDID interrupt itself:
+ *
+ *      HDMI_Edid_Start_Block(block);
+ *      wait until HDMI_Edid_Status() returns EDID_RDY or EDID_ERR
+ *      HDMI_Edid_Fetch_Block(buffer, 128) if it was EDID_RDY
+ *      ...
+ *      HDMI_Edid_Stop();
+ *
+ *  The engine borrows the I2C1 pins, see enableHdmI2C().
+ */
+void HDMI_Edid_Start_Block (ddk768_context_t *pCtx, unsigned int block);
+BYTE HDMI_Edid_Status (ddk768_context_t *pCtx);
+void HDMI_Edid_Fetch_Block (ddk768_context_t *pCtx, BYTE *pBuffer, unsigned long size);
+void HDMI_Edid_Stop (ddk768_context_t *pCtx);
 
 /*
  *  Function:
@@ -465,11 +499,37 @@ long HDMI_Read_Edid(BYTE *pEDIDBuffer, unsigned long bufferSize);
  *      1 - plugged
  * 
  */
-BYTE HDMI_hotplug_check (void);
+BYTE HDMI_hotplug_check (ddk768_context_t *pCtx);
+
+/*
+ *  Function:
+ *      HDMI_Enable_Hotplug_Interrupt
+ *
+ *  Input:
+ *      enable - 1 to unmask the hot plug interrupt, 0 to mask it
+ *
+ *  Output:
+ *      None
+ *
+ */
+void HDMI_Enable_Hotplug_Interrupt (ddk768_context_t *pCtx, int enable);
+
+/*
+ *  Function:
+ *      HDMI_Hotplug_Ack
+ *
+ *  Input:
+ *      None
+ *
+ *  Output:
+ *      The hot plug / MSENS bits of the latched status, 0 if neither changed.
+ *
+ */
+BYTE HDMI_Hotplug_Ack (ddk768_context_t *pCtx);
 
-int hdmi_detect(void);
+int hdmi_detect(ddk768_context_t *pCtx);
 
-BYTE HDMI_connector_detect(void);
+BYTE HDMI_connector_detect(ddk768_context_t *pCtx);
 
 void hdmiHandler(void);
 void Delay (void);
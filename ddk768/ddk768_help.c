@@ -1,12 +1,127 @@
-#include "ddk768_help.h"
+#include <linux/slab.h>
 
-volatile unsigned char __iomem * mmio768 = NULL;
+#include "ddk768_reg.h"
+#include "ddk768_context.h"
+#include "ddk768_hdmi.h"
+#include "ddk768_swi2c.h"
 
 /* after driver mapped io registers, use this function first */
-void ddk768_set_mmio(volatile unsigned char * addr,unsigned short devId,char revId)
+ddk768_context_t *ddk768_alloc_context(volatile unsigned char __iomem * addr,unsigned short devId,char revId)
 {
-	mmio768 = addr;
+	ddk768_context_t *pCtx;
+
+	pCtx = kzalloc(sizeof(*pCtx), GFP_KERNEL);
+	if (!pCtx)
+		return NULL;
+
+	pCtx->mmio = addr;
+	pCtx->devId = devId;
+	pCtx->revId = revId;
+
+	/* Software I2C defaults to the DVI DDC pins until a bus is selected. */
+	pCtx->i2cClockGPIO = DEFAULT_I2C0_SCL;
+	pCtx->i2cDataGPIO = DEFAULT_I2C0_SDA;
+	pCtx->i2cClkGPIOMuxReg = GPIO_MUX;
+	pCtx->i2cClkGPIODataReg = GPIO_DATA;
+	pCtx->i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
+	pCtx->i2cDataGPIOMuxReg = GPIO_MUX;
+	pCtx->i2cDataGPIODataReg = GPIO_DATA;
+	pCtx->i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
+	pCtx->i2cHalfPeriod = 1250;     /* 400 kHz */
+
+	pCtx->hdmiPowerMode = PowerMode_A;
+
+	smi_reg_lock_init(&pCtx->regLock[DDK768_LOCK_INT], "int_mask");
+	smi_reg_lock_init(&pCtx->regLock[DDK768_LOCK_GPIO], "gpio");
+	smi_reg_lock_init(&pCtx->regLock[DDK768_LOCK_DC0], "dc0");
+	smi_reg_lock_init(&pCtx->regLock[DDK768_LOCK_DC1], "dc1");
+
+	mutex_init(&pCtx->hwI2CLock[0]);
+	mutex_init(&pCtx->hwI2CLock[1]);
+	init_completion(&pCtx->hdmiEdidDone);
+
+	ddk768_gpioLoadShadow(pCtx);
+
 	printk("Found SM768 SOC Chip\n");
+	return pCtx;
+}
+
+void ddk768_free_context(ddk768_context_t *pCtx)
+{
+	kfree(pCtx);
+}
+
+struct smi_reg_lock *ddk768_getRegLock(ddk768_context_t *pCtx, int lock)
+{
+	if (lock < 0 || lock >= DDK768_LOCK_COUNT)
+		return NULL;
+
+	return &pCtx->regLock[lock];
+}
+
+/* 
+ * Find the lock of the register block an MMIO offset belongs to.
+ * Returns NULL when the register is not shared with another context.
+ */
+struct smi_reg_lock *ddk768_findRegLock(ddk768_context_t *pCtx, unsigned long offset)
+{
+	if (offset == INT_MASK)
+		return &pCtx->regLock[DDK768_LOCK_INT];
+
+	if (offset >= GPIO_DATA && offset <= GPIO_MUX)
+		return &pCtx->regLock[DDK768_LOCK_GPIO];
+
+	if (offset >= DISPLAY_CTRL && offset < DISPLAY_CTRL + CHANNEL_OFFSET)
+		return &pCtx->regLock[DDK768_LOCK_DC0];
+
+	if (offset >= DISPLAY_CTRL + CHANNEL_OFFSET && offset < DISPLAY_CTRL + 2 * CHANNEL_OFFSET)
+		return &pCtx->regLock[DDK768_LOCK_DC1];
+
+	return NULL;
+}
+
+/*
+ * The GPIO output latch and direction registers are only ever written
+ * through ddk768_gpioUpdate(), which keeps a copy of the last value in the
+ * context. That lets the bit-banged I2C masters flip a line with one posted
+ * write instead of a read-modify-write across PCIe. GPIO_DATA reads back
+ * the pin level of inputs, so its shadow is only exact for output pins.
+ *
+ * Reload the shadow after anything outside the DDK may have changed the
+ * registers, i.e. at probe and on resume.
+ */
+void ddk768_gpioLoadShadow(ddk768_context_t *pCtx)
+{
+	unsigned long flags;
+
+	lockRegisterBlock(DDK768_LOCK_GPIO, flags);
+	pCtx->gpioData = peekRegisterDWord(GPIO_DATA);
+	pCtx->gpioDirection = peekRegisterDWord(GPIO_DATA_DIRECTION);
+	unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
+}
+
+/*
+ * Called after a raw register write that bypassed the DDK, e.g. from
+ * debugfs, so the GPIO shadow does not undo it on the next update.
+ */
+void ddk768_regWritten(ddk768_context_t *pCtx, unsigned long offset)
+{
+	if (offset == GPIO_DATA || offset == GPIO_DATA_DIRECTION)
+		ddk768_gpioLoadShadow(pCtx);
 }
 
+/*
+ * Set and clear bits of GPIO_DATA or GPIO_DATA_DIRECTION, skipping the write
+ * if nothing changes. The caller holds DDK768_LOCK_GPIO.
+ */
+void ddk768_gpioUpdate(ddk768_context_t *pCtx, unsigned long reg, unsigned long set, unsigned long clear)
+{
+	unsigned long *shadow = (reg == GPIO_DATA) ? &pCtx->gpioData : &pCtx->gpioDirection;
+	unsigned long value = (*shadow & ~clear) | set;
+
+	if (value == *shadow)
+		return;
 
+	*shadow = value;
+	pokeRegisterDWord(reg, value);
+}
@@ -1,21 +1,31 @@
 #ifndef _DDK768_HELP_H__
 #define _DDK768_HELP_H__
 
+/*
+ * Per-device DDK state. Every DDK function that touches the hardware takes
+ * the context of the chip it works on as first argument, so that several
+ * SM768 cards can be driven from the same module. The layout is only visible
+ * to the DDK itself (ddk768_context.h).
+ */
+typedef struct _ddk768_context_t ddk768_context_t;
+
 #ifndef USE_INTERNAL_REGISTER_ACCESS
 
 #include <linux/ioport.h>
 #include <linux/io.h>
 #include <linux/uaccess.h>
 
+#include "../smi_lock.h"
 
 
 
 
-#define peekRegisterDWord(addr) readl((addr)+mmio768)
-#define pokeRegisterDWord(addr,data) writel((data),(addr)+mmio768)
+/* The register access macros expect the device context "pCtx" in scope. */
+#define peekRegisterDWord(addr) readl((addr)+pCtx->mmio)
+#define pokeRegisterDWord(addr,data) writel((data),(addr)+pCtx->mmio)
 
-#define peekRegisterByte(addr) readb((addr)+mmio768)
-#define pokeRegisterByte(addr,data) writeb((data),(addr)+mmio768)
+#define peekRegisterByte(addr) readb((addr)+pCtx->mmio)
+#define pokeRegisterByte(addr,data) writeb((data),(addr)+pCtx->mmio)
 
 
 /* Size of SM768 MMIO and memory */
@@ -23,9 +33,27 @@
 #define SM768_PCI_ALLOC_MEMORY_SIZE     (128*1024*1024)
 
 
-void ddk768_set_mmio(volatile unsigned char * addr,unsigned short devId,char revId);
+ddk768_context_t *ddk768_alloc_context(volatile unsigned char __iomem * addr,unsigned short devId,char revId);
+void ddk768_free_context(ddk768_context_t *pCtx);
+
+/* Register blocks that have their own lock in the context (see smi_lock.h). */
+typedef enum _ddk768_reg_lock_t
+{
+    DDK768_LOCK_INT = 0,     /* Interrupt mask */
+    DDK768_LOCK_GPIO,        /* GPIO mux, data and direction */
+    DDK768_LOCK_DC0,         /* Display channel 0 registers */
+    DDK768_LOCK_DC1,         /* Display channel 1 registers */
+    DDK768_LOCK_COUNT
+}
+ddk768_reg_lock_t;
+
+struct smi_reg_lock *ddk768_getRegLock(ddk768_context_t *pCtx, int lock);
+struct smi_reg_lock *ddk768_findRegLock(ddk768_context_t *pCtx, unsigned long offset);
 
-extern volatile unsigned  char __iomem * mmio768;
+/* GPIO_DATA and GPIO_DATA_DIRECTION writes go through a shadow copy in the context. */
+void ddk768_gpioLoadShadow(ddk768_context_t *pCtx);
+void ddk768_regWritten(ddk768_context_t *pCtx, unsigned long offset);
+void ddk768_gpioUpdate(ddk768_context_t *pCtx, unsigned long reg, unsigned long set, unsigned long clear);
 
 #else
 /* implement if you want use it*/
@@ -1,90 +1,247 @@
+#include <linux/delay.h>
+#include <linux/ktime.h>
+
 #include "ddk768_reg.h"
 #include "ddk768_power.h"
 #include "ddk768_hwi2c.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
+
+/*
+ *  Half SCL period of the controller, in ns. The controller only knows
+ *  standard (100 kHz) and fast (400 kHz) mode; pick the one closest to
+ *  the bus speed set by ddk768_swI2CSetSpeed().
+ */
+static unsigned long hwI2CHalfPeriod(ddk768_context_t *pCtx)
+{
+    return (pCtx->i2cHalfPeriod < 5000) ? 1250 : 5000;
+}
+
+/*
+ *  This function waits until the transfer is completed within the timeout value.
+ *  It first sleeps for the time the address and data bytes need on the
+ *  wire (9 clocks each), then polls I2C_STATUS, sleeping in between.
+ *
+ *  Parameters:
+ *      count   - Number of data bytes in the transaction
+ *      write   - The bytes are sent to the slave (its ACKs are checked)
+ *
+ *  Return Value:
+ *       0   - Transfer is completed
+ *      -1   - Bus error, or the slave did not acknowledge
+ *      -2   - Tranfer is not successful (timeout)
+ */
+static long ddk768_hwI2CWaitTXDone(
+    ddk768_context_t *pCtx,
+    unsigned char i2cNumber, //I2C0 or I2C1
+    unsigned long count,
+    int write
+)
+{
+    unsigned long offset, wireTime;
+    unsigned char status;
+    ktime_t timeout;
+
+    offset = (i2cNumber == 0)? 0 : I2C_OFFSET;
 
-unsigned long hwI2CWriteData(
+    wireTime = DIV_ROUND_UP((count + 1) * 18 * hwI2CHalfPeriod(pCtx), 1000);
+    usleep_range(wireTime, wireTime + wireTime / 4 + HWI2C_POLL_US);
+
+    /* Wait until the transfer is completed. */
+    timeout = ktime_add_us(ktime_get(), HWI2C_WAIT_TIMEOUT_US);
+    while (1)
+    {
+        status = peekRegisterByte(I2C_STATUS+offset);
+        if (FIELD_VAL_GET(status, I2C_STATUS, TX) == I2C_STATUS_TX_COMPLETED)
+            break;
+
+        if (ktime_after(ktime_get(), timeout))
+            return (-2);
+
+        usleep_range(HWI2C_POLL_US, 2 * HWI2C_POLL_US);
+    }
+
+    if (FIELD_VAL_GET(status, I2C_STATUS, ERR) == I2C_STATUS_ERR_ERROR)
+        return (-1);
+
+    /* On reads the master NAKs the last byte itself, only writes are checked. */
+    if (write && FIELD_VAL_GET(status, I2C_STATUS, ACK) == I2C_STATUS_ACK_NOT)
+        return (-1);
+
+    return 0;
+}
+
+/*
+ *  This function runs one transaction: START, the address, up to a full
+ *  FIFO of data bytes and STOP.
+ *
+ *  Parameters:
+ *      deviceAddress   - i2c Slave device address, bit 0 set for a read
+ *      count           - Number of bytes, 1 to MAX_HWI2C_FIFO
+ *      pBuffer         - Bytes to send, or buffer for the bytes read
+ *
+ *  Return Value:
+ *      See ddk768_hwI2CWaitTXDone()
+ */
+static long hwI2CTransaction(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress,
-    unsigned long length,
+    unsigned long count,
     unsigned char *pBuffer
-);
+)
+{
+    unsigned long offset, i;
+    int write = !(deviceAddress & 0x01);
+    long ret;
+
+    offset = (i2cNumber == 0)? 0 : I2C_OFFSET;
+
+    /* Reset I2C by writing 0 to I2C_RESET register to clear the previous status. */
+    pokeRegisterByte(I2C_RESET+offset, 0);
+
+    pokeRegisterByte(I2C_SLAVE_ADDRESS+offset, deviceAddress);
+    pokeRegisterByte(I2C_BYTE_COUNT+offset, count - 1);
+
+    /* Move the data to the I2C data register */
+    if (write)
+    {
+        for (i = 0; i < count; i++)
+            pokeRegisterByte(I2C_DATA0 + i + offset, pBuffer[i]);
+    }
+
+    /* Start the I2C */
+    pokeRegisterByte(I2C_CTRL+offset, FIELD_SET(peekRegisterByte(I2C_CTRL+offset), I2C_CTRL, CTRL, START));
+
+    ret = ddk768_hwI2CWaitTXDone(pCtx, i2cNumber, count, write);
+    if (ret != 0)
+        return ret;
+
+    /* Save the data to the given buffer */
+    if (!write)
+    {
+        for (i = 0; i < count; i++)
+            pBuffer[i] = peekRegisterByte(I2C_DATA0 + i + offset);
+    }
 
-unsigned long hwI2CReadData(
+    return 0;
+}
+
+/*
+ *  This function reads a buffer from the slave device in as many full-FIFO
+ *  transactions as it takes. Each one ends with a STOP; DDC EEPROMs keep
+ *  their address counter across it, so the next one reads on from there.
+ *  The caller holds the lock of the controller.
+ *
+ *  Parameters:
+ *      deviceAddress   - i2c Slave device address, bit 0 set
+ *      length          - Total number of bytes
+ *      pBuffer         - Buffer for the bytes read
+ *
+ *  Return Value:
+ *      See ddk768_hwI2CWaitTXDone()
+ */
+static long hwI2CReadData(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress,
     unsigned long length,
     unsigned char *pBuffer
-);
+)
+{
+    unsigned long count;
+    long ret;
+
+    while (length > 0)
+    {
+        count = (length < MAX_HWI2C_FIFO) ? length : MAX_HWI2C_FIFO;
+
+        ret = hwI2CTransaction(pCtx, i2cNumber, deviceAddress, count, pBuffer);
+        if (ret != 0)
+            return ret;
+
+        pBuffer += count;
+        length -= count;
+    }
+
+    return 0;
+}
 
 static int ddk768_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg msgs[],
                            int num)
 {
     struct smi_connector *connector = i2c_get_adapdata(adap);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk768_context_t *pCtx = sdev->ddk768_ctx;
     unsigned char i2cNumber = connector->i2cNumber;
-    unsigned long ret;
-    int i, count = 0;
+    unsigned char deviceAddress;
+    long ret = 0;
+    int i;
 
     if(i2cNumber > 1)
     {
         return -EOPNOTSUPP;
     }
-    for (i = 0; i < (num - 1); i++)
-        if (msgs[i].flags & I2C_M_RD)
-        {
-            pr_err("only one read message supported, has to be last\n");
-            return -EOPNOTSUPP;
-        }
 
-    while (msgs->len && (count < num))
+    for (i = 0; i < num; i++)
     {
-	    msgs->addr = msgs->addr << 1;
-        if (!(msgs->flags & I2C_M_RD))
-        {
-            ret = hwI2CWriteData(
-                i2cNumber, // I2C0 or I2C1
-                msgs->addr,
-                msgs->len,
-                msgs->buf);
-            if (ret < msgs->len)
-            {
-                pr_err("ddk768 i2c xfer tx failed %ld.\n", ret);
-                break;
-            }
-        }
-        else
-        {
-            ret = hwI2CReadData(
-                i2cNumber, // I2C0 or I2C1
-                msgs->addr,
-                msgs->len,
-                msgs->buf);
-            if (ret < msgs->len)
-            {
-                pr_err("ddk768 i2c xfer rx failed %ld.\n", ret);
-                break;
-            }
-        }
-
-        msgs++;
-        count++;
+        /*
+         * The byte count register can't express an empty transaction.
+         * Reads go on across transactions, but a write split in two would
+         * start again at its first byte as the register offset.
+         */
+        if (msgs[i].len == 0 || (msgs[i].flags & I2C_M_TEN))
+            return -EOPNOTSUPP;
+        if (!(msgs[i].flags & I2C_M_RD) && msgs[i].len > MAX_HWI2C_FIFO)
+            return -EOPNOTSUPP;
+
+        /*
+         * Every transaction ends with a STOP, which resets the E-DDC
+         * segment pointer before the read it was meant for.
+         */
+        if (msgs[i].addr == HWI2C_DDC_SEGMENT_ADDR && i + 1 < num)
+            return -EOPNOTSUPP;
     }
 
-    if (count < num)
+    mutex_lock(&pCtx->hwI2CLock[i2cNumber]);
+    for (i = 0; i < num; i++)
     {
-        pr_err("ddk768 i2c xfer failed %d(%d).\n", count, num);
-        return -EIO;
+        deviceAddress = msgs[i].addr << 1;
+        if (msgs[i].flags & I2C_M_RD)
+            ret = hwI2CReadData(pCtx, i2cNumber, deviceAddress | 0x01, msgs[i].len, msgs[i].buf);
+        else
+            ret = hwI2CTransaction(pCtx, i2cNumber, deviceAddress, msgs[i].len, msgs[i].buf);
+        if (ret != 0)
+            break;
     }
+    mutex_unlock(&pCtx->hwI2CLock[i2cNumber]);
+
+    if (ret == -2)
+        return -ETIMEDOUT;
+    if (ret != 0)
+        return (i == 0) ? -ENXIO : -EIO;
 
     return num;
 }
 
 static u32 ddk768_i2c_func(struct i2c_adapter *adap)
 {
-	return I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
+	return I2C_FUNC_I2C | (I2C_FUNC_SMBUS_EMUL & ~I2C_FUNC_SMBUS_QUICK);
 }
 
 
+/*
+ * Every message is its own START ... STOP transaction. Long reads are split
+ * by hwI2CReadData(), writes have to fit in the FIFO.
+ */
+static const struct i2c_adapter_quirks ddk768_i2c_quirks = {
+#ifdef I2C_AQ_NO_REP_START
+	.flags		= I2C_AQ_NO_ZERO_LEN | I2C_AQ_NO_REP_START,
+#else
+	.flags		= I2C_AQ_NO_ZERO_LEN,
+#endif
+	.max_write_len	= MAX_HWI2C_FIFO,
+};
+
 const struct i2c_algorithm ddk768_i2c_algo = {
 	.master_xfer	= ddk768_i2c_xfer,
 	.functionality	= ddk768_i2c_func
@@ -98,10 +255,11 @@ const struct i2c_algorithm ddk768_i2c_algo = {
  *      -1   - Fail to initialize i2c
  */
 long ddk768_hwI2CInit(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber //I2C0 or I2C1
 )
 {
-    unsigned long value, offset;
+    unsigned long value, offset, flags;
     if(i2cNumber > 1) {
         return -1;
     }
@@ -109,20 +267,27 @@ long ddk768_hwI2CInit(
     /* Enable GPIO pins as IIC clock & data */
     if (i2cNumber == 0)
     {
+        lockRegisterBlock(DDK768_LOCK_GPIO, flags);
         value = FIELD_SET(peekRegisterDWord(GPIO_MUX), GPIO_MUX, I2C0, ENABLE);
         pokeRegisterDWord(GPIO_MUX, value);
+        unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
         offset = 0;
     }
     else
     {
+        lockRegisterBlock(DDK768_LOCK_GPIO, flags);
         value = FIELD_SET(peekRegisterDWord(GPIO_MUX), GPIO_MUX, I2C1, ENABLE);
         pokeRegisterDWord(GPIO_MUX, value);
+        unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
         offset = I2C_OFFSET;
     }
               
     /* Enable the I2C Controller and set the bus speed mode */
     value = FIELD_SET(peekRegisterByte(I2C_CTRL+offset), I2C_CTRL, EN, ENABLE);
-    value = FIELD_SET(value, I2C_CTRL, MODE, FAST);        
+    if (hwI2CHalfPeriod(pCtx) < 5000)
+        value = FIELD_SET(value, I2C_CTRL, MODE, FAST);
+    else
+        value = FIELD_SET(value, I2C_CTRL, MODE, STANDARD);
     pokeRegisterByte(I2C_CTRL+offset, value);
 
     return 0;
@@ -132,22 +297,27 @@ long ddk768_hwI2CInit(
  *  This function closes the hardware i2c.
  */
 void ddk768_hwI2CClose(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber //I2C0 or I2C1
 )
 {
-    unsigned long value, offset;
+    unsigned long value, offset, flags;
     
     /* Set GPIO 30 & 31 back as GPIO pins */
     if (i2cNumber == 0)
     {
+        lockRegisterBlock(DDK768_LOCK_GPIO, flags);
         value = FIELD_SET(peekRegisterDWord(GPIO_MUX), GPIO_MUX, I2C0, DISABLE);
         pokeRegisterDWord(GPIO_MUX, value);
+        unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
         offset = 0;
     }
     else
     {
+        lockRegisterBlock(DDK768_LOCK_GPIO, flags);
         value = FIELD_SET(peekRegisterDWord(GPIO_MUX), GPIO_MUX, I2C1, DISABLE);
         pokeRegisterDWord(GPIO_MUX, value);
+        unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
         offset = I2C_OFFSET;
     }
 
@@ -156,168 +326,6 @@ void ddk768_hwI2CClose(
     pokeRegisterByte(I2C_CTRL+offset, value);
 }
 
-
-/*
- *  This function waits until the transfer is completed within the timeout value.
- *
- *  Return Value:
- *       0   - Transfer is completed
- *      -1   - Tranfer is not successful (timeout)
- */
-long ddk768_hwI2CWaitTXDone(
-    unsigned char i2cNumber //I2C0 or I2C1
-)
-{
-    unsigned long timeout, offset;
-
-    offset = (i2cNumber == 0)? 0 : I2C_OFFSET;
-
-    /* Wait until the transfer is completed. */
-    timeout = HWI2C_WAIT_TIMEOUT;
-    while ((FIELD_VAL_GET(peekRegisterByte(I2C_STATUS+offset), I2C_STATUS, TX) != I2C_STATUS_TX_COMPLETED) &&
-           (timeout != 0))
-        timeout--;
-    
-    if (timeout == 0)
-        return (-1);
-
-    return 0;
-}
-
-/*
- *  This function writes data to the i2c slave device registers.
- *
- *  Parameters:
- *      deviceAddress   - i2c Slave device address
- *      length          - Total number of bytes to be written to the device
- *      pBuffer         - The buffer that contains the data to be written to the
- *                     i2c device.   
- *
- *  Return Value:
- *      Total number of bytes those are actually written.
- */
-unsigned long hwI2CWriteData(
-    unsigned char i2cNumber, //I2C0 or I2C1
-    unsigned char deviceAddress,
-    unsigned long length,
-    unsigned char *pBuffer
-)
-{
-    unsigned char count, i;
-    unsigned long offset, totalBytes = 0;
-    
-    offset = (i2cNumber == 0)? 0 : I2C_OFFSET;
-
-    /* Set the Device Address */
-    pokeRegisterByte(I2C_SLAVE_ADDRESS+offset, deviceAddress & ~0x01);
-    
-    /* Write data.
-     * Note:
-     *      Only 16 byte can be accessed per i2c start instruction.
-     */
-    do
-    {
-        /* Reset I2C by writing 0 to I2C_RESET register to clear the previous status. */
-        pokeRegisterByte(I2C_RESET+offset, 0);
-        
-        /* Set the number of bytes to be written */
-        if (length < MAX_HWI2C_FIFO)
-            count = length - 1;
-        else
-            count = MAX_HWI2C_FIFO - 1;
-        pokeRegisterByte(I2C_BYTE_COUNT+offset, count);
-        
-        /* Move the data to the I2C data register */
-        for (i = 0; i <= count; i++)
-            pokeRegisterByte(I2C_DATA0 + i + offset, *pBuffer++);
-
-        /* Start the I2C */
-        pokeRegisterByte(I2C_CTRL+offset, FIELD_SET(peekRegisterByte(I2C_CTRL+offset), I2C_CTRL, CTRL, START));
-        
-        /* Wait until the transfer is completed. */
-        if (ddk768_hwI2CWaitTXDone(i2cNumber) != 0)
-            break;
-    
-        /* Substract length */
-        length -= (count + 1);
-        
-        /* Total byte written */
-        totalBytes += (count + 1);
-        
-    } while (length > 0);
-            
-    return totalBytes;
-}
-
-/*
- *  This function reads data from the slave device and stores them
- *  in the given buffer
- *
- *  Parameters:
- *      deviceAddress   - i2c Slave device address
- *      length          - Total number of bytes to be read
- *      pBuffer         - Pointer to a buffer to be filled with the data read
- *                     from the slave device. It has to be the same size as the
- *                     length to make sure that it can keep all the data read.   
- *
- *  Return Value:
- *      Total number of actual bytes read from the slave device
- */
-unsigned long hwI2CReadData(
-    unsigned char i2cNumber, //I2C0 or I2C1
-    unsigned char deviceAddress,
-    unsigned long length,
-    unsigned char *pBuffer
-)
-{
-    unsigned char count, i;
-    unsigned long offset, totalBytes = 0; 
-    
-    offset = (i2cNumber == 0)? 0 : I2C_OFFSET;
-
-    /* Set the Device Address */
-    pokeRegisterByte(I2C_SLAVE_ADDRESS+offset, deviceAddress | 0x01);
-    
-    /* Read data and save them to the buffer.
-     * Note:
-     *      Only 16 byte can be accessed per i2c start instruction.
-     */
-    do
-    {
-        /* Reset I2C by writing 0 to I2C_RESET register to clear all the status. */
-        pokeRegisterByte(I2C_RESET+offset, 0);
-        
-        /* Set the number of bytes to be read */
-        if (length <= MAX_HWI2C_FIFO)
-            count = length - 1;
-        else
-            count = MAX_HWI2C_FIFO - 1;
-        pokeRegisterByte(I2C_BYTE_COUNT+offset, count);
-
-        /* Start the I2C */
-        pokeRegisterByte(I2C_CTRL+offset, FIELD_SET(peekRegisterByte(I2C_CTRL+offset), I2C_CTRL, CTRL, START));
-        
-        /* Wait until transaction done. */
-        if (ddk768_hwI2CWaitTXDone(i2cNumber) != 0)
-            break;
-
-        /* Save the data to the given buffer */
-        for (i = 0; i <= count; i++)
-        {
-            *pBuffer++ = peekRegisterByte(I2C_DATA0 + i + offset);
-        }
-
-        /* Substract length by 16 */
-        length -= (count + 1);
-    
-        /* Number of bytes read. */
-        totalBytes += (count + 1); 
-        
-    } while (length > 0);
-    
-    return totalBytes;
-}
-
 /*
  *  This function reads the slave device's register
  *
@@ -330,6 +338,7 @@ unsigned long hwI2CReadData(
  *      Register value
  */
 unsigned char ddk768_hwI2CReadReg(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress, 
     unsigned char registerIndex
@@ -337,8 +346,10 @@ unsigned char ddk768_hwI2CReadReg(
 {
     unsigned char value = (0xFF);
 
-    if (hwI2CWriteData(i2cNumber, deviceAddress, 1, &registerIndex) == 1)
-        hwI2CReadData(i2cNumber, deviceAddress, 1, &value);
+    mutex_lock(&pCtx->hwI2CLock[i2cNumber]);
+    if (hwI2CTransaction(pCtx, i2cNumber, deviceAddress & ~0x01, 1, &registerIndex) == 0)
+        hwI2CTransaction(pCtx, i2cNumber, deviceAddress | 0x01, 1, &value);
+    mutex_unlock(&pCtx->hwI2CLock[i2cNumber]);
 
     return value;
 }
@@ -357,6 +368,7 @@ unsigned char ddk768_hwI2CReadReg(
  *         -1   - Fail
  */
 long ddk768_hwI2CWriteReg(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
@@ -364,17 +376,20 @@ long ddk768_hwI2CWriteReg(
 )
 {
     unsigned char value[2];
+    long ret;
     
     value[0] = registerIndex;
     value[1] = data;
-    if (hwI2CWriteData(i2cNumber, deviceAddress, 2, value) == 2)
-        return 0;
 
-    return (-1);
+    mutex_lock(&pCtx->hwI2CLock[i2cNumber]);
+    ret = hwI2CTransaction(pCtx, i2cNumber, deviceAddress & ~0x01, 2, value);
+    mutex_unlock(&pCtx->hwI2CLock[i2cNumber]);
+
+    return (ret == 0) ? 0 : (-1);
 }
 
 
-long ddk768_AdaptHWI2CInit(struct smi_connector *connector)
+long ddk768_AdaptHWI2CInit(ddk768_context_t *pCtx, struct smi_connector *connector)
 {
     int ret;
 
@@ -385,7 +400,7 @@ long ddk768_AdaptHWI2CInit(struct smi_connector *connector)
     else
     connector->i2cNumber = 2; // No exist.
 
-    ddk768_hwI2CInit(connector->i2cNumber);
+    ddk768_hwI2CInit(pCtx, connector->i2cNumber);
 
     connector->adapter.owner = THIS_MODULE;
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
@@ -395,6 +410,7 @@ long ddk768_AdaptHWI2CInit(struct smi_connector *connector)
     connector->adapter.dev.parent = connector->base.dev->dev;
     i2c_set_adapdata(&connector->adapter, connector);
 	connector->adapter.algo = &ddk768_i2c_algo;
+    connector->adapter.quirks = &ddk768_i2c_quirks;
     ret = i2c_add_adapter(&connector->adapter);
 	if (ret)
     {
@@ -405,9 +421,9 @@ long ddk768_AdaptHWI2CInit(struct smi_connector *connector)
     return 0;
 }
 
-long ddk768_AdaptHWI2CCleanBus(struct smi_connector *connector)
+long ddk768_AdaptHWI2CCleanBus(ddk768_context_t *pCtx, struct smi_connector *connector)
 {
-    ddk768_hwI2CClose(connector->i2cNumber);
+    ddk768_hwI2CClose(pCtx, connector->i2cNumber);
     return 0;
 }
 
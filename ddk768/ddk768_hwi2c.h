@@ -1,12 +1,20 @@
 #ifndef _DDK768_HWI2C_H_
 #define _DDK768_HWI2C_H_
 
+#include "ddk768_help.h"
+
 
 #include "../smi_drv.h"
 
 
 #define MAX_HWI2C_FIFO 16
-#define HWI2C_WAIT_TIMEOUT 0x7FF
+/* Longest a transaction may take, slaves may stretch the clock (us) */
+#define HWI2C_WAIT_TIMEOUT_US 20000
+/* Interval between two reads of I2C_STATUS once the bytes should be out (us) */
+#define HWI2C_POLL_US 10
+
+/* E-DDC segment pointer, see ddk768_i2c_xfer() */
+#define HWI2C_DDC_SEGMENT_ADDR 0x30
 
 extern const struct i2c_algorithm ddk768_i2c_algo;
 
@@ -19,6 +27,7 @@ extern const struct i2c_algorithm ddk768_i2c_algo;
  *      -1   - Fail to initialize i2c
  */
 long ddk768_hwI2CInit(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber //I2C0 or I2C1
 );
 
@@ -26,6 +35,7 @@ long ddk768_hwI2CInit(
  * This function close the hardware i2c 
  */
 void ddk768_hwI2CClose(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber //I2C0 or I2C1
 );
 
@@ -39,6 +49,7 @@ void ddk768_hwI2CClose(
  *          The value of the register being read.
  */
 unsigned char ddk768_hwI2CReadReg(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress, 
     unsigned char registerIndex
@@ -56,14 +67,15 @@ unsigned char ddk768_hwI2CReadReg(
  *         -1   - Fail
  */
 long ddk768_hwI2CWriteReg(
+    ddk768_context_t *pCtx,
     unsigned char i2cNumber, //I2C0 or I2C1
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
 );
 
-long ddk768_AdaptHWI2CInit(struct smi_connector *connector);
-long ddk768_AdaptHWI2CCleanBus(struct smi_connector *connector);
+long ddk768_AdaptHWI2CInit(ddk768_context_t *pCtx, struct smi_connector *connector);
+long ddk768_AdaptHWI2CCleanBus(ddk768_context_t *pCtx, struct smi_connector *connector);
 
 
 
@@ -1,24 +1,56 @@
 #include "ddk768_reg.h"
 #include "ddk768_iis.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_power.h"
 #include "ddk768_chip.h"
 
 
+/* IIS_REF_CLOCK, derived from the crystal */
+static unsigned long iisRefClock(ddk768_context_t *pCtx)
+{
+    unsigned long value;
+
+    value = FIELD_VAL_GET(peekRegisterDWord(USBH_CLOCK), USBH_CLOCK, FS_IIS);
+
+	if (ddk768_getCrystalType(pCtx))
+		return 24576000 * value / 8;
+	else
+		return 24000000 * value / 8;
+}
+
+/* I2S_CTRL CDIV for a sample rate */
+static unsigned long iisClockDivider(
+   ddk768_context_t *pCtx,
+   unsigned long wordLength,
+   unsigned long sampleRate
+)
+{
+    unsigned long clockDivider;
+
+    clockDivider = iisRefClock(pCtx) / (4 * sampleRate * wordLength);
+    if (clockDivider == 0)
+        return 0;
+    clockDivider--;
+
+    return clockDivider > 0x1F ? 0x1F : clockDivider;
+}
+
 /*
  * Set up I2S and GPIO registers to transmit/receive data.
  */
 void iisOpen(
+   ddk768_context_t *pCtx,
    unsigned long wordLength, //Number of bits in IIS data: 16 bit, 24 bit, 32 bit
    unsigned long sampleRate  //Sampling rate.
 )
 {
-    unsigned long value, clockDivider, iisRefClk;
+    unsigned long value, clockDivider, flags;
     unsigned char ws;
 
-    ddk768_enableI2S(1); //Turn on I2S clock
+    ddk768_enableI2S(pCtx, 1); //Turn on I2S clock
 
     /* Configure GPIO Mux for I2s output */
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     value = peekRegisterDWord(GPIO_MUX);
     value |= (1 << GPIO_MUX_IIS_RX_SHIFT);        // I2S Data Input
     value &= ~(1 << GPIO_MUX_GPIO_IIS_TX_SHIFT);         // I2S Tx Output
@@ -30,9 +62,8 @@ void iisOpen(
     pokeRegisterDWord(GPIO_MUX, value);
 
     /* Make sure GPIO data direction (0x10004) bit 28 = 0 (input) */
-    value = peekRegisterDWord(GPIO_DATA_DIRECTION);
-    value &= ~(1 << GPIO_DATA_DIRECTION_IIS_RX_SHIFT);
-    pokeRegisterDWord(GPIO_DATA_DIRECTION, value);
+    ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION, 0, 1 << GPIO_DATA_DIRECTION_IIS_RX_SHIFT);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
     /* IIS register set up */
     pokeRegisterDWord(I2S_TX_DATA_L, 0); //Clear Tx registers
@@ -51,15 +82,7 @@ void iisOpen(
             ws = 0;
     }
 
-	/* Calculate IIS_REF_CLOCK.*/
-    value = FIELD_VAL_GET(peekRegisterDWord(USBH_CLOCK), USBH_CLOCK, FS_IIS);
-
-	if (ddk768_getCrystalType())
-		iisRefClk = 24576000 * value / 8;
-	else
-		iisRefClk = 24000000 * value / 8;
-
-    clockDivider = (iisRefClk / (4 * sampleRate * wordLength)) - 1;
+    clockDivider = iisClockDivider(pCtx, wordLength, sampleRate);
 
     pokeRegisterDWord(I2S_CTRL, 
           FIELD_VALUE(0, I2S_CTRL, CS, ws)
@@ -69,20 +92,47 @@ void iisOpen(
 }
 
 
+/*
+ * Sampling rate the I2S clock divider produces when asked for sampleRate.
+ */
+unsigned long iisGetSampleRate(
+   ddk768_context_t *pCtx,
+   unsigned long wordLength,
+   unsigned long sampleRate
+)
+{
+    return iisRefClock(pCtx) / (4 * wordLength * (iisClockDivider(pCtx, wordLength, sampleRate) + 1));
+}
+
+/*
+ * Change the sampling rate of an opened I2S. Call with I2S stopped.
+ */
+void iisSetSampleRate(
+   ddk768_context_t *pCtx,
+   unsigned long wordLength,
+   unsigned long sampleRate
+)
+{
+    pokeRegisterDWord(I2S_CTRL, FIELD_VALUE(peekRegisterDWord(I2S_CTRL), I2S_CTRL, CDIV,
+                      iisClockDivider(pCtx, wordLength, sampleRate)));
+}
+
 /*
  *    Turn off I2S and close GPIO 
  */
-void iisClose()
+void iisClose(ddk768_context_t *pCtx)
 {
-    unsigned long value;
+    unsigned long value, flags;
 
     /* Close GPIO Mux for I2s output   Clear bit 28 and 4:2*/
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     value = peekRegisterDWord(GPIO_MUX);
     value &= ~(1 << GPIO_MUX_IIS_RX_SHIFT);
     value &= ~(1 << GPIO_MUX_IIS_TX_SELECT_SHIFT);
     value &= ~(1 << GPIO_MUX_IIS_WS_SELECT_SHIFT);
     value &= ~(1 << GPIO_MUX_IIS_CLK_SELECT_SHIFT);
     pokeRegisterDWord(GPIO_MUX, value);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
     pokeRegisterDWord(I2S_TX_DATA_L, 0); //Clear Tx registers
     pokeRegisterDWord(I2S_TX_DATA_R, 0);    
@@ -106,6 +156,7 @@ void iisClose()
  *        Number of bytes to DMA (DWord aligned)
  */
 void iisTxDmaSetup(
+    ddk768_context_t *pCtx,
     unsigned long offset, /* Offset from start of SRAM to start DMA */
     unsigned long len     /* Number of bytes to DMA */
     )
@@ -137,7 +188,7 @@ void iisTxDmaSetup(
         | FIELD_VALUE(0, I2S_SRAM_DMA, SIZE, (0x1FF - dmaPointer))
         | FIELD_VALUE(0, I2S_SRAM_DMA, ADDRESS, dmaPointer));
 
-    iisStartNoTx();//Start DMA without output the old data from Tx line.
+    iisStartNoTx(pCtx);//Start DMA without output the old data from Tx line.
 
     //Once DMA starts, make the new base pointer ready.
     pokeRegisterDWord(I2S_SRAM_DMA,
@@ -151,13 +202,13 @@ void iisTxDmaSetup(
       dmaPointer = FIELD_VAL_GET(peekRegisterDWord(I2S_SRAM_DMA), I2S_SRAM_DMA, ADDRESS);
     } while(dmaPointer != offset);
 
-    iisStop();
+    iisStop(pCtx);
 }
 
 /*
  * Return current IIS DMA position.
  */
-unsigned long iisDmaPointer(void)
+unsigned long iisDmaPointer(ddk768_context_t *pCtx)
 {
     return(FIELD_VAL_GET(peekRegisterDWord(I2S_SRAM_DMA), I2S_SRAM_DMA, ADDRESS));
 }
@@ -167,7 +218,7 @@ unsigned long iisDmaPointer(void)
  * It can be used to flush left over SRAM data without
  * sending them to Codec.
  */
-void iisStartNoTx(void)
+void iisStartNoTx(ddk768_context_t *pCtx)
 {
     unsigned long value;
 
@@ -184,7 +235,7 @@ void iisStartNoTx(void)
  *
  */
 
-void iisStart(void)
+void iisStart(ddk768_context_t *pCtx)
 {
 	unsigned long value;
 	
@@ -202,7 +253,7 @@ void iisStart(void)
  * control register.
  *
  */
-void iisStop(void)
+void iisStop(ddk768_context_t *pCtx)
 {
     unsigned long value;
 
@@ -218,6 +269,7 @@ void iisStop(void)
  * Set values for left Tx and right Tx register.
  */
 void iisSetTx(
+    ddk768_context_t *pCtx,
     unsigned long left, //Data for left channel Tx
     unsigned long right //Data for right channel Tx
     )
@@ -235,7 +287,7 @@ void iisSetTx(
  * It has to be cleared, in order to distinguish between different sessions of countdown.
  *
  */
-void iisClearRawInt(void)
+void iisClearRawInt(ddk768_context_t *pCtx)
 {
     /* Read I2S Control & TX to clear INT when IIS get data from Tx & Rx. */
     peekRegisterDWord(I2S_STATUS);
@@ -1,6 +1,8 @@
 #ifndef _IIS_H_
 #define _IIS_H_
 
+#include "ddk768_help.h"
+
 
 #define IIS_REF_CLOCK 48000000
 
@@ -9,14 +11,33 @@
  * Set up I2S and GPIO registers to transmit/receive data.
  */
 void iisOpen(
+   ddk768_context_t *pCtx,
    unsigned long wordLength, //Number of bits in IIS data: 16 bit, 24 bit, 32 bit
    unsigned long sampleRate  //Sampling rate.
 );
 
+/*
+ * Sampling rate the I2S clock divider produces when asked for sampleRate.
+ */
+unsigned long iisGetSampleRate(
+   ddk768_context_t *pCtx,
+   unsigned long wordLength,
+   unsigned long sampleRate
+);
+
+/*
+ * Change the sampling rate of an opened I2S. Call with I2S stopped.
+ */
+void iisSetSampleRate(
+   ddk768_context_t *pCtx,
+   unsigned long wordLength,
+   unsigned long sampleRate
+);
+
 /*
  *    Turn off I2S and close GPIO 
  */
-void iisClose(void);
+void iisClose(ddk768_context_t *pCtx);
 
 /*
  *  This function set up I2S to DMA data from SRAM.
@@ -29,6 +50,7 @@ void iisClose(void);
  *        Number of bytes to DMA (DWord aligned)
  */
 void iisTxDmaSetup(
+    ddk768_context_t *pCtx,
     unsigned long offset, /* Offset from start of SRAM area */
     unsigned long len     /* Number of bytes to DMA */
     );
@@ -36,14 +58,14 @@ void iisTxDmaSetup(
 /*
  * Return current IIS DMA position.
  */
-unsigned long iisDmaPointer(void);
+unsigned long iisDmaPointer(ddk768_context_t *pCtx);
 
 /*
  * This function start IIS without enabling Tx line.
  * It can be used to flush left over SRAM data without
  * sending them to Codec.
  */
-void iisStartNoTx(void);
+void iisStartNoTx(ddk768_context_t *pCtx);
 
 /*
  * This function is needed only when I2S is intended to operate in master mode.
@@ -52,7 +74,7 @@ void iisStartNoTx(void);
  * functioning as soon as an external clock is detected after iisOpen().
  *
  */
-void iisStart(void);
+void iisStart(ddk768_context_t *pCtx);
 
 /*
  * This function is useful only when I2S is operating in master mode.
@@ -61,12 +83,13 @@ void iisStart(void);
  * control register.
  *
  */
-void iisStop(void);
+void iisStop(ddk768_context_t *pCtx);
 
 /*
  * Set values for left Tx and right Tx register.
  */
 void iisSetTx(
+    ddk768_context_t *pCtx,
     unsigned long left, //Data for left channel Tx
     unsigned long right //Data for right channel Tx
     );
@@ -78,7 +101,7 @@ void iisSetTx(
  * It has to be cleared, in order to distinguish between different sessions of countdown.
  * 
  */
-void iisClearRawInt(void);
+void iisClearRawInt(ddk768_context_t *pCtx);
 
 /* 
  * This function returns the INT mask for IIS.
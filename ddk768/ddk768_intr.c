@@ -1,18 +1,21 @@
 #include "ddk768_reg.h"
 #include "ddk768_chip.h"
 #include "ddk768_intr.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 /* 
  * Change interrupt mask 
  */
 void setIntMask(
+    ddk768_context_t *pCtx,
     unsigned long mask_on, 
     unsigned long mask_off
 )
 {
-    unsigned long mask;
+    unsigned long mask, flags;
+
+    lockRegisterBlock(DDK768_LOCK_INT, flags);
 
     /* Get current interrupt mask */
     mask = peekRegisterDWord(INT_MASK);
@@ -23,28 +26,22 @@ void setIntMask(
 
     /* Program new interrupt mask */
     pokeRegisterDWord(INT_MASK, mask);
+
+    unlockRegisterBlock(DDK768_LOCK_INT, flags);
 }
 
 
-void sb_IRQMask(int irq_num)
+void sb_IRQMask(ddk768_context_t *pCtx, int irq_num)
 {
-		unsigned int mask;
-        mask = peekRegisterDWord(INT_MASK);
-        mask &= ~(0x1<<irq_num);
-        pokeRegisterDWord(INT_MASK,mask);  
-  
+        setIntMask(pCtx, 0, 0x1 << irq_num);
 }
 
 
 
 
-void sb_IRQUnmask(int irq_num)
+void sb_IRQUnmask(ddk768_context_t *pCtx, int irq_num)
 {
-		unsigned int mask;
-        mask = peekRegisterDWord(INT_MASK);
-        mask = mask | 0x1<<irq_num;
-        pokeRegisterDWord(INT_MASK,mask);  
-  
+        setIntMask(pCtx, 0x1 << irq_num, 0);
 }
 
 
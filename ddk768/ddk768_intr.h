@@ -1,6 +1,8 @@
 #ifndef _INTR_H_
 #define _INTR_H_
 
+#include "ddk768_help.h"
+
 
 /*******************************************************************
  * Interrupt implementation
@@ -66,8 +68,15 @@ short unhookInterrupt(
 void notifyEndOfISR(void);
 
 
-void sb_IRQMask(int irq_num);
-void sb_IRQUnmask(int irq_num);
+/*
+ * Change the interrupt mask: enable the sources in mask_on and disable the
+ * ones in mask_off. The read-modify-write is done under the interrupt mask
+ * lock, so it may be called from any context.
+ */
+void setIntMask(ddk768_context_t *pCtx, unsigned long mask_on, unsigned long mask_off);
+
+void sb_IRQMask(ddk768_context_t *pCtx, int irq_num);
+void sb_IRQUnmask(ddk768_context_t *pCtx, int irq_num);
 
 #define SB_IRQ_VAL_TC3     	31
 #define SB_IRQ_VAL_TC2     	30
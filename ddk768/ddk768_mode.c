@@ -1,5 +1,6 @@
 #include "linux/string.h"
 #include <linux/delay.h>	
+#include <linux/math64.h>
 
 
 #include "ddk768_reg.h"
@@ -9,7 +10,7 @@
 #include "ddk768_power.h"
 #include "ddk768_mode.h"
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 extern int lvds_channel;
 
@@ -390,10 +391,6 @@ static mode_parameter_t gChannel1ModeParamTable[MAX_MODE_TABLE_ENTRIES] = {
 	{ 0, 0, 0, 0, NEG, 0, 0, 0, 0, NEG, 0, 0, 0, NEG },
 };
 
-/* Static variable to store the mode information. */
-static mode_parameter_t gChannel0CurrentModeParam;
-static mode_parameter_t gChannel1CurrentModeParam;
-
 
 void debug_mode_param(mode_parameter_t *modeParam)
 {
@@ -570,6 +567,119 @@ mode_parameter_t *ddk768_findVesaModeParam(unsigned long width,
 					     gDefaultModeParamTable);
 }
 
+/*
+ * CVT 1.2 reduced blanking constants. Times are in picoseconds so that the
+ * whole calculation fits in integer arithmetic.
+ */
+#define CVT_RB_MIN_V_BLANK      460000000ULL    /* 460 us */
+#define CVT_RB_V_FPORCH         3
+#define CVT_RB_MIN_V_BPORCH     6
+#define CVT_RB1_H_BLANK         160
+#define CVT_RB1_H_FPORCH        48
+#define CVT_RB1_CLOCK_STEP      250000          /* Hz */
+#define CVT_RB2_H_BLANK         80
+#define CVT_RB2_H_FPORCH        8
+#define CVT_RB2_V_SYNC          8
+#define CVT_RB2_CLOCK_STEP      1000
+#define CVT_RB_H_SYNC           32
+
+/*
+ * The CVT 1.2 vsync width encodes the aspect ratio of the mode.
+ */
+static unsigned long ddk768_cvtVsyncWidth(unsigned long width, unsigned long height)
+{
+    if (width * 3 == height * 4)
+        return 4;
+    if (width * 9 == height * 16)
+        return 5;
+    if (width * 10 == height * 16)
+        return 6;
+    if (width * 4 == height * 5 || width * 9 == height * 15)
+        return 7;
+    return 10;
+}
+
+/*
+ *  ddk768_calcCvtModeParam
+ *      Work out CVT 1.2 reduced blanking timing for a mode, for sinks
+ *      that are not driven from a mode table. Compared with the VESA
+ *      tables, the blanking shrinks to 160 (RB) or 80 (RBv2) pixels and
+ *      460 us, which lowers the pixel clock of the same mode.
+ *
+ *  Input:
+ *      width, height   - Active area; RB rounds the width down to 8 pixels
+ *      refresh_rate    - Vertical refresh in Hz
+ *      version         - 1 for CVT-RB, 2 for CVT-RBv2
+ *      pModeParam      - Filled with the timing
+ *
+ *  Output:
+ *      0   - Success
+ *     -1   - Invalid input
+ */
+long ddk768_calcCvtModeParam(unsigned long width,
+                             unsigned long height,
+                             unsigned long refresh_rate,
+                             unsigned long version,
+                             mode_parameter_t *pModeParam)
+{
+    unsigned long long hPeriod, pixelClock;
+    unsigned long vSync, vbiLines, minVbi, hBlank, hFrontPorch, clockStep;
+
+    if (width == 0 || height == 0 || refresh_rate == 0 || (version != 1 && version != 2))
+        return -1;
+
+    if (version == 1) {
+        width &= ~7UL;
+        vSync = ddk768_cvtVsyncWidth(width, height);
+        hBlank = CVT_RB1_H_BLANK;
+        hFrontPorch = CVT_RB1_H_FPORCH;
+        clockStep = CVT_RB1_CLOCK_STEP;
+        minVbi = CVT_RB_V_FPORCH + vSync + CVT_RB_MIN_V_BPORCH;
+    } else {
+        vSync = CVT_RB2_V_SYNC;
+        hBlank = CVT_RB2_H_BLANK;
+        hFrontPorch = CVT_RB2_H_FPORCH;
+        clockStep = CVT_RB2_CLOCK_STEP;
+        minVbi = 1 + vSync + CVT_RB_MIN_V_BPORCH;
+    }
+
+    /* Estimated line period, then enough lines to cover the minimum blank */
+    hPeriod = div_u64(1000000000000ULL, refresh_rate);
+    if (hPeriod <= CVT_RB_MIN_V_BLANK)
+        return -1;
+    hPeriod = div_u64(hPeriod - CVT_RB_MIN_V_BLANK, height);
+    vbiLines = (unsigned long)div64_u64(CVT_RB_MIN_V_BLANK, hPeriod) + 1;
+    if (vbiLines < minVbi)
+        vbiLines = minVbi;
+
+    pModeParam->horizontal_display_end = width;
+    pModeParam->horizontal_total = width + hBlank;
+    pModeParam->horizontal_sync_start = width + hFrontPorch;
+    pModeParam->horizontal_sync_width = CVT_RB_H_SYNC;
+    pModeParam->horizontal_sync_polarity = POS;
+
+    /* RB has a fixed front porch, RBv2 a fixed back porch */
+    pModeParam->vertical_display_end = height;
+    pModeParam->vertical_total = height + vbiLines;
+    if (version == 1)
+        pModeParam->vertical_sync_start = height + CVT_RB_V_FPORCH;
+    else
+        pModeParam->vertical_sync_start = height + vbiLines - vSync - CVT_RB_MIN_V_BPORCH;
+    pModeParam->vertical_sync_height = vSync;
+    pModeParam->vertical_sync_polarity = NEG;
+
+    pixelClock = (unsigned long long)refresh_rate *
+                 pModeParam->horizontal_total * pModeParam->vertical_total;
+    pixelClock = div_u64(pixelClock, clockStep) * clockStep;
+
+    pModeParam->pixel_clock = (unsigned long)pixelClock;
+    pModeParam->horizontal_frequency = (unsigned long)div_u64(pixelClock, pModeParam->horizontal_total);
+    pModeParam->vertical_frequency = refresh_rate;
+    pModeParam->clock_phase_polarity = POS;
+
+    return 0;
+}
+
 /*
  * (Obsolete) 
  * Return a point to the gDefaultModeParamTable.
@@ -666,12 +776,107 @@ unsigned long getMaximumModeEntries()
 /* 
  * This function returns the current mode.
  */
-mode_parameter_t ddk768_getCurrentModeParam(disp_control_t dispCtrl)
+mode_parameter_t ddk768_getCurrentModeParam(ddk768_context_t *pCtx, disp_control_t dispCtrl)
+{
+	if (dispCtrl == CHANNEL0_CTRL)
+		return pCtx->channel0CurrentModeParam;
+	else
+		return pCtx->channel1CurrentModeParam;
+}
+
+long ddk768_readModeRegisters(ddk768_context_t *pCtx, disp_control_t dispCtrl,
+			       mode_parameter_t *pModeParam, logicalMode_t *pLogicalMode)
 {
+	unsigned long offset, pllReg, value, format;
+	pll_value_t pll;
+
+	offset = (dispCtrl == CHANNEL0_CTRL) ? 0 : CHANNEL_OFFSET;
+	pllReg = (dispCtrl == CHANNEL0_CTRL) ? VCLK0_PLL : VCLK1_PLL;
+
+	value = peekRegisterDWord(DISPLAY_CTRL + offset);
+	if (FIELD_VAL_GET(value, DISPLAY_CTRL, TIMING) != DISPLAY_CTRL_TIMING_ENABLE ||
+	    FIELD_VAL_GET(value, DISPLAY_CTRL, PLANE) != DISPLAY_CTRL_PLANE_ENABLE)
+		return -1;
+
+	pModeParam->horizontal_sync_polarity =
+	    FIELD_VAL_GET(value, DISPLAY_CTRL, HSYNC_PHASE) == DISPLAY_CTRL_HSYNC_PHASE_ACTIVE_HIGH ? POS : NEG;
+	pModeParam->vertical_sync_polarity =
+	    FIELD_VAL_GET(value, DISPLAY_CTRL, VSYNC_PHASE) == DISPLAY_CTRL_VSYNC_PHASE_ACTIVE_HIGH ? POS : NEG;
+	pModeParam->clock_phase_polarity =
+	    FIELD_VAL_GET(value, DISPLAY_CTRL, CLOCK_PHASE) == DISPLAY_CTRL_CLOCK_PHASE_ACTIVE_HIGH ? POS : NEG;
+
+	format = FIELD_VAL_GET(value, DISPLAY_CTRL, FORMAT);
+	pLogicalMode->bpp = (format == DISPLAY_CTRL_FORMAT_8) ? 8 :
+			    (format == DISPLAY_CTRL_FORMAT_16) ? 16 : 32;
+
+	/* The PLL has to be running for the timing to mean anything */
+	value = peekRegisterDWord(pllReg);
+	if (FIELD_VAL_GET(value, VCLK_PLL, POWER) != VCLK_PLL_POWER_NORMAL)
+		return -1;
+
+	if (ddk768_getCrystalType(pCtx))
+		pll.inputFreq = (24576000 / 2);
+	else
+		pll.inputFreq = (24000000 / 2);
+	pll.INT = FIELD_VAL_GET(value, VCLK_PLL, INT);
+	pll.FRAC = FIELD_VAL_GET(value, VCLK_PLL, FRAC);
+	pll.VCO = FIELD_VAL_GET(value, VCLK_PLL, VCO);
+	pll.BS = FIELD_VAL_GET(value, VCLK_PLL, BS);
+	pModeParam->pixel_clock = ddk768_calcPLL(&pll);
+
+	/* Undo the "- 1" ddk768_programModeRegisters applies to these fields */
+	value = peekRegisterDWord(HORIZONTAL_TOTAL + offset);
+	pModeParam->horizontal_total = FIELD_VAL_GET(value, HORIZONTAL_TOTAL, TOTAL) + 1;
+	pModeParam->horizontal_display_end = FIELD_VAL_GET(value, HORIZONTAL_TOTAL, DISPLAY_END) + 1;
+
+	value = peekRegisterDWord(HORIZONTAL_SYNC + offset);
+	pModeParam->horizontal_sync_width = FIELD_VAL_GET(value, HORIZONTAL_SYNC, WIDTH);
+	pModeParam->horizontal_sync_start = FIELD_VAL_GET(value, HORIZONTAL_SYNC, START) + 1;
+
+	value = peekRegisterDWord(VERTICAL_TOTAL + offset);
+	pModeParam->vertical_total = FIELD_VAL_GET(value, VERTICAL_TOTAL, TOTAL) + 1;
+	pModeParam->vertical_display_end = FIELD_VAL_GET(value, VERTICAL_TOTAL, DISPLAY_END) + 1;
+
+	value = peekRegisterDWord(VERTICAL_SYNC + offset);
+	pModeParam->vertical_sync_height = FIELD_VAL_GET(value, VERTICAL_SYNC, HEIGHT);
+	pModeParam->vertical_sync_start = FIELD_VAL_GET(value, VERTICAL_SYNC, START) + 1;
+
+	if (pModeParam->horizontal_total == 0 || pModeParam->vertical_total == 0)
+		return -1;
+
+	pModeParam->horizontal_frequency = pModeParam->pixel_clock / pModeParam->horizontal_total;
+	pModeParam->vertical_frequency =
+	    (pModeParam->horizontal_frequency + pModeParam->vertical_total / 2) / pModeParam->vertical_total;
+
+	pLogicalMode->x = pModeParam->horizontal_display_end;
+	pLogicalMode->y = pModeParam->vertical_display_end;
+	pLogicalMode->hz = pModeParam->vertical_frequency;
+	pLogicalMode->dispCtrl = dispCtrl;
+	pLogicalMode->pitch = FIELD_VAL_GET(peekRegisterDWord(FB_WIDTH + offset), FB_WIDTH, WIDTH);
+	pLogicalMode->baseAddress = FIELD_VAL_GET(peekRegisterDWord(FB_ADDRESS + offset), FB_ADDRESS, ADDRESS);
+
 	if (dispCtrl == CHANNEL0_CTRL)
-		return gChannel0CurrentModeParam;
+		pCtx->channel0CurrentModeParam = *pModeParam;
 	else
-		return gChannel1CurrentModeParam;
+		pCtx->channel1CurrentModeParam = *pModeParam;
+
+	return 0;
+}
+
+/*
+ * Return in Hz the pixel clock last asked for on a channel and what the
+ * PLL makes of it. Returns -1 if no mode was set on the channel yet.
+ */
+long ddk768_getPixelClock(ddk768_context_t *pCtx, int dispCtrl,
+			  unsigned long *pRequested, unsigned long *pActual)
+{
+	if (dispCtrl < CHANNEL0_CTRL || dispCtrl > CHANNEL1_CTRL ||
+	    pCtx->requestedPixelClock[dispCtrl] == 0)
+		return -1;
+
+	*pRequested = pCtx->requestedPixelClock[dispCtrl];
+	*pActual = pCtx->actualPixelClock[dispCtrl];
+	return 0;
 }
 
 /*
@@ -743,7 +948,7 @@ long addTiming(disp_control_t dispCtrl,
  *		dispControl		- display control of which base address to be set.
  *		ulBaseAddress	- Base Address value to be set.
  */
-void ddk768_setDisplayBaseAddress(disp_control_t dispControl,
+void ddk768_setDisplayBaseAddress(ddk768_context_t *pCtx, disp_control_t dispControl,
 				  unsigned long ulBaseAddress)
 {
 	unsigned long regFB;
@@ -769,7 +974,7 @@ void ddk768_setDisplayBaseAddress(disp_control_t dispControl,
  *      1   - Display is pending
  *      0   - Display is not pending
  */
-long isDisplayBasePending(disp_control_t dispControl)
+long isDisplayBasePending(ddk768_context_t *pCtx, disp_control_t dispControl)
 {
 	unsigned long regFB;
 
@@ -785,14 +990,36 @@ long isDisplayBasePending(disp_control_t dispControl)
 }
 
 
+/*
+ * Write a register only when it does not already hold the value, so that
+ * setting the mode a channel is running costs reads only.
+ *
+ * return:
+ *         1 = the register was written
+ *         0 = the register already had the value
+ */
+static int updateRegisterDWord(ddk768_context_t *pCtx, unsigned long offset, unsigned long value)
+{
+	if (peekRegisterDWord(offset) == value)
+		return 0;
+
+	pokeRegisterDWord(offset, value);
+	return 1;
+}
+
 /* 
  * Program the hardware for a specific video mode
  *
+ * Only the registers whose value changes are written. In particular the
+ * PLL is left running when it already produces the requested clock, and
+ * the palette is not refilled when neither timing nor format changed.
+ *
  * return:
  *         0 = success
+ *         1 = success, the channel was already running this mode
  *        -1 = fail.
  */
-long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam,	/* mode information about pixel clock, horizontal total, etc. */
+long ddk768_programModeRegisters(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, mode_parameter_t *pModeParam,	/* mode information about pixel clock, horizontal total, etc. */
 				 pll_value_t *pPLL	/* Pre-calculated values for the PLL */
     )
 {
@@ -801,13 +1028,15 @@ long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *
 	unsigned long offset, pllReg;
 	unsigned long hdmi_channel;
 	unsigned long regvalue;
+	unsigned long flags;
+	int changed = 0;
 #if 0				// print UHD register setting for debug.
 	if (pLogicalMode->x == 3840)
 		return (printModeRegisters(pLogicalMode, pModeParam, pPLL));
 #endif
 
 	/*  Make sure normal display channel is used, not VGA channel */
-	pokeRegisterDWord(VGA_CONFIGURATION,
+	changed |= updateRegisterDWord(pCtx, VGA_CONFIGURATION,
 			  FIELD_SET(0, VGA_CONFIGURATION, PLL,
 				    PANEL) | FIELD_SET(0, VGA_CONFIGURATION,
 						       MODE, GRAPHIC));
@@ -816,19 +1045,23 @@ long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *
 	pllReg =
 	    (pLogicalMode->dispCtrl == CHANNEL0_CTRL) ? VCLK0_PLL : VCLK1_PLL;
 
-	/* Turn off PLL at first. */
-	regvalue = peekRegisterByte(pllReg);
-	regvalue |= (1 << 0);
-	pokeRegisterDWord(pllReg, regvalue);
-	/* Poke setting. */
-	regvalue = ddk768_formatPllReg(pPLL);
-	regvalue |= (1 << 0);
-	pokeRegisterDWord(pllReg, regvalue);
-	/* Delay 100 us and turn on PLL. */
-	udelay(100);
-	regvalue = ddk768_formatPllReg(pPLL);
-	regvalue &= ~(1 << 0);
-	pokeRegisterDWord(pllReg, regvalue);
+	/* Nothing to do if the PLL is already on with these settings. */
+	if (peekRegisterDWord(pllReg) != ddk768_formatPllReg(pPLL)) {
+		/* Turn off PLL at first. */
+		regvalue = peekRegisterByte(pllReg);
+		regvalue |= (1 << 0);
+		pokeRegisterDWord(pllReg, regvalue);
+		/* Poke setting. */
+		regvalue = ddk768_formatPllReg(pPLL);
+		regvalue |= (1 << 0);
+		pokeRegisterDWord(pllReg, regvalue);
+		/* Delay 100 us and turn on PLL. */
+		udelay(100);
+		regvalue = ddk768_formatPllReg(pPLL);
+		regvalue &= ~(1 << 0);
+		pokeRegisterDWord(pllReg, regvalue);
+		changed = 1;
+	}
 
 #if 0
 	/* Frame buffer base */
@@ -840,26 +1073,28 @@ long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *
 #endif
 
 	/* Pitch value (Hardware people calls it Offset) */
-	pokeRegisterDWord((FB_WIDTH + offset),
+	changed |= updateRegisterDWord(pCtx, (FB_WIDTH + offset),
 			  FIELD_VALUE(0, FB_WIDTH, WIDTH, pLogicalMode->pitch));
 
-    pokeRegisterDWord((HORIZONTAL_TOTAL+offset),
+    changed |= updateRegisterDWord(pCtx, (HORIZONTAL_TOTAL+offset),
           FIELD_VALUE(0, HORIZONTAL_TOTAL, TOTAL, pModeParam->horizontal_total - 1)
         | FIELD_VALUE(0, HORIZONTAL_TOTAL, DISPLAY_END, pModeParam->horizontal_display_end - 1));
 
-    pokeRegisterDWord((HORIZONTAL_SYNC+offset),
+    changed |= updateRegisterDWord(pCtx, (HORIZONTAL_SYNC+offset),
           FIELD_VALUE(0, HORIZONTAL_SYNC, WIDTH, pModeParam->horizontal_sync_width)
         | FIELD_VALUE(0, HORIZONTAL_SYNC, START, pModeParam->horizontal_sync_start - 1));
 
-    pokeRegisterDWord((VERTICAL_TOTAL+offset),
+    changed |= updateRegisterDWord(pCtx, (VERTICAL_TOTAL+offset),
           FIELD_VALUE(0, VERTICAL_TOTAL, TOTAL, pModeParam->vertical_total - 1)
         | FIELD_VALUE(0, VERTICAL_TOTAL, DISPLAY_END, pModeParam->vertical_display_end - 1));
 
-    pokeRegisterDWord((VERTICAL_SYNC+offset),
+    changed |= updateRegisterDWord(pCtx, (VERTICAL_SYNC+offset),
           FIELD_VALUE(0, VERTICAL_SYNC, HEIGHT, pModeParam->vertical_sync_height)
         | FIELD_VALUE(0, VERTICAL_SYNC, START, pModeParam->vertical_sync_start - 1));
 
 
+	/* DISPLAY_CTRL is also written by the DPMS, plane and output code */
+	lockRegisterBlock(DDK768_LOCK_DC(pLogicalMode->dispCtrl), flags);
 	hdmi_channel = FIELD_VAL_GET(peekRegisterDWord(DISPLAY_CTRL + offset),
 				     DISPLAY_CTRL, HDMI_SELECT);
 
@@ -903,16 +1138,21 @@ long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *
 		ulTmpValue =
 		    FIELD_SET(ulTmpValue, DISPLAY_CTRL, HDMI_SELECT, CHANNEL1);
 
-	pokeRegisterDWord((DISPLAY_CTRL + offset), ulTmpValue);
+	changed |= updateRegisterDWord(pCtx, (DISPLAY_CTRL + offset), ulTmpValue);
+	unlockRegisterBlock(DDK768_LOCK_DC(pLogicalMode->dispCtrl), flags);
 
 	/* Palette RAM. */
 	paletteRam = PALETTE_RAM + offset;
 
 	/* Save the current mode param */
 	if (pLogicalMode->dispCtrl == CHANNEL0_CTRL)
-		gChannel0CurrentModeParam = *pModeParam;
+		pCtx->channel0CurrentModeParam = *pModeParam;
 	else
-		gChannel1CurrentModeParam = *pModeParam;
+		pCtx->channel1CurrentModeParam = *pModeParam;
+
+	/* Same timing and format: the palette still holds what we filled in. */
+	if (!changed)
+		return 1;
 
 	/* In case of 8-bpp, fill palette */
 	if (pLogicalMode->bpp == 8) {
@@ -975,9 +1215,10 @@ long ddk768_programModeRegisters(logicalMode_t *pLogicalMode, mode_parameter_t *
  * predefined Vesa parameter table (gDefaultModeParamTable) does not fit.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
-long ddk768_setCustomMode(logicalMode_t *pLogicalMode,
+long ddk768_setCustomMode(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode,
 			  mode_parameter_t *pUserModeParam)
 {
 	//mode_parameter_t pModeParam; /* physical parameters for the mode */
@@ -988,13 +1229,13 @@ long ddk768_setCustomMode(logicalMode_t *pLogicalMode,
 	 * Minimum check on mode base address.
 	 * At least it shouldn't be bigger than the size of frame buffer.
 	 */
-	if (ddk768_getFrameBufSize() <= pLogicalMode->baseAddress)
+	if (ddk768_getFrameBufSize(pCtx) <= pLogicalMode->baseAddress)
 		return -1;
 
 	/*
 	 * Set up PLL, a structure to hold the value to be set in clocks.
 	 */
-	if (ddk768_getCrystalType())
+	if (ddk768_getCrystalType(pCtx))
 		pll.inputFreq = (24576000 / 2);
 	else
 		pll.inputFreq = (24000000 / 2);
@@ -1006,6 +1247,8 @@ long ddk768_setCustomMode(logicalMode_t *pLogicalMode,
 	 */
 	ulActualPixelClk =
 	    ddk768_calcPllValue(pUserModeParam->pixel_clock, &pll);
+	pCtx->requestedPixelClock[pLogicalMode->dispCtrl] = pUserModeParam->pixel_clock;
+	pCtx->actualPixelClock[pLogicalMode->dispCtrl] = ulActualPixelClk;
 
 	/* If calling function don't have a preferred pitch value, 
 	   work out a 16 byte aligned pitch value.
@@ -1025,7 +1268,7 @@ long ddk768_setCustomMode(logicalMode_t *pLogicalMode,
 	}
 
 	/* Program the hardware to set up the mode. */
-	return (ddk768_programModeRegisters(pLogicalMode,
+	return (ddk768_programModeRegisters(pCtx, pLogicalMode,
 					    pUserModeParam, &pll));
 }
 
@@ -1034,9 +1277,10 @@ long ddk768_setCustomMode(logicalMode_t *pLogicalMode,
  * The main difference between setMode and setModeEx userData.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
-long ddk768_setModeEx(logicalMode_t *pLogicalMode)
+long ddk768_setModeEx(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode)
 {
 	mode_parameter_t *pModeParam;	/* physical parameters for the mode */
 	unsigned short index = 0;
@@ -1065,7 +1309,7 @@ long ddk768_setModeEx(logicalMode_t *pLogicalMode)
 	if (pModeParam == (mode_parameter_t *) 0)
 		return -1;
 
-	return (ddk768_setCustomMode(pLogicalMode, pModeParam));
+	return (ddk768_setCustomMode(pCtx, pLogicalMode, pModeParam));
 }
 
 /*
@@ -1074,12 +1318,13 @@ long ddk768_setModeEx(logicalMode_t *pLogicalMode)
  * If there are special parameters, use setModeEx.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
-long ddk768_setMode(logicalMode_t *pLogicalMode)
+long ddk768_setMode(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode)
 {
 	pLogicalMode->userData = (void *)0;
 
 	/* Call the setModeEx to set the mode. */
-	return ddk768_setModeEx(pLogicalMode);
+	return ddk768_setModeEx(pCtx, pLogicalMode);
 }
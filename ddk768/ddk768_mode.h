@@ -1,6 +1,8 @@
 #ifndef _DDK768_MODE_H_
 #define _DDK768_MODE_H_
 
+#include "ddk768_help.h"
+
 /* Maximum parameters those can be saved in the mode table. */
 #define MAX_MODE_TABLE_ENTRIES              60
 #define PITCH(width, bpp)               (((width) * (bpp) / 8 + 15) & ~15)
@@ -217,6 +219,19 @@ mode_parameter_t *ddk768_findVesaModeParam(
     unsigned long refresh_rate
 );
 
+/*
+ *  Work out CVT 1.2 reduced blanking timing (version 1 = RB, 2 = RBv2)
+ *  for the requested mode.
+ *  Success: 0, Fail: -1.
+ */
+long ddk768_calcCvtModeParam(
+    unsigned long width,
+    unsigned long height,
+    unsigned long refresh_rate,
+    unsigned long version,
+    mode_parameter_t *pModeParam
+);
+
 /*
  * Return a point to the gDefaultModeParamTable.
  * Function in other files used this to get the mode table pointer.
@@ -262,9 +277,43 @@ unsigned long ddk768_getStockModeParamTableSizeEx(
  * This function returns the current mode.
  */
 mode_parameter_t ddk768_getCurrentModeParam(
+    ddk768_context_t *pCtx,
     disp_control_t dispCtrl
 );
 
+/*
+ * This function returns the pixel clock requested for a channel and the
+ * one the PLL actually produces, in Hz.
+ */
+long ddk768_getPixelClock(
+    ddk768_context_t *pCtx,
+    int dispCtrl,
+    unsigned long *pRequested,
+    unsigned long *pActual
+);
+
+/*
+ *  ddk768_readModeRegisters
+ *      This function reads back the mode a display channel is running, for
+ *      example the one set up by the firmware, and makes it the current mode
+ *      of the channel.
+ *
+ *  Input:
+ *      dispCtrl        - Display control to read
+ *      pModeParam      - Returns the timing and pixel clock
+ *      pLogicalMode    - Returns x, y, bpp, pitch and baseAddress
+ *
+ *  Output:
+ *      0   - The channel timing, plane and PLL are on
+ *     -1   - The channel is not displaying anything
+ */
+long ddk768_readModeRegisters(
+    ddk768_context_t *pCtx,
+    disp_control_t dispCtrl,
+    mode_parameter_t *pModeParam,
+    logicalMode_t *pLogicalMode
+);
+
 /*
  *  getMaximumModeEntries
  *      This function gets the maximum entries that can be stored in the mode table.
@@ -304,6 +353,7 @@ long addTiming(
  *        ulBaseAddress    - Base Address value to be set.
  */
 void ddk768_setDisplayBaseAddress(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl,
     unsigned long ulBaseAddress
 );
@@ -321,6 +371,7 @@ void ddk768_setDisplayBaseAddress(
  *      0   - Display is not pending
  */
 long isDisplayBasePending(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl
 );
 
@@ -336,9 +387,11 @@ long isDisplayBasePending(
  * predefined Vesa parameter table (gDefaultModeParamTable) does not fit.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
 long ddk768_setCustomMode(
+    ddk768_context_t *pCtx,
     logicalMode_t *pLogicalMode, 
     mode_parameter_t *pUserModeParam
 );
@@ -348,9 +401,11 @@ long ddk768_setCustomMode(
  * The main difference between setMode and setModeEx userData.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
 long ddk768_setModeEx(
+    ddk768_context_t *pCtx,
     logicalMode_t *pLogicalMode
 );
 
@@ -360,9 +415,11 @@ long ddk768_setModeEx(
  * If there are special parameters, use setModeEx.
  *
  * Return: 0 (or NO_ERROR) if mode can be set successfully.
+ *         1 if the channel was already running the mode.
  *         -1 if any set mode error.
  */
 long ddk768_setMode(
+    ddk768_context_t *pCtx,
     logicalMode_t *pLogicalMode
 );
 
@@ -3,14 +3,14 @@
 #include "ddk768_chip.h"
 #include "ddk768_power.h"
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 
 /*
  *  Enable/disable jpeg decoder 1.
  */
-void ddk768_enableJPU1(unsigned long enable)
+void ddk768_enableJPU1(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -26,7 +26,7 @@ void ddk768_enableJPU1(unsigned long enable)
 /* 
  * This function enable/disable the 2D engine.
  */
-void ddk768_enable2DEngine(unsigned long enable)
+void ddk768_enable2DEngine(ddk768_context_t *pCtx, unsigned long enable)
 {
 	unsigned long regValue;
 	
@@ -43,7 +43,7 @@ void ddk768_enable2DEngine(unsigned long enable)
 /* 
  * This function enable/disable the ZV Port.
  */
-void ddk768_enableZVPort(unsigned long enable)
+void ddk768_enableZVPort(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -60,7 +60,7 @@ void ddk768_enableZVPort(unsigned long enable)
 /* 
  * This function enable/disable the SSP.
  */
-void ddk768_enableSSP(unsigned long enable)
+void ddk768_enableSSP(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -77,7 +77,7 @@ void ddk768_enableSSP(unsigned long enable)
 /* 
  * This function enable/disable the DMA Engine
  */
-void ddk768_enableDMA(unsigned long enable)
+void ddk768_enableDMA(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -96,7 +96,7 @@ void ddk768_enableDMA(unsigned long enable)
 /*
  *  This function enable/disable HDMI
  */
-void ddk768_enableHDMI(unsigned long enable)
+void ddk768_enableHDMI(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -112,7 +112,7 @@ void ddk768_enableHDMI(unsigned long enable)
 /*
  *  Enable/disable USB 2 Host.
  */
-void ddk768_enableUsbHost(unsigned long enable)
+void ddk768_enableUsbHost(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -128,7 +128,7 @@ void ddk768_enableUsbHost(unsigned long enable)
 /*
  *  Enable/disable USB 3 device
  */
-void ddk768_enableUsbDevice(unsigned long enable)
+void ddk768_enableUsbDevice(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -144,7 +144,7 @@ void ddk768_enableUsbDevice(unsigned long enable)
 /*
  *  Enable/disable jpeg decoder.
  */
-void ddk768_enableJPU(unsigned long enable)
+void ddk768_enableJPU(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -160,7 +160,7 @@ void ddk768_enableJPU(unsigned long enable)
 /*
  *	Enable/disable H264 video decoder.
  */ 
-void ddk768_enableVPU(unsigned long enable)
+void ddk768_enableVPU(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -177,7 +177,7 @@ void ddk768_enableVPU(unsigned long enable)
 /*
  *	Enable/disable UART
  */ 
-void ddk768_enableUART(unsigned long enable)
+void ddk768_enableUART(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -193,7 +193,7 @@ void ddk768_enableUART(unsigned long enable)
 /*
  *	Enable/disable I2S
  */ 
-void ddk768_enableI2S(unsigned long enable)
+void ddk768_enableI2S(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -211,7 +211,7 @@ void ddk768_enableI2S(unsigned long enable)
 /*
  *	Enable/disable ARM
  */ 
-void ddk768_enableARM(unsigned long enable)
+void ddk768_enableARM(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -227,7 +227,7 @@ void ddk768_enableARM(unsigned long enable)
 /*
  *	Enable/disable display control 0
  */ 
-void ddk768_enableDC0(unsigned long enable)
+void ddk768_enableDC0(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -243,7 +243,7 @@ void ddk768_enableDC0(unsigned long enable)
 /*
  *	Enable/disable display control 1
  */ 
-void ddk768_enableDC1(unsigned long enable)
+void ddk768_enableDC1(ddk768_context_t *pCtx, unsigned long enable)
 {
     unsigned long regValue;
 
@@ -1,30 +1,32 @@
 #ifndef _DDK768_POWER_H_
 #define _DDK768_POWER_H_
 
+#include "ddk768_help.h"
 
-void ddk768_enableUsbHost(unsigned long enable);
+
+void ddk768_enableUsbHost(ddk768_context_t *pCtx, unsigned long enable);
 
 
 /*
  *  Enable/disable jpeg decoder 1.
  */
-void ddk768_enableJPU1(unsigned long enable);
+void ddk768_enableJPU1(ddk768_context_t *pCtx, unsigned long enable);
 
 
 /* 
  * This function enable/disable the 2D engine.
  */
-void ddk768_enable2DEngine(unsigned long enable);
+void ddk768_enable2DEngine(ddk768_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the ZV Port 
  */
-void ddk768_enableZVPort(unsigned long enable);
+void ddk768_enableZVPort(ddk768_context_t *pCtx, unsigned long enable);
 
 /* 
  * This function enable/disable the DMA Engine
  */
-void ddk768_enableDMA(unsigned long enable);
+void ddk768_enableDMA(ddk768_context_t *pCtx, unsigned long enable);
 
 
 
@@ -36,15 +38,15 @@ void ddk768_enablePWM(unsigned long enable);
 /* 
  * This function enable/disable the SSP.
  */
-void ddk768_enableSSP(unsigned long enable);
+void ddk768_enableSSP(ddk768_context_t *pCtx, unsigned long enable);
 
 /*
  * This function enable/disable the HDMI Clock. 
  */
-void ddk768_enableHDMI(unsigned long enable);
+void ddk768_enableHDMI(ddk768_context_t *pCtx, unsigned long enable);
 
 
-void ddk768_enableI2S(unsigned long enable);
+void ddk768_enableI2S(ddk768_context_t *pCtx, unsigned long enable);
 
 
 
@@ -1,22 +1,22 @@
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_reg.h"
 #include "ddk768_helper.h"
 #include "ddk768_intr.h"
 #include "ddk768_pwm.h"
 
 
-static unsigned long gPwm = 0;
-
 /*
  * This function open PWM lines in GPIO Mux
  */
 void ddk768_pwmOpen(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 )
 {
-    unsigned long value;
+    unsigned long value, flags;
 
     /* Enable GPIO mux (0x10010) 19, 18 or 17 for PWM output */
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     value = peekRegisterDWord(GPIO_MUX);
 
     switch(pwm)
@@ -35,18 +35,21 @@ void ddk768_pwmOpen(
     }
 
     pokeRegisterDWord(GPIO_MUX, value);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 }
 
 /*
  * This function closes PWM lines in GPIO Mux
  */
 void ddk768_pwmClose(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 )
 {
-    unsigned long value;
+    unsigned long value, flags;
 
     /* Enable GPIO mux (0x10010) 19, 18 or 17 for PWM output */
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     value = peekRegisterDWord(GPIO_MUX);
 
     switch(pwm)
@@ -65,6 +68,7 @@ void ddk768_pwmClose(
     }
 
     pokeRegisterDWord(GPIO_MUX, value);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 }
 
 /*
@@ -95,6 +99,7 @@ void ddk768_pwmCalcCounter(
  *
  */
 void ddk768_pwmStart(
+    ddk768_context_t *pCtx,
     unsigned long pwm,           /* which pwm: 0 to 2 */
     unsigned long divider,
     unsigned long highCounter,
@@ -126,7 +131,7 @@ void ddk768_pwmStart(
     pokeRegisterDWord(pwmAddr, pwmValue);
 
     if (isrSupport)
-        gPwm = pwm;
+        pCtx->pwm = pwm;
 }
 
 /*
@@ -139,6 +144,7 @@ void ddk768_pwmStart(
  *        0 = Raw int is NOT pending.
  */
 unsigned long ddk768_pwmRawIntPending(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 )
 {  
@@ -164,6 +170,7 @@ unsigned long ddk768_pwmRawIntPending(
  * 
  */
 void ddk768_pwmClearRawInt(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 )
 {  
@@ -188,6 +195,7 @@ void ddk768_pwmClearRawInt(
  *
  */
 void ddk768_pwmStop(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 )
 {  
@@ -213,6 +221,7 @@ void ddk768_pwmStop(
  * Input: millisecond unit.
  */
 void ddk768_pwmWait(
+    ddk768_context_t *pCtx,
     unsigned long pwm,
     unsigned long milliSeconds
 )
@@ -225,11 +234,11 @@ void ddk768_pwmWait(
     ddk768_pwmCalcCounter(milliSeconds, &divider, &highCounter);
     lowCounter = highCounter;
 
-    ddk768_pwmStart(pwm, divider, highCounter, lowCounter, 0);
+    ddk768_pwmStart(pCtx, pwm, divider, highCounter, lowCounter, 0);
 
-    while (!ddk768_pwmRawIntPending(pwm)); /* Danger, put a timeout here later */
+    while (!ddk768_pwmRawIntPending(pCtx, pwm)); /* Danger, put a timeout here later */
 
-    ddk768_pwmStop(pwm);
+    ddk768_pwmStop(pCtx, pwm);
 }
 
 /* 
@@ -256,7 +265,7 @@ unsigned long ddk768_pwmIntMask(
  * interrupt under WATCOM DOS extender.
  * 
  */
-void ddk768_pwmIsrTemplate(unsigned long status)
+void ddk768_pwmIsrTemplate(ddk768_context_t *pCtx, unsigned long status)
 {
     /* Check if it's PWM interrupt. */
 
@@ -269,7 +278,7 @@ void ddk768_pwmIsrTemplate(unsigned long status)
            There is no way to tell which PWM generates the interrupt.
            Just Clear the one marked down by pwmStart.
          */
-        ddk768_pwmClearRawInt(gPwm);
+        ddk768_pwmClearRawInt(pCtx, pCtx->pwm);
     }            
 }
 
@@ -1,10 +1,13 @@
 #ifndef _PWM_H_
 #define _PWM_H_
 
+#include "ddk768_help.h"
+
 /*
  * This function open PWM lines in GPIO Mux
  */
 void ddk768_pwmOpen(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 );
 
@@ -12,6 +15,7 @@ void ddk768_pwmOpen(
  * This function closes PWM lines in GPIO Mux
  */
 void ddk768_pwmClose(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 );
 
@@ -34,6 +38,7 @@ void ddk768_pwmCalcCounter(
  *
  */
 void ddk768_pwmStart(
+    ddk768_context_t *pCtx,
     unsigned long pwm,           /* which pwm: 0 to 2 */
     unsigned long divider,
     unsigned long highCounter,
@@ -53,6 +58,7 @@ void ddk768_pwmStart(
  *        0 = Raw int is NOT pending.
  */
 unsigned long ddk768_pwmRawIntPending(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 );
 
@@ -64,6 +70,7 @@ unsigned long ddk768_pwmRawIntPending(
  * 
  */
 void ddk768_pwmClearRawInt(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 );
 
@@ -72,6 +79,7 @@ void ddk768_pwmClearRawInt(
  *
  */
 void ddk768_pwmStop(
+    ddk768_context_t *pCtx,
     unsigned long pwm           /* which pwm: 0 to 2 */
 );
 
@@ -81,6 +89,7 @@ void ddk768_pwmStop(
  * Input: millisecond unit.
  */
 void ddk768_pwmWait(
+    ddk768_context_t *pCtx,
     unsigned long pwm,
     unsigned long milliSeconds
 );
@@ -101,7 +110,7 @@ unsigned long ddk768_pwmIntMask(
  * interrupt under WATCOM DOS extender.
  * 
  */
-void ddk768_pwmIsrTemplate(unsigned long status);
+void ddk768_pwmIsrTemplate(ddk768_context_t *pCtx, unsigned long status);
 
 #endif /* _PWM_H_ */
 
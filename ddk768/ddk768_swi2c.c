@@ -1,11 +1,11 @@
 #include <linux/delay.h>
+#include <linux/sched.h>
 
 #include "ddk768_reg.h"
 #include "ddk768_chip.h"
 #include "ddk768_power.h"
-#include "ddk768_timer.h"
 #include "ddk768_swi2c.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 
 
 /*******************************************************************
@@ -46,115 +46,84 @@
  *
  ******************************************************************/
 
-/* GPIO pins used for this I2C. It ranges from 0 to 31. */
-unsigned char g_i2cClockGPIO = DEFAULT_I2C0_SCL;
-unsigned char g_i2cDataGPIO = DEFAULT_I2C0_SDA;
-
-/*
- *  Below is the variable declaration for the GPIO pin register usage
- *  for the i2c Clock and i2c Data.
- *
- *  Note:
- *      Notice that the GPIO usage for the i2c clock and i2c Data are
- *      separated. This is to make this code flexible enough when 
- *      two separate GPIO pins for the clock and data are located
- *      in two different GPIO register set (worst case).
- */
-
-/* i2c Clock GPIO Register usage */
-static unsigned long g_i2cClkGPIOMuxReg = GPIO_MUX;
-static unsigned long g_i2cClkGPIODataReg = GPIO_DATA;
-static unsigned long g_i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
-
-/* i2c Data GPIO Register usage */
-static unsigned long g_i2cDataGPIOMuxReg = GPIO_MUX;
-static unsigned long g_i2cDataGPIODataReg = GPIO_DATA;
-static unsigned long g_i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
-
 /*
  *  This function puts a delay between command
  */        
-static void swI2CWait(void)
+static void swI2CWait(ddk768_context_t *pCtx)
 {
-    //SM768 has build-in timer. Use it instead of SW loop.
-    timerWaitTicks(3, 0x3ff);
+    /* Half an SCL period at the bus speed set by ddk768_swI2CSetSpeed() */
+    ndelay(pCtx->i2cHalfPeriod);
 }
 
-static void swI2CSCL(unsigned char value, unsigned char i2cClockGPIO)
+/*
+ *  Drive one of the I2C lines. The lines are open drain: high means
+ *  releasing the pin (input, pulled up externally), low means driving the
+ *  output latch, which ddk768_swI2CSetGPIO() cleared, onto the pin. Both
+ *  are a single write of the shadowed direction register.
+ */
+static void swI2CSetLine(ddk768_context_t *pCtx, unsigned char value, unsigned char gpio)
 {
-    unsigned long ulGPIOData;
-    unsigned long ulGPIODirection;
+    unsigned long flags;
 
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     if (value) /* High */
     {
         /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION, 0, 1 << gpio);
     }
     else /* Low */
     {
-        /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
-        ulGPIOData &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataReg, ulGPIOData);
-
-        /* Set direction as output */
-        ulGPIODirection |= (1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
+        /* Set the signal down, then set direction as output */
+        ddk768_gpioUpdate(pCtx, GPIO_DATA, 0, 1 << gpio);
+        ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION, 1 << gpio, 0);
     }
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 }
 
 /*
- *  This function read the data from the SDA GPIO pin
+ *  Release one of the I2C lines and sample it.
  *
  *  Return Value:
- *      The SDA data bit sent by the Slave
+ *      The level of the line
  */
-static unsigned char swI2CReadSCL(unsigned char i2cClockGPIO)
+static unsigned char swI2CReadLine(ddk768_context_t *pCtx, unsigned char gpio)
 {
-    unsigned long ulGPIODirection;
     unsigned long ulGPIOData;
+    unsigned long flags;
 
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
     /* Make sure that the direction is input (High) */
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
-    if ((ulGPIODirection & (1 << i2cClockGPIO)) != (~(1 << i2cClockGPIO)))
-    {
-        ulGPIODirection &= ~(1 << i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
-    }
+    ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION, 0, 1 << gpio);
+
+    /* Now read the line */
+    ulGPIOData = peekRegisterDWord(GPIO_DATA);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
-    /* Now read the SCL line */
-    ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
-    if (ulGPIOData & (1 << i2cClockGPIO))
+    if (ulGPIOData & (1 << gpio))
         return 1;
     else
         return 0;
 }
 
-static void swI2CSDA(unsigned char value, unsigned char i2cDataGPIO)
+static void swI2CSCL(ddk768_context_t *pCtx, unsigned char value, unsigned char i2cClockGPIO)
 {
-    unsigned long ulGPIOData;
-    unsigned long ulGPIODirection;
+    swI2CSetLine(pCtx, value, i2cClockGPIO);
+}
 
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
-    if (value) /* High */
-    {
-        /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
-    }
-    else /* Low */
-    {
-        /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
-        ulGPIOData &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataReg, ulGPIOData);
-
-        /* Set direction as output */
-        ulGPIODirection |= (1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
-    }
+/*
+ *  This function read the data from the SCL GPIO pin
+ *
+ *  Return Value:
+ *      The SCL level, low while a slave stretches the clock
+ */
+static unsigned char swI2CReadSCL(ddk768_context_t *pCtx, unsigned char i2cClockGPIO)
+{
+    return swI2CReadLine(pCtx, i2cClockGPIO);
+}
+
+static void swI2CSDA(ddk768_context_t *pCtx, unsigned char value, unsigned char i2cDataGPIO)
+{
+    swI2CSetLine(pCtx, value, i2cDataGPIO);
 }
 
 /*
@@ -163,25 +132,9 @@ static void swI2CSDA(unsigned char value, unsigned char i2cDataGPIO)
  *  Return Value:
  *      The SDA data bit sent by the Slave
  */
-static unsigned char swI2CReadSDA(unsigned char i2cDataGPIO)
+static unsigned char swI2CReadSDA(ddk768_context_t *pCtx, unsigned char i2cDataGPIO)
 {
-    unsigned long ulGPIODirection;
-    unsigned long ulGPIOData;
-
-    /* Make sure that the direction is input (High) */
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
-    if ((ulGPIODirection & (1 << i2cDataGPIO)) != (~(1 << i2cDataGPIO)))
-    {
-        ulGPIODirection &= ~(1 << i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
-    }
-
-    /* Now read the SDA line */
-    ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
-    if (ulGPIOData & (1 << i2cDataGPIO))
-        return 1;
-    else
-        return 0;
+    return swI2CReadLine(pCtx, i2cDataGPIO);
 }
 
 /*
@@ -196,29 +149,9 @@ static unsigned char swI2CReadSDA(unsigned char i2cDataGPIO)
  *      signal because the i2c will fail when other device try to drive the
  *      signal due to SM50x will drive the signal to always high.
  */
-void ddk768_swI2CSDA(unsigned char value)
+void ddk768_swI2CSDA(ddk768_context_t *pCtx, unsigned char value)
 {
-    unsigned long ulGPIOData;
-    unsigned long ulGPIODirection;
-
-    ulGPIODirection = peekRegisterDWord(g_i2cDataGPIODataDirReg);
-    if (value)      /* High */
-    {
-        /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << g_i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
-    }
-    else            /* Low */
-    {
-        /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cDataGPIODataReg);
-        ulGPIOData &= ~(1 << g_i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataReg, ulGPIOData);
-
-        /* Set direction as output */
-        ulGPIODirection |= (1 << g_i2cDataGPIO);
-        pokeRegisterDWord(g_i2cDataGPIODataDirReg, ulGPIODirection);
-    }
+    swI2CSetLine(pCtx, value, pCtx->i2cDataGPIO);
 }
 
 
@@ -234,58 +167,54 @@ void ddk768_swI2CSDA(unsigned char value)
  *      signal because the i2c will fail when other device try to drive the
  *      signal due to SM50x will drive the signal to always high.
  */
-void ddk768_swI2CSCL(unsigned char value)
+void ddk768_swI2CSCL(ddk768_context_t *pCtx, unsigned char value)
 {
-    unsigned long ulGPIOData;
-    unsigned long ulGPIODirection;
+    swI2CSetLine(pCtx, value, pCtx->i2cClockGPIO);
+}
 
-    ulGPIODirection = peekRegisterDWord(g_i2cClkGPIODataDirReg);
-    if (value)      /* High */
-    {
-        /* Set direction as input. This will automatically pull the signal up. */
-        ulGPIODirection &= ~(1 << g_i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
-    }
-    else            /* Low */
-    {
-        /* Set the signal down */
-        ulGPIOData = peekRegisterDWord(g_i2cClkGPIODataReg);
-        ulGPIOData &= ~(1 << g_i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataReg, ulGPIOData);
-
-        /* Set direction as output */
-        ulGPIODirection |= (1 << g_i2cClockGPIO);
-        pokeRegisterDWord(g_i2cClkGPIODataDirReg, ulGPIODirection);
-    }
+/*
+ *  This function sets the bus speed of the software I2C master
+ *
+ *  Parameters:
+ *      khz     - SCL frequency in kHz, 100 (standard) or 400 (fast mode)
+ */
+void ddk768_swI2CSetSpeed(ddk768_context_t *pCtx, unsigned int khz)
+{
+    if (khz == 0)
+        khz = 100;
+    else if (khz > 400)
+        khz = 400;
+
+    pCtx->i2cHalfPeriod = DIV_ROUND_UP(500000, khz);
 }
 #pragma GCC push_options
 #pragma GCC optimize("O0")
 /*
  *  This function sends ACK signal
  */
-static void swI2CAck(unsigned char ack)
+static void swI2CAck(ddk768_context_t *pCtx, unsigned char ack)
 {
         if(ack)
     {
-        ddk768_swI2CSCL(0);
-        ddk768_swI2CSDA(0);
-        swI2CWait();
-        ddk768_swI2CSCL(1);
-        swI2CWait();
-        ddk768_swI2CSCL(0);
-        ddk768_swI2CSDA(0);
-        swI2CWait();
+        ddk768_swI2CSCL(pCtx, 0);
+        ddk768_swI2CSDA(pCtx, 0);
+        swI2CWait(pCtx);
+        ddk768_swI2CSCL(pCtx, 1);
+        swI2CWait(pCtx);
+        ddk768_swI2CSCL(pCtx, 0);
+        ddk768_swI2CSDA(pCtx, 0);
+        swI2CWait(pCtx);
     }
     else
     {
-        ddk768_swI2CSCL(0);
-        ddk768_swI2CSDA(1);
-        swI2CWait();
-        ddk768_swI2CSCL(1);
-        swI2CWait();
-        ddk768_swI2CSCL(0);
-        ddk768_swI2CSDA(0);
-        swI2CWait();
+        ddk768_swI2CSCL(pCtx, 0);
+        ddk768_swI2CSDA(pCtx, 1);
+        swI2CWait(pCtx);
+        ddk768_swI2CSCL(pCtx, 1);
+        swI2CWait(pCtx);
+        ddk768_swI2CSCL(pCtx, 0);
+        ddk768_swI2CSDA(pCtx, 0);
+        swI2CWait(pCtx);
     }
 
     return;  /* Single byte read is ok without it. */
@@ -295,31 +224,31 @@ static void swI2CAck(unsigned char ack)
 /*
  *  This function sends the start command to the slave device
  */
-void ddk768_swI2CStart(void)
+void ddk768_swI2CStart(ddk768_context_t *pCtx)
 {
     /* Start I2C */
-    swI2CSDA(1, g_i2cDataGPIO);
-    swI2CSCL(1, g_i2cClockGPIO);
-    swI2CSDA(0, g_i2cDataGPIO);
+    swI2CSDA(pCtx, 1, pCtx->i2cDataGPIO);
+    swI2CSCL(pCtx, 1, pCtx->i2cClockGPIO);
+    swI2CSDA(pCtx, 0, pCtx->i2cDataGPIO);
 }
 
 /*
  *  This function sends the stop command to the slave device
  */
-void ddk768_swI2CStop(void)
+void ddk768_swI2CStop(ddk768_context_t *pCtx)
 {
     /* Stop the I2C */
-    swI2CSCL(1, g_i2cClockGPIO);
-    swI2CSDA(0, g_i2cDataGPIO);
-    swI2CSDA(1, g_i2cDataGPIO);
+    swI2CSCL(pCtx, 1, pCtx->i2cClockGPIO);
+    swI2CSDA(pCtx, 0, pCtx->i2cDataGPIO);
+    swI2CSDA(pCtx, 1, pCtx->i2cDataGPIO);
 }
 
-void ddk768_swI2CClean(void)
+void ddk768_swI2CClean(ddk768_context_t *pCtx)
 {
-    swI2CSCL(0, g_i2cClockGPIO);
-    swI2CWait();
-    swI2CSCL(1, g_i2cClockGPIO);
-    swI2CWait();
+    swI2CSCL(pCtx, 0, pCtx->i2cClockGPIO);
+    swI2CWait(pCtx);
+    swI2CSCL(pCtx, 1, pCtx->i2cClockGPIO);
+    swI2CWait(pCtx);
 }
 
 /*
@@ -332,7 +261,7 @@ void ddk768_swI2CClean(void)
  *       0   - Success
  *      -1   - Fail to write byte
  */
-long ddk768_swI2CWriteByte(unsigned char data) 
+long ddk768_swI2CWriteByte(ddk768_context_t *pCtx, unsigned char data) 
 {
     unsigned char value = data;
     int i;
@@ -341,18 +270,18 @@ long ddk768_swI2CWriteByte(unsigned char data)
     for (i=0; i<8; i++)
     {
         /* Set SCL to low */
-        swI2CSCL(0, g_i2cClockGPIO);
+        swI2CSCL(pCtx, 0, pCtx->i2cClockGPIO);
 
         /* Send data bit */
         if ((value & 0x80) != 0)
-            swI2CSDA(1, g_i2cDataGPIO);
+            swI2CSDA(pCtx, 1, pCtx->i2cDataGPIO);
         else
-            swI2CSDA(0, g_i2cDataGPIO);
+            swI2CSDA(pCtx, 0, pCtx->i2cDataGPIO);
 
-        swI2CWait();
+        swI2CWait(pCtx);
 
         /* Toggle clk line to one */
-        swI2CSCL(1, g_i2cClockGPIO);
+        swI2CSCL(pCtx, 1, pCtx->i2cClockGPIO);
       
 
         /* Shift byte to be sent */
@@ -360,29 +289,29 @@ long ddk768_swI2CWriteByte(unsigned char data)
     }
 
     /* Set the SCL Low and SDA High (prepare to get input) */
-    swI2CSCL(0, g_i2cClockGPIO);
-    swI2CSDA(1, g_i2cDataGPIO);
+    swI2CSCL(pCtx, 0, pCtx->i2cClockGPIO);
+    swI2CSDA(pCtx, 1, pCtx->i2cDataGPIO);
 
     /* Set the SCL High for ack */
-    swI2CWait();
-    swI2CSCL(1, g_i2cClockGPIO);
+    swI2CWait(pCtx);
+    swI2CSCL(pCtx, 1, pCtx->i2cClockGPIO);
 
 
     /* Read SDA, until SDA==0 */
     for(i=0; i<0xf; i++) 
     {
-        if (!swI2CReadSDA(g_i2cDataGPIO))
+        if (!swI2CReadSDA(pCtx, pCtx->i2cDataGPIO))
             break;
 
 
-        swI2CWait();
+        swI2CWait(pCtx);
 
-        swI2CWait();
+        swI2CWait(pCtx);
     }
 
     /* Set the SCL Low and SDA High */
-    swI2CSCL(0, g_i2cClockGPIO);
-    swI2CSDA(1, g_i2cDataGPIO);
+    swI2CSCL(pCtx, 0, pCtx->i2cClockGPIO);
+    swI2CSDA(pCtx, 1, pCtx->i2cDataGPIO);
 
     if (i<0xf)
         return 0;
@@ -393,32 +322,45 @@ long ddk768_swI2CWriteByte(unsigned char data)
 #pragma GCC pop_options
 
 long ddk768_swI2CSetGPIO(
+    ddk768_context_t *pCtx,
     unsigned char i2cClkGPIO,
     unsigned char i2cDataGPIO)
 {
+    unsigned long flags;
+
     /* Return 0 if the GPIO pins to be used is out of range. The range is only from [0..63] */
     if ((i2cClkGPIO > 31) || (i2cDataGPIO > 31))
         return (-1);
 
     /* Initialize the GPIO pin for the i2c Clock Register */
-    g_i2cClkGPIOMuxReg = GPIO_MUX;
-    g_i2cClkGPIODataReg = GPIO_DATA;
-    g_i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cClkGPIOMuxReg = GPIO_MUX;
+    pCtx->i2cClkGPIODataReg = GPIO_DATA;
+    pCtx->i2cClkGPIODataDirReg = GPIO_DATA_DIRECTION;
 
 
 
     /* Initialize the GPIO pin for the i2c Data Register */
-    g_i2cDataGPIOMuxReg = GPIO_MUX;
-    g_i2cDataGPIODataReg = GPIO_DATA;
-    g_i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
+    pCtx->i2cDataGPIOMuxReg = GPIO_MUX;
+    pCtx->i2cDataGPIODataReg = GPIO_DATA;
+    pCtx->i2cDataGPIODataDirReg = GPIO_DATA_DIRECTION;
 
 
 
     /* Enable the GPIO pins for the i2c Clock and Data (GPIO MUX) */
-    pokeRegisterDWord(g_i2cClkGPIOMuxReg,
-                      peekRegisterDWord(g_i2cClkGPIOMuxReg) & ~(1 << i2cClkGPIO));
-    pokeRegisterDWord(g_i2cDataGPIOMuxReg,
-                      peekRegisterDWord(g_i2cDataGPIOMuxReg) & ~(1 << i2cDataGPIO));
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
+    pokeRegisterDWord(pCtx->i2cClkGPIOMuxReg,
+                      peekRegisterDWord(pCtx->i2cClkGPIOMuxReg) & ~(1 << i2cClkGPIO));
+    pokeRegisterDWord(pCtx->i2cDataGPIOMuxReg,
+                      peekRegisterDWord(pCtx->i2cDataGPIOMuxReg) & ~(1 << i2cDataGPIO));
+
+    /*
+     * Clear the output latch of both lines once, driving a line low is then
+     * only a direction change. Write it unconditionally: the shadow of an
+     * input pin holds the pin level, not what is in the latch.
+     */
+    pCtx->gpioData &= ~((1 << i2cClkGPIO) | (1 << i2cDataGPIO));
+    pokeRegisterDWord(GPIO_DATA, pCtx->gpioData);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
     /* Enable GPIO power */
     //enableGPIO(1);
@@ -437,14 +379,14 @@ long ddk768_swI2CSetGPIO(
  *      -1   - Fail to initialize the i2c
  *       0   - Success
  */
-long ddk768_swI2CInit(unsigned char i2cClkGPIO, unsigned char i2cDataGPIO)
+long ddk768_swI2CInit(ddk768_context_t *pCtx, unsigned char i2cClkGPIO, unsigned char i2cDataGPIO)
 {
 
     /* GPIO pins used for this I2C. It ranges from 0 to 31. */
-    g_i2cClockGPIO = i2cClkGPIO;
-    g_i2cDataGPIO = i2cDataGPIO;
+    pCtx->i2cClockGPIO = i2cClkGPIO;
+    pCtx->i2cDataGPIO = i2cDataGPIO;
 
-    if (ddk768_swI2CSetGPIO(i2cClkGPIO, i2cDataGPIO))
+    if (ddk768_swI2CSetGPIO(pCtx, i2cClkGPIO, i2cDataGPIO))
         return (-1);
 
 #if 0
@@ -461,33 +403,49 @@ long ddk768_swI2CInit(unsigned char i2cClkGPIO, unsigned char i2cDataGPIO)
 static void smi_ddc_setsda(void *data, int state)
 {
     struct smi_connector *connector = data;
-    swI2CSDA(state, connector->i2c_sda);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk768_context_t *pCtx = sdev->ddk768_ctx;
+    swI2CSDA(pCtx, state, connector->i2c_sda);
     /* smi_set_i2c_signal(data, I2C_SDA_MASK, state); */
 }
 
 static void smi_ddc_setscl(void *data, int state)
 {
     struct smi_connector *connector = data;
-    swI2CSCL(state, connector->i2c_scl);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk768_context_t *pCtx = sdev->ddk768_ctx;
+    swI2CSCL(pCtx, state, connector->i2c_scl);
     /* smi_set_i2c_signal(data, I2C_SCL_MASK, state); */
+
+    /*
+     * i2c-algo-bit busy-waits the whole transfer. Give the CPU away about
+     * once per byte (9 clocks), while SCL is held low: the slaves have to
+     * cope with a master that stretches the low phase.
+     */
+    if (!state && ++connector->i2c_clocks % 9 == 0)
+        cond_resched();
 }
 
 static int smi_ddc_getsda(void *data)
 {
 
     struct smi_connector *connector = data;
-    return (int)swI2CReadSDA(connector->i2c_sda);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk768_context_t *pCtx = sdev->ddk768_ctx;
+    return (int)swI2CReadSDA(pCtx, connector->i2c_sda);
     /* return smi_get_i2c_signal(data, I2C_SDA_MASK); */
 }
 
 static int smi_ddc_getscl(void *data)
 {
     struct smi_connector *connector = data;
-    return (int)swI2CReadSCL(connector->i2c_scl);
+    struct smi_device *sdev = connector->base.dev->dev_private;
+    ddk768_context_t *pCtx = sdev->ddk768_ctx;
+    return (int)swI2CReadSCL(pCtx, connector->i2c_scl);
     /* return smi_get_i2c_signal(data, I2C_SCL_MASK); */
 }
 
-static int smi_ddc_create(struct smi_connector *connector)
+static int smi_ddc_create(ddk768_context_t *pCtx, struct smi_connector *connector)
 {
     connector->adapter.owner = THIS_MODULE;
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
@@ -498,7 +456,8 @@ static int smi_ddc_create(struct smi_connector *connector)
     i2c_set_adapdata(&connector->adapter, connector);
     connector->adapter.algo_data = &connector->bit_data;
 
-    connector->bit_data.udelay = 2; /* 0x3ff ticks, 168MHZ */
+    /* Half SCL period in us, rounded up: 2 for 400 kHz, 5 for 100 kHz */
+    connector->bit_data.udelay = DIV_ROUND_UP(pCtx->i2cHalfPeriod, 1000);
     connector->bit_data.timeout = usecs_to_jiffies(2200);
     connector->bit_data.data = connector;
     connector->bit_data.setsda = smi_ddc_setsda;
@@ -515,7 +474,7 @@ static int smi_ddc_create(struct smi_connector *connector)
 }
 
 
-long ddk768_AdaptSWI2CInit(struct smi_connector *smi_connector)
+long ddk768_AdaptSWI2CInit(ddk768_context_t *pCtx, struct smi_connector *smi_connector)
 {
     struct drm_connector *connector = &smi_connector->base;
     unsigned char i2cClkGPIO;
@@ -544,7 +503,7 @@ long ddk768_AdaptSWI2CInit(struct smi_connector *smi_connector)
     smi_connector->i2c_scl = i2cClkGPIO;
     smi_connector->i2c_sda = i2cDataGPIO;
 
-    if (ddk768_swI2CSetGPIO(i2cClkGPIO, i2cDataGPIO))
+    if (ddk768_swI2CSetGPIO(pCtx, i2cClkGPIO, i2cDataGPIO))
     {
         return (-1);
     }
@@ -560,7 +519,7 @@ long ddk768_AdaptSWI2CInit(struct smi_connector *smi_connector)
 
     udelay(20);
 
-    if (smi_ddc_create(smi_connector))
+    if (smi_ddc_create(pCtx, smi_connector))
     {
         return -1;
     }
@@ -571,18 +530,19 @@ long ddk768_AdaptSWI2CInit(struct smi_connector *smi_connector)
 
 /* After closing HW I2C, give a SCL clk by SW to avoid the deadlock */
 long ddk768_AdaptSWI2CCleanBus(
+    ddk768_context_t *pCtx,
     struct smi_connector *connector)
 {
     unsigned char i2cClkGPIO = connector->i2c_scl;
     unsigned char i2cDataGPIO = connector->i2c_sda;
 
-    if (ddk768_swI2CSetGPIO(i2cClkGPIO, i2cDataGPIO))
+    if (ddk768_swI2CSetGPIO(pCtx, i2cClkGPIO, i2cDataGPIO))
         return (-1);
 
     udelay(20);
-    swI2CSCL(0, i2cClkGPIO);
+    swI2CSCL(pCtx, 0, i2cClkGPIO);
     udelay(20);
-    swI2CSCL(1, i2cClkGPIO);
+    swI2CSCL(pCtx, 1, i2cClkGPIO);
     udelay(20);
 //    ddk768_swI2CClean();
 
@@ -592,7 +552,7 @@ long ddk768_AdaptSWI2CCleanBus(
 
 /*
  *  This function writes a value to the slave device's register
- *  (here the g_i2cClockGPIO and g_i2cDataGPIO must have been initilized) 
+ *  (here the I2C GPIO pins in the device context must have been initilized) 
  *
  *  Parameters:
  *      deviceAddress   - i2c Slave device address which register
@@ -605,6 +565,7 @@ long ddk768_AdaptSWI2CCleanBus(
  *         -1   - Fail
  */
 long ddk768_swI2CWriteReg(
+    ddk768_context_t *pCtx,
     unsigned char deviceAddress,
     unsigned char registerIndex,
     unsigned char data)
@@ -612,26 +573,26 @@ long ddk768_swI2CWriteReg(
     long returnValue = 0;
     
     /* Send the Start signal */
-    ddk768_swI2CStart();
+    ddk768_swI2CStart(pCtx);
 
     /* Send the device address and read the data. All should return success
        in order for the writing processed to be successful
      */
-    if ((ddk768_swI2CWriteByte(deviceAddress) != 0) ||
-        (ddk768_swI2CWriteByte(registerIndex) != 0) ||
-        (ddk768_swI2CWriteByte(data) != 0))
+    if ((ddk768_swI2CWriteByte(pCtx, deviceAddress) != 0) ||
+        (ddk768_swI2CWriteByte(pCtx, registerIndex) != 0) ||
+        (ddk768_swI2CWriteByte(pCtx, data) != 0))
     {
         returnValue = -1;
     }
 
     /* Stop i2c and release the bus */
-    ddk768_swI2CStop();
+    ddk768_swI2CStop(pCtx);
 
     return returnValue;
 }
 
 
-unsigned char ddk768_swI2CReadByte(unsigned char ack)
+unsigned char ddk768_swI2CReadByte(ddk768_context_t *pCtx, unsigned char ack)
 {
     int i;
     unsigned char data = 0;
@@ -639,19 +600,19 @@ unsigned char ddk768_swI2CReadByte(unsigned char ack)
     for(i=7; i>=0; i--)
     {
         /* Set the SCL to Low and SDA to High (Input) */
-        ddk768_swI2CSCL(0);
-        ddk768_swI2CSDA(1);
-        swI2CWait();
+        ddk768_swI2CSCL(pCtx, 0);
+        ddk768_swI2CSDA(pCtx, 1);
+        swI2CWait(pCtx);
 
         /* Set the SCL High */
-        ddk768_swI2CSCL(1);
-        swI2CWait();
+        ddk768_swI2CSCL(pCtx, 1);
+        swI2CWait(pCtx);
 
         /* Read data bits from SDA */
-        data |= (swI2CReadSDA(g_i2cDataGPIO) << i);
+        data |= (swI2CReadSDA(pCtx, pCtx->i2cDataGPIO) << i);
     }
 
-       swI2CAck(ack);
+       swI2CAck(pCtx, ack);
 
 
     return data;
@@ -671,6 +632,7 @@ unsigned char ddk768_swI2CReadByte(unsigned char ack)
 
 
 unsigned char ddk768_swI2CReadReg(
+    ddk768_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 )
@@ -678,22 +640,22 @@ unsigned char ddk768_swI2CReadReg(
     unsigned char data;
 
     /* Send the Start signal */
-    ddk768_swI2CStart();
+    ddk768_swI2CStart(pCtx);
 
     /* Send the device address */
-    ddk768_swI2CWriteByte(deviceAddress);                                                  
+    ddk768_swI2CWriteByte(pCtx, deviceAddress);                                                  
 
     /* Send the register index */
-    ddk768_swI2CWriteByte(registerIndex);               
+    ddk768_swI2CWriteByte(pCtx, registerIndex);               
 
     /* Get the bus again and get the data from the device read address */
-    ddk768_swI2CStart();
-    ddk768_swI2CWriteByte(deviceAddress + 1);
+    ddk768_swI2CStart(pCtx);
+    ddk768_swI2CWriteByte(pCtx, deviceAddress + 1);
 
-       data = ddk768_swI2CReadByte(0);
+       data = ddk768_swI2CReadByte(pCtx, 0);
 
     /* Stop swI2C and release the bus */
-    ddk768_swI2CStop();
+    ddk768_swI2CStop(pCtx);
 
     return data;
 }
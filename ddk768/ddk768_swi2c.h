@@ -2,6 +2,8 @@
 #ifndef _DDK768_SWI2C_H_
 #define _DDK768_SWI2C_H_
 
+#include "ddk768_help.h"
+
 #include "../smi_drv.h"
 
 /* Default i2c CLK and Data GPIO. These are the default i2c pins */
@@ -23,6 +25,7 @@
  *       0   - Success
  */
 long ddk768_swI2CInit(
+    ddk768_context_t *pCtx,
     unsigned char i2cClkGPIO, 
     unsigned char i2cDataGPIO
 );
@@ -40,21 +43,26 @@ long ddk768_swI2CInit(
  *          0   - Success
  *         -1   - Fail
  */
+void ddk768_swI2CSetSpeed(ddk768_context_t *pCtx, unsigned int khz);
+
 long ddk768_swI2CWriteReg(
+    ddk768_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex, 
     unsigned char data
 );
 
 unsigned char ddk768_swI2CReadReg(
+    ddk768_context_t *pCtx,
     unsigned char deviceAddress, 
     unsigned char registerIndex
 );
 
 
-long ddk768_AdaptSWI2CInit(struct smi_connector *smi_connector);
+long ddk768_AdaptSWI2CInit(ddk768_context_t *pCtx, struct smi_connector *smi_connector);
 
 long ddk768_AdaptSWI2CCleanBus(
+    ddk768_context_t *pCtx,
     struct smi_connector *connector);
 
 
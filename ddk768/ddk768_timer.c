@@ -3,14 +3,7 @@
 #include "ddk768_helper.h"
 #include "ddk768_intr.h"
 #include "ddk768_timer.h"
-#include "ddk768_help.h"
-
-/* 
- * A global varible to store the counter values set in the timer.
- * It is needed because the counter value cannot be read back from the timer.
- * A read to the timer counter only gets the latest value being decremented.
- */
-static unsigned long gTimerCounter[4] = {0, 0, 0, 0};
+#include "ddk768_context.h"
 
 /*
  * Calculate a value for timer counter according to input time in micro-second.
@@ -33,6 +26,7 @@ unsigned long calcTimerCounter(
  *
  */
 void timerStart(
+    ddk768_context_t *pCtx,
     timer_number_t timer,         /* which timer: 0 to 3 */
     unsigned long timerCounter,   /* Timer counter */
     unsigned long div16Enable     /* Enable the 16 divisor, time out will be increased by 16 */
@@ -56,7 +50,7 @@ void timerStart(
 
     pokeRegisterDWord(ulTimerAddr, ulTimerValue);
 
-    gTimerCounter[timer] = timerCounter;
+    pCtx->timerCounter[timer] = timerCounter;
 }
 
 /*
@@ -69,6 +63,7 @@ void timerStart(
  *        0 = Raw int is NOT pending.
  */
 unsigned long timerRawIntPending(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 )
 {  
@@ -91,6 +86,7 @@ unsigned long timerRawIntPending(
  * 
  */
 void timerClearRawInt(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 )
 {  
@@ -105,7 +101,7 @@ void timerClearRawInt(
 
     pokeRegisterDWord(ulTimerAddr,
             ulTimerValue
-          | FIELD_VALUE(0, TIMER_CONTROL, COUNTER, gTimerCounter[timer]) /* When clearing raw int, we don't want to erase the original counter value */
+          | FIELD_VALUE(0, TIMER_CONTROL, COUNTER, pCtx->timerCounter[timer]) /* When clearing raw int, we don't want to erase the original counter value */
           | FIELD_SET(0, TIMER_CONTROL, RAWINT_STATUS, RESET));    /* Reset the raw interrupt */
 }
 
@@ -114,6 +110,7 @@ void timerClearRawInt(
  *
  */
 void timerStop(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 )
 {  
@@ -130,7 +127,7 @@ void timerStop(
 
     pokeRegisterDWord(ulTimerAddr, ulTimerValue);
 
-    gTimerCounter[timer] = 0;
+    pCtx->timerCounter[timer] = 0;
 }
 
 /*
@@ -139,6 +136,7 @@ void timerStop(
  * Note: When timer is disable, always read back 0.
  */
 unsigned long timerGetCounter(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 )
 {  
@@ -161,13 +159,14 @@ unsigned long timerGetCounter(
  * Note: When timer is disable, always read back 0.
  */
 unsigned long timerGetCounterSetting(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 )
 {
     /* The counter value put in timer cannot be read back from the register.
        It has to keep in global variable.
     */
-    return(gTimerCounter[timer]);
+    return(pCtx->timerCounter[timer]);
 }
 
 /* 
@@ -175,6 +174,7 @@ unsigned long timerGetCounterSetting(
  * in micro-second.
  */
 void timerWait(
+    ddk768_context_t *pCtx,
     timer_number_t timer,
     unsigned long microSeconds
 )
@@ -190,11 +190,11 @@ void timerWait(
 
     //Tick count is based on enabling DIV 16.
     //Third parameter to timerStart is 1.
-    timerStart(timer, ticks, 1);
+    timerStart(pCtx, timer, ticks, 1);
 
-    while (!timerRawIntPending(timer) && --retry);
+    while (!timerRawIntPending(pCtx, timer) && --retry);
 
-    timerStop(timer);
+    timerStop(pCtx, timer);
 }
 
 /* 
@@ -202,6 +202,7 @@ void timerWait(
  *
  */
 void timerWaitTicks(
+    ddk768_context_t *pCtx,
     timer_number_t timer, /* Use timer 0, 1, 2 or 3 */
     unsigned long ticks
 )
@@ -210,11 +211,11 @@ void timerWaitTicks(
     //Counter is 28 bits only.
     ticks &= 0xFFFFFFF;
 
-    timerStart(timer, ticks, 0);
+    timerStart(pCtx, timer, ticks, 0);
 
-    while (!timerRawIntPending(timer) && --retry);
+    while (!timerRawIntPending(pCtx, timer) && --retry);
 
-    timerStop(timer);
+    timerStop(pCtx, timer);
 }
 
 /* 
@@ -257,14 +258,14 @@ unsigned long timerIntMask(
  * interrupt under WATCOM DOS extender.
  * 
  */
-void timerIsrTemplate(unsigned long status)
+void timerIsrTemplate(ddk768_context_t *pCtx, unsigned long status)
 {
     if (FIELD_VAL_GET(status, INT_STATUS, TIMER0) == INT_STATUS_TIMER0_ACTIVE)
     {
         /* Perform ISR action for timer 0 here */
         incTestCounter();
 
-        timerClearRawInt(0);
+        timerClearRawInt(pCtx, 0);
     }            
 
     if (FIELD_VAL_GET(status, INT_STATUS, TIMER1) == INT_STATUS_TIMER1_ACTIVE)
@@ -272,7 +273,7 @@ void timerIsrTemplate(unsigned long status)
         /* Perform ISR action for timer 1 here */
         incTestCounter();
 
-        timerClearRawInt(1);
+        timerClearRawInt(pCtx, 1);
     }            
 
     if (FIELD_VAL_GET(status, INT_STATUS, TIMER2) == INT_STATUS_TIMER2_ACTIVE)
@@ -280,7 +281,7 @@ void timerIsrTemplate(unsigned long status)
         /* Perform ISR action for timer 2 here */
         incTestCounter();
 
-        timerClearRawInt(2);
+        timerClearRawInt(pCtx, 2);
     }            
 
     if (FIELD_VAL_GET(status, INT_STATUS, TIMER3) == INT_STATUS_TIMER3_ACTIVE)
@@ -288,12 +289,13 @@ void timerIsrTemplate(unsigned long status)
         /* Perform ISR action for timer 3 here */
         incTestCounter();
 
-        timerClearRawInt(3);
+        timerClearRawInt(pCtx, 3);
     }            
 }
 
 
 void timerWaitMsec(
+    ddk768_context_t *pCtx,
     unsigned long milliSeconds
 )
 {
@@ -303,14 +305,15 @@ void timerWaitMsec(
     /* Calculate how many ticks are needed for the amount of time.   */
     ticks = 168000 * milliSeconds;
 
-    timerStart(timer, ticks, 0);
+    timerStart(pCtx, timer, ticks, 0);
 
-    while (!timerRawIntPending(timer));
+    while (!timerRawIntPending(pCtx, timer));
 
-    timerStop(timer);
+    timerStop(pCtx, timer);
 }
 
 void timerWaitUsec(
+    ddk768_context_t *pCtx,
     unsigned long USeconds
 )
 {
@@ -320,11 +323,11 @@ void timerWaitUsec(
     /* Calculate how many ticks are needed for the amount of time.   */
     ticks = 168 * USeconds;
 
-    timerStart(timer, ticks, 0);
+    timerStart(pCtx, timer, ticks, 0);
 
-    while (!timerRawIntPending(timer));
+    while (!timerRawIntPending(pCtx, timer));
 
-    timerStop(timer);
+    timerStop(pCtx, timer);
 }
 
 
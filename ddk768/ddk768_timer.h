@@ -2,6 +2,8 @@
 #ifndef _TIMER_H_
 #define _TIMER_H_
 
+#include "ddk768_help.h"
+
 
 
 typedef enum _timer_number_t
@@ -31,6 +33,7 @@ unsigned long calcTimerCounter(
  *
  */
 void timerStart(
+    ddk768_context_t *pCtx,
     timer_number_t timer,         /* which timer: 0 to 3 */
     unsigned long timerCounter,      /* Timer counter: use calcTimerCounter() to work out a counter for a specific period. */
     unsigned long div16Enable     /* Enable the 16 divisor, time out will be increased by 16 */
@@ -46,6 +49,7 @@ void timerStart(
  *        0 = Raw int is NOT pending.
  */
 unsigned long timerRawIntPending(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 );
 
@@ -57,6 +61,7 @@ unsigned long timerRawIntPending(
  *
  */
 void timerClearRawInt(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 );
 
@@ -65,6 +70,7 @@ void timerClearRawInt(
  *
  */
 void timerStop(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 );
 
@@ -74,6 +80,7 @@ void timerStop(
  * Note: When timer is disable, always read back 0.
  */
 unsigned long timerGetCounter(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 );
 
@@ -85,6 +92,7 @@ unsigned long timerGetCounter(
  * Note: When timer is disable, always read back 0.
  */
 unsigned long timerGetCounterSetting(
+    ddk768_context_t *pCtx,
     timer_number_t timer         /* which timer: 0 to 3 */
 );
 
@@ -93,6 +101,7 @@ unsigned long timerGetCounterSetting(
  * in micro-second.
  */
 void timerWait(
+    ddk768_context_t *pCtx,
     timer_number_t timer,
     unsigned long microSeconds
 );
@@ -102,6 +111,7 @@ void timerWait(
  *
  */
 void timerWaitTicks(
+    ddk768_context_t *pCtx,
     timer_number_t timer, /* Use timer 0, 1, 2 or 3 */
     unsigned long ticks
 );
@@ -126,16 +136,18 @@ void setTestCounter(unsigned long value);
  * interrupt under WATCOM DOS extender.
  * 
  */
-void timerIsrTemplate(unsigned long status);
+void timerIsrTemplate(ddk768_context_t *pCtx, unsigned long status);
 
 void timerWaitMsec(
+    ddk768_context_t *pCtx,
     unsigned long milliSeconds
 );
 
 void timerWaitUsec(
+    ddk768_context_t *pCtx,
     unsigned long USeconds
 );
-#define sb_OS_WAIT_MSEC_POLL(ms) timerWaitMsec(ms)
-#define sb_OS_WAIT_USEC_POLL(us) timerWaitUsec(us)
+#define sb_OS_WAIT_MSEC_POLL(ms) timerWaitMsec(pCtx, ms)
+#define sb_OS_WAIT_USEC_POLL(us) timerWaitUsec(pCtx, us)
 #endif /* _TIMER_H_ */
 
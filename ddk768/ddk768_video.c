@@ -1,5 +1,5 @@
 
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "ddk768_chip.h"
 #include "ddk768_mode.h"
 #include "ddk768_video.h"
@@ -10,14 +10,6 @@
 
 #define SCALE_CONSTANT                      (1 << 12)
 
-/* Offset Adjustment for the window */
-static short gWidthAdjustment = 0;
-static short gHeightAdjustment = 0;
-
-/* Source Video Width and Height */
-static unsigned long gSrcVideoWidth = 0;
-static unsigned long gSrcVideoHeight = 0;
-
 /*
  *  videoSetWindowAdjustment
  *      This function sets the video window adjustment. There are usually
@@ -29,18 +21,19 @@ static unsigned long gSrcVideoHeight = 0;
  *      heightAdjustment    - Height adjustment in line        
  */
 void videoSetWindowAdjustment(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     short widthAdjustment,
     short heightAdjustment
 )
 {
     unsigned long width, height;
-    videoGetWindowSize(dispCtrl, &width, &height);
+    videoGetWindowSize(pCtx, dispCtrl, &width, &height);
     
-    gWidthAdjustment = widthAdjustment;
-    gHeightAdjustment = heightAdjustment;
+    pCtx->videoWidthAdjustment = widthAdjustment;
+    pCtx->videoHeightAdjustment = heightAdjustment;
     
-    videoSetWindowSize(dispCtrl, width, height);
+    videoSetWindowSize(pCtx, dispCtrl, width, height);
 }
 
 /*
@@ -52,15 +45,16 @@ void videoSetWindowAdjustment(
  *      heightAdjustment    - Height adjustment in line 
  */
 void videoGetWindowAdjustment(
+    ddk768_context_t *pCtx,
     short *pWidthAdjustment,
     short *pHeightAdjustment
 )
 {
     if (pWidthAdjustment != ((short *)0))
-        *pWidthAdjustment = gWidthAdjustment;
+        *pWidthAdjustment = pCtx->videoWidthAdjustment;
     
     if (pHeightAdjustment != ((short *)0))
-        *pHeightAdjustment = gHeightAdjustment;
+        *pHeightAdjustment = pCtx->videoHeightAdjustment;
 }
 
 /*
@@ -76,6 +70,7 @@ void videoGetWindowAdjustment(
  *      1 - Flip pending
  */
 unsigned long videoGetBufferStatus(
+    ddk768_context_t *pCtx,
     unsigned long bufferIndex
 )
 {
@@ -90,7 +85,7 @@ unsigned long videoGetBufferStatus(
  *      pitch   - Number of bytes per line of the video plane 
  *                specified in 128-bit aligned bytes.
  */
-unsigned short videoGetPitch()
+unsigned short videoGetPitch(ddk768_context_t *pCtx)
 {
     return (FIELD_VAL_GET(peekRegisterDWord(VIDEO_FB_WIDTH), VIDEO_FB_WIDTH, WIDTH));
 }
@@ -103,7 +98,7 @@ unsigned short videoGetPitch()
  *      lineOffset  - Number of 128-bit aligned bytes per line 
  *                    of the video plane.
  */
-unsigned short videoGetLineOffset()
+unsigned short videoGetLineOffset(ddk768_context_t *pCtx)
 {
     return (FIELD_VAL_GET(peekRegisterDWord(VIDEO_FB_WIDTH), VIDEO_FB_WIDTH, OFFSET));
 }
@@ -116,6 +111,7 @@ unsigned short videoGetLineOffset()
  *      bufferIndex - The index of the buffer which size to be retrieved
  */
 unsigned long videoGetBufferSize(
+    ddk768_context_t *pCtx,
     unsigned long bufferIndex
 )
 {
@@ -142,6 +138,7 @@ unsigned long videoGetBufferSize(
  *      The video buffer of the requested index.
  */
 unsigned long videoGetBuffer(
+    ddk768_context_t *pCtx,
     unsigned char bufferIndex
 )
 {
@@ -226,6 +223,7 @@ unsigned long videoGetBufferLastAddress(
  *      bufferStartAddress  - The starting address of the buffer
  */
 void videoSetBuffer(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned char bufferIndex,          /* The index of the buffer to be set. */
     unsigned long bufferStartAddress    /* Video buffer with 128-bit alignment */
@@ -235,7 +233,7 @@ void videoSetBuffer(
 	unsigned long regFB;
 
     /* Get the buffer size first */
-    bufferSize = videoGetBufferSize(bufferIndex);
+    bufferSize = videoGetBufferSize(pCtx, bufferIndex);
     
     lastAddress = videoGetBufferLastAddress(bufferIndex);
 #if 0    
@@ -268,6 +266,7 @@ void videoSetBuffer(
  *      bufferStartAddress  - The starting address of the buffer
  */
 void videoSetUVBuffer(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long bufferStartUAddress,    /* Video buffer with 128-bit alignment */
     unsigned long bufferStartVAddress    /* Video buffer with 128-bit alignment */
@@ -294,6 +293,7 @@ void videoSetUVBuffer(
  *                        of the video plane.
  */
 void videoSetPitchOffset(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short pitch,
     unsigned short lineOffset
@@ -318,6 +318,7 @@ void videoSetPitchOffset(
  *                        of the video plane.
  */
 void videoSetUVPitchOffset(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short pitch,
     unsigned short lineOffset
@@ -372,6 +373,7 @@ void videoSetLast(
  *      height      - Video Window height
  */
 void videoSetWindowSize(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long width,
     unsigned long height
@@ -388,8 +390,8 @@ void videoSetWindowSize(
 
 	/* Set bottom and right position */
 	pokeRegisterDWord(regBR,
-	    FIELD_VALUE(0, VIDEO_PLANE_BR, BOTTOM, startY + height - 1 - gHeightAdjustment) |
-	    FIELD_VALUE(0, VIDEO_PLANE_BR, RIGHT, startX + width - 1 - gWidthAdjustment)); 
+	    FIELD_VALUE(0, VIDEO_PLANE_BR, BOTTOM, startY + height - 1 - pCtx->videoHeightAdjustment) |
+	    FIELD_VALUE(0, VIDEO_PLANE_BR, RIGHT, startX + width - 1 - pCtx->videoWidthAdjustment)); 
 }
 
 /*
@@ -401,6 +403,7 @@ void videoSetWindowSize(
  *      height      - Video Window height
  */
 void videoGetWindowSize(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long *pVideoWidth,
     unsigned long *pVideoHeight
@@ -416,10 +419,10 @@ void videoGetWindowSize(
 	positionRightBottom = peekRegisterDWord(regBR);
 	videoWidth  = FIELD_VAL_GET(positionRightBottom, VIDEO_PLANE_BR, RIGHT) - 
 	              FIELD_VAL_GET(positionTopLeft, VIDEO_PLANE_TL, LEFT) + 1 +
-	              gWidthAdjustment;
+	              pCtx->videoWidthAdjustment;
 	videoHeight = FIELD_VAL_GET(positionRightBottom, VIDEO_PLANE_BR, BOTTOM) - 
 	              FIELD_VAL_GET(positionTopLeft, VIDEO_PLANE_TL, TOP) + 1 +
-	              gHeightAdjustment;
+	              pCtx->videoHeightAdjustment;
 
     if (pVideoWidth != ((unsigned long *)0))
         *pVideoWidth = videoWidth;
@@ -437,6 +440,7 @@ void videoGetWindowSize(
  *      startY      - Y Coordinate of the video window starting position
  */
 void videoSetPosition(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long startX,
     unsigned long startY
@@ -448,14 +452,14 @@ void videoSetPosition(
 	regTL = (dispCtrl == CHANNEL0_CTRL)? VIDEO_PLANE_TL : (VIDEO_PLANE_TL+CHANNEL_OFFSET);
 
 	/* Get the video window width and height */
-    videoGetWindowSize(dispCtrl, &videoWidth, &videoHeight);
+    videoGetWindowSize(pCtx, dispCtrl, &videoWidth, &videoHeight);
 
 	pokeRegisterDWord(regTL,
 	    FIELD_VALUE(0, VIDEO_PLANE_TL, TOP, startY) |
 	    FIELD_VALUE(0, VIDEO_PLANE_TL, LEFT, startX));
 
     /* Set bottom and right position */    
-    videoSetWindowSize(dispCtrl, videoWidth, videoHeight);
+    videoSetWindowSize(pCtx, dispCtrl, videoWidth, videoHeight);
 
 }
 
@@ -471,6 +475,7 @@ void videoSetPosition(
  *      blueConstant    - Blue Constant Value
  */
 void videoSetConstants(
+    ddk768_context_t *pCtx,
     unsigned dispCtrl,
     unsigned char  yConstant,               /* Y Adjustment */
     unsigned char  redConstant,             /* Red Conversion constant */
@@ -498,6 +503,7 @@ void videoSetConstants(
  *      bufferInitScale     - Buffer Initial vertical scale value
  */
 void videoSetInitialScale(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short InitScaleHorizontal,
     unsigned short InitScaleVertical
@@ -523,6 +529,7 @@ void videoSetInitialScale(
  *      pbuffer1InitScale   - Pointer to variable to store buffer 1 initial vertical scale
  */
 void videoGetInitialScale(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short *pBufferVInitScale,
     unsigned short *pBufferHInitScale
@@ -549,6 +556,7 @@ void videoGetInitialScale(
  *      dstHeight    - The destination video height
  */
 void videoScale(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long srcWidth,
     unsigned long srcHeight,
@@ -589,6 +597,7 @@ void videoScale(
  *      byteSwap    - Flag to enable/disable YUV data byte swap.
  */
 void videoSwapYUVByte(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
    	video_byteswap_t byteSwap  
 )
@@ -616,6 +625,7 @@ void videoSwapYUVByte(
  *      enableVertInterpolation   - Flag to enable/disable Vertical interpolation
  */
 void videoSetInterpolation(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long enableHorzInterpolation,
     unsigned long enableVertInterpolation
@@ -650,6 +660,7 @@ void videoSetInterpolation(
  *      pVertInterpolationStatus	- Pointer to store the vertical interpolation status
  */
 void videoGetInterpolation(
+    ddk768_context_t *pCtx,
     unsigned long *pHorzInterpolationStatus,
     unsigned long *pVertInterpolationStatus
 )
@@ -682,6 +693,7 @@ void videoGetInterpolation(
  *      startPixel  - Starting pixel number for smooth pixel panning
  */
 void videoSetStartPanningPixel(
+    ddk768_context_t *pCtx,
     unsigned char startPixel
 )
 {
@@ -702,6 +714,7 @@ void videoSetStartPanningPixel(
  *      without proper format will have no effect.
  */
 void videoSetGammaCtrl(
+    ddk768_context_t *pCtx,
     unsigned dispCtrl,
     unsigned long enableGammaCtrl
 )
@@ -729,7 +742,7 @@ void videoSetGammaCtrl(
  *      0   - Disable
  *      1   - Enable
  */
-unsigned char isVideoEnable()
+unsigned char isVideoEnable(ddk768_context_t *pCtx)
 {
     unsigned long value;
     
@@ -746,6 +759,7 @@ unsigned char isVideoEnable()
  *      videoCtrl   - Enable/Disable video
  */
 static void videoSetCtrl(
+    ddk768_context_t *pCtx,
     disp_control_t dispCtrl,
     video_ctrl_t videoCtrl
 )
@@ -775,6 +789,7 @@ static void videoSetCtrl(
  *                    * FORMAT_YUYV - 16-bit YUYV mode
  */
 static void videoSetFormat(
+    ddk768_context_t *pCtx,
     unsigned dispCtrl,
     video_format_t  videoFormat
 )
@@ -912,6 +927,7 @@ unsigned long videoGetEdgeDetection(
  *     -1  - Fail
  */
 unsigned char videoSetupEx(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long x,                /* X Coordinate of the video window */
     unsigned long y,                /* Y Coordinate of the video window */
@@ -935,37 +951,37 @@ unsigned char videoSetupEx(
 {
     unsigned long enableEdgeDetect;
     /* Save the source video width and height */
-    gSrcVideoWidth = srcWidth;
-    gSrcVideoHeight = srcHeight;
+    pCtx->srcVideoWidth = srcWidth;
+    pCtx->srcVideoHeight = srcHeight;
     /* Disable the video plane first */
-    videoSetCtrl(dispCtrl, VIDEO_OFF);
+    videoSetCtrl(pCtx, dispCtrl, VIDEO_OFF);
     
     /* Set the video position */
-    videoSetPosition(dispCtrl, x, y);
+    videoSetPosition(pCtx, dispCtrl, x, y);
     
     /* Set the scale factor */
-    videoScale(dispCtrl, srcWidth, srcHeight, dstWidth, dstHeight);
+    videoScale(pCtx, dispCtrl, srcWidth, srcHeight, dstWidth, dstHeight);
     
     /* Set the video format */
-    videoSetFormat(dispCtrl, videoFormat);
+    videoSetFormat(pCtx, dispCtrl, videoFormat);
     
     /* Set the buffer pitch */
-    videoSetPitchOffset(dispCtrl, srcPitch, srcLineOffset);
+    videoSetPitchOffset(pCtx, dispCtrl, srcPitch, srcLineOffset);
     /* Set the UV buffer pitch */
-    videoSetUVPitchOffset(dispCtrl, sUVPitch, sUVPitch);
+    videoSetUVPitchOffset(pCtx, dispCtrl, sUVPitch, sUVPitch);
     
     /* Enable double buffer */
 //    videoEnableDoubleBuffer(doubleBuffer);
     
     /* Set the video buffer 0 and 1 */
-    videoSetBuffer(dispCtrl, 0, srcAddress0);
+    videoSetBuffer(pCtx, dispCtrl, 0, srcAddress0);
 //    videoSetBuffer(dispCtrl, 1, srcAddress1);
    
     /* Set the video buffer U and V */
-    videoSetUVBuffer(dispCtrl, sUAddress, sVAddress);
+    videoSetUVBuffer(pCtx, dispCtrl, sUAddress, sVAddress);
         
     /* Set the destination video window */
-    videoSetWindowSize(dispCtrl, dstWidth, dstHeight);
+    videoSetWindowSize(pCtx, dispCtrl, dstWidth, dstHeight);
 
     /* Set the last line */
     videoSetLast(dispCtrl, srcWidth, srcHeight);
@@ -1014,6 +1030,7 @@ unsigned char videoSetupEx(
  *     -1  - Fail
  */
 unsigned char videoSetup(
+    ddk768_context_t *pCtx,
     disp_control_t dispCtrl,
     unsigned long x,                /* X Coordinate of the video window */
     unsigned long y,                /* Y Coordinate of the video window */
@@ -1033,7 +1050,7 @@ unsigned char videoSetup(
     video_format_t videoFormat      /* Source video format */
 )
 {
-    return videoSetupEx(dispCtrl, x, y, srcWidth, srcHeight, dstWidth, dstHeight, doubleBuffer, 
+    return videoSetupEx(pCtx, dispCtrl, x, y, srcWidth, srcHeight, dstWidth, dstHeight, doubleBuffer, 
                         srcAddress0, 0, 0, 0,srcPitch, srcLineOffset, videoFormat,
                         0, 0);
     
@@ -1043,22 +1060,23 @@ unsigned char videoSetup(
  *  startVideo
  *      This function starts the video.
  */
-void startVideo( 
+void startVideo(
+ddk768_context_t *pCtx, 
 unsigned dispCtrl
 )
 {
     /* Enable the video plane */
-    videoSetCtrl(dispCtrl, VIDEO_ON);
+    videoSetCtrl(pCtx, dispCtrl, VIDEO_ON);
 }
 
 /*
  *  stopVideo
  *      This function stops the video.
  */
-void stopVideo(unsigned dispCtrl)
+void stopVideo(ddk768_context_t *pCtx, unsigned dispCtrl)
 {
     /* Just disable the video plane */
-    videoSetCtrl(dispCtrl, VIDEO_OFF);
+    videoSetCtrl(pCtx, dispCtrl, VIDEO_OFF);
 }
 
 /*
@@ -1066,6 +1084,7 @@ void stopVideo(unsigned dispCtrl)
 */
 
 int SM768_setOverlay(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl, /* Channel 0 or Channel 1) */
     PBLIT_BLK src,  /* Only need: source Width & Height, Pitch */
     PYUV_BUF_ADDR SrcAddr,   /* Y U V source base address */
@@ -1077,7 +1096,7 @@ int SM768_setOverlay(
     video_format_t VideoFormat = FORMAT_RGB565;
 
     /* Set Video Conversion Constant */
-    videoSetConstants(
+    videoSetConstants(pCtx, 
 			 dispControl,            				  
 			 0,                /* Y Adjustment */
                       0xED,             /* Red Conversion constant */
@@ -1085,19 +1104,19 @@ int SM768_setOverlay(
                       0xED);            /* Blue Conversion constant */
                       
     /* Set video initial scale for Buffer 0 and buffer 1 */                      
-    videoSetInitialScale(dispControl, 0, 0);
+    videoSetInitialScale(pCtx, dispControl, 0, 0);
 
     /* Set source buffer */
     //    videoSetSourceBuffer(NORMAL_BUFFER);
 
     /* Set the YUV Swap byte */
-    videoSwapYUVByte(dispControl,NORMAL);
+    videoSwapYUVByte(pCtx, dispControl,NORMAL);
 
     /* Set video interpolation */
-    videoSetInterpolation(dispControl, 0, 0);
+    videoSetInterpolation(pCtx, dispControl, 0, 0);
 
     /* Not using Gamma Control */
-    videoSetGammaCtrl(dispControl, 0);
+    videoSetGammaCtrl(pCtx, dispControl, 0);
 
     /* Setup the video */
     /* Based on the selected fileFormat, calculate the video source addresses (if necessary) and pitches. */
@@ -1114,7 +1133,7 @@ int SM768_setOverlay(
             VideoFormat = FORMAT_RGB888;
             break;
     }
-    videoSetupEx(
+    videoSetupEx(pCtx, 
                dispControl,
     		   dest->x,    /* X Coordinate of the video window */
                dest->y,   /* Y Coordinate of the video window */ 
@@ -1136,7 +1155,7 @@ int SM768_setOverlay(
                0);   /* Edge Detection value. SM718 only use bit 9 to 0 */
     
     /* Start Video */
-    startVideo(dispControl);
+    startVideo(pCtx, dispControl);
     return 0;
 }
 
@@ -1,3 +1,4 @@
+#include "ddk768_help.h"
 
 /****************************************************************************
    Structure and data type definition 
@@ -103,6 +104,7 @@ typedef struct BLIT_BLK
  *      heightAdjustment    - Height adjustment in line        
  */
 void videoSetWindowAdjustment(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     short widthAdjustment,
     short heightAdjustment
@@ -117,6 +119,7 @@ void videoSetWindowAdjustment(
  *      heightAdjustment    - Height adjustment in line 
  */
 void videoGetWindowAdjustment(
+    ddk768_context_t *pCtx,
     short *pWidthAdjustment,
     short *pHeightAdjustment
 );
@@ -157,6 +160,7 @@ void videoEnableDoubleBuffer(
  *      1 - Flip pending
  */
 unsigned long videoGetBufferStatus(
+    ddk768_context_t *pCtx,
     unsigned long bufferIndex
 );
 
@@ -171,6 +175,7 @@ unsigned long videoGetBufferStatus(
  *      The video buffer of the requested index.
  */
 unsigned long videoGetBuffer(
+    ddk768_context_t *pCtx,
     unsigned char bufferIndex
 );
 
@@ -183,6 +188,7 @@ unsigned long videoGetBuffer(
  *      bufferStartAddress  - The starting address of the buffer
  */
 void videoSetBuffer(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned char bufferIndex,          /* The index of the buffer to be set. */
     unsigned long bufferStartAddress    /* Video buffer with 128-bit alignment */
@@ -196,6 +202,7 @@ void videoSetBuffer(
  *      bufferStartAddress  - The starting address of the buffer
  */
 void videoSetUVBuffer(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long bufferStartUAddress,    /* Video buffer with 128-bit alignment */
     unsigned long bufferStartVAddress    /* Video buffer with 128-bit alignment */
@@ -212,6 +219,7 @@ void videoSetUVBuffer(
  *                        of the video plane.
  */
 void videoSetPitchOffset(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short pitch,
     unsigned short lineOffset
@@ -228,6 +236,7 @@ void videoSetPitchOffset(
  *                        of the video plane.
  */
 void videoSetUVPitchOffset(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short pitch,
     unsigned short lineOffset
@@ -241,7 +250,7 @@ void videoSetUVPitchOffset(
  *      pitch   - Number of bytes per line of the video plane 
  *                specified in 128-bit aligned bytes.
  */
-unsigned short videoGetPitch(void);
+unsigned short videoGetPitch(ddk768_context_t *pCtx);
 
 /*
  * videoGetLineOffset
@@ -251,7 +260,7 @@ unsigned short videoGetPitch(void);
  *      lineOffset  - Number of 128-bit aligned bytes per line 
  *                    of the video plane.
  */
-unsigned short videoGetLineOffset(void);
+unsigned short videoGetLineOffset(ddk768_context_t *pCtx);
 /*
  *  videoSetLast 
  *      This function sets the video source last lines and width.
@@ -276,6 +285,7 @@ void videoSetLast(
  *      height      - Video Window height
  */
 void videoSetWindowSize(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long width,
     unsigned long height
@@ -290,6 +300,7 @@ void videoSetWindowSize(
  *      height      - Video Window height
  */
 void videoGetWindowSize(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long *pWidth,
     unsigned long *pHeight
@@ -304,6 +315,7 @@ void videoGetWindowSize(
  *      startY      - Y Coordinate of the video window starting position
  */
 void videoSetPosition(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long startX,
     unsigned long startY
@@ -321,6 +333,7 @@ void videoSetPosition(
  *      blueConstant    - Blue Constant Value
  */
 void videoSetConstants(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned char  yConstant,               /* Y Adjustment */
     unsigned char  redConstant,             /* Red Conversion constant */
@@ -338,6 +351,7 @@ void videoSetConstants(
  *      bufferInitScale     - Buffer Initial vertical scale value
  */
 void videoSetInitialScale(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned short InitScaleHorizontal,
     unsigned short InitScaleVertical
@@ -376,6 +390,7 @@ void videoSetSourceBuffer(
  *      byteSwap    - Flag to enable/disable YUV data byte swap.
  */
 void videoSwapYUVByte(
+   ddk768_context_t *pCtx,
    unsigned dispCtrl,
    video_byteswap_t byteSwap  
 );
@@ -389,6 +404,7 @@ void videoSwapYUVByte(
  *      enableVertInterpolation   - Flag to enable/disable Vertical interpolation
  */
 void videoSetInterpolation(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long enableHorzInterpolation,
     unsigned long enableVertInterpolation
@@ -403,6 +419,7 @@ void videoSetInterpolation(
  *      pVertInterpolationStatus	- Pointer to store the vertical interpolation status
  */
 void videoGetInterpolation(
+    ddk768_context_t *pCtx,
     unsigned long *pHorzInterpolationStatus,
     unsigned long *pVertInterpolationStatus
 );
@@ -415,6 +432,7 @@ void videoGetInterpolation(
  *      startPixel  - Starting pixel number for smooth pixel panning
  */
 void videoSetStartPanningPixel(
+    ddk768_context_t *pCtx,
     unsigned char startPixel
 );
 
@@ -430,6 +448,7 @@ void videoSetStartPanningPixel(
  *      without proper format will have no effect.
  */
 void videoSetGammaCtrl(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long enableGammaCtrl
 );
@@ -442,7 +461,7 @@ void videoSetGammaCtrl(
  *      0   - Disable
  *      1   - Enable
  */
-unsigned char isVideoEnable(void);
+unsigned char isVideoEnable(ddk768_context_t *pCtx);
 
 /*
  *  videoSetEdgeDetection
@@ -507,6 +526,7 @@ unsigned long videoGetEdgeDetection(
  *     -1  - Fail
  */
 unsigned char videoSetupEx(
+	ddk768_context_t *pCtx,
 	unsigned dispCtrl,
     unsigned long x,                /* X Coordinate of the video window */
     unsigned long y,                /* Y Coordinate of the video window */
@@ -553,6 +573,7 @@ unsigned char videoSetupEx(
  *     -1  - Fail
  */
 unsigned char videoSetup(
+    ddk768_context_t *pCtx,
     disp_control_t dispCtrl,
     unsigned long x,                /* X Coordinate of the video window */
     unsigned long y,                /* Y Coordinate of the video window */
@@ -576,15 +597,16 @@ unsigned char videoSetup(
  *  startVideo
  *      This function starts the video.
  */
-void startVideo(unsigned dispCtrl);
+void startVideo(ddk768_context_t *pCtx, unsigned dispCtrl);
 
 /*
  *  stopVideo
  *      This function stops the video.
  */
-void stopVideo(unsigned dispCtrl);
+void stopVideo(ddk768_context_t *pCtx, unsigned dispCtrl);
 
 int SM768_setOverlay(
+    ddk768_context_t *pCtx,
     disp_control_t dispControl, /* Channel 0 or Channel 1) */
     PBLIT_BLK src,  /* Only need: source Width & Height, Pitch */
     PYUV_BUF_ADDR SrcAddr,   /* Y U V source base address */
@@ -88,8 +88,8 @@ typedef struct _ADO_PARAMS {
 //
 
 // All Interface Inital
-extern void EP952_IIC_Initial(void);
-extern void EP952_Info_Reset(void);
+extern void EP952_IIC_Initial(struct smi_device *sdev);
+extern void EP952_Info_Reset(struct smi_device *sdev);
 
 
 //--------------------------------------------------------------------------------------------------
@@ -98,18 +98,18 @@ extern void EP952_Info_Reset(void);
 //
 
 // Common
-extern void HDMI_Tx_Power_Down(void);
-extern void HDMI_Tx_Power_Up(void);
-extern void HDMI_Tx_HDMI(void);
-extern void HDMI_Tx_DVI(void);
+extern void HDMI_Tx_Power_Down(struct smi_device *sdev);
+extern void HDMI_Tx_Power_Up(struct smi_device *sdev);
+extern void HDMI_Tx_HDMI(struct smi_device *sdev);
+extern void HDMI_Tx_DVI(struct smi_device *sdev);
 extern unsigned char HDMI_Tx_HTPLG(void);
 extern unsigned char HDMI_Tx_RSEN(void);
 
 // HDCP
-extern void HDMI_Tx_Mute_Enable(void);
-extern void HDMI_Tx_Mute_Disable(void);
+extern void HDMI_Tx_Mute_Enable(struct smi_device *sdev);
+extern void HDMI_Tx_Mute_Disable(struct smi_device *sdev);
 extern void HDMI_Tx_HDCP_Enable(void);
-extern void HDMI_Tx_HDCP_Disable(void);
+extern void HDMI_Tx_HDCP_Disable(struct smi_device *sdev);
 extern void HDMI_Tx_RPTR_Set(void);
 extern void HDMI_Tx_RPTR_Clear(void);
 extern unsigned char HDMI_Tx_RI_RDY(void);
@@ -122,11 +122,11 @@ extern void HDMI_Tx_read_M0(unsigned char *pM0);
 extern SMBUS_STATUS HDMI_Tx_Get_Key(unsigned char *Key);
 
 // Special for EP952E
-extern void HDMI_Tx_AMute_Enable(void);
-extern void HDMI_Tx_AMute_Disable(void);
-extern void HDMI_Tx_VMute_Enable(void);
-extern void HDMI_Tx_VMute_Disable(void);
-extern void HDMI_Tx_Video_Config(PVDO_PARAMS Params);
+extern void HDMI_Tx_AMute_Enable(struct smi_device *sdev);
+extern void HDMI_Tx_AMute_Disable(struct smi_device *sdev);
+extern void HDMI_Tx_VMute_Enable(struct smi_device *sdev);
+extern void HDMI_Tx_VMute_Disable(struct smi_device *sdev);
+extern void HDMI_Tx_Video_Config(struct smi_device *sdev, PVDO_PARAMS Params);
 extern void HDMI_Tx_Audio_Config(PADO_PARAMS Params);
 
 
@@ -136,10 +136,10 @@ extern void HDMI_Tx_Audio_Config(PADO_PARAMS Params);
 //
 
 // EP952
-extern unsigned char EP952_Reg_Read(unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
-extern unsigned char EP952_Reg_Write(unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
-extern unsigned char EP952_Reg_Set_Bit(unsigned char ByteAddr, unsigned char BitMask);
-extern unsigned char EP952_Reg_Clear_Bit(unsigned char ByteAddr, unsigned char BitMask);
+extern unsigned char EP952_Reg_Read(struct smi_device *sdev, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
+extern unsigned char EP952_Reg_Write(struct smi_device *sdev, unsigned char ByteAddr, unsigned char *Data, unsigned int Size);
+extern unsigned char EP952_Reg_Set_Bit(struct smi_device *sdev, unsigned char ByteAddr, unsigned char BitMask);
+extern unsigned char EP952_Reg_Clear_Bit(struct smi_device *sdev, unsigned char ByteAddr, unsigned char BitMask);
 
 
 #endif // EP952_IF_H
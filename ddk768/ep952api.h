@@ -1,6 +1,8 @@
 #ifndef EP952_API_H
 #define EP952_API_H
 
+struct smi_device;
+
 //#include <stdio.h>
 
 
@@ -100,11 +102,11 @@ typedef enum {
 //--------------------------------------------------------------------------------------------------
 void EP_EP952_Reset(void);
 //void EP_HDMI_Set_Audio_Fmt(HDMI_AudFmt_t Audfmt, HDMI_AudFreq Audfreq);
-void  EP_HDMI_Set_Video_Timing(unsigned int isHDMI,unsigned int dsel); //(logicalMode_t *pLogicalMode, unsigned int isHDMI);
-void EP_HDMI_Init(int chipID); 
+void  EP_HDMI_Set_Video_Timing(struct smi_device *sdev, unsigned int isHDMI,unsigned int dsel); //(logicalMode_t *pLogicalMode, unsigned int isHDMI);
+void EP_HDMI_Init(struct smi_device *sdev, int chipID); 
 void EP_Register_Init(void);
 int EP952_HDMI_Set_Mode (logicalMode_t *pLogicalMode);
-void EP952_Register_Message(void);
+void EP952_Register_Message(struct smi_device *sdev);
 
 
 
@@ -65,14 +65,14 @@ typedef struct _EP952C_REGISTER_MAP {
 
 typedef void (*EP952C_CALLBACK)(void);
 
-void EP952Controller_Initial(PEP952C_REGISTER_MAP pEP952C_RegMap);
+void EP952Controller_Initial(struct smi_device *sdev, PEP952C_REGISTER_MAP pEP952C_RegMap);
 
 void EP952Controller_Task(void);
 
 void EP952Controller_Timer(void);
 
 void EP952_Audio_reg_set(void);
-void EP952_Video_reg_set(void);
+void EP952_Video_reg_set(struct smi_device *sdev);
 
 void EP952_EXTINT_init(unsigned char INT_Enable, unsigned char INT_OD, unsigned char INT_POL);
 void EP_HDMI_DumpMessage(void);
@@ -5,16 +5,16 @@
  * Send one byte of data to the chip.  Data is latched into the chip on
  * the rising edge of the clock.
  */
-static void sendbyte(struct l3_pins *adap, unsigned int byte)
+static void sendbyte(ddk768_context_t *pCtx, struct l3_pins *adap, unsigned int byte)
 {
 	int i;
 
 	for (i = 0; i < 8; i++) {
-		adap->setclk(0);
+		adap->setclk(pCtx, 0);
 		sb_OS_WAIT_USEC_POLL(adap->data_hold);
-		adap->setdat(byte & 1);
+		adap->setdat(pCtx, byte & 1);
 		sb_OS_WAIT_USEC_POLL(adap->data_setup);
-		adap->setclk(1);
+		adap->setclk(pCtx, 1);
 		sb_OS_WAIT_USEC_POLL(adap->clock_high);
 		byte >>= 1;
 	}
@@ -25,7 +25,7 @@ static void sendbyte(struct l3_pins *adap, unsigned int byte)
  * between each byte, but never at the start nor at the end of the
  * transfer.
  */
-static void sendbytes(struct l3_pins *adap, const u8 *buf,
+static void sendbytes(ddk768_context_t *pCtx, struct l3_pins *adap, const u8 *buf,
 		      int len)
 {
 	int i;
@@ -33,32 +33,32 @@ static void sendbytes(struct l3_pins *adap, const u8 *buf,
 	for (i = 0; i < len; i++) {
 		if (i) {
 			sb_OS_WAIT_USEC_POLL(adap->mode_hold);
-			adap->setmode(0);
+			adap->setmode(pCtx, 0);
 			sb_OS_WAIT_USEC_POLL(adap->mode);
 		}
-		adap->setmode(1);
+		adap->setmode(pCtx, 1);
 		sb_OS_WAIT_USEC_POLL(adap->mode_setup);
-		sendbyte(adap, buf[i]);
+		sendbyte(pCtx, adap, buf[i]);
 	}
 }
 
-int l3_write(struct l3_pins *adap, u8 addr, u8 *data, int len)
+int l3_write(ddk768_context_t *pCtx, struct l3_pins *adap, u8 addr, u8 *data, int len)
 {
-	adap->setclk(1);
-	adap->setdat(1);
-	adap->setmode(1);
+	adap->setclk(pCtx, 1);
+	adap->setdat(pCtx, 1);
+	adap->setmode(pCtx, 1);
 	sb_OS_WAIT_USEC_POLL(adap->mode);
 
-	adap->setmode(0);
+	adap->setmode(pCtx, 0);
 	sb_OS_WAIT_USEC_POLL(adap->mode_setup);
-	sendbyte(adap, addr);
+	sendbyte(pCtx, adap, addr);
 	sb_OS_WAIT_USEC_POLL(adap->mode_hold);
 
-	sendbytes(adap, data, len);
+	sendbytes(pCtx, adap, data, len);
 
-	adap->setclk(1);
-	adap->setdat(1);
-	adap->setmode(0);
+	adap->setclk(pCtx, 1);
+	adap->setdat(pCtx, 1);
+	adap->setmode(pCtx, 0);
 
 	return len;
 }
@@ -1,14 +1,17 @@
 #ifndef _L3_H_
 #define _L3_H_ 
 
+#include "ddk768_help.h"
+
 #include <linux/string.h>
+#include "ddk768_help.h"
 #include "ddk768_timer.h"
 
 
 struct l3_pins {
-	void (*setdat)(int);
-	void (*setclk)(int);
-	void (*setmode)(int);
+	void (*setdat)(ddk768_context_t *, int);
+	void (*setclk)(ddk768_context_t *, int);
+	void (*setmode)(ddk768_context_t *, int);
 	int data_hold;
 	int data_setup;
 	int clock_high;
@@ -17,6 +20,6 @@ struct l3_pins {
 	int mode_setup;
 };
 
-int l3_write(struct l3_pins *adap, u8 addr, u8 *data, int len);
+int l3_write(ddk768_context_t *pCtx, struct l3_pins *adap, u8 addr, u8 *data, int len);
 
 #endif
@@ -1,11 +1,11 @@
 #include <linux/string.h>
 #include "ddk768_reg.h"
-#include "ddk768_help.h"
+#include "ddk768_context.h"
 #include "uda1345.h"
 
-static void setdat(int v);
-static void setclk(int v);
-static void setmode(int v);
+static void setdat(ddk768_context_t *pCtx, int v);
+static void setclk(ddk768_context_t *pCtx, int v);
+static void setmode(ddk768_context_t *pCtx, int v);
 
 static const u8 uda1346_reg[UDA1345_REGS_NUM] =
 {
@@ -32,42 +32,39 @@ static struct uda1345_data falcon_uda1345 =
     .cache_init = 0,
 };
 
-static void setdat(int v)
+static void setpin(ddk768_context_t *pCtx, unsigned long bit, int v)
 {
-    unsigned long value;
-
-    value = peekRegisterDWord(GPIO_DATA);
-    pokeRegisterDWord(GPIO_DATA, 0 < v ? (value | (1 << GPIO_DATA_GPIO_CODEC_DATA_SHIFT)) : \
-                      (value & ~(1 << GPIO_DATA_GPIO_CODEC_DATA_SHIFT)));
-
+    unsigned long flags;
+
+    lockRegisterBlock(DDK768_LOCK_GPIO, flags);
+    if (0 < v)
+        ddk768_gpioUpdate(pCtx, GPIO_DATA, bit, 0);
+    else
+        ddk768_gpioUpdate(pCtx, GPIO_DATA, 0, bit);
+    unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 }
 
-static void setclk(int v)
+static void setdat(ddk768_context_t *pCtx, int v)
 {
-    unsigned long value;
-
-		value = peekRegisterDWord(GPIO_DATA);
-		pokeRegisterDWord(GPIO_DATA, 0 < v ? (value | (1 << GPIO_DATA_GPIO_CODEC_CLK_SHIFT)) : \
-						  (value & ~(1 << GPIO_DATA_GPIO_CODEC_CLK_SHIFT)));
-
-
+    setpin(pCtx, 1 << GPIO_DATA_GPIO_CODEC_DATA_SHIFT, v);
 }
 
-static void setmode(int v)
+static void setclk(ddk768_context_t *pCtx, int v)
 {
-    unsigned long value;
-
-		value = peekRegisterDWord(GPIO_DATA);
-		pokeRegisterDWord(GPIO_DATA, 0 < v ? (value | (1 << GPIO_DATA_GPIO_CODEC_MODE_SHIFT)) : \
-						  (value & ~(1 << GPIO_DATA_GPIO_CODEC_MODE_SHIFT)));
+    setpin(pCtx, 1 << GPIO_DATA_GPIO_CODEC_CLK_SHIFT, v);
+}
 
+static void setmode(ddk768_context_t *pCtx, int v)
+{
+    setpin(pCtx, 1 << GPIO_DATA_GPIO_CODEC_MODE_SHIFT, v);
 }
 
-static void uda1345_GPIOInit(void)
+static void uda1345_GPIOInit(ddk768_context_t *pCtx)
 {
-    unsigned long value;
+    unsigned long value, flags;
    		 /*l3 mode control pins*/
 
+		lockRegisterBlock(DDK768_LOCK_GPIO, flags);
 		value = peekRegisterDWord(GPIO_MUX);
 		value &= ~(1 << GPIO_MUX_GPIO_CODEC_MODE_SHIFT);
 		value &= ~(1 << GPIO_MUX_GPIO_CODEC_CLK_SHIFT);
@@ -75,11 +72,11 @@ static void uda1345_GPIOInit(void)
 		pokeRegisterDWord(GPIO_MUX, value);
 
 		/*set 3 pins as input*/
-		value = peekRegisterDWord(GPIO_DATA_DIRECTION);
-		value |= (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_MODE_SHIFT);
-		value |= (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_CLK_SHIFT);
-		value |= (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_DATA_SHIFT);
-		pokeRegisterDWord(GPIO_DATA_DIRECTION, value);
+		ddk768_gpioUpdate(pCtx, GPIO_DATA_DIRECTION,
+				  (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_MODE_SHIFT) |
+				  (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_CLK_SHIFT) |
+				  (1 << GPIO_DATA_DIRECTION_GPIO_CODEC_DATA_SHIFT), 0);
+		unlockRegisterBlock(DDK768_LOCK_GPIO, flags);
 
 
 }
@@ -114,7 +111,7 @@ static inline int uda1345_write_reg_cache(struct uda1345_data *codec,
  * Write to the uda134x registers
  *
  */
-static int uda1345_write(unsigned int reg,
+static int uda1345_write(ddk768_context_t *pCtx, unsigned int reg,
                          unsigned int value)
 {
     int ret;
@@ -143,7 +140,7 @@ static int uda1345_write(unsigned int reg,
         break;
     }
 
-    ret = l3_write(&falcon_uda1345.l3,
+    ret = l3_write(pCtx, &falcon_uda1345.l3,
                    addr, &data, 1);
    
    if (ret != 1)
@@ -152,7 +149,7 @@ static int uda1345_write(unsigned int reg,
     return 0;
 }
 
-int uda1345_setsysclkfs(enum uda1345_sysclkf sysclk)
+int uda1345_setsysclkfs(ddk768_context_t *pCtx, enum uda1345_sysclkf sysclk)
 {
     u8 data;
 	
@@ -174,11 +171,11 @@ int uda1345_setsysclkfs(enum uda1345_sysclkf sysclk)
         return -1;
     }
 	
-    return uda1345_write(UDA1345_STATUS,data);
+    return uda1345_write(pCtx, UDA1345_STATUS,data);
 
 }
 
-int uda1345_setformat(enum uda1345_input_format informat)
+int uda1345_setformat(ddk768_context_t *pCtx, enum uda1345_input_format informat)
 {
 
     u8 data;
@@ -213,12 +210,12 @@ int uda1345_setformat(enum uda1345_input_format informat)
     default:
         return -1;
     }
-    return  uda1345_write(UDA1345_STATUS,data);
+    return  uda1345_write(pCtx, UDA1345_STATUS,data);
 
 }
 
 
-int uda1345_setdcfilter(enum uda1345_dc_filter onoff)
+int uda1345_setdcfilter(ddk768_context_t *pCtx, enum uda1345_dc_filter onoff)
 {
 
     u8 data;
@@ -235,24 +232,24 @@ int uda1345_setdcfilter(enum uda1345_dc_filter onoff)
     default:
         return -1;
     }
-    return  uda1345_write(UDA1345_STATUS,data);
+    return  uda1345_write(pCtx, UDA1345_STATUS,data);
 
 }
 
 
-int uda1345_setvolume(u8 dB)
+int uda1345_setvolume(ddk768_context_t *pCtx, u8 dB)
 {
 
     u8 data;
     data = uda1345_read_reg_cache(&falcon_uda1345,UDA1345_DATA_VOLUME);
     data &= ~UDA1345_VOLUME_MASK;
     data |= (dB&UDA1345_VOLUME_MASK);
-    return  uda1345_write(UDA1345_DATA_VOLUME,data);
+    return  uda1345_write(pCtx, UDA1345_DATA_VOLUME,data);
 
 }
 
 
-int uda1345_setdemphasis(enum uda1345_de_emphasis emphasis)
+int uda1345_setdemphasis(ddk768_context_t *pCtx, enum uda1345_de_emphasis emphasis)
 {
     u8 data;
     data = uda1345_read_reg_cache(&falcon_uda1345,UDA1345_DATA_DE_MUTE);
@@ -275,11 +272,11 @@ int uda1345_setdemphasis(enum uda1345_de_emphasis emphasis)
 
         return -1;
     }
-    return uda1345_write(UDA1345_DATA_DE_MUTE,data);
+    return uda1345_write(pCtx, UDA1345_DATA_DE_MUTE,data);
 
 }
 
-int uda1345_setmute(enum uda1345_mute onoff)
+int uda1345_setmute(ddk768_context_t *pCtx, enum uda1345_mute onoff)
 {
     u8 data;
     data = uda1345_read_reg_cache(&falcon_uda1345,UDA1345_DATA_DE_MUTE);
@@ -295,11 +292,11 @@ int uda1345_setmute(enum uda1345_mute onoff)
     default:
         return -1;
     }
-    return  uda1345_write(UDA1345_DATA_DE_MUTE,data);
+    return  uda1345_write(pCtx, UDA1345_DATA_DE_MUTE,data);
 
 }
 
-int uda1345_setpower(enum uda1345_power onoff)
+int uda1345_setpower(ddk768_context_t *pCtx, enum uda1345_power onoff)
 {
     u8 data;
     data = uda1345_read_reg_cache(&falcon_uda1345,UDA1345_DATA_POWER);
@@ -321,13 +318,13 @@ int uda1345_setpower(enum uda1345_power onoff)
     default:
         return -1;
     }
-    return  uda1345_write(UDA1345_DATA_POWER,data);
+    return  uda1345_write(pCtx, UDA1345_DATA_POWER,data);
 
 }
 
-int uda1345_init(void)
+int uda1345_init(ddk768_context_t *pCtx)
 {
-    uda1345_GPIOInit();    
+    uda1345_GPIOInit(pCtx);    
 
     if(0 ==  falcon_uda1345.cache_init)
     {
@@ -337,27 +334,27 @@ int uda1345_init(void)
         falcon_uda1345.cache_init = 1;
     }
 
-    if(uda1345_setsysclkfs(SYSCLKF_384FS))
+    if(uda1345_setsysclkfs(pCtx, SYSCLKF_384FS))
         return -1;
-    if(uda1345_setformat(I2S_BUS))
+    if(uda1345_setformat(pCtx, I2S_BUS))
         return -1;
-    if(uda1345_setdcfilter(NO_DC_FILTERING))
+    if(uda1345_setdcfilter(pCtx, NO_DC_FILTERING))
         return -1;
-    if(uda1345_setdemphasis(NO_DE_EMPHASIS))
+    if(uda1345_setdemphasis(pCtx, NO_DE_EMPHASIS))
         return -1;
-    if(uda1345_setvolume(0))
+    if(uda1345_setvolume(pCtx, 0))
         return -1;
-    if(uda1345_setmute(MUTE))
+    if(uda1345_setmute(pCtx, MUTE))
         return -1;
-    if(uda1345_setpower(ADCOFF_DACOFF))
+    if(uda1345_setpower(pCtx, ADCOFF_DACOFF))
         return -1;
 
     return 0;
 }
 
-int uda1345_deinit(void)
+int uda1345_deinit(ddk768_context_t *pCtx)
 {
-    uda1345_setpower(ADCOFF_DACOFF);
+    uda1345_setpower(pCtx, ADCOFF_DACOFF);
     if(falcon_uda1345.cache_init&&falcon_uda1345.reg_cache)
     {
         falcon_uda1345.reg_cache = NULL;
@@ -1,5 +1,7 @@
 #ifndef _UDA1345_CODEC_H
 #define _UDA1345_CODEC_H
+
+#include "ddk768_help.h"
 #include "l3.h"
 
 
@@ -118,14 +120,14 @@ struct uda1345_data
 
 
 
-int uda1345_setsysclkfs(enum uda1345_sysclkf sysclk);
-int uda1345_setformat(enum uda1345_input_format informat);
-int uda1345_setdcfilter(enum uda1345_dc_filter onoff);
-int uda1345_setvolume(u8 dB);
-int uda1345_setdemphasis(enum uda1345_de_emphasis emphasis);
-int uda1345_setmute(enum uda1345_mute onoff);
-int uda1345_setpower(enum uda1345_power onoff);
-int uda1345_init(void);
-int uda1345_deinit(void);
+int uda1345_setsysclkfs(ddk768_context_t *pCtx, enum uda1345_sysclkf sysclk);
+int uda1345_setformat(ddk768_context_t *pCtx, enum uda1345_input_format informat);
+int uda1345_setdcfilter(ddk768_context_t *pCtx, enum uda1345_dc_filter onoff);
+int uda1345_setvolume(ddk768_context_t *pCtx, u8 dB);
+int uda1345_setdemphasis(ddk768_context_t *pCtx, enum uda1345_de_emphasis emphasis);
+int uda1345_setmute(ddk768_context_t *pCtx, enum uda1345_mute onoff);
+int uda1345_setpower(ddk768_context_t *pCtx, enum uda1345_power onoff);
+int uda1345_init(ddk768_context_t *pCtx);
+int uda1345_deinit(ddk768_context_t *pCtx);
 #endif
 
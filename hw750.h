@@ -13,15 +13,21 @@
 
 
 
-void ddk750_set_mmio(volatile unsigned char * addr,unsigned short devId,char revId);
-unsigned long ddk750_getFrameBufSize(void);
-long ddk750_initChip(void);
-void ddk750_deInit(void);
-long ddk750_detectCRTMonitor(unsigned char redValue, unsigned char greenValue,
+struct _ddk750_context_t *ddk750_alloc_context(volatile unsigned char __iomem * addr,unsigned short devId,char revId);
+void ddk750_free_context(struct _ddk750_context_t *pCtx);
+struct smi_reg_lock *ddk750_getRegLock(struct _ddk750_context_t *pCtx, int lock);
+struct smi_reg_lock *ddk750_findRegLock(struct _ddk750_context_t *pCtx, unsigned long offset);
+unsigned long ddk750_testPixelPll(unsigned long ulRequestClk);
+long ddk750_getPixelClock(struct _ddk750_context_t *pCtx, int dispCtrl, unsigned long *pRequested, unsigned long *pActual);
+unsigned long ddk750_getFrameBufSize(struct _ddk750_context_t *pCtx);
+long ddk750_initChip(struct _ddk750_context_t *pCtx);
+void ddk750_deInit(struct _ddk750_context_t *pCtx);
+long ddk750_detectCRTMonitor(struct _ddk750_context_t *pCtx, unsigned char redValue, unsigned char greenValue,
 	unsigned char blueValue);
 
-long ddk750_edidHeaderReadMonitorExHwI2C(void);
+long ddk750_edidHeaderReadMonitorExHwI2C(struct _ddk750_context_t *pCtx);
 long ddk750_edidHeaderReadMonitorEx(
+    struct _ddk750_context_t *pCtx,
     unsigned char sclGpio,
     unsigned char sdaGpio
 );	
@@ -41,6 +47,7 @@ long ddk750_edidHeaderReadMonitorEx(
  *     -1   - Fail
  */
 long ddk750_edidReadMonitor(
+    struct _ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -64,6 +71,7 @@ long ddk750_edidReadMonitor(
  *     -1   - Fail
  */
 long ddk750_edidReadMonitorEx(
+    struct _ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -74,6 +82,7 @@ long ddk750_edidReadMonitorEx(
 
 
 long ddk750_edidReadMonitorEx_HW(
+    struct _ddk750_context_t *pCtx,
     disp_path_t displayPath,
     unsigned char *pEDIDBuffer,
     unsigned long bufferSize,
@@ -85,6 +94,7 @@ long ddk750_edidReadMonitorEx_HW(
  * This function initializes the cursor attributes.
  */
 void ddk750_initCursor(
+    struct _ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long base,             /* Base Address */ 
     unsigned long color1,           /* Cursor color 1 in RGB 5:6:5 format */
@@ -96,6 +106,7 @@ void ddk750_initCursor(
  * This function sets the cursor position.
  */
 void ddk750_setCursorPosition(
+    struct _ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long dx,               /* X Coordinate of the cursor */
     unsigned long dy,               /* Y Coordinate of the cursor */
@@ -109,59 +120,64 @@ void ddk750_setCursorPosition(
  * This function enables/disables the cursor.
  */
 void ddk750_enableCursor(
+    struct _ddk750_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (PRIMARY_CTRL or SECONDARY_CTRL) */
     unsigned long enable
 );
 
 
 
-void hw750_set_base(int display,int pitch,int base_addr);
+void hw750_set_base(struct _ddk750_context_t *pCtx, int display,int pitch,int base_addr);
 
 long setMode(
+	struct _ddk750_context_t *pCtx,
 	logicalMode_t *pLogicalMode
 );
-void setDisplayControl(disp_control_t dispControl, disp_state_t dispState);
+void setDisplayControl(struct _ddk750_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState);
 void setPath(
+    struct _ddk750_context_t *pCtx,
     disp_path_t dispPath, 
     disp_control_t dispControl, 
     disp_state_t dispState
 );
 
-void swPanelPowerSequence(disp_state_t dispState, unsigned long vsync_delay);
-void setDAC(disp_state_t state);
-void setDPMS(DPMS_t state);
+void swPanelPowerSequence(struct _ddk750_context_t *pCtx, disp_state_t dispState, unsigned long vsync_delay);
+void setDAC(struct _ddk750_context_t *pCtx, disp_state_t state);
+void setDPMS(struct _ddk750_context_t *pCtx, DPMS_t state);
 
 
 
-void hw750_set_dpms(int display,int state);
-void hw750_suspend(struct smi_750_register * pSave);
-void hw750_resume(struct smi_750_register * pSave);
-int hw750_check_vsync_interrupt(int path);
-void hw750_clear_vsync_interrupt(int path);
+void hw750_set_dpms(struct _ddk750_context_t *pCtx, int display,int state);
+unsigned long hw750_regsave_count(void);
+void hw750_suspend(struct _ddk750_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime);
+void hw750_resume(struct _ddk750_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime);
+unsigned long hw750_get_irq_sources(struct _ddk750_context_t *pCtx);
+void hw750_clear_vsync_sources(struct _ddk750_context_t *pCtx, unsigned long sources);
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(5, 5, 0)
-int hw750_en_dis_interrupt(int status, int pipe);
+int hw750_en_dis_interrupt(struct _ddk750_context_t *pCtx, int status, int pipe);
 #else
-int hw750_en_dis_interrupt(int status);
+int hw750_en_dis_interrupt(struct _ddk750_context_t *pCtx, int status);
 #endif
 
 
-void ddk750_disable_IntMask(void);
+void ddk750_disable_IntMask(struct _ddk750_context_t *pCtx);
 
-int sii9022xInitChip(void);
-int sii9022xSetMode(int);
+int sii9022xInitChip(struct _ddk750_context_t *pCtx);
+int sii9022xSetMode(struct _ddk750_context_t *pCtx, int);
 unsigned char sii9022xIsConnected(void);
 
-int ddk750_GetDDC_9022Access(void);
+int ddk750_GetDDC_9022Access(struct _ddk750_context_t *pCtx);
 int ddk750_Release9022DDC(void);
 
 void ddk750_DoEdidRead(void);
 
-void hw750_setgamma(disp_control_t dispCtrl, unsigned long enable);
-void hw750_load_lut(disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[]);
+void hw750_setgamma(struct _ddk750_context_t *pCtx, disp_control_t dispCtrl, unsigned long enable);
+void hw750_load_lut(struct _ddk750_context_t *pCtx, disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[]);
 
-long hw750_AdaptI2CInit(struct smi_connector *smi_connector);
+long hw750_AdaptI2CInit(struct _ddk750_context_t *pCtx, struct smi_connector *smi_connector);
 long hw750_AdaptI2CCleanBus(
+    struct _ddk750_context_t *pCtx,
     struct drm_connector *connector
 );
 
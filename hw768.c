@@ -5,7 +5,7 @@
 #include <drm/drm_modes.h>
 
 #include "ddk768/ddk768_mode.h"
-#include "ddk768/ddk768_help.h"
+#include "ddk768/ddk768_context.h"
 #include "ddk768/ddk768_reg.h"	
 #include "ddk768/ddk768_display.h"
 #include "ddk768/ddk768_2d.h"
@@ -16,6 +16,9 @@
 #include "ddk768/ddk768_pwm.h"
 #include "ddk768/ddk768_swi2c.h"
 #include "ddk768/ddk768_hwi2c.h"
+#include "ddk768/ddk768_intr.h"
+#include "smi_pm.h"
+#include "smi_irq.h"
 
 #include <linux/delay.h>
 
@@ -25,13 +28,12 @@
 extern int lcd_scale;
 extern int pwm_ctrl;
 
+/* EDID reads through the HDMI transmitter's DDC engine */
+#define HDMI_EDID_TIMEOUT_MS	200	/* per attempt */
+#define HDMI_EDID_POLL_MS	20	/* status check if no interrupt came */
+#define HDMI_EDID_RETRY		3
+
 
-struct smi_768_register{
-	uint32_t clock_enable, pll_ctrl[3];
-	
-	uint32_t primary_display_ctrl[10], lvds_ctrl, primary_hwcurs_ctrl[4];
-	uint32_t secondary_display_ctrl[10], secondary_hwcurs_ctrl[4];
-};
 
 
 mode_parameter_t convert_drm_mode_to_ddk_mode(struct drm_display_mode mode)
@@ -62,7 +64,35 @@ mode_parameter_t convert_drm_mode_to_ddk_mode(struct drm_display_mode mode)
 	return modeP;
 }
 
-void hw768_ddr_init(void)
+/*
+ * Build a CVT reduced blanking mode (version 1 = RB, 2 = RBv2) for the
+ * driver's built-in timings on digital outputs.
+ */
+int hw768_cvt_mode(struct drm_display_mode *mode, int width, int height, int hz, int version)
+{
+	mode_parameter_t modeP;
+
+	if (ddk768_calcCvtModeParam(width, height, hz, version, &modeP))
+		return -EINVAL;
+
+	memset(mode, 0, sizeof(*mode));
+	mode->hdisplay = modeP.horizontal_display_end;
+	mode->hsync_start = modeP.horizontal_sync_start;
+	mode->hsync_end = modeP.horizontal_sync_start + modeP.horizontal_sync_width;
+	mode->htotal = modeP.horizontal_total;
+	mode->vdisplay = modeP.vertical_display_end;
+	mode->vsync_start = modeP.vertical_sync_start;
+	mode->vsync_end = modeP.vertical_sync_start + modeP.vertical_sync_height;
+	mode->vtotal = modeP.vertical_total;
+	mode->clock = modeP.pixel_clock / 1000;
+	mode->flags = DRM_MODE_FLAG_PHSYNC | DRM_MODE_FLAG_NVSYNC;
+	mode->type = DRM_MODE_TYPE_DRIVER;
+	drm_mode_set_name(mode);
+
+	return 0;
+}
+
+void hw768_ddr_init(ddk768_context_t *pCtx)
 {
 	unsigned long ulTmp;
 
@@ -86,7 +116,8 @@ void hw768_ddr_init(void)
 	pokeRegisterDWord(0x4004, 0x1FF);
 
 
-	mdelay(50);
+	/* Only called from probe, don't spin the CPU while the DDR trains */
+	msleep(50);
 
 	 //Restore clocks
     pokeRegisterDWord(CLOCK_ENABLE, ulTmp);
@@ -94,24 +125,28 @@ void hw768_ddr_init(void)
 }
 
 
-void hw768_enable_lvds(int channels)
+void hw768_enable_lvds(ddk768_context_t *pCtx, int channels)
 {
 	if(channels == 1){	
 		pokeRegisterDWord(0x80020,0x31E30000);		
 		pokeRegisterDWord(0x8002C,0x74001200);
 	}else{
-		unsigned long value = 0;
+		unsigned long value = 0, flags;
 		pokeRegisterDWord(0x80020, 0x31E3F71D);
 		pokeRegisterDWord(0x8002C,0x750FED02);
+		lockRegisterBlock(DDK768_LOCK_DC0, flags);
 		value = peekRegisterDWord(DISPLAY_CTRL);
 		value = FIELD_SET(value, DISPLAY_CTRL, LVDS_OUTPUT_FORMAT, CHANNEL0_48BIT);
 		value = FIELD_SET(value, DISPLAY_CTRL, PIXEL_CLOCK_SELECT, HALF);
 		value = FIELD_SET(value, DISPLAY_CTRL, DOUBLE_PIXEL_CLOCK, ENABLE);
 		pokeRegisterDWord(DISPLAY_CTRL,value);
+		unlockRegisterBlock(DDK768_LOCK_DC0, flags);
 
+		lockRegisterBlock(DDK768_LOCK_DC1, flags);
 		value = peekRegisterDWord(DISPLAY_CTRL + CHANNEL_OFFSET);
 		value = FIELD_SET(value, DISPLAY_CTRL, LVDS_OUTPUT_FORMAT, CHANNEL0_48BIT);
 		pokeRegisterDWord(DISPLAY_CTRL + CHANNEL_OFFSET,value);
+		unlockRegisterBlock(DDK768_LOCK_DC1, flags);
 	}
 	
 	
@@ -124,8 +159,8 @@ void hw768_enable_lvds(int channels)
 	    	highCounter = (pwm_ctrl & 0xfff00) >> 8;
 		lowCounter = (pwm_ctrl & 0xfff00000) >> 20;
 
-		ddk768_pwmOpen(pwm);
-		ddk768_pwmStart(pwm, divider, highCounter, lowCounter, 0);
+		ddk768_pwmOpen(pCtx, pwm);
+		ddk768_pwmStart(pCtx, pwm, divider, highCounter, lowCounter, 0);
 	}
 
 	
@@ -134,13 +169,16 @@ void hw768_enable_lvds(int channels)
 
 
 void ddk768_setDisplayPlaneDisableOnly(
+   ddk768_context_t *pCtx,
    disp_control_t dispControl /* Channel 0 or Channel 1) */
 )
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
     ulDispCtrlAddr = (dispControl == CHANNEL0_CTRL)? DISPLAY_CTRL : (DISPLAY_CTRL+CHANNEL_OFFSET);
+    lockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
     ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
 
 	
@@ -148,57 +186,149 @@ void ddk768_setDisplayPlaneDisableOnly(
                     FIELD_SET(0, DISPLAY_CTRL, DATA_PATH, EXTENDED); 
 
 	 pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
+	 unlockRegisterBlock(DDK768_LOCK_DC(dispControl), flags);
    
 }
 
 
 
 
-void hw768_suspend(struct smi_768_register * pSave)
-{
+enum {
+	HW768_PM_CLOCK,
+	HW768_PM_GPIO,
+	HW768_PM_DISPLAY,
+	HW768_PM_CURSOR,
+	HW768_PM_VIDEO,
+	HW768_PM_ALPHA,
+	HW768_PM_GAMMA,
+	HW768_PM_HDMI,
+	HW768_PM_I2S,
+	HW768_PM_INTERRUPT,
+};
 
-	int i;
+static const char * const hw768_pm_phase[] = {
+	"clock", "gpio", "display", "cursor", "video",
+	"alpha", "gamma", "hdmi", "i2s", "interrupt",
+};
 
-	pSave->clock_enable = peekRegisterDWord(CLOCK_ENABLE);
-	for (i = 0; i < 3; i++)
-		pSave->pll_ctrl[i] = peekRegisterDWord(MCLK_PLL + i * 4);
+/*
+ * MMIO kept across suspend, restored in this order: the clock gates first
+ * so that every block is ungated, then the PLLs, then the blocks they
+ * clock. HDMI_CONFIG is only the index/data port of the HDMI transmitter;
+ * its own registers are rebuilt by HDMI_Init() and the next modeset.
+ * CLOCK_ENABLE has to stay the first dword.
+ */
+static const reg_range_t hw768_regsave[] = {
+	{ HW768_PM_CLOCK,     CLOCK_ENABLE,                          1, 0 },
+	{ HW768_PM_CLOCK,     MCLK_PLL,                              1, 0 },
+	{ HW768_PM_CLOCK,     VCLK0_PLL,                             2, REG_RANGE_PLL },
+	{ HW768_PM_GPIO,      GPIO_DATA,                             3, 0 },
+	{ HW768_PM_GPIO,      GPIO_MUX,                              1, 0 },
+	{ HW768_PM_DISPLAY,   DISPLAY_CTRL,                         12, 0 },	/* to LVDS_CTRL2 */
+	{ HW768_PM_DISPLAY,   DISPLAY_CTRL + CHANNEL_OFFSET,        12, 0 },
+	{ HW768_PM_CURSOR,    HWC_CONTROL,                           4, 0 },
+	{ HW768_PM_CURSOR,    HWC_CONTROL + CHANNEL_OFFSET,          4, 0 },
+	{ HW768_PM_VIDEO,     VIDEO_DISPLAY_CTRL,                   12, 0 },
+	{ HW768_PM_VIDEO,     VIDEO_DISPLAY_CTRL + CHANNEL_OFFSET,  12, 0 },
+	{ HW768_PM_ALPHA,     ALPHA_DISPLAY_CTRL,                   14, 0 },
+	{ HW768_PM_ALPHA,     ALPHA_DISPLAY_CTRL + CHANNEL_OFFSET,  14, 0 },
+	{ HW768_PM_GAMMA,     CHANNEL0_PALETTE_RAM,                256, 0 },
+	{ HW768_PM_GAMMA,     CHANNEL1_PALETTE_RAM,                256, 0 },
+	{ HW768_PM_HDMI,      HDMI_CONTROL,                          1, 0 },
+	{ HW768_PM_I2S,       I2S_CTRL,                              2, 0 },	/* and I2S_SRAM_DMA */
+	{ HW768_PM_INTERRUPT, INT_MASK,                              1, 0 },
+};
 
-	for (i = 0; i < 10; i++)
-		pSave->primary_display_ctrl[i] = peekRegisterDWord(DISPLAY_CTRL + i * 4);
-	pSave->lvds_ctrl = peekRegisterDWord(LVDS_CTRL2);
-	for (i = 0; i < 4; i++)
-		pSave->primary_hwcurs_ctrl[i] = peekRegisterDWord(HWC_CONTROL + i * 4);
+/* There is no lock status for these PLLs: the mode set waits 100 us too */
+#define HW768_PLL_SETTLE_US	100
 
-	for (i = 0; i < 10; i++)
-		pSave->secondary_display_ctrl[i] = peekRegisterDWord(0x8000 + DISPLAY_CTRL + i * 4);
-	for (i = 0; i < 4; i++)
-		pSave->secondary_hwcurs_ctrl[i] = peekRegisterDWord(0x8000 + HWC_CONTROL + i * 4);
+unsigned long hw768_regsave_count(void)
+{
+	unsigned long i, count = 0;
 
+	for (i = 0; i < ARRAY_SIZE(hw768_regsave); i++)
+		count += hw768_regsave[i].count;
 
+	return count;
 }
 
-void hw768_resume(struct smi_768_register * pSave)
+static void hw768_pm_names(pm_phase_time_t *pTime)
 {
-
 	int i;
 
-	pokeRegisterDWord(CLOCK_ENABLE, pSave->clock_enable);
-	for (i = 0; i < 3; i++)
-		pokeRegisterDWord(MCLK_PLL + i * 4, pSave->pll_ctrl[i]);
+	for (i = 0; i < ARRAY_SIZE(hw768_pm_phase); i++)
+		pTime[i].name = hw768_pm_phase[i];
+}
+
+void hw768_suspend(ddk768_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime)
+{
+	const reg_range_t *r;
+	u64 start;
+	int i, j;
+
+	hw768_pm_names(pTime);
+	for (i = 0; i < ARRAY_SIZE(hw768_regsave); i++)
+		pTime[hw768_regsave[i].phase].save_ns = 0;
+
+	for (i = 0; i < ARRAY_SIZE(hw768_regsave); i++) {
+		r = &hw768_regsave[i];
+		start = ktime_get_ns();
+		for (j = 0; j < r->count; j++)
+			*pSave++ = peekRegisterDWord(r->offset + j * 4);
+		pTime[r->phase].save_ns += ktime_get_ns() - start;
+	}
+}
+
+/*
+ * A PLL is programmed the way the mode set does it: written powered down,
+ * then powered up 100 us later, and given the same time to settle.
+ */
+static void hw768_restore_pll(ddk768_context_t *pCtx, unsigned long reg, uint32_t value)
+{
+	if (peekRegisterDWord(reg) == value)
+		return;
+
+	pokeRegisterDWord(reg, value | 1);
+	udelay(HW768_PLL_SETTLE_US);
+	pokeRegisterDWord(reg, value);
+	if (!(value & 1))
+		udelay(HW768_PLL_SETTLE_US);
+}
 
-	for (i = 0; i < 10; i++)
-		pokeRegisterDWord(DISPLAY_CTRL + i * 4, pSave->primary_display_ctrl[i]);
-	pokeRegisterDWord(LVDS_CTRL2, pSave->lvds_ctrl);
-	for (i = 0; i < 4; i++)
-		pokeRegisterDWord(HWC_CONTROL + i * 4, pSave->primary_hwcurs_ctrl[i]);
+void hw768_resume(ddk768_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime)
+{
+	const reg_range_t *r;
+	uint32_t clockEnable = pSave[0];
+	u64 start;
+	int i, j;
+
+	hw768_pm_names(pTime);
+	for (i = 0; i < ARRAY_SIZE(hw768_regsave); i++)
+		pTime[hw768_regsave[i].phase].restore_ns = 0;
+
+	for (i = 0; i < ARRAY_SIZE(hw768_regsave); i++) {
+		r = &hw768_regsave[i];
+		start = ktime_get_ns();
+		for (j = 0; j < r->count; j++, pSave++) {
+			if (r->flags & REG_RANGE_PLL)
+				hw768_restore_pll(pCtx, r->offset + j * 4, *pSave);
+			else
+				pokeRegisterDWord(r->offset + j * 4, *pSave);
+		}
+		pTime[r->phase].restore_ns += ktime_get_ns() - start;
+	}
 
-	for (i = 0; i < 10; i++)
-		pokeRegisterDWord(0x8000 + DISPLAY_CTRL + i * 4, pSave->secondary_display_ctrl[i]);
-	for (i = 0; i < 4; i++)
-		pokeRegisterDWord(0x8000 + HWC_CONTROL + i * 4, pSave->secondary_hwcurs_ctrl[i]);
+	ddk768_gpioLoadShadow(pCtx);
 
+	/* The transmitter lost its state with the rest of the chip */
+	if (FIELD_VAL_GET(clockEnable, CLOCK_ENABLE, HDMI) == CLOCK_ENABLE_HDMI_ON) {
+		start = ktime_get_ns();
+		HDMI_Init(pCtx);
+		pTime[HW768_PM_HDMI].restore_ns += ktime_get_ns() - start;
+	}
 }
-void hw768_set_base(int display,int pitch,int base_addr)
+
+void hw768_set_base(ddk768_context_t *pCtx, int display,int pitch,int base_addr)
 {	
 
 	if(display == 0)
@@ -237,196 +367,297 @@ void hw768_set_base(int display,int pitch,int base_addr)
 }
 
 
-void hw768_init_hdmi(void)
+void hw768_init_hdmi(ddk768_context_t *pCtx)
 {
-	HDMI_Init();
+	HDMI_Init(pCtx);
 }
 
-int hw768_set_hdmi_mode(logicalMode_t *pLogicalMode, struct drm_display_mode mode, bool isHDMI)
+int hw768_set_hdmi_mode(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, struct drm_display_mode mode, bool isHDMI)
 {
 	int ret = 1;
 	mode_parameter_t modeParam;
 	
 	// set HDMI parameters
-	HDMI_Disable_Output();
+	HDMI_Disable_Output(pCtx);
 
 	if(pLogicalMode->valid_edid)
 		modeParam = convert_drm_mode_to_ddk_mode(mode);
-	ret = HDMI_Set_Mode(pLogicalMode,&modeParam,isHDMI);
+	ret = HDMI_Set_Mode(pCtx, pLogicalMode,&modeParam,isHDMI);
 	return ret;
 }
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(5, 5, 0)
-int hw768_en_dis_interrupt(int status, int pipe)
+int hw768_en_dis_interrupt(ddk768_context_t *pCtx, int status, int pipe)
 {
+	unsigned long vsync = (pipe == CHANNEL1_CTRL) ?
+		FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, ENABLE):
+		FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, ENABLE);
+
+	/* Only touch the vsync bit, the HDMI and I2S sources share INT_MASK. */
 	if(status == 0)
-	{
-		pokeRegisterDWord(INT_MASK, 	(pipe == CHANNEL0_CTRL) ? 
-		FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, DISABLE):
-		FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, DISABLE));
-	}
+		setIntMask(pCtx, 0, vsync);
 	else
-	{
-		pokeRegisterDWord(INT_MASK, 	(pipe == CHANNEL1_CTRL) ? 
-		FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, ENABLE):
-		FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, ENABLE));
-	}
+		setIntMask(pCtx, vsync, 0);
 	return 0;
 }
 #else
-int hw768_en_dis_interrupt(int status)
+int hw768_en_dis_interrupt(ddk768_context_t *pCtx, int status)
 	{
+		unsigned long vsync = FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, ENABLE) |
+				      FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, ENABLE);
+
+		/* Only touch the vsync bits, the HDMI and I2S sources share INT_MASK. */
 		if(status == 0)
-		{
-			pokeRegisterDWord(INT_MASK, FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, DISABLE));
-			pokeRegisterDWord(INT_MASK, FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, DISABLE)); 
-		}
+			setIntMask(pCtx, 0, vsync);
 		else
-		{
-			pokeRegisterDWord(INT_MASK, FIELD_SET(0, INT_MASK, CHANNEL1_VSYNC, ENABLE));
-			pokeRegisterDWord(INT_MASK, FIELD_SET(0, INT_MASK, CHANNEL0_VSYNC, ENABLE));  
-		}
+			setIntMask(pCtx, vsync, 0);
 		return 0;
 	}
 
 #endif
 
-void hw768_HDMI_Enable_Output(void)
+void hw768_HDMI_Enable_Output(ddk768_context_t *pCtx)
 {
-	HDMI_Enable_Output();
+	HDMI_Enable_Output(pCtx);
 }
 
-void hw768_HDMI_Disable_Output(void)
+void hw768_HDMI_Disable_Output(ddk768_context_t *pCtx)
 {
-	HDMI_Disable_Output();
+	HDMI_Disable_Output(pCtx);
 }
 
 
-int hw768_get_hdmi_edid(unsigned char *pEDIDBuffer)
+/*
+ * Mask (or unmask) the HDMI source in INT_MASK, the HDMI block's own mask is
+ * left alone. The source is only unmasked while the driver handles hot plug
+ * interrupts, otherwise nobody would ack it.
+ */
+void hw768_mask_hdmi_interrupt(ddk768_context_t *pCtx, int mask)
 {
-    int ret;
-    enableHdmI2C(1);
-    ret = HDMI_Read_Edid(pEDIDBuffer, 128);
-    enableHdmI2C(0);
+	unsigned long hdmi = FIELD_SET(0, INT_MASK, HDMI, ENABLE);
 
-    return ret;
+	if (mask)
+		setIntMask(pCtx, 0, hdmi);
+	else if (pCtx->hdmiHotplugInt)
+		setIntMask(pCtx, hdmi, 0);
 }
 
-int hw768_check_iis_interrupt(void)
+void hw768_enable_hdmi_hotplug(ddk768_context_t *pCtx, int enable)
 {
+	if (enable) {
+		HDMI_Enable_Hotplug_Interrupt(pCtx, 1);
+		hw768_mask_hdmi_interrupt(pCtx, 0);
+	} else {
+		hw768_mask_hdmi_interrupt(pCtx, 1);
+		HDMI_Enable_Hotplug_Interrupt(pCtx, 0);
+	}
+}
 
-	unsigned long value;
-		
-	value = peekRegisterDWord(INT_STATUS);
-
-	
-    if (FIELD_VAL_GET(value, INT_STATUS, I2S) == INT_STATUS_I2S_ACTIVE)
-		return true;
-	else	
-		return false;
+int hw768_hdmi_hotplug_ack(ddk768_context_t *pCtx)
+{
+	return HDMI_Hotplug_Ack(pCtx) != 0;
 }
 
+/*
+ * Read one EDID block with the DDC engine of the HDMI transmitter. The
+ * caller holds the HDMI register mutex.
+ *
+ * The engine reports EDID_RDY or EDID_ERR through the HDMI interrupt,
+ * which hw768_hdmi_edid_irq() turns into a completion. The status is also
+ * checked every HDMI_EDID_POLL_MS, in case the interrupt isn't installed.
+ */
+int hw768_get_hdmi_edid_block(ddk768_context_t *pCtx, unsigned int block, unsigned char *buf, size_t len)
+{
+	unsigned long deadline;
+	unsigned char status = 0;
+	int retry, ret = -ETIMEDOUT;
+
+	if (len > 128)
+		return -EINVAL;
+
+	/* The engine borrows the I2C1 pins from the VGA DDC controller */
+	mutex_lock(&pCtx->hwI2CLock[1]);
+	enableHdmI2C(pCtx, 1);
+
+	for (retry = 0; retry < HDMI_EDID_RETRY; retry++) {
+		reinit_completion(&pCtx->hdmiEdidDone);
+		WRITE_ONCE(pCtx->hdmiEdidWaiting, 1);
+		HDMI_Edid_Start_Block(pCtx, block);
+
+		deadline = jiffies + msecs_to_jiffies(HDMI_EDID_TIMEOUT_MS);
+		do {
+			wait_for_completion_timeout(&pCtx->hdmiEdidDone,
+						    msecs_to_jiffies(HDMI_EDID_POLL_MS));
+			status = HDMI_Edid_Status(pCtx);
+			/* The interrupt handler masked the source before waking us */
+			reinit_completion(&pCtx->hdmiEdidDone);
+			hw768_mask_hdmi_interrupt(pCtx, 0);
+		} while (!status && time_before(jiffies, deadline));
+
+		WRITE_ONCE(pCtx->hdmiEdidWaiting, 0);
+
+		if (status & EDID_RDY) {
+			HDMI_Edid_Fetch_Block(pCtx, buf, len);
+			ret = 0;
+			break;
+		}
+		ret = (status & EDID_ERR) ? -EIO : -ETIMEDOUT;
+	}
 
-int hw768_check_vsync_interrupt(int path)
+	HDMI_Edid_Stop(pCtx);
+	enableHdmI2C(pCtx, 0);
+	mutex_unlock(&pCtx->hwI2CLock[1]);
+
+	return ret;
+}
+
+/*
+ * Interrupt handler side of hw768_get_hdmi_edid_block(). Returns 1 if an
+ * EDID read is waiting, in which case the HDMI source is masked and the
+ * reader woken; it acks the transmitter and unmasks the source itself.
+ */
+int hw768_hdmi_edid_irq(ddk768_context_t *pCtx)
 {
+	if (!READ_ONCE(pCtx->hdmiEdidWaiting))
+		return 0;
 
-	unsigned long value1,value2;
-		
-	value1 = peekRegisterDWord(RAW_INT);
-	value2 = peekRegisterDWord(INT_MASK);
+	hw768_mask_hdmi_interrupt(pCtx, 1);
+	complete(&pCtx->hdmiEdidDone);
 
-	if(path == CHANNEL0_CTRL)
-	{
-	    if ((FIELD_VAL_GET(value1, RAW_INT, CHANNEL0_VSYNC) == RAW_INT_CHANNEL0_VSYNC_ACTIVE)
-			&&(FIELD_VAL_GET(value2, INT_MASK, CHANNEL0_VSYNC) == INT_MASK_CHANNEL0_VSYNC_ENABLE))
-	    {
-			return true;
-		}
-	}else{
-		if ((FIELD_VAL_GET(value1, RAW_INT, CHANNEL1_VSYNC) == RAW_INT_CHANNEL1_VSYNC_ACTIVE)
-			&&(FIELD_VAL_GET(value2, INT_MASK, CHANNEL1_VSYNC) == INT_MASK_CHANNEL1_VSYNC_ENABLE))
-		{
-			return true;
-		}
-	}
-	
-	return false;
+	return 1;
 }
 
+/*
+ * Read INT_STATUS, which only reports unmasked sources, once and return the
+ * pending ones as a mask of BIT(SMI_IRQ_xxx).
+ */
+unsigned long hw768_get_irq_sources(ddk768_context_t *pCtx)
+{
+	unsigned long value, sources = 0;
+	unsigned long timers = FIELD_SET(0, INT_STATUS, TIMER0, ACTIVE) |
+			       FIELD_SET(0, INT_STATUS, TIMER1, ACTIVE) |
+			       FIELD_SET(0, INT_STATUS, TIMER2, ACTIVE) |
+			       FIELD_SET(0, INT_STATUS, TIMER3, ACTIVE);
+
+	value = peekRegisterDWord(INT_STATUS);
 
-void hw768_clear_vsync_interrupt(int path)
+	if (FIELD_VAL_GET(value, INT_STATUS, CHANNEL0_VSYNC) == INT_STATUS_CHANNEL0_VSYNC_ACTIVE)
+		sources |= BIT(SMI_IRQ_VSYNC0);
+	if (FIELD_VAL_GET(value, INT_STATUS, CHANNEL1_VSYNC) == INT_STATUS_CHANNEL1_VSYNC_ACTIVE)
+		sources |= BIT(SMI_IRQ_VSYNC1);
+	if (FIELD_VAL_GET(value, INT_STATUS, HDMI) == INT_STATUS_HDMI_ACTIVE)
+		sources |= BIT(SMI_IRQ_HDMI);
+	if (FIELD_VAL_GET(value, INT_STATUS, I2S) == INT_STATUS_I2S_ACTIVE)
+		sources |= BIT(SMI_IRQ_I2S);
+	if (FIELD_VAL_GET(value, INT_STATUS, DE) == INT_STATUS_DE_ACTIVE)
+		sources |= BIT(SMI_IRQ_DE);
+	if (FIELD_VAL_GET(value, INT_STATUS, PWM) == INT_STATUS_PWM_ACTIVE)
+		sources |= BIT(SMI_IRQ_PWM);
+	if (value & timers)
+		sources |= BIT(SMI_IRQ_TIMER);
+
+	return sources;
+}
+
+/* Ack the vsync sources in sources with a single RAW_INT write */
+void hw768_clear_vsync_sources(ddk768_context_t *pCtx, unsigned long sources)
 {
-	
-	unsigned long value;
-	
-	value = peekRegisterDWord(RAW_INT);
+	unsigned long value = 0;
 
-	if (path == CHANNEL0_CTRL)
-	{
-		pokeRegisterDWord(RAW_INT, FIELD_SET(value, RAW_INT, CHANNEL0_VSYNC, CLEAR));
-	}
-	else
-	{
-		pokeRegisterDWord(RAW_INT, FIELD_SET(value, RAW_INT, CHANNEL1_VSYNC, CLEAR));
-	}
+	if (sources & BIT(SMI_IRQ_VSYNC0))
+		value = FIELD_SET(value, RAW_INT, CHANNEL0_VSYNC, CLEAR);
+	if (sources & BIT(SMI_IRQ_VSYNC1))
+		value = FIELD_SET(value, RAW_INT, CHANNEL1_VSYNC, CLEAR);
+
+	if (value)
+		pokeRegisterDWord(RAW_INT, value);
 }
 
-long hw768_setMode(logicalMode_t *pLogicalMode, struct drm_display_mode mode)
+long hw768_setMode(ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, struct drm_display_mode mode)
 {
 	
 	if (!pLogicalMode->valid_edid)
-		return ddk768_setMode(pLogicalMode);
+		return ddk768_setMode(pCtx, pLogicalMode);
 	else
 	{	
 		mode_parameter_t ModeParam;
 		ModeParam = convert_drm_mode_to_ddk_mode(mode);
-		return ddk768_setCustomMode(pLogicalMode, &ModeParam);
+		return ddk768_setCustomMode(pCtx, pLogicalMode, &ModeParam);
 	}
 	
 }
 
+/*
+ * Read back the mode the firmware left on a channel, for taking it over
+ * without a modeset. Fails unless the channel scans out a plain, unscaled
+ * framebuffer laid out the way ddk768_setCustomMode() would lay it out.
+ */
+int hw768_read_boot_mode(ddk768_context_t *pCtx, disp_control_t dispCtrl, struct drm_display_mode *mode, int *bpp)
+{
+	mode_parameter_t modeParam;
+	logicalMode_t logicalMode;
+
+	if (ddk768_readModeRegisters(pCtx, dispCtrl, &modeParam, &logicalMode) != 0)
+		return -1;
+
+	if (logicalMode.pitch != PITCH(logicalMode.x, logicalMode.bpp))
+		return -1;
+
+	memset(mode, 0, sizeof(*mode));
+	mode->hdisplay = modeParam.horizontal_display_end;
+	mode->hsync_start = modeParam.horizontal_sync_start;
+	mode->hsync_end = modeParam.horizontal_sync_start + modeParam.horizontal_sync_width;
+	mode->htotal = modeParam.horizontal_total;
+	mode->vdisplay = modeParam.vertical_display_end;
+	mode->vsync_start = modeParam.vertical_sync_start;
+	mode->vsync_end = modeParam.vertical_sync_start + modeParam.vertical_sync_height;
+	mode->vtotal = modeParam.vertical_total;
+	mode->clock = modeParam.pixel_clock / 1000;
+	mode->flags = (modeParam.horizontal_sync_polarity == POS ? DRM_MODE_FLAG_PHSYNC : DRM_MODE_FLAG_NHSYNC) |
+		      (modeParam.vertical_sync_polarity == POS ? DRM_MODE_FLAG_PVSYNC : DRM_MODE_FLAG_NVSYNC);
+	drm_mode_set_name(mode);
+
+	*bpp = logicalMode.bpp;
 
-int hdmi_int_status = 0;
+	return 0;
+}
 
-inline int hdmi_hotplug_detect(void)
+inline int hdmi_hotplug_detect(ddk768_context_t *pCtx)
 {
 	int ret = 0;
-	unsigned int intMask = peekRegisterDWord(INT_MASK);
-	intMask = FIELD_SET(intMask, INT_MASK, HDMI, ENABLE);
-	pokeRegisterDWord(INT_MASK, intMask);
 
-	ret = hdmi_detect();
+	setIntMask(pCtx, FIELD_SET(0, INT_MASK, HDMI, ENABLE), 0);
+
+	ret = hdmi_detect(pCtx);
 
 	if (ret == 1)
 	{
-		hdmi_int_status = 1;
+		pCtx->hdmiIntStatus = 1;
 	}
 	else if (ret == 0)
 	{
-		hdmi_int_status = 0;
+		pCtx->hdmiIntStatus = 0;
 	}
 	else
 	{
-		hdmi_int_status = hdmi_int_status & ret;
+		pCtx->hdmiIntStatus = pCtx->hdmiIntStatus & ret;
 	}
 
-	intMask = peekRegisterDWord(INT_MASK);
-	intMask = FIELD_SET(intMask, INT_MASK, HDMI, DISABLE);
-	pokeRegisterDWord(INT_MASK, intMask);
+	setIntMask(pCtx, 0, FIELD_SET(0, INT_MASK, HDMI, ENABLE));
 
-	return hdmi_int_status;
+	return pCtx->hdmiIntStatus;
 }
 
-void ddk768_disable_IntMask(void)
+void ddk768_disable_IntMask(ddk768_context_t *pCtx)
 {
-	
-    pokeRegisterDWord(INT_MASK, 0);
+	setIntMask(pCtx, 0, ~0UL);
 }
 
-void hw768_SetPixelClockFormat(disp_control_t dispControl,unsigned int is_half)
+void hw768_SetPixelClockFormat(ddk768_context_t *pCtx, disp_control_t dispControl,unsigned int is_half)
 {
     unsigned long ulDispCtrlAddr;
     unsigned long ulDispCtrlReg;
+    unsigned long flags;
 
     if (dispControl == CHANNEL0_CTRL)
     {
@@ -435,6 +666,7 @@ void hw768_SetPixelClockFormat(disp_control_t dispControl,unsigned int is_half)
     else
         return;
     
+    lockRegisterBlock(DDK768_LOCK_DC0, flags);
     ulDispCtrlReg = peekRegisterDWord(ulDispCtrlAddr);
     
 	if(is_half)
@@ -444,9 +676,10 @@ void hw768_SetPixelClockFormat(disp_control_t dispControl,unsigned int is_half)
 
 
     pokeRegisterDWord(ulDispCtrlAddr, ulDispCtrlReg);
+    unlockRegisterBlock(DDK768_LOCK_DC0, flags);
 }
 
-void hw768_setgamma(disp_control_t dispCtrl, unsigned long enable, unsigned long lvds_ch)
+void hw768_setgamma(ddk768_context_t *pCtx, disp_control_t dispCtrl, unsigned long enable, unsigned long lvds_ch)
 {
 	unsigned long value;
 	unsigned long regCtrl;
@@ -470,7 +703,7 @@ void hw768_setgamma(disp_control_t dispCtrl, unsigned long enable, unsigned long
 	pokeRegisterDWord(regCtrl, value);    
 }
 
-void hw768_load_lut(disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[])
+void hw768_load_lut(ddk768_context_t *pCtx, disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[])
 {
 	unsigned int i, v;
 	unsigned long regCtrl;
@@ -488,9 +721,10 @@ void hw768_load_lut(disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u
 
 
 
-long hw768_AdaptI2CInit(struct smi_connector *smi_connector)
+long hw768_AdaptI2CInit(ddk768_context_t *pCtx, struct smi_connector *smi_connector)
 {
-    if(hwi2c_en)
+    /* Only the DVI (I2C0) and VGA (I2C1) DDC pins have a controller behind them. */
+    if(hwi2c_en && smi_connector->base.connector_type != DRM_MODE_CONNECTOR_HDMIA)
     {
         smi_connector->i2c_hw_enabled = 1;
     }
@@ -499,28 +733,30 @@ long hw768_AdaptI2CInit(struct smi_connector *smi_connector)
         smi_connector->i2c_hw_enabled = 0;      
     }
 
+    ddk768_swI2CSetSpeed(pCtx, i2c_speed);
+
     if(smi_connector->i2c_hw_enabled)
     {
-        return ddk768_AdaptHWI2CInit(smi_connector);
+        return ddk768_AdaptHWI2CInit(pCtx, smi_connector);
     }
     else
     {
-        return ddk768_AdaptSWI2CInit(smi_connector); 
+        return ddk768_AdaptSWI2CInit(pCtx, smi_connector); 
     }
 }
 
 
-long hw768_AdaptI2CCleanBus(struct drm_connector *connector)
+long hw768_AdaptI2CCleanBus(ddk768_context_t *pCtx, struct drm_connector *connector)
 {
         struct smi_connector *smi_connector = to_smi_connector(connector);
     
     if(smi_connector->i2c_hw_enabled)
     {
-        return ddk768_AdaptHWI2CCleanBus(smi_connector);
+        return ddk768_AdaptHWI2CCleanBus(pCtx, smi_connector);
     }
     else
     {
-        return ddk768_AdaptSWI2CCleanBus(smi_connector);
+        return ddk768_AdaptSWI2CCleanBus(pCtx, smi_connector);
     }
 }
 
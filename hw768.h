@@ -10,21 +10,29 @@
 #endif
 
 
-unsigned char HDMI_connector_detect(void);
+unsigned char HDMI_connector_detect(struct _ddk768_context_t *pCtx);
 void ddk768_setDisplayPlaneDisableOnly(
+   struct _ddk768_context_t *pCtx,
    disp_control_t dispControl /* Channel 0 or Channel 1) */
 );
 
-void hw768_ddr_init(void);
+void hw768_ddr_init(struct _ddk768_context_t *pCtx);
 
-void hw768_enable_lvds(int channels);
+void hw768_enable_lvds(struct _ddk768_context_t *pCtx, int channels);
 
-void ddk768_set_mmio(volatile unsigned char * addr,unsigned short devId,char revId);
-unsigned long ddk768_getFrameBufSize(void);
-long ddk768_initChip(void);
-void ddk768_deInit(void);
+struct _ddk768_context_t *ddk768_alloc_context(volatile unsigned char __iomem * addr,unsigned short devId,char revId);
+void ddk768_free_context(struct _ddk768_context_t *pCtx);
+struct smi_reg_lock *ddk768_getRegLock(struct _ddk768_context_t *pCtx, int lock);
+struct smi_reg_lock *ddk768_findRegLock(struct _ddk768_context_t *pCtx, unsigned long offset);
+void ddk768_regWritten(struct _ddk768_context_t *pCtx, unsigned long offset);
+unsigned long ddk768_testPixelPll(unsigned long inputFreq, unsigned long ulRequestClk);
+long ddk768_getPixelClock(struct _ddk768_context_t *pCtx, int dispCtrl, unsigned long *pRequested, unsigned long *pActual);
+unsigned long ddk768_getFrameBufSize(struct _ddk768_context_t *pCtx);
+unsigned long ddk768_getMemoryClock(struct _ddk768_context_t *pCtx);
+long ddk768_initChip(struct _ddk768_context_t *pCtx);
+void ddk768_deInit(struct _ddk768_context_t *pCtx);
 
-void ddk768_swPanelPowerSequence(disp_control_t dispControl, disp_state_t dispState, unsigned long vSyncDelay);
+void ddk768_swPanelPowerSequence(struct _ddk768_context_t *pCtx, disp_control_t dispControl, disp_state_t dispState, unsigned long vSyncDelay);
 
 
 long ddk768_edidHeaderReadMonitorEx(
@@ -38,7 +46,7 @@ long ddk768_edidHeaderReadMonitorExHwI2C(
 
 
 
-long ddk768_detectCRTMonitor(disp_control_t dispControl, unsigned char redValue, 
+long ddk768_detectCRTMonitor(struct _ddk768_context_t *pCtx, disp_control_t dispControl, unsigned char redValue, 
 	unsigned char greenValue, unsigned char blueValue);
 
 long ddk768_edidReadMonitor(
@@ -62,7 +70,8 @@ long ddk768_edidReadMonitorEx(
 
 
 
-int hw768_get_hdmi_edid(unsigned char *pEDIDBuffer);
+int hw768_get_hdmi_edid_block(struct _ddk768_context_t *pCtx, unsigned int block, unsigned char *buf, size_t len);
+int hw768_hdmi_edid_irq(struct _ddk768_context_t *pCtx);
 
 
 
@@ -77,15 +86,16 @@ long ddk768_edidReadMonitorExHwI2C(
  * Disable double pixel clock. 
  * This is a teporary function, used to patch for the random fuzzy font problem. 
  */
-void DisableDoublePixel(disp_control_t dispControl);
-void EnableDoublePixel(disp_control_t dispControl);
-void hw768_SetPixelClockFormat(disp_control_t dispControl,unsigned int is_half);
+void DisableDoublePixel(struct _ddk768_context_t *pCtx, disp_control_t dispControl);
+void EnableDoublePixel(struct _ddk768_context_t *pCtx, disp_control_t dispControl);
+void hw768_SetPixelClockFormat(struct _ddk768_context_t *pCtx, disp_control_t dispControl,unsigned int is_half);
 
 
 /*
  * This function initializes the cursor attributes.
  */
 void ddk768_initCursor(
+    struct _ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long base,             /* Base Address */ 
     unsigned long color1,           /* Cursor color 1 in RGB 5:6:5 format */
@@ -97,6 +107,7 @@ void ddk768_initCursor(
  * This function sets the cursor position.
  */
 void ddk768_setCursorPosition(
+    struct _ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long dx,               /* X Coordinate of the cursor */
     unsigned long dy,               /* Y Coordinate of the cursor */
@@ -106,74 +117,85 @@ void ddk768_setCursorPosition(
                                        or within the screen left boundary (= 0) */
 );
  
-void hw768_set_base(int display,int pitch,int base_addr);
+void hw768_set_base(struct _ddk768_context_t *pCtx, int display,int pitch,int base_addr);
  
 /*
  * This function enables/disables the cursor.
  */
 void ddk768_enableCursor(
+    struct _ddk768_context_t *pCtx,
     disp_control_t dispControl,     /* Display control (CHANNEL0_CTRL or CHANNEL1_CTRL) */
     unsigned long enable
 );
 
-void hw768_HDMI_Enable_Output(void);
+void hw768_HDMI_Enable_Output(struct _ddk768_context_t *pCtx);
 
-void hw768_HDMI_Disable_Output(void);
+void hw768_HDMI_Disable_Output(struct _ddk768_context_t *pCtx);
 
  
 long ddk768_setMode(
+    struct _ddk768_context_t *pCtx,
     logicalMode_t *pLogicalMode
 );
-long setSingleViewOn(disp_control_t dispOutput);
+long setSingleViewOn(struct _ddk768_context_t *pCtx, disp_control_t dispOutput);
 long initDisplay(void);	
 
 void setDisplayDPMS(
+   struct _ddk768_context_t *pCtx,
    disp_control_t dispControl, /* Channel 0 or Channel 1) */
    DISP_DPMS_t state /* DPMS state */
    );
 
-void hw768_init_hdmi(void);
-int hw768_set_hdmi_mode(logicalMode_t *pLogicalMode, struct drm_display_mode mode, bool isHDMI);
+void hw768_init_hdmi(struct _ddk768_context_t *pCtx);
+int hw768_set_hdmi_mode(struct _ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, struct drm_display_mode mode, bool isHDMI);
 
 
 
-void ddk768_setDisplayEnable(disp_control_t dispControl, /* Channel 0 or Channel 1) */
+void ddk768_setDisplayEnable(struct _ddk768_context_t *pCtx, disp_control_t dispControl, /* Channel 0 or Channel 1) */
 disp_state_t dispState /* ON or OFF */);
 
-int hw768_check_iis_interrupt(void);
+unsigned long hw768_get_irq_sources(struct _ddk768_context_t *pCtx);
+void hw768_clear_vsync_sources(struct _ddk768_context_t *pCtx, unsigned long sources);
 
-int hw768_check_vsync_interrupt(int path);
-void hw768_clear_vsync_interrupt(int path);
+void hw768_mask_hdmi_interrupt(struct _ddk768_context_t *pCtx, int mask);
+void hw768_enable_hdmi_hotplug(struct _ddk768_context_t *pCtx, int enable);
+int hw768_hdmi_hotplug_ack(struct _ddk768_context_t *pCtx);
 
-long hw768_setMode(logicalMode_t *pLogicalMode, struct drm_display_mode mode);
+long hw768_setMode(struct _ddk768_context_t *pCtx, logicalMode_t *pLogicalMode, struct drm_display_mode mode);
+int hw768_cvt_mode(struct drm_display_mode *mode, int width, int height, int hz, int version);
+int hw768_read_boot_mode(struct _ddk768_context_t *pCtx, disp_control_t dispCtrl, struct drm_display_mode *mode, int *bpp);
 
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(5, 5, 0)
-int hw768_en_dis_interrupt(int status, int pipe);
+int hw768_en_dis_interrupt(struct _ddk768_context_t *pCtx, int status, int pipe);
 #else
-int hw768_en_dis_interrupt(int status);
+int hw768_en_dis_interrupt(struct _ddk768_context_t *pCtx, int status);
 #endif
 
-int hdmi_detect(void);
+int hdmi_detect(struct _ddk768_context_t *pCtx);
 
-int hdmi_hotplug_detect(void);
+int hdmi_hotplug_detect(struct _ddk768_context_t *pCtx);
 
-void HDMI_Audio_Mute (void);
+void HDMI_Audio_Mute (struct _ddk768_context_t *pCtx);
 
-void HDMI_Audio_Unmute (void);
+void HDMI_Audio_Unmute (struct _ddk768_context_t *pCtx);
 
+void HDMI_Audio_Set_Rate (struct _ddk768_context_t *pCtx, unsigned long sampleRate);
 
-void ddk768_disable_IntMask(void);
 
-void hw768_suspend(struct smi_768_register * pSave);
-void hw768_resume(struct smi_768_register * pSave);
+void ddk768_disable_IntMask(struct _ddk768_context_t *pCtx);
 
-void hw768_setgamma(disp_control_t dispCtrl, unsigned long enable,unsigned long lvds_ch);
-void hw768_load_lut(disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[]);
+unsigned long hw768_regsave_count(void);
+void hw768_suspend(struct _ddk768_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime);
+void hw768_resume(struct _ddk768_context_t *pCtx, uint32_t *pSave, pm_phase_time_t *pTime);
+
+void hw768_setgamma(struct _ddk768_context_t *pCtx, disp_control_t dispCtrl, unsigned long enable,unsigned long lvds_ch);
+void hw768_load_lut(struct _ddk768_context_t *pCtx, disp_control_t dispCtrl, int size, u8 lut_r[], u8 lut_g[], u8 lut_b[]);
 
 long hw768_AdaptI2CCleanBus(
+    struct _ddk768_context_t *pCtx,
     struct drm_connector *connector
 );
-long hw768_AdaptI2CInit(struct smi_connector *smi_connector);
+long hw768_AdaptI2CInit(struct _ddk768_context_t *pCtx, struct smi_connector *smi_connector);
 
 #endif
@@ -5,6 +5,13 @@
 #ifndef LYNX_HW_COM_H__
 #define LYNX_HW_COM_H__
 
+#include "smi_pm.h"
+
+/* Per-device DDK state, see ddk750_context.h and ddk768_context.h */
+struct _ddk750_context_t;
+struct _ddk768_context_t;
+struct smi_reg_lock;
+
 typedef enum _disp_path_t
 {
     SMI0_PATH = 0,
@@ -7,8 +7,12 @@
 #include "ddk768/ddk768_pwm.h"
 #include <linux/vmalloc.h>
 #include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <drm/drm_debugfs.h>
 #include "smi_debugfs.h"
+#include "smi_lock.h"
+#include "hw750.h"
+#include "hw768.h"
 
 extern int pwm_ctrl;
 extern int smi_debug;
@@ -17,7 +21,8 @@ extern int force_connect;
 
 static int debugfs_pwm_set(void *data, u64 val)
 {
-	int ctrl = *(u32*)data;
+	struct smi_device *sdev = data;
+	int ctrl = pwm_ctrl;
 
 	if(val == ctrl) {
 		pr_info("Nothing to do with %u\n", (int)val);
@@ -26,11 +31,11 @@ static int debugfs_pwm_set(void *data, u64 val)
 
 	if(ctrl) {
 		if((val & 0xf) != (ctrl & 0xf)) {
-			ddk768_pwmClose(ctrl & 0xf);
+			ddk768_pwmClose(sdev->ddk768_ctx, ctrl & 0xf);
 		} 
 	
 		if((val & ~0xf) != (ctrl & ~0xf)) {
-			ddk768_pwmStop(ctrl & 0xf);
+			ddk768_pwmStop(sdev->ddk768_ctx, ctrl & 0xf);
 		}
 	}
 
@@ -43,15 +48,15 @@ static int debugfs_pwm_set(void *data, u64 val)
 		lowCounter = (val & 0xfff00000) >> 20;
 
 		if((val & 0xf) != (ctrl & 0xf)) {
-			ddk768_pwmOpen(pwm);
+			ddk768_pwmOpen(sdev->ddk768_ctx, pwm);
 		}
 
 		if((val & ~0xf) != (ctrl & ~0xf)) {
-			ddk768_pwmStart(pwm, divider, highCounter, lowCounter, 0);
+			ddk768_pwmStart(sdev->ddk768_ctx, pwm, divider, highCounter, lowCounter, 0);
 		}
 	}
 
-	*(u32 *)data = val;
+	pwm_ctrl = val;
 	pr_info("Setting pwm_ctrl to %u\n", (int)val);
 
 	return 0;
@@ -59,7 +64,7 @@ static int debugfs_pwm_set(void *data, u64 val)
 
 static int debugfs_pwm_get(void *data, u64 *val)
 {
-	*val = *(u32 *)data;
+	*val = (u32)pwm_ctrl;
 	return 0;
 }
 
@@ -77,6 +82,22 @@ static struct smi_regs smiregs[] = {
 
 static unsigned int reg_data;
 
+static struct smi_reg_lock *smi_get_reg_lock(struct smi_device *sdev, int lock)
+{
+	if (sdev->specId == SPC_SM750)
+		return ddk750_getRegLock(sdev->ddk750_ctx, lock);
+	else
+		return ddk768_getRegLock(sdev->ddk768_ctx, lock);
+}
+
+static struct smi_reg_lock *smi_find_reg_lock(struct smi_device *sdev, unsigned long offset)
+{
+	if (sdev->specId == SPC_SM750)
+		return ddk750_findRegLock(sdev->ddk750_ctx, offset);
+	else
+		return ddk768_findRegLock(sdev->ddk768_ctx, offset);
+}
+
 static ssize_t reg_read(struct file *lp, char __user *user_data, size_t cnt, loff_t *lt)
 {
 	char data[11];
@@ -98,6 +119,8 @@ static ssize_t reg_write(struct file *lp, const char *user_data, size_t cnt, lof
 	struct drm_device *dev = lp->private_data;
 	struct smi_device *sdev  = dev->dev_private;
 	void *base = sdev->rmmio, *addr;
+	struct smi_reg_lock *lock;
+	unsigned long flags;
 
 	if(cnt > 64) return -1;
 	ret = copy_from_user(data, user_data, cnt);
@@ -114,7 +137,17 @@ static ssize_t reg_write(struct file *lp, const char *user_data, size_t cnt, lof
 	} else {
 		p++;
 		reg_data = simple_strtoul(p, &p, 16);
+
+		/* Do not land in the middle of a driver read-modify-write. */
+		lock = smi_find_reg_lock(sdev, offset);
+		if (lock)
+			smi_reg_lock_acquire(lock, flags);
 		*(unsigned int *)addr = reg_data;
+		if (lock)
+			smi_reg_lock_release(lock, flags);
+
+		if (sdev->specId != SPC_SM750)
+			ddk768_regWritten(sdev->ddk768_ctx, offset);
 	}
 
 	return cnt;
@@ -126,6 +159,229 @@ static const struct file_operations reg_fops = {
 	.read  = reg_read,
 	.write = reg_write,
 };
+
+/* Hold time statistics of the register block locks, see smi_lock.h */
+static int reg_locks_show(struct seq_file *m, void *unused)
+{
+	struct smi_device *sdev = m->private;
+	struct smi_reg_lock *lock;
+	unsigned long flags, count;
+	u64 max_ns, total_ns;
+	int i;
+
+	seq_printf(m, "%-10s %12s %12s %12s\n", "lock", "count", "max_ns", "avg_ns");
+	for (i = 0; (lock = smi_get_reg_lock(sdev, i)) != NULL; i++) {
+		spin_lock_irqsave(&lock->lock, flags);
+		count = lock->count;
+		max_ns = lock->hold_max_ns;
+		total_ns = lock->hold_total_ns;
+		spin_unlock_irqrestore(&lock->lock, flags);
+
+		seq_printf(m, "%-10s %12lu %12llu %12llu\n", lock->name, count, max_ns,
+			   count ? div64_u64(total_ns, count) : 0);
+	}
+
+	return 0;
+}
+
+static int reg_locks_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, reg_locks_show, inode->i_private);
+}
+
+static const struct file_operations reg_locks_fops = {
+	.owner   = THIS_MODULE,
+	.open    = reg_locks_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+/* Pixel clock accuracy of the mode set on each display channel */
+static int pll_show(struct seq_file *m, void *unused)
+{
+	struct smi_device *sdev = m->private;
+	unsigned long requested, actual;
+	long ret;
+	s64 ppm;
+	int i;
+
+	seq_printf(m, "%-8s %12s %12s %8s\n", "channel", "requested", "actual", "ppm");
+	for (i = 0; i < MAX_CRTC; i++) {
+		if (sdev->specId == SPC_SM750)
+			ret = ddk750_getPixelClock(sdev->ddk750_ctx, i, &requested, &actual);
+		else
+			ret = ddk768_getPixelClock(sdev->ddk768_ctx, i, &requested, &actual);
+		if (ret != 0)
+			continue;
+
+		ppm = div64_s64(((s64)actual - (s64)requested) * 1000000, requested);
+		seq_printf(m, "%-8d %12lu %12lu %8lld\n", i, requested, actual, ppm);
+	}
+
+	return 0;
+}
+
+static int pll_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pll_show, inode->i_private);
+}
+
+static const struct file_operations pll_fops = {
+	.owner   = THIS_MODULE,
+	.open    = pll_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+/* Duration of the last suspend and resume, per register save/restore phase */
+static int pm_show(struct seq_file *m, void *unused)
+{
+	struct smi_device *sdev = m->private;
+	int i;
+
+	seq_printf(m, "%-10s %12s %12s\n", "phase", "save_ns", "restore_ns");
+	for (i = 0; i < PM_MAX_PHASES && sdev->pm_time[i].name; i++)
+		seq_printf(m, "%-10s %12llu %12llu\n", sdev->pm_time[i].name,
+			   sdev->pm_time[i].save_ns, sdev->pm_time[i].restore_ns);
+	seq_printf(m, "%-10s %12llu %12llu\n", "total", sdev->pm_suspend_ns, sdev->pm_resume_ns);
+
+	return 0;
+}
+
+static int pm_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pm_show, inode->i_private);
+}
+
+static const struct file_operations pm_fops = {
+	.owner   = THIS_MODULE,
+	.open    = pm_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+/* Interrupts taken by the top-level handler, per source */
+static int irq_show(struct seq_file *m, void *unused)
+{
+	struct smi_device *sdev = m->private;
+	struct smi_irq_handler *h;
+	int i;
+
+	seq_printf(m, "%-8s %12s %12s %12s\n", "source", "count", "threaded", "unclaimed");
+	for (i = 0; i < SMI_IRQ_SOURCES; i++) {
+		h = &sdev->irq_handlers[i];
+		seq_printf(m, "%-8s %12lu %12lu %12lu\n", smi_irq_names[i],
+			   h->count, h->threaded, h->unclaimed);
+	}
+	seq_printf(m, "total %lu, not ours %lu\n", sdev->irq_count, sdev->irq_none);
+
+	return 0;
+}
+
+static int irq_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, irq_show, inode->i_private);
+}
+
+static const struct file_operations irq_fops = {
+	.owner   = THIS_MODULE,
+	.open    = irq_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+/* Upper bound, in ns, of the histogram bucket holding percentile pct */
+static u64 perf_percentile(const u64 *hist, u64 total, unsigned int pct)
+{
+	u64 seen = 0;
+	int i;
+
+	for (i = 0; i < SMI_PERF_BUCKETS; i++) {
+		seen += hist[i];
+		if (seen * 100 >= total * pct)
+			break;
+	}
+	return 1ULL << min(i, SMI_PERF_BUCKETS - 1);
+}
+
+/*
+ * Sum of the per-CPU counters of a CRTC, with the rates and the upload
+ * time percentiles since the previous read of the file.
+ */
+static int crtc_perf_show(struct seq_file *m, void *unused)
+{
+	struct smi_crtc *smi_crtc = m->private;
+	struct smi_crtc_perf sum = {}, delta;
+	const struct smi_crtc_perf *last = &smi_crtc->perf_last;
+	u64 now, ms, *d, *t;
+	int cpu, i;
+
+	for_each_possible_cpu(cpu) {
+		const struct smi_crtc_perf *p = per_cpu_ptr(smi_crtc->perf, cpu);
+
+		t = (u64 *)&sum;
+		for (i = 0; i < sizeof(sum) / sizeof(u64); i++)
+			t[i] += ((const u64 *)p)[i];
+	}
+
+	mutex_lock(&smi_crtc->perf_lock);
+	now = ktime_get_ns();
+	ms = max_t(u64, div_u64(now - smi_crtc->perf_last_ns, NSEC_PER_MSEC), 1);
+	d = (u64 *)&delta;
+	for (i = 0; i < sizeof(sum) / sizeof(u64); i++)
+		d[i] = ((u64 *)&sum)[i] - ((const u64 *)last)[i];
+	smi_crtc->perf_last = sum;
+	smi_crtc->perf_last_ns = now;
+	mutex_unlock(&smi_crtc->perf_lock);
+
+	seq_printf(m, "%-16s %16s %12s\n", "", "total", "per second");
+#define PERF_ROW(name, field) \
+	seq_printf(m, "%-16s %16llu %12llu\n", name, sum.field, div64_u64(delta.field * 1000, ms))
+	PERF_ROW("commits", commits);
+	PERF_ROW("flips", flips);
+	PERF_ROW("vblank irqs", vblanks);
+	PERF_ROW("missed frames", missed);
+	PERF_ROW("uploads", uploads);
+	PERF_ROW("upload bytes", upload_bytes);
+	PERF_ROW("damage clips", upload_clips);
+	PERF_ROW("cursor updates", cursor_updates);
+#undef PERF_ROW
+
+	if (delta.commits)
+		seq_printf(m, "clips/commit     %llu.%02llu\n", div64_u64(delta.upload_clips, delta.commits),
+			   div64_u64(delta.upload_clips * 100, delta.commits) % 100);
+	if (delta.uploads)
+		seq_printf(m, "upload time      p50 <= %llu ns, p99 <= %llu ns\n",
+			   perf_percentile(delta.upload_hist, delta.uploads, 50),
+			   perf_percentile(delta.upload_hist, delta.uploads, 99));
+
+	return 0;
+}
+
+static int crtc_perf_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, crtc_perf_show, inode->i_private);
+}
+
+static const struct file_operations crtc_perf_fops = {
+	.owner   = THIS_MODULE,
+	.open    = crtc_perf_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+/* Called from the late_register hook of the CRTC, once its directory exists */
+void smi_crtc_debugfs_init(struct drm_crtc *crtc)
+{
+#ifdef CONFIG_DEBUG_FS
+	debugfs_create_file("perf", 0444, crtc->debugfs_entry, to_smi_crtc(crtc), &crtc_perf_fops);
+#endif
+}
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
      void smi_debugfs_init(struct drm_minor *minor)
 #else
@@ -147,7 +403,7 @@ static const struct file_operations reg_fops = {
 	
 	sdev  = minor->dev->dev_private;
 
-	debugfs_create_file_unsafe("pwm_ctl", S_IRUGO | S_IWUSR, minor->debugfs_root, &pwm_ctrl, &fops_pwm);
+	debugfs_create_file_unsafe("pwm_ctl", S_IRUGO | S_IWUSR, minor->debugfs_root, sdev, &fops_pwm);
 
 	debugfs_create_u32("smi_debug", S_IRUGO | S_IWUSR, minor->debugfs_root, &smi_debug);
 
@@ -180,6 +436,14 @@ static const struct file_operations reg_fops = {
 	debugfs_create_regset32("regdump", 0644, minor->debugfs_root, regset);
 
 	debugfs_create_file("regrw", 0644, minor->debugfs_root, minor->dev, &reg_fops);
+
+	debugfs_create_file("reg_locks", 0444, minor->debugfs_root, sdev, &reg_locks_fops);
+
+	debugfs_create_file("pll", 0444, minor->debugfs_root, sdev, &pll_fops);
+
+	debugfs_create_file("pm", 0444, minor->debugfs_root, sdev, &pm_fops);
+
+	debugfs_create_file("irq", 0444, minor->debugfs_root, sdev, &irq_fops);
 DEBUGFS_FAIL:
 #if LINUX_VERSION_CODE < KERNEL_VERSION(5, 6, 0)
     return 0;
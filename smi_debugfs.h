@@ -19,6 +19,8 @@ struct smi_regs{
 
 
 
+void smi_crtc_debugfs_init(struct drm_crtc *crtc);
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
         void smi_debugfs_init(struct drm_minor *minor);
 #else
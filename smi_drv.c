@@ -42,6 +42,7 @@
 #include "hw768.h"
 
 #include "smi_debugfs.h"
+#include "smi_trace.h"
 
 int smi_modeset = -1;
 int smi_indent = 0;
@@ -53,7 +54,8 @@ int usb_host = 0;
 int audio_en = 0;
 int fixed_width = 0;
 int fixed_height = 0;
-int hwi2c_en = 0;
+int hwi2c_en = -1;
+int i2c_speed = 400;
 int swcur_en = 0;
 int edid_mode = 1;
 int smi_debug = 0;
@@ -61,6 +63,8 @@ int lcd_scale = 0;
 int pwm_ctrl = 0;
 int	ddr_retrain = 0;
 int clk_phase = -1;
+int fast_boot = 0;
+int reduced_blanking = 1;
 
 module_param(smi_pat, int, S_IWUSR | S_IRUSR);
 
@@ -79,8 +83,10 @@ MODULE_PARM_DESC(height, "Fixed mode height for LVDS or nopnp (default:0)");
 module_param_named(height, fixed_height, int, 0400);
 MODULE_PARM_DESC(audio, "SM768 Audio, 0=diable 1=use UDA1345 Codec, 2=use WM8978 Codec(default:0)");
 module_param_named(audio, audio_en, int, 0400);
-MODULE_PARM_DESC(hwi2c, "HW I2C for EDID reading, 0=SW I2C 1=HW I2C(default:0)");
+MODULE_PARM_DESC(hwi2c, "I2C master for EDID and DDC/CI, 0=SW I2C 1=HW I2C -1=HW on SM768, SW on SM750; SM768 HDMI always uses SW I2C (default:-1)");
 module_param_named(hwi2c, hwi2c_en, int, 0400);
+MODULE_PARM_DESC(i2cspeed, "I2C bus speed in kHz, 100 or 400 (default:400)");
+module_param_named(i2cspeed, i2c_speed, int, 0400);
 MODULE_PARM_DESC(swcur, "Use Software cursor, 0=HW Cursor 1=SW Cursor(default:0)");
 module_param_named(swcur, swcur_en, int, 0400);
 MODULE_PARM_DESC(edidmode, "Use Monitor EDID mode timing, 0 = Driver build-in mode timing 1 = Monitor EDID mode timing(default:1)");
@@ -95,6 +101,10 @@ MODULE_PARM_DESC(clkphase, "Panel Mode Clock phase, -1 = Use Mode table (Default
 module_param_named(clkphase, clk_phase, int, 0400);
 MODULE_PARM_DESC(ddretrain, "DDR Re-train  0 = disable 1 = enable  (default:0)");
 module_param_named(ddretrain, ddr_retrain, int, 0400);
+MODULE_PARM_DESC(fastboot, "Keep the mode set up by the firmware on the boot GPU, 0 = disable 1 = enable (default:0)");
+module_param_named(fastboot, fast_boot, int, 0400);
+MODULE_PARM_DESC(rb, "Built-in timing on SM768 DVI/HDMI, 0 = VESA mode table 1 = CVT reduced blanking 2 = CVT-RBv2, used when the sink allows it (default:1)");
+module_param_named(rb, reduced_blanking, int, 0400);
 
 
 /*
@@ -226,58 +236,39 @@ static void smi_pci_remove(struct pci_dev *pdev)
 
 
 
-static int smi_vram_suspend(struct smi_device *sdev,int vram_size)
-{
-
-	sdev->vram_save = kvmalloc(vram_size << 20,GFP_KERNEL);
-	if (!sdev->vram_save)			
-		goto malloc_failed;
-	
-	memcpy_fromio(sdev->vram_save, sdev->vram, vram_size << 20);
-
-	return 0;
-	
-malloc_failed:
-	if (sdev->vram_save) {			
-		kvfree(sdev->vram_save); 		
-		sdev->vram_save = NULL; 	
-	}	
-	return -ENOMEM;
-}
-
-static void smi_vram_resume(struct smi_device *sdev,int vram_size)
-{
-	if (sdev->vram_save) {		
-		memcpy_toio(sdev->vram, sdev->vram_save, vram_size << 20);
-		kvfree(sdev->vram_save); 		
-		sdev->vram_save = NULL; 
-	}
-}
-
-
+/*
+ * Everything the display engine fetches has a copy in system memory: the
+ * primary planes and cursors are uploaded from their shmem framebuffers,
+ * and the fbdev console is a shmem buffer too. VRAM is therefore not saved
+ * across suspend. The CRTCs are turned off before the registers are saved,
+ * so resume does not scan out stale VRAM, and drm_mode_config_helper_resume()
+ * re-uploads every plane in full when it restores the state.
+ */
 static int smi_drm_freeze(struct drm_device *dev)
 {
 	int ret;
 	struct smi_device *sdev = dev->dev_private;
+	u64 start = ktime_get_ns();
 	ENTER();
 	
-	if (sdev->specId == SPC_SM750){
-		smi_vram_suspend(sdev,16);
-		hw750_suspend(sdev->regsave);
-	}else if(sdev->specId == SPC_SM768){
+	/* Don't save the chip halfway through the deferred part of load */
+	smi_wait_deferred_init(sdev);
 #ifndef NO_AUDIO
-		if(audio_en)
-			 smi_audio_suspend();
+	if (sdev->specId == SPC_SM768 && audio_en && sdev->card)
+		smi_audio_suspend(dev);
 #endif
-		smi_vram_suspend(sdev,32);
-		hw768_suspend(sdev->regsave_768);
-    }
 	ret = drm_mode_config_helper_suspend(dev);
 	if (ret)
 		return ret;
 
+	if (sdev->specId == SPC_SM750)
+		hw750_suspend(sdev->ddk750_ctx, sdev->regsave, sdev->pm_time);
+	else if (sdev->specId == SPC_SM768)
+		hw768_suspend(sdev->ddk768_ctx, sdev->regsave, sdev->pm_time);
+
 
 	pci_save_state(to_pci_dev(dev->dev));
+	sdev->pm_suspend_ns = ktime_get_ns() - start;
 
 	LEAVE(0);
 }
@@ -291,20 +282,21 @@ static int smi_drm_thaw(struct drm_device *dev)
 	
 	
 	if(sdev->specId == SPC_SM750){
-		smi_vram_resume(sdev,16);
-		hw750_resume(sdev->regsave);
+		hw750_resume(sdev->ddk750_ctx, sdev->regsave, sdev->pm_time);
 	}else if(sdev->specId == SPC_SM768){
-		smi_vram_resume(sdev,32);
-		hw768_resume(sdev->regsave_768);
+		/* Resume re-initializes the HDMI transmitter */
+		mutex_lock(&sdev->hdmi_lock);
+		hw768_resume(sdev->ddk768_ctx, sdev->regsave, sdev->pm_time);
+		mutex_unlock(&sdev->hdmi_lock);
 #ifndef NO_AUDIO
-		if(audio_en)
-			smi_audio_resume();
+		if(audio_en && sdev->card)
+			smi_audio_resume(dev);
 #endif
 		if (lvds_channel == 1)
-			hw768_enable_lvds(1);
+			hw768_enable_lvds(sdev->ddk768_ctx, 1);
 		else if (lvds_channel == 2) {
-			hw768_enable_lvds(2);
-			EnableDoublePixel(0);
+			hw768_enable_lvds(sdev->ddk768_ctx, 2);
+			EnableDoublePixel(sdev->ddk768_ctx, 0);
 		}
 	}
 
@@ -318,6 +310,8 @@ static int smi_drm_resume(struct drm_device *dev)
 {
 	int ret;
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
+	struct smi_device *sdev = dev->dev_private;
+	u64 start = ktime_get_ns();
 
 	pci_set_power_state(pdev, PCI_D0);
 	pci_restore_state(pdev);
@@ -328,7 +322,9 @@ static int smi_drm_resume(struct drm_device *dev)
 	if (ret)
 		return ret;
 
-	return drm_mode_config_helper_resume(dev);
+	ret = drm_mode_config_helper_resume(dev);
+	sdev->pm_resume_ns = ktime_get_ns() - start;
+	return ret;
 }
 
 static int smi_pm_suspend(struct device *dev)
@@ -364,7 +360,18 @@ static int smi_pm_freeze(struct device *dev)
 static int smi_pm_thaw(struct device *dev)
 {
 	struct drm_device *ddev = dev_get_drvdata(dev);
-	return smi_drm_thaw(ddev);
+	struct smi_device *sdev = ddev->dev_private;
+	u64 start = ktime_get_ns();
+	int ret;
+
+	ret = smi_drm_thaw(ddev);
+	if (ret)
+		return ret;
+
+	/* Bring the displays back, and hand the state to the poweroff freeze */
+	ret = drm_mode_config_helper_resume(ddev);
+	sdev->pm_resume_ns = ktime_get_ns() - start;
+	return ret;
 }
 
 static int smi_pm_poweroff(struct device *dev)
@@ -380,9 +387,9 @@ static int smi_enable_vblank(struct drm_device *dev, unsigned int pipe)
 	struct smi_device *sdev = dev->dev_private;
 	
 	if (sdev->specId == SPC_SM750) {
-		hw750_en_dis_interrupt(1, pipe);
+		hw750_en_dis_interrupt(sdev->ddk750_ctx, 1, pipe);
 	} else if (sdev->specId == SPC_SM768) {
-		hw768_en_dis_interrupt(1, pipe);
+		hw768_en_dis_interrupt(sdev->ddk768_ctx, 1, pipe);
 	}
 	return 0;
 }
@@ -392,75 +399,196 @@ static void smi_disable_vblank(struct drm_device *dev, unsigned int pipe)
 	struct smi_device *sdev = dev->dev_private;
 	
 	if (sdev->specId == SPC_SM750) {
-		hw750_en_dis_interrupt(0, pipe);
+		hw750_en_dis_interrupt(sdev->ddk750_ctx, 0, pipe);
 	} else if (sdev->specId == SPC_SM768) {
-		hw768_en_dis_interrupt(0, pipe);
+		hw768_en_dis_interrupt(sdev->ddk768_ctx, 0, pipe);
 	}
 }
 #endif
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
-static void smi_irq_preinstall(struct drm_device *dev)
-{
-	// To Do....
-	/* Disable *all* interrupts */
-
-	/* Clear bits if they're already high */
-}
+const char * const smi_irq_names[SMI_IRQ_SOURCES] = {
+	[SMI_IRQ_VSYNC0] = "vsync0",
+	[SMI_IRQ_VSYNC1] = "vsync1",
+	[SMI_IRQ_HDMI] = "hdmi",
+	[SMI_IRQ_I2S] = "i2s",
+	[SMI_IRQ_DE] = "2d",
+	[SMI_IRQ_PWM] = "pwm",
+	[SMI_IRQ_TIMER] = "timer",
+};
 
-static int smi_irq_postinstall(struct drm_device *dev)
+static irqreturn_t smi_vsync_irq(struct smi_device *sdev, void *data)
 {
-	return 0;
+	struct drm_crtc *crtc = drm_crtc_from_index(sdev->dev, (uintptr_t)data);
+
+	trace_smi_vblank((uintptr_t)data);
+	if (crtc)
+		this_cpu_inc(to_smi_crtc(crtc)->perf->vblanks);
+	drm_handle_vblank(sdev->dev, (uintptr_t)data);
+	return IRQ_HANDLED;
 }
 
-static void smi_irq_uninstall(struct drm_device *dev)
+/*
+ * HDMI registers can't be reached from here: wake the EDID reader if one
+ * is waiting, else mask the source and ack it in the worker.
+ */
+static irqreturn_t smi_hdmi_irq(struct smi_device *sdev, void *data)
 {
-	struct smi_device *sdev = dev->dev_private;
+	if (!sdev->hdmi_connector)
+		return IRQ_NONE;
 
-	/* Disable *all* interrupts */
-	if (sdev->specId == SPC_SM750) {
-		ddk750_disable_IntMask();
-	} else if (sdev->specId == SPC_SM768) {
-		ddk768_disable_IntMask();
+	if (!hw768_hdmi_edid_irq(sdev->ddk768_ctx)) {
+		hw768_mask_hdmi_interrupt(sdev->ddk768_ctx, 1);
+		schedule_work(&sdev->hotplug_work);
 	}
+	return IRQ_HANDLED;
 }
-#endif
 
+/*
+ * Top-level handler for the whole chip: read the status once, call the
+ * handler of every pending source, then ack the vsyncs together.
+ */
 irqreturn_t smi_drm_interrupt(DRM_IRQ_ARGS)
 {
 	struct drm_device *dev = (struct drm_device *)arg;
-	int handled = 0;
 	struct smi_device *sdev = dev->dev_private;
-
-	if (sdev->specId == SPC_SM750) {
-		if (hw750_check_vsync_interrupt(0)) {
-			/* Clear the panel VSync Interrupt */
-			drm_handle_vblank(dev, 0);
-			handled = 1;
-			hw750_clear_vsync_interrupt(0);
-		}
-		if (hw750_check_vsync_interrupt(1)) {
-			drm_handle_vblank(dev, 1);
-			handled = 1;
-			hw750_clear_vsync_interrupt(1);
-		}
-	} else if (sdev->specId == SPC_SM768) {
-		if (hw768_check_vsync_interrupt(0)) {
-			/* Clear the panel VSync Interrupt */
-			drm_handle_vblank(dev, 0);
-			handled = 1;
-			hw768_clear_vsync_interrupt(0);
+	struct smi_irq_handler *h;
+	unsigned long sources;
+	irqreturn_t ret = IRQ_NONE, r;
+	int i;
+
+	if (sdev->specId == SPC_SM750)
+		sources = hw750_get_irq_sources(sdev->ddk750_ctx);
+	else
+		sources = hw768_get_irq_sources(sdev->ddk768_ctx);
+
+	if (!sources) {
+		sdev->irq_none++;
+		return IRQ_NONE;
+	}
+	sdev->irq_count++;
+
+	spin_lock(&sdev->irq_lock);
+	for_each_set_bit(i, &sources, SMI_IRQ_SOURCES) {
+		h = &sdev->irq_handlers[i];
+		h->count++;
+		if (!h->handler) {
+			h->unclaimed++;
+			trace_smi_irq(i, IRQ_NONE);
+			continue;
 		}
-		if (hw768_check_vsync_interrupt(1)) {
-			drm_handle_vblank(dev, 1);
-			handled = 1;
-			hw768_clear_vsync_interrupt(1);
+		r = h->handler(sdev, h->data);
+		trace_smi_irq(i, r);
+		if (r == IRQ_WAKE_THREAD) {
+			h->threaded++;
+			set_bit(i, &sdev->irq_thread_pending);
+			ret = IRQ_WAKE_THREAD;
+		} else if (r == IRQ_HANDLED && ret == IRQ_NONE) {
+			ret = IRQ_HANDLED;
 		}
 	}
+	spin_unlock(&sdev->irq_lock);
+
+	if (sdev->specId == SPC_SM750)
+		hw750_clear_vsync_sources(sdev->ddk750_ctx, sources);
+	else
+		hw768_clear_vsync_sources(sdev->ddk768_ctx, sources);
+
+	return ret;
+}
+
+static irqreturn_t smi_irq_thread(int irq, void *arg)
+{
+	struct drm_device *dev = arg;
+	struct smi_device *sdev = dev->dev_private;
+	smi_irq_fn_t thread_fn;
+	void *data;
+	int i;
+
+	for (i = 0; i < SMI_IRQ_SOURCES; i++) {
+		if (!test_and_clear_bit(i, &sdev->irq_thread_pending))
+			continue;
+
+		spin_lock_irq(&sdev->irq_lock);
+		thread_fn = sdev->irq_handlers[i].thread_fn;
+		data = sdev->irq_handlers[i].data;
+		spin_unlock_irq(&sdev->irq_lock);
+
+		if (thread_fn)
+			thread_fn(sdev, data);
+	}
+
+	return IRQ_HANDLED;
+}
+
+/*
+ * Hook a block to its interrupt source. The source itself must be unmasked
+ * by the caller, once the handler is in place.
+ */
+void smi_irq_register(struct smi_device *sdev, enum smi_irq_source source,
+		      smi_irq_fn_t handler, smi_irq_fn_t thread_fn, void *data)
+{
+	struct smi_irq_handler *h = &sdev->irq_handlers[source];
+	unsigned long flags;
+
+	spin_lock_irqsave(&sdev->irq_lock, flags);
+	h->handler = handler;
+	h->thread_fn = thread_fn;
+	h->data = data;
+	spin_unlock_irqrestore(&sdev->irq_lock, flags);
+}
+
+/*
+ * Unhook a source, the caller masks it first. On return neither handler
+ * nor thread_fn is running any more.
+ */
+void smi_irq_unregister(struct smi_device *sdev, enum smi_irq_source source)
+{
+	smi_irq_register(sdev, source, NULL, NULL, NULL);
+	clear_bit(source, &sdev->irq_thread_pending);
+
+	if (sdev->irq_enabled)
+		synchronize_irq(to_pci_dev(sdev->dev->dev)->irq);
+}
+
+/*
+ * Request the PCI interrupt for the whole chip, with the display and HDMI
+ * handlers in place; audio adds its own once it is up.
+ */
+int smi_irq_install(struct smi_device *sdev)
+{
+	struct drm_device *dev = sdev->dev;
+	int r;
+
+	smi_irq_register(sdev, SMI_IRQ_VSYNC0, smi_vsync_irq, NULL, (void *)0);
+	smi_irq_register(sdev, SMI_IRQ_VSYNC1, smi_vsync_irq, NULL, (void *)1);
+	if (sdev->specId == SPC_SM768)
+		smi_irq_register(sdev, SMI_IRQ_HDMI, smi_hdmi_irq, NULL, NULL);
+
+	r = request_threaded_irq(to_pci_dev(dev->dev)->irq, smi_drm_interrupt, smi_irq_thread,
+				 IRQF_SHARED, KBUILD_MODNAME, dev);
+	if (r)
+		return r;
+
+	sdev->irq_enabled = true;
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
+	/* Not installed by drm_irq_install(), but the vblank ioctls check it */
+	dev->irq_enabled = true;
+#endif
+	return 0;
+}
+
+void smi_irq_uninstall(struct smi_device *sdev)
+{
+	struct drm_device *dev = sdev->dev;
+
+	if (!sdev->irq_enabled)
+		return;
 
-	if (handled)
-		return IRQ_HANDLED;
-	return IRQ_NONE;
+	free_irq(to_pci_dev(dev->dev)->irq, dev);
+	sdev->irq_enabled = false;
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
+	dev->irq_enabled = false;
+#endif
 }
 
 
@@ -489,6 +617,10 @@ static struct pci_driver smi_pci_driver = {
 	.probe = smi_pci_probe,
 	.remove = smi_pci_remove,
 	.driver.pm = &smi_pm_ops,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 2, 0)
+	/* Probe doesn't depend on anything else: let it run in parallel */
+	.driver.probe_type = PROBE_PREFER_ASYNCHRONOUS,
+#endif
 };
 
 
@@ -531,12 +663,6 @@ static struct drm_driver driver = {
 	.enable_vblank = smi_enable_vblank,
 	.disable_vblank = smi_disable_vblank,
 #endif
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
-	.irq_preinstall = smi_irq_preinstall,
-	.irq_postinstall = smi_irq_postinstall,
-	.irq_uninstall = smi_irq_uninstall,
-	.irq_handler = smi_drm_interrupt,
-#endif
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 6, 0)
 	.prime_handle_to_fd = drm_gem_prime_handle_to_fd,
 	.prime_fd_to_handle = drm_gem_prime_fd_to_handle,
@@ -21,10 +21,13 @@
 #endif
 
 
+#include <linux/completion.h>
 #include <linux/i2c-algo-bit.h>
 #include <linux/i2c.h>
 
 #include "smi_priv.h"
+#include "smi_pm.h"
+#include "smi_irq.h"
 
 #define DRIVER_AUTHOR "SiliconMotion"
 
@@ -68,6 +71,10 @@
 #define SM768_MAX_MODE_SIZE (32<<20)
 #define SM750_MAX_MODE_SIZE (8<<20)
 
+/* SM768 memory interface: 32-bit DDR, share reserved for display fetch */
+#define SMI768_DDR_BYTES_PER_CLOCK 8
+#define SMI768_DISPLAY_BW_PERCENT 70
+
 #define MAX_CRTC 2
 #define MAX_ENCODER 3
 
@@ -82,14 +89,17 @@ extern int audio_en;
 extern int fixed_width;
 extern int fixed_height;
 extern int hwi2c_en;
+extern int i2c_speed;
 extern int swcur_en;
 extern int edid_mode;
 extern int lcd_scale;
 extern int pwm_ctrl;
 extern int ddr_retrain;
+extern int fast_boot;
+extern int reduced_blanking;
 
-struct smi_750_register;
-struct smi_768_register;
+struct _ddk750_context_t;
+struct _ddk768_context_t;
 
 struct smi_plane {
 	struct drm_plane base;
@@ -106,6 +116,19 @@ static inline struct smi_plane *to_smi_plane(struct drm_plane *plane)
 	return container_of(plane, struct smi_plane, base);
 }
 
+/* What smi_crtc_program_mode() needs from the EDID of an output */
+struct smi_edid_caps {
+	bool valid;		/* header checks out */
+	bool rb_allowed;	/* no EDID range limits forbidding reduced blanking */
+};
+
+/* Mode the firmware left running on a display channel */
+struct smi_boot_mode {
+	bool valid;
+	int bpp;
+	struct drm_display_mode mode;
+};
+
 struct smi_device {
 	struct drm_device *dev;
 	struct snd_card 		*card;	
@@ -119,6 +142,10 @@ struct smi_device {
 	void __iomem *vram;
 
 	int specId;
+	union {
+		struct _ddk750_context_t *ddk750_ctx;
+		struct _ddk768_context_t *ddk768_ctx;
+	};
 	
 	int m_connector;  //bit 0: DVI, bit 1: VGA, bit 2: HDMI.
 
@@ -130,22 +157,60 @@ struct smi_device {
 	int fb_mtrr;
 	bool need_dma32;
 	bool mm_inited;
-	void *vram_save;
-	union {
-		struct smi_750_register *regsave;
-		struct smi_768_register *regsave_768;
-	};
+	/* Registers kept across suspend, see hw750_regsave/hw768_regsave */
+	uint32_t *regsave;
+	pm_phase_time_t pm_time[PM_MAX_PHASES];
+	u64 pm_suspend_ns, pm_resume_ns;	/* whole freeze / thaw */
 #ifdef USE_HDMICHIP
 	struct edid si9022_edid[2];
 #endif
-	void *dvi_edid;
-	void *vga_edid;
-	void *hdmi_edid;
+	/*
+	 * Per output (DVI, VGA, HDMI, the encoder order). The EDIDs belong to
+	 * the connectors and a probe may free them under a running commit, so
+	 * the modeset only sees these, updated under edid_lock.
+	 */
+	spinlock_t edid_lock;
+	struct smi_edid_caps edid_caps[MAX_ENCODER];
 	struct drm_display_mode *fixed_mode;
 	bool is_hdmi;
 	bool is_boot_gpu;
+	struct smi_boot_mode boot_mode[MAX_CRTC];
+	bool hdmi_init_pending;
+	/*
+	 * Every HDMI register access sleeps; hdmi_lock serializes them between
+	 * the modeset, DPMS and hotplug paths. The IRQ handler only masks the
+	 * HDMI source and defers the rest to hotplug_work.
+	 */
+	struct mutex hdmi_lock;
+	struct work_struct hotplug_work;
+	struct drm_connector *hdmi_connector;
+	/* Bytes/s the display fetch may use, 0 when not modelled (SM750) */
+	unsigned long mem_bandwidth;
+	/*
+	 * The HDMI transmitter and the audio codec are not needed to light up
+	 * the displays, so init_work brings them up after load has returned.
+	 * init_done completes once it has run; card is set if audio came up.
+	 */
+	struct work_struct init_work;
+	struct completion init_done;
+	/*
+	 * Interrupt dispatch, see smi_irq.h. irq_lock guards the handler
+	 * table against (un)registration; irq_thread_pending holds the
+	 * sources whose thread_fn is due.
+	 */
+	spinlock_t irq_lock;
+	struct smi_irq_handler irq_handlers[SMI_IRQ_SOURCES];
+	unsigned long irq_thread_pending;
+	unsigned long irq_count;
+	unsigned long irq_none;		/* the line is shared: not ours */
+	bool irq_enabled;
 };
 
+static inline void smi_wait_deferred_init(struct smi_device *sdev)
+{
+	wait_for_completion(&sdev->init_done);
+}
+
 struct smi_encoder {
 	struct drm_encoder base;
 	int last_dpms;
@@ -159,6 +224,15 @@ struct smi_connector {
 	unsigned char i2c_sda;
 	unsigned char i2cNumber;
 	bool i2c_hw_enabled;
+	unsigned int i2c_clocks;	/* SCL low edges, to yield once per byte */
+	/*
+	 * EDID read by get_modes, kept while edid_gen matches hpd_gen. The
+	 * hotplug work and a change of DDC presence bump hpd_gen.
+	 */
+	struct edid *edid;
+	unsigned int edid_gen;
+	atomic_t hpd_gen;
+	bool ddc_present;
 };
 
 static inline struct smi_connector *to_smi_connector(struct drm_connector *connector)
@@ -184,6 +258,9 @@ struct drm_plane *smi_plane_init(struct smi_device *cdev, unsigned int possible_
 int smi_modeset_init(struct smi_device *cdev);
 void smi_modeset_fini(struct smi_device *cdev);
 int smi_calc_hdmi_ctrl(int m_connector);
+void smi_crtc_queue_commit(struct drm_crtc *crtc, struct drm_atomic_state *state);
+void smi_crtc_wait_commit(struct drm_crtc *crtc);
+void smi_hdmi_hotplug_work(struct work_struct *work);
 
 #define to_smi_crtc(x) container_of(x, struct smi_crtc, base)
 #define to_smi_encoder(x) container_of(x, struct smi_encoder, base)
@@ -202,14 +279,21 @@ struct drm_gem_object *smi_gem_prime_import_sg_table(struct drm_device *dev,
 int smi_audio_init(struct drm_device *dev);
 void smi_audio_remove(struct drm_device *dev);
 
-void smi_audio_suspend(void);
-void smi_audio_resume(void);
+void smi_audio_suspend(struct drm_device *dev);
+void smi_audio_eld_notify(struct drm_device *dev);
+void smi_audio_resume(struct drm_device *dev);
 
 #ifndef DRM_IRQ_ARGS
 #define DRM_IRQ_ARGS int irq, void *arg
 #endif
 
 irqreturn_t smi_drm_interrupt(DRM_IRQ_ARGS);
+int smi_irq_install(struct smi_device *sdev);
+void smi_irq_uninstall(struct smi_device *sdev);
+void smi_irq_register(struct smi_device *sdev, enum smi_irq_source source,
+		      smi_irq_fn_t handler, smi_irq_fn_t thread_fn, void *data);
+void smi_irq_unregister(struct smi_device *sdev, enum smi_irq_source source);
+extern const char * const smi_irq_names[SMI_IRQ_SOURCES];
 
 
 
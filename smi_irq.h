@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0+
+// Copyright (c) 2023, SiliconMotion Inc.
+
+#ifndef __SMI_IRQ_H__
+#define __SMI_IRQ_H__
+
+#include <linux/interrupt.h>
+
+/*
+ * Interrupt sources behind the one PCI line.
+ *
+ * The display, HDMI, audio, 2D, PWM and timer blocks all raise the same
+ * interrupt. smi_drm_interrupt() reads the status once per interrupt
+ * (hw750/hw768_get_irq_sources() turn it into a mask of BIT(SMI_IRQ_xxx))
+ * and calls the handler registered for each pending source:
+ *
+ *   - handler runs in hard IRQ context, must ack its source and may return
+ *     IRQ_WAKE_THREAD to have thread_fn called from the IRQ thread;
+ *   - the vsync sources are acked by the dispatcher, in one register write.
+ *
+ * Per-source counts are exported through the "irq" debugfs file.
+ */
+enum smi_irq_source {
+	SMI_IRQ_VSYNC0,
+	SMI_IRQ_VSYNC1,
+	SMI_IRQ_HDMI,
+	SMI_IRQ_I2S,
+	SMI_IRQ_DE,
+	SMI_IRQ_PWM,
+	SMI_IRQ_TIMER,
+	SMI_IRQ_SOURCES,
+};
+
+struct smi_device;
+
+typedef irqreturn_t (*smi_irq_fn_t)(struct smi_device *sdev, void *data);
+
+struct smi_irq_handler {
+	smi_irq_fn_t handler;
+	smi_irq_fn_t thread_fn;
+	void *data;
+	unsigned long count;		/* interrupts from this source */
+	unsigned long threaded;		/* ... that woke thread_fn */
+	unsigned long unclaimed;	/* ... with no handler registered */
+};
+
+#endif
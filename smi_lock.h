@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0+
+// Copyright (c) 2023, SiliconMotion Inc.
+
+#ifndef __SMI_LOCK_H__
+#define __SMI_LOCK_H__
+
+#include <linux/spinlock.h>
+#include <linux/ktime.h>
+
+/*
+ * Register block locks.
+ *
+ * Most of the chip is programmed with peek/modify/poke sequences on
+ * registers that several contexts share: the interrupt mask is touched by
+ * the vblank code, the HDMI and audio drivers from process and IRQ context,
+ * the GPIO mux/data/direction registers by both I2C masters, the I2S and
+ * PWM setup, and each display controller by the CRTC that owns it plus
+ * the plane and cursor code.
+ *
+ * Each of those blocks has one smi_reg_lock in the DDK context:
+ *
+ *   - interrupt mask    INT_MASK
+ *   - GPIO              GPIO_MUX, GPIO_DATA, GPIO_DATA_DIRECTION
+ *   - display ctrl [n]  the register bank of display channel n
+ *
+ * The rules are:
+ *
+ *   - hold the lock only around the read-modify-write itself, never across
+ *     a vsync wait, a delay or an I2C transaction, so that the two CRTCs
+ *     can be programmed concurrently and the IRQ handler never spins long;
+ *   - the locks are leaves: never take one while holding another;
+ *   - they are taken with interrupts disabled, so any context may use them.
+ *
+ * Every release records how long the lock was held; the numbers are
+ * exported through the "reg_locks" debugfs file.
+ */
+struct smi_reg_lock {
+	spinlock_t lock;
+	const char *name;
+	u64 acquired;		/* ktime_get_ns() when the current holder got it */
+	u64 hold_max_ns;
+	u64 hold_total_ns;
+	unsigned long count;
+};
+
+static inline void smi_reg_lock_init(struct smi_reg_lock *l, const char *name)
+{
+	spin_lock_init(&l->lock);
+	l->name = name;
+	l->hold_max_ns = 0;
+	l->hold_total_ns = 0;
+	l->count = 0;
+}
+
+#define smi_reg_lock_acquire(l, flags)				\
+	do {							\
+		spin_lock_irqsave(&(l)->lock, flags);		\
+		(l)->acquired = ktime_get_ns();			\
+	} while (0)
+
+static inline void smi_reg_lock_release(struct smi_reg_lock *l, unsigned long flags)
+{
+	u64 held = ktime_get_ns() - l->acquired;
+
+	if (held > l->hold_max_ns)
+		l->hold_max_ns = held;
+	l->hold_total_ns += held;
+	l->count++;
+	spin_unlock_irqrestore(&l->lock, flags);
+}
+
+#endif
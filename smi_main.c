@@ -8,10 +8,6 @@
 #include <linux/pci.h>
 #endif
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
-#include <drm/drm_irq.h>
-#endif
-
 #include <drm/drm_vblank.h>
 #include <drm/drm_gem_framebuffer_helper.h>
 #include <drm/drm_atomic_helper.h>
@@ -32,18 +28,248 @@ static const struct drm_framebuffer_funcs smi_fb_funcs = {
 	.destroy = drm_gem_fb_destroy,
 };
 
+/*
+ * Same sequence as drm_atomic_helper_commit_tail(), except that the plane
+ * updates of each CRTC run in parallel. The modes are still programmed one
+ * CRTC at a time by drm_atomic_helper_commit_modeset_disables().
+ */
+static void smi_atomic_commit_tail(struct drm_atomic_state *state)
+{
+	struct drm_device *dev = state->dev;
+	struct drm_crtc_state *new_crtc_state;
+	struct drm_crtc *crtc;
+	int i;
+
+	drm_atomic_helper_commit_modeset_disables(dev, state);
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i)
+		smi_crtc_queue_commit(crtc, state);
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i)
+		smi_crtc_wait_commit(crtc);
+
+	drm_atomic_helper_commit_modeset_enables(dev, state);
+
+	drm_atomic_helper_commit_hw_done(state);
+
+	drm_atomic_helper_wait_for_flip_done(dev, state);
+
+	drm_atomic_helper_cleanup_planes(dev, state);
+}
+
 static const struct drm_mode_config_helper_funcs smi_mode_config_helper_funcs = {
-	.atomic_commit_tail = drm_atomic_helper_commit_tail,
+	.atomic_commit_tail = smi_atomic_commit_tail,
 };
 
+/*
+ * Display fetch bandwidth model.
+ *
+ * Both display channels, their cursors and the overlay fetch from the same
+ * DDR interface. While a line is scanned out, a plane needs its bytes of
+ * that line within the active part of the line, i.e. at the pixel clock
+ * times cpp for a full width plane. The sum of these peak rates over every
+ * active CRTC has to fit in the share of the memory bandwidth left to the
+ * display FIFOs, or they underflow.
+ */
+static u64 smi_plane_bandwidth(const struct drm_plane_state *plane_state,
+			       const struct drm_display_mode *mode)
+{
+	const struct drm_framebuffer *fb = plane_state->fb;
+	u32 src_h = plane_state->src_h >> 16;
+	u64 rate;
+
+	if (!fb || !plane_state->crtc || !mode->clock || !mode->hdisplay)
+		return 0;
+
+	rate = div_u64((u64)mode->clock * 1000 * fb->format->cpp[0] * (plane_state->src_w >> 16),
+		       mode->hdisplay);
+
+	/* Vertical downscaling fetches several source lines per line */
+	if (plane_state->crtc_h && src_h > plane_state->crtc_h)
+		rate = div_u64(rate * src_h, plane_state->crtc_h);
+
+	return rate;
+}
+
+/* Mode of the CRTC @crtc will scan out once @state is committed */
+static const struct drm_display_mode *smi_crtc_new_mode(struct drm_atomic_state *state,
+							struct drm_crtc *crtc)
+{
+	struct drm_crtc_state *crtc_state = drm_atomic_get_new_crtc_state(state, crtc);
+
+	return &(crtc_state ? crtc_state : crtc->state)->adjusted_mode;
+}
+
+/*
+ * Runs after drm_atomic_helper_check_modeset(), so that every modeset,
+ * including active and connector changes, is known. The CRTCs and planes
+ * it pulls in have to go through drm_atomic_helper_check_planes() after it.
+ */
+static int smi_atomic_check_bandwidth(struct drm_device *dev, struct drm_atomic_state *state)
+{
+	struct smi_device *cdev = dev->dev_private;
+	struct drm_plane_state *old_plane_state, *new_plane_state;
+	struct drm_crtc_state *crtc_state;
+	const struct drm_plane_state *plane_state;
+	const struct drm_display_mode *mode;
+	struct drm_plane *plane;
+	struct drm_crtc *crtc;
+	bool grown = false;
+	u64 total = 0;
+	int i, ret;
+
+	if (!cdev->mem_bandwidth)
+		return 0;
+
+	/*
+	 * Page flips and cursor moves keep the fetch rate, only look at the
+	 * other CRTCs (and wait for their commits) when it may have grown.
+	 */
+	for_each_new_crtc_in_state(state, crtc, crtc_state, i)
+		if (drm_atomic_crtc_needs_modeset(crtc_state))
+			grown = true;
+	for_each_oldnew_plane_in_state(state, plane, old_plane_state, new_plane_state, i) {
+		crtc = new_plane_state->crtc;
+		if (!crtc)
+			continue;
+		if (crtc != old_plane_state->crtc) {
+			grown = true;
+			continue;
+		}
+		mode = smi_crtc_new_mode(state, crtc);
+		if (smi_plane_bandwidth(new_plane_state, mode) > smi_plane_bandwidth(old_plane_state, mode))
+			grown = true;
+	}
+	if (!grown)
+		return 0;
+
+	drm_for_each_crtc(crtc, dev) {
+		crtc_state = drm_atomic_get_crtc_state(state, crtc);
+		if (IS_ERR(crtc_state))
+			return PTR_ERR(crtc_state);
+		if (!crtc_state->active)
+			continue;
+
+		ret = drm_atomic_add_affected_planes(state, crtc);
+		if (ret)
+			return ret;
+
+		drm_atomic_crtc_state_for_each_plane_state(plane, plane_state, crtc_state)
+			total += smi_plane_bandwidth(plane_state, &crtc_state->adjusted_mode);
+	}
+
+	if (total > cdev->mem_bandwidth) {
+		dbg_msg("display fetch needs %llu MB/s, memory allows %lu MB/s\n",
+			div_u64(total, 1000000), cdev->mem_bandwidth / 1000000);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* drm_atomic_helper_check() with the bandwidth check between its halves */
+static int smi_atomic_check(struct drm_device *dev, struct drm_atomic_state *state)
+{
+	int ret;
+
+	ret = drm_atomic_helper_check_modeset(dev, state);
+	if (ret)
+		return ret;
+
+	ret = smi_atomic_check_bandwidth(dev, state);
+	if (ret)
+		return ret;
+
+	ret = drm_atomic_helper_check_planes(dev, state);
+	if (ret)
+		return ret;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 14, 0)
+	if (state->legacy_cursor_update)
+		state->async_update = !drm_atomic_helper_async_check(dev, state);
+#endif
+
+	return 0;
+}
+
 static const struct drm_mode_config_funcs smi_mode_config_funcs = {
 	.fb_create = drm_gem_fb_create_with_dirty,
 	.output_poll_changed = drm_fb_helper_output_poll_changed,
-	.atomic_check = drm_atomic_helper_check,
+	.atomic_check = smi_atomic_check,
 	.atomic_commit = drm_atomic_helper_commit,
 };
 
 
+/*
+ * Record the modes the firmware is displaying, so that the first commit
+ * asking for the same mode on a channel can keep it instead of blanking the
+ * screen for a full modeset. Returns true if any channel is active.
+ */
+static bool smi_read_boot_modes(struct smi_device *cdev)
+{
+	struct smi_boot_mode *boot;
+	bool found = false;
+	int i;
+
+	for (i = 0; i < MAX_CRTC; i++) {
+		boot = &cdev->boot_mode[i];
+		boot->valid = hw768_read_boot_mode(cdev->ddk768_ctx, i, &boot->mode, &boot->bpp) == 0;
+		if (!boot->valid)
+			continue;
+
+		DRM_INFO("channel %d: keeping firmware mode " DRM_MODE_FMT ", %d bpp\n",
+			 i, DRM_MODE_ARG(&boot->mode), boot->bpp);
+		found = true;
+	}
+
+	return found;
+}
+
+/*
+ * The part of load that is not needed for the first frame: the HDMI
+ * transmitter and the audio codec. Runs on the system workqueue while the
+ * DRM device gets registered; everything that needs those blocks first
+ * waits for init_done, or (for the SM768 HDMI) checks hdmi_init_pending.
+ */
+static void smi_deferred_init_work(struct work_struct *work)
+{
+	struct smi_device *cdev = container_of(work, struct smi_device, init_work);
+	int i;
+
+	if (cdev->specId == SPC_SM750) {
+#ifdef USE_HDMICHIP
+		if (sii9022xInitChip(cdev->ddk750_ctx) < 0)
+			printk("Init HDMI-Tx chip failed!");
+#endif
+#ifdef USE_EP952
+		EP_HDMI_Init(cdev, 0);
+		EP_HDMI_Set_Video_Timing(cdev, 1,0);
+#endif
+	} else {
+		mutex_lock(&cdev->hdmi_lock);
+		/* HDMI_Init would mute a sink kept from the firmware: leave it to the first modeset */
+		for (i = 0; i < MAX_CRTC; i++)
+			if (cdev->boot_mode[i].valid)
+				break;
+		if (cdev->hdmi_init_pending && i == MAX_CRTC) {
+			cdev->hdmi_init_pending = false;
+			hw768_init_hdmi(cdev->ddk768_ctx);
+		}
+		if (cdev->hdmi_connector && cdev->hdmi_connector->polled == DRM_CONNECTOR_POLL_HPD)
+			hw768_enable_hdmi_hotplug(cdev->ddk768_ctx, 1);
+		mutex_unlock(&cdev->hdmi_lock);
+#ifdef USE_EP952
+		EP_HDMI_Init(cdev, 1);
+		EP_HDMI_Set_Video_Timing(cdev, 1,1);
+#endif
+#ifndef NO_AUDIO
+		if(audio_en && smi_audio_init(cdev->dev))
+			DRM_ERROR("audio init failed, no sound card\n");
+#endif
+	}
+
+	complete_all(&cdev->init_done);
+}
+
 /*
  * Functions here will be called by the core once it's bound the driver to
  * a PCI device
@@ -52,6 +278,7 @@ int smi_driver_load(struct drm_device *dev, unsigned long flags)
 {
 	struct smi_device *cdev;
 	struct pci_dev *pdev; 
+	bool irq_ok;
 	int r;
 	
 	pdev = to_pci_dev(dev->dev);
@@ -59,6 +286,12 @@ int smi_driver_load(struct drm_device *dev, unsigned long flags)
 	if (cdev == NULL)
 		return -ENOMEM;
 	dev->dev_private = (void *)cdev;
+	mutex_init(&cdev->hdmi_lock);
+	spin_lock_init(&cdev->irq_lock);
+	spin_lock_init(&cdev->edid_lock);
+	INIT_WORK(&cdev->hotplug_work, smi_hdmi_hotplug_work);
+	INIT_WORK(&cdev->init_work, smi_deferred_init_work);
+	init_completion(&cdev->init_done);
 
 	switch (pdev->device) {
 	case PCI_DEVID_LYNX_EXP:
@@ -78,68 +311,59 @@ int smi_driver_load(struct drm_device *dev, unsigned long flags)
 		dev_err(&pdev->dev, "Fatal error during GPU init: %d\n", r);
 		goto out;
 	}
+	cdev->regsave = kvmalloc_array(cdev->specId == SPC_SM750 ? hw750_regsave_count() : hw768_regsave_count(),
+				       sizeof(uint32_t), GFP_KERNEL);
+	if (!cdev->regsave) {
+		r = -ENOMEM;
+		goto out;
+	}
+	if (pdev->resource[PCI_ROM_RESOURCE].flags & IORESOURCE_ROM_SHADOW) {
+		cdev->is_boot_gpu = true;
+	}
 	if(cdev->specId == SPC_SM750)
 	{
-	    if (pdev->resource[PCI_ROM_RESOURCE].flags & IORESOURCE_ROM_SHADOW) {
-			cdev->is_boot_gpu = true;
-		}
-		ddk750_initChip();
-		ddk750_deInit();
-		
-#ifdef USE_HDMICHIP
-		if((r = sii9022xInitChip()) < 0)
-		{	
-			printk("Init HDMI-Tx chip failed!");
-			r = 0;	
-		}
-#endif
-#ifdef USE_EP952
-		EP_HDMI_Init(0);
-		EP_HDMI_Set_Video_Timing(1,0);
-#endif
-
+		ddk750_initChip(cdev->ddk750_ctx);
+		ddk750_deInit(cdev->ddk750_ctx);
 	}
 	else
 	{
-		ddk768_initChip();
-		ddk768_deInit();
-		hw768_init_hdmi();
-#ifdef USE_EP952
-		EP_HDMI_Init(1);
-		EP_HDMI_Set_Video_Timing(1,1);
-#endif
-#ifndef NO_AUDIO
-		if(audio_en)
-			smi_audio_init(dev);
-#endif
+		/* HDMI is initialized by init_work, or before its first modeset */
+		cdev->hdmi_init_pending = true;
+		/*
+		 * With fastboot, leave the planes and the HDMI transmitter as the
+		 * firmware set them up: initChip turns the overlays off and
+		 * HDMI_Init mutes the sink.
+		 */
+		if (!(fast_boot && cdev->is_boot_gpu && smi_read_boot_modes(cdev)))
+			ddk768_initChip(cdev->ddk768_ctx);
+		ddk768_deInit(cdev->ddk768_ctx);
+		cdev->mem_bandwidth = (u64)ddk768_getMemoryClock(cdev->ddk768_ctx) *
+				      SMI768_DDR_BYTES_PER_CLOCK * SMI768_DISPLAY_BW_PERCENT / 100;
 	}	
 
 	drm_vblank_init(dev, dev->mode_config.num_crtc);
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
-	r = drm_irq_install(dev, pdev->irq);
-#else
-	r = request_irq(pdev->irq, smi_drm_interrupt, IRQF_SHARED,
-				  KBUILD_MODNAME, dev);
-#endif
+	r = smi_irq_install(cdev);
 	if (r)
 		DRM_ERROR("install irq failed , ret = %d\n", r);
+	irq_ok = (r == 0);
 
 	dev->mode_config.funcs = (void *)&smi_mode_config_funcs;
+	dev->mode_config.helper_private = &smi_mode_config_helper_funcs;
 	r = smi_modeset_init(cdev);
 	if (r) {
 		DRM_ERROR("Fatal error during modeset init: %d\n", r);
 		goto out;
 	}
 
-
-	cdev->regsave = kvmalloc(1024,GFP_KERNEL);
-	if (!cdev->regsave) {
-		DRM_ERROR("cannot allocate regsave\n");
-		//return -ENOMEM;
+	/* Hotplug interrupts are enabled by init_work, once HDMI is up */
+	if (cdev->hdmi_connector && !irq_ok) {
+		/* No interrupt, fall back to polling HDMI like the other connectors */
+		cdev->hdmi_connector->polled = DRM_CONNECTOR_POLL_CONNECT | DRM_CONNECTOR_POLL_DISCONNECT;
 	}
 
 	drm_kms_helper_poll_init(dev);
+	schedule_work(&cdev->init_work);
 
 	return 0;
 out:
@@ -151,26 +375,30 @@ out:
 void smi_driver_unload(struct drm_device *dev)
 {
 	struct smi_device *cdev = dev->dev_private;
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 15, 0)
-	struct pci_dev *pdev = to_pci_dev(dev->dev);
-#endif
-
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
-	if (dev->irq_enabled)
-		drm_irq_uninstall(dev);
-#else
-	free_irq(pdev->irq, dev);
-	/* Disable *all* interrupts */
-	if (cdev->specId == SPC_SM750) {
-		ddk750_disable_IntMask();
-	} else if (cdev->specId == SPC_SM768) {
-		ddk768_disable_IntMask();
-	}
-#endif
 
 	if (cdev == NULL)
 		return;
 
+	smi_irq_uninstall(cdev);
+	flush_work(&cdev->init_work);
+	if (cdev->specId == SPC_SM768)
+		cancel_work_sync(&cdev->hotplug_work);
+
+	/* Load may have failed before the registers or the DDK were set up */
+	if (cdev->rmmio) {
+		if (cdev->specId == SPC_SM768 && cdev->ddk768_ctx) {
+			if (cdev->hdmi_connector) {
+				mutex_lock(&cdev->hdmi_lock);
+				hw768_enable_hdmi_hotplug(cdev->ddk768_ctx, 0);
+				mutex_unlock(&cdev->hdmi_lock);
+			}
+			/* Disable *all* interrupts */
+			ddk768_disable_IntMask(cdev->ddk768_ctx);
+		} else if (cdev->specId == SPC_SM750 && cdev->ddk750_ctx) {
+			ddk750_disable_IntMask(cdev->ddk750_ctx);
+		}
+	}
+
 	smi_modeset_fini(cdev);
 	smi_device_fini(cdev);
 
@@ -178,12 +406,16 @@ void smi_driver_unload(struct drm_device *dev)
 #ifndef NO_AUDIO
 	if(cdev->specId == SPC_SM768)
 	{
-		if(audio_en)
+		if(audio_en && cdev->card)
 			smi_audio_remove(dev);
     }
 #endif
 
 	kvfree(cdev->regsave);
+	if (cdev->specId == SPC_SM750)
+		ddk750_free_context(cdev->ddk750_ctx);
+	else
+		ddk768_free_context(cdev->ddk768_ctx);
 	kfree(cdev);
 	dev->dev_private = NULL;
 }
@@ -216,9 +448,9 @@ static int smi_vram_init(struct smi_device *cdev)
 
 	/* VRAM Size */
 	if (cdev->specId == SPC_SM750)
-		cdev->vram_size = ddk750_getFrameBufSize();
+		cdev->vram_size = ddk750_getFrameBufSize(cdev->ddk750_ctx);
 	else
-		cdev->vram_size = ddk768_getFrameBufSize();
+		cdev->vram_size = ddk768_getFrameBufSize(cdev->ddk768_ctx);
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 16, 0)
 	/* Don't fail on errors, but performance might be reduced. */
@@ -290,13 +522,18 @@ int smi_device_init(struct smi_device *cdev, struct drm_device *ddev, struct pci
 	if (cdev->rmmio == NULL)
 		return -ENOMEM;
 
-	if (cdev->specId == SPC_SM750)
-		ddk750_set_mmio(cdev->rmmio, pdev->device, pdev->revision);
-	else
-		ddk768_set_mmio(cdev->rmmio, pdev->device, pdev->revision);
+	if (cdev->specId == SPC_SM750) {
+		cdev->ddk750_ctx = ddk750_alloc_context(cdev->rmmio, pdev->device, pdev->revision);
+		if (cdev->ddk750_ctx == NULL)
+			return -ENOMEM;
+	} else {
+		cdev->ddk768_ctx = ddk768_alloc_context(cdev->rmmio, pdev->device, pdev->revision);
+		if (cdev->ddk768_ctx == NULL)
+			return -ENOMEM;
+	}
 
 	if(ddr_retrain && (cdev->specId == SPC_SM768))
-		hw768_ddr_init();
+		hw768_ddr_init(cdev->ddk768_ctx);
 	
 	ret = smi_vram_init(cdev);
 	if (ret) {
@@ -26,6 +26,8 @@
 #include "ddk768/ddk768_video.h"
 #include "ddk768/ddk768_chip.h"
 #include "smi_dbg.h"
+#include "smi_trace.h"
+#include "smi_debugfs.h"
 
 
 
@@ -94,27 +96,88 @@ static int smi_crtc_set_gamma(struct drm_crtc *crtc, const struct drm_format_inf
        	}
 
 	if (sdev->specId == SPC_SM768) {
-		hw768_setgamma(dst_ctrl, true , lvds_channel);
-		hw768_load_lut(dst_ctrl, crtc->gamma_size, smi_crtc->lut_r, smi_crtc->lut_g, smi_crtc->lut_b);
+		hw768_setgamma(sdev->ddk768_ctx, dst_ctrl, true , lvds_channel);
+		hw768_load_lut(sdev->ddk768_ctx, dst_ctrl, crtc->gamma_size, smi_crtc->lut_r, smi_crtc->lut_g, smi_crtc->lut_b);
 	
 	}else if(sdev->specId == SPC_SM750) {
-		hw750_setgamma(dst_ctrl, true);
-		hw750_load_lut(dst_ctrl, crtc->gamma_size, smi_crtc->lut_r, smi_crtc->lut_g, smi_crtc->lut_b);
+		hw750_setgamma(sdev->ddk750_ctx, dst_ctrl, true);
+		hw750_load_lut(sdev->ddk750_ctx, dst_ctrl, crtc->gamma_size, smi_crtc->lut_r, smi_crtc->lut_g, smi_crtc->lut_b);
 	}
 	
 	return 0;
 }
 
+/*
+ * The first modeset of a channel that still shows the firmware's mode is
+ * skipped when it asks for that very mode: the plane update moves the
+ * scanout to our framebuffer at the next vsync, without a blank. The PLL
+ * read back is rounded, so the clock only has to match within 0.5%. The
+ * firmware mode is only ever considered once.
+ */
+static bool smi_crtc_keep_boot_mode(struct smi_device *sdev, int dst_ctrl,
+				    struct drm_display_mode *mode,
+				    logicalMode_t *logicalMode, bool scaled)
+{
+	struct smi_boot_mode *boot = &sdev->boot_mode[dst_ctrl];
+
+	if (!boot->valid)
+		return false;
+	boot->valid = false;
+
+	if (scaled || !logicalMode->valid_edid || boot->bpp != logicalMode->bpp)
+		return false;
+
+	if (!drm_mode_match(mode, &boot->mode, DRM_MODE_MATCH_TIMINGS | DRM_MODE_MATCH_FLAGS))
+		return false;
+
+	return abs(mode->clock - boot->mode.clock) <= boot->mode.clock / 200;
+}
+
+/*
+ * Same rule as the DRM core: EDID 1.4 sinks have to advertise CVT reduced
+ * blanking in their range limits, older digital sinks are assumed to cope.
+ */
+static bool smi_edid_allows_rb(const u8 *edid)
+{
+	int i;
+
+	if (edid[0x13] < 4)
+		return edid[0x14] & 0x80;
+
+	for (i = 0; i < 4; i++) {
+		const u8 *desc = edid + 54 + i * 18;
+
+		if (desc[0] == 0 && desc[1] == 0 && desc[3] == 0xfd &&
+		    desc[10] == 0x04 && (desc[15] & 0x10))
+			return true;
+	}
+	return false;
+}
+
+/*
+ * CVT version to use for the built-in timing of a digital output, or 0 to
+ * keep the VESA mode table.
+ */
+static int smi_cvt_rb_version(struct smi_device *sdev, bool rb_allowed)
+{
+	if (reduced_blanking <= 0 || sdev->specId != SPC_SM768 || !rb_allowed)
+		return 0;
+
+	return reduced_blanking >= 2 ? 2 : 1;
+}
+
 /*
  * The DRM core requires DPMS functions, but they make little sense in our
  * case and so are just stubs
  */
 
-static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
+static void smi_crtc_program_mode(struct drm_crtc *crtc)
 {
 	
 	struct drm_display_mode *mode;
+	struct drm_display_mode cvt_mode;
 	struct smi_device *sdev = crtc->dev->dev_private;
+	struct smi_edid_caps caps;
 	logicalMode_t logicalMode;
 	unsigned long refresh_rate;
 	unsigned int need_to_scale = 0;
@@ -152,10 +215,10 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 			logicalMode.hz = refresh_rate;
 			logicalMode.pitch = 0;
 
-			setMode(&logicalMode);
+			setMode(sdev->ddk750_ctx, &logicalMode);
 
-			setDisplayControl(SMI0_CTRL, DISP_ON);           /* Turn on Primary Control */
-			setPath(SMI0_PATH, SMI0_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
+			setDisplayControl(sdev->ddk750_ctx, SMI0_CTRL, DISP_ON);           /* Turn on Primary Control */
+			setPath(sdev->ddk750_ctx, SMI0_PATH, SMI0_CTRL, DISP_ON);     /* Turn on Panel Path and use Primary data */
 			
 		}
 		if(crtc == sdev->smi_enc_tab[1]->crtc)
@@ -167,19 +230,20 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 			logicalMode.dispCtrl = SMI1_CTRL;
 			logicalMode.hz = refresh_rate;
 			logicalMode.pitch = 0;
-			setMode(&logicalMode);
+			setMode(sdev->ddk750_ctx, &logicalMode);
 
-			setDisplayControl(SMI1_CTRL, DISP_ON);         /* Turn on Secondary control */
-			setPath(SMI1_PATH, SMI1_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
+			setDisplayControl(sdev->ddk750_ctx, SMI1_CTRL, DISP_ON);         /* Turn on Secondary control */
+			setPath(sdev->ddk750_ctx, SMI1_PATH, SMI1_CTRL, DISP_ON);     /* Turn on CRT Path and use Secondary data */
 			
 		}
 		
-		swPanelPowerSequence(DISP_ON, 4);                   /* Turn on Panel */
-	    setDAC(DISP_ON);                                    /* Turn on DAC */
+		swPanelPowerSequence(sdev->ddk750_ctx, DISP_ON, 4);                   /* Turn on Panel */
+	    setDAC(sdev->ddk750_ctx, DISP_ON);                                    /* Turn on DAC */
 
 #ifdef USE_HDMICHIP
 		printk("HDMI set mode\n");
-		sii9022xSetMode(5);
+		smi_wait_deferred_init(sdev);
+		sii9022xSetMode(sdev->ddk750_ctx, 5);
 #endif
 
 	}
@@ -213,23 +277,10 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 		logicalMode.pitch = 0;
 		logicalMode.dispCtrl = dst_ctrl;
 
-		switch (ctrl_index)
-		{
-			case 0:
-				if (sdev->dvi_edid && drm_edid_header_is_valid((u8 *)sdev->dvi_edid) == 8)
-					logicalMode.valid_edid = true;
-				break;
-			case 1:
-				if (sdev->vga_edid && drm_edid_header_is_valid((u8 *)sdev->vga_edid) == 8)
-					logicalMode.valid_edid = true;
-				break;
-			case 2:
-				if (sdev->hdmi_edid && drm_edid_header_is_valid((u8 *)sdev->hdmi_edid) == 8)
-					logicalMode.valid_edid = true;
-				break;
-			default:
-				break;
-		}
+		spin_lock(&sdev->edid_lock);
+		caps = sdev->edid_caps[ctrl_index];
+		spin_unlock(&sdev->edid_lock);
+		logicalMode.valid_edid = caps.valid;
 		if(edid_mode == 0){
 			printk("Use Driver build-in mode timing\n");
 			logicalMode.valid_edid = false;
@@ -244,10 +295,28 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 				 logicalMode.y = fixed_height;
 				 logicalMode.valid_edid = false;
 		 }
+
+		/* Built-in timing on DVI/HDMI: CVT reduced blanking rather than the table */
+		if (!logicalMode.valid_edid && !need_to_scale &&
+		    ((ctrl_index == 0 && !lvds_channel) || ctrl_index > SMI1_CTRL)) {
+			int rb = smi_cvt_rb_version(sdev, caps.rb_allowed);
+
+			if (rb && !hw768_cvt_mode(&cvt_mode, mode->hdisplay, mode->vdisplay, refresh_rate, rb) &&
+			    cvt_mode.hdisplay == mode->hdisplay) {
+				dbg_msg("channel %d: CVT-RB%s timing, %d kHz\n", dst_ctrl, rb == 2 ? "v2" : "", cvt_mode.clock);
+				mode = &cvt_mode;
+				logicalMode.valid_edid = true;
+			}
+		}
 		
-		hw768_setMode(&logicalMode, *mode);
-		DisableDoublePixel(0);
-		DisableDoublePixel(1);
+		if (smi_crtc_keep_boot_mode(sdev, dst_ctrl, mode, &logicalMode, need_to_scale)) {
+			DRM_INFO("channel %d: firmware mode kept, skipping modeset\n", dst_ctrl);
+			LEAVE();
+		}
+
+		hw768_setMode(sdev->ddk768_ctx, &logicalMode, *mode);
+		DisableDoublePixel(sdev->ddk768_ctx, 0);
+		DisableDoublePixel(sdev->ddk768_ctx, 1);
 
 		if(need_to_scale)
 		{
@@ -269,31 +338,37 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 			SrcAddr.bufYAddr = logicalMode.baseAddress;
 			SrcAddr.bufCbAddr = 0;
 			SrcAddr.bufCrAddr = 0;		
-			SM768_setOverlay(logicalMode.dispCtrl, &src, &SrcAddr, &dest, srcFormat);
+			SM768_setOverlay(sdev->ddk768_ctx, logicalMode.dispCtrl, &src, &SrcAddr, &dest, srcFormat);
 		}else{
-			stopVideo(dst_ctrl);
+			stopVideo(sdev->ddk768_ctx, dst_ctrl);
 		}
-		setSingleViewOn(dst_ctrl);
+		setSingleViewOn(sdev->ddk768_ctx, dst_ctrl);
 
 		initDisplay();		
 
 		if(need_to_scale)
-			ddk768_setDisplayPlaneDisableOnly(dst_ctrl);
+			ddk768_setDisplayPlaneDisableOnly(sdev->ddk768_ctx, dst_ctrl);
 #ifdef USE_EP952
-		hw768_SetPixelClockFormat(dst_ctrl,1);
+		hw768_SetPixelClockFormat(sdev->ddk768_ctx, dst_ctrl,1);
 #else
-		if (ddk768_getPixelType())
-			hw768_SetPixelClockFormat(dst_ctrl, 1);
+		if (ddk768_getPixelType(sdev->ddk768_ctx))
+			hw768_SetPixelClockFormat(sdev->ddk768_ctx, dst_ctrl, 1);
 		else
-			hw768_SetPixelClockFormat(dst_ctrl,0);
+			hw768_SetPixelClockFormat(sdev->ddk768_ctx, dst_ctrl,0);
 #endif
 		if((sdev->m_connector & USE_HDMI)&&(ctrl_index > SMI1_CTRL))
 		{
 			int ret = 0;
 			printk("Starting init SM768 HDMI! Use Channel [%d]\n", dst_ctrl);
+			mutex_lock(&sdev->hdmi_lock);
+			if (sdev->hdmi_init_pending) {
+				sdev->hdmi_init_pending = false;
+				hw768_init_hdmi(sdev->ddk768_ctx);
+			}
 			if(dst_ctrl == 0)
-				hw768_SetPixelClockFormat(dst_ctrl,0);
-			ret=hw768_set_hdmi_mode(&logicalMode, *mode, sdev->is_hdmi);
+				hw768_SetPixelClockFormat(sdev->ddk768_ctx, dst_ctrl,0);
+			ret=hw768_set_hdmi_mode(sdev->ddk768_ctx, &logicalMode, *mode, sdev->is_hdmi);
+			mutex_unlock(&sdev->hdmi_lock);
 			if (ret != 0)
 			{
 				printk("HDMI Mode not supported!\n");
@@ -303,12 +378,12 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 
 		if(lvds_channel == 1){
 			printk("Use Single Channel LVDS\n");
-			hw768_enable_lvds(1);
+			hw768_enable_lvds(sdev->ddk768_ctx, 1);
 		}
 		else if(lvds_channel == 2){
 			printk("Use Dual Channel LVDS\n");
-			hw768_enable_lvds(2);
-			EnableDoublePixel(0);
+			hw768_enable_lvds(sdev->ddk768_ctx, 2);
+			EnableDoublePixel(sdev->ddk768_ctx, 0);
 		}		
 
 	
@@ -317,15 +392,78 @@ static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
 	LEAVE();
 }
 
+/*
+ * Called from drm_atomic_helper_commit_modeset_disables(), one CRTC after
+ * the other. The mode programming shares registers between the channels
+ * (double pixel, LVDS, the SM750 mode and DAC setup), so it is not moved
+ * into the parallel commit works.
+ */
+static void smi_crtc_mode_set_nofb(struct drm_crtc *crtc)
+{
+	u64 start = ktime_get_ns();
+
+	smi_crtc_program_mode(crtc);
+	trace_smi_mode_set(crtc, &crtc->state->adjusted_mode, ktime_get_ns() - start);
+}
+
+static void smi_crtc_commit_work(struct work_struct *work)
+{
+	struct smi_crtc *smi_crtc = container_of(work, struct smi_crtc, commit_work);
+	struct drm_crtc *crtc = &smi_crtc->base;
+	struct drm_crtc_state *old_crtc_state, *new_crtc_state;
+	struct drm_display_mode *mode;
+	u64 start = ktime_get_ns(), frame_ns = 0;
+
+	ENTER();
+
+	old_crtc_state = drm_atomic_get_old_crtc_state(smi_crtc->commit_state, crtc);
+	new_crtc_state = drm_atomic_get_new_crtc_state(smi_crtc->commit_state, crtc);
+	mode = &new_crtc_state->adjusted_mode;
+	drm_atomic_helper_commit_planes_on_crtc(old_crtc_state);
+
+	this_cpu_inc(smi_crtc->perf->commits);
+	if (new_crtc_state->active && mode->clock)
+		frame_ns = div_u64((u64)mode->htotal * mode->vtotal * 1000000, mode->clock);
+	if (frame_ns && ktime_get_ns() - start > frame_ns)
+		this_cpu_inc(smi_crtc->perf->missed);
+
+	LEAVE();
+}
+
+/*
+ * Run the plane updates of one CRTC of @state asynchronously. The planes of
+ * a CRTC never move to the other one, so the works of the two CRTCs touch
+ * disjoint display controller registers.
+ */
+void smi_crtc_queue_commit(struct drm_crtc *crtc, struct drm_atomic_state *state)
+{
+	struct smi_crtc *smi_crtc = to_smi_crtc(crtc);
+
+	smi_crtc->commit_state = state;
+	queue_work(system_unbound_wq, &smi_crtc->commit_work);
+}
+
+void smi_crtc_wait_commit(struct drm_crtc *crtc)
+{
+	flush_work(&to_smi_crtc(crtc)->commit_work);
+}
+
 /* Simple cleanup function */
 static void smi_crtc_destroy(struct drm_crtc *crtc)
 {
 	struct smi_crtc *smi_crtc = to_smi_crtc(crtc);
 
 	drm_crtc_cleanup(crtc);
+	free_percpu(smi_crtc->perf);
 	kfree(smi_crtc);
 }
 
+static int smi_crtc_late_register(struct drm_crtc *crtc)
+{
+	smi_crtc_debugfs_init(crtc);
+	return 0;
+}
+
 
 static void smi_crtc_atomic_flush(struct drm_crtc *crtc, 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 11, 0)
@@ -357,8 +495,11 @@ static void smi_crtc_atomic_flush(struct drm_crtc *crtc,
 	}
 
 	spin_lock_irqsave(&crtc->dev->event_lock, flags);
-	if (crtc->state->event)
+	if (crtc->state->event) {
+		trace_smi_vblank_event(crtc);
+		this_cpu_inc(to_smi_crtc(crtc)->perf->flips);
 		drm_crtc_send_vblank_event(crtc, crtc->state->event);
+	}
 	crtc->state->event = NULL;
 	spin_unlock_irqrestore(&crtc->dev->event_lock, flags);
 	LEAVE();
@@ -396,9 +537,9 @@ static int smi_enable_vblank(struct drm_crtc *crtc)
 	struct smi_device *sdev = crtc->dev->dev_private;
 
 	if (sdev->specId == SPC_SM750) {
-		hw750_en_dis_interrupt(1);
+		hw750_en_dis_interrupt(sdev->ddk750_ctx, 1);
 	} else if (sdev->specId == SPC_SM768) {
-		hw768_en_dis_interrupt(1);
+		hw768_en_dis_interrupt(sdev->ddk768_ctx, 1);
 	}
 	return 0;
 }
@@ -408,9 +549,9 @@ static void smi_disable_vblank(struct drm_crtc *crtc)
 	struct smi_device *sdev = crtc->dev->dev_private;
 	
 	if (sdev->specId == SPC_SM750) {
-		hw750_en_dis_interrupt(0);
+		hw750_en_dis_interrupt(sdev->ddk750_ctx, 0);
 	} else if (sdev->specId == SPC_SM768) {
-		hw768_en_dis_interrupt(0);
+		hw768_en_dis_interrupt(sdev->ddk768_ctx, 0);
 	}
 }
 #endif
@@ -426,6 +567,7 @@ static const struct drm_crtc_funcs smi_crtc_funcs = {
 	.atomic_destroy_state = drm_atomic_helper_crtc_destroy_state,
 	.set_config = drm_atomic_helper_set_config,
 	.destroy = smi_crtc_destroy,
+	.late_register = smi_crtc_late_register,
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 5, 0)
 	.enable_vblank = smi_enable_vblank,
 	.disable_vblank = smi_disable_vblank,
@@ -452,6 +594,14 @@ static struct smi_crtc *smi_crtc_init(struct drm_device *dev, int crtc_id)
 	if (smi_crtc == NULL)
 		return NULL;
 
+	smi_crtc->perf = alloc_percpu(struct smi_crtc_perf);
+	if (smi_crtc->perf == NULL) {
+		kfree(smi_crtc);
+		return NULL;
+	}
+	mutex_init(&smi_crtc->perf_lock);
+	smi_crtc->perf_last_ns = ktime_get_ns();
+
 	primary = smi_plane_init(cdev, 1 << crtc_id, DRM_PLANE_TYPE_PRIMARY);
 
 	if (IS_ERR(primary)) {
@@ -469,6 +619,7 @@ static struct smi_crtc *smi_crtc_init(struct drm_device *dev, int crtc_id)
 		}
 	}
 	smi_crtc->CursorOffset = 0;
+	INIT_WORK(&smi_crtc->commit_work, smi_crtc_commit_work);
 
 	r = drm_crtc_init_with_planes(dev, &smi_crtc->base, primary, cursor, &smi_crtc_funcs, NULL);
 
@@ -496,6 +647,7 @@ clean_primary:
 	drm_plane_cleanup(primary);
 	kfree(primary);
 free_mem:
+	free_percpu(smi_crtc->perf);
 	kfree(smi_crtc);
 	return NULL;
 }
@@ -527,11 +679,11 @@ static void smi_encoder_dpms(struct drm_encoder *encoder, int mode)
 	{	
 		if (mode == DRM_MODE_DPMS_OFF) {
 			dbg_msg("disable dpms, index=%d\n",index);
-			setDisplayControl(index, DISP_OFF); 
+			setDisplayControl(sdev->ddk750_ctx, index, DISP_OFF); 
 		}else
 		{
-			setDisplayControl(index, DISP_ON); 
-			swPanelPowerSequence(DISP_ON, 4); 
+			setDisplayControl(sdev->ddk750_ctx, index, DISP_ON); 
+			swPanelPowerSequence(sdev->ddk750_ctx, DISP_ON, 4); 
 			dbg_msg("enable dpms ,index=%d\n",index);
 		}
 	}else if(sdev->specId == SPC_SM768)
@@ -558,10 +710,12 @@ static void smi_encoder_dpms(struct drm_encoder *encoder, int mode)
 		}
 		else if(encoder->encoder_type  == DRM_MODE_ENCODER_TMDS)
 		{	
+			mutex_lock(&sdev->hdmi_lock);
 			if (mode == DRM_MODE_DPMS_OFF)	
-				hw768_HDMI_Disable_Output();
+				hw768_HDMI_Disable_Output(sdev->ddk768_ctx);
 			else
-				hw768_HDMI_Enable_Output();
+				hw768_HDMI_Enable_Output(sdev->ddk768_ctx);
+			mutex_unlock(&sdev->hdmi_lock);
 			if(sdev->m_connector == USE_DVI_HDMI){
 				index = SMI1_CTRL;
 			 	dbg_msg("HDMI connector: index=%d\n",index);
@@ -576,15 +730,15 @@ static void smi_encoder_dpms(struct drm_encoder *encoder, int mode)
 		}
 		
 		if (mode == DRM_MODE_DPMS_OFF){
-			setDisplayDPMS(index, DISP_DPMS_OFF);
-			ddk768_swPanelPowerSequence(index, 0, 4);
+			setDisplayDPMS(sdev->ddk768_ctx, index, DISP_DPMS_OFF);
+			ddk768_swPanelPowerSequence(sdev->ddk768_ctx, index, 0, 4);
 		}else{
-			setDisplayDPMS(index, DISP_DPMS_ON);
-			ddk768_swPanelPowerSequence(index, 1, 4);
+			setDisplayDPMS(sdev->ddk768_ctx, index, DISP_DPMS_ON);
+			ddk768_swPanelPowerSequence(sdev->ddk768_ctx, index, 1, 4);
 		}
 		
 		if(lvds_channel == 2)
-			EnableDoublePixel(0);
+			EnableDoublePixel(sdev->ddk768_ctx, 0);
 
 	}
 	
@@ -659,6 +813,172 @@ static struct drm_encoder *smi_encoder_init(struct drm_device *dev, int index)
 }
 
 
+/*
+ * Replace the cached EDID of a connector, and the facts about it that the
+ * mode setting code looks at in sdev->edid_caps.
+ */
+static void smi_connector_set_edid(struct drm_connector *connector, struct edid *edid)
+{
+	struct smi_connector *smi_connector = to_smi_connector(connector);
+	struct smi_device *sdev = connector->dev->dev_private;
+	struct smi_edid_caps caps = { .valid = false, .rb_allowed = true };
+	int index;
+
+	if (smi_connector->edid == edid)
+		return;
+
+	if (edid && drm_edid_header_is_valid((u8 *)edid) == 8) {
+		caps.valid = true;
+		caps.rb_allowed = smi_edid_allows_rb((u8 *)edid);
+	}
+
+	if (connector->connector_type == DRM_MODE_CONNECTOR_DVII)
+		index = 0;
+	else if (connector->connector_type == DRM_MODE_CONNECTOR_VGA)
+		index = 1;
+	else
+		index = 2;
+
+	spin_lock(&sdev->edid_lock);
+	sdev->edid_caps[index] = caps;
+	spin_unlock(&sdev->edid_lock);
+
+	kfree(smi_connector->edid);
+	smi_connector->edid = edid;
+}
+
+static int smi_hdmi_get_edid_block(void *data, u8 *buf, unsigned int block, size_t len)
+{
+	struct drm_connector *connector = data;
+	struct smi_device *sdev = connector->dev->dev_private;
+	int ret;
+
+	mutex_lock(&sdev->hdmi_lock);
+	ret = hw768_get_hdmi_edid_block(sdev->ddk768_ctx, block, buf, len);
+	mutex_unlock(&sdev->hdmi_lock);
+
+	return ret;
+}
+
+/*
+ * Read the EDID of the SM768 HDMI sink with the transmitter's own DDC
+ * engine, which handles the E-DDC segment pointer for CTA extensions.
+ */
+static struct edid *smi_hdmi_read_edid(struct drm_connector *connector)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
+	const struct drm_edid *drm_edid;
+	struct edid *edid = NULL;
+
+	drm_edid = drm_edid_read_custom(connector, smi_hdmi_get_edid_block, connector);
+	if (drm_edid) {
+		edid = drm_edid_duplicate(drm_edid_raw(drm_edid));
+		drm_edid_free(drm_edid);
+	}
+	return edid;
+#else
+	return drm_do_get_edid(connector, smi_hdmi_get_edid_block, connector);
+#endif
+}
+
+/* Return the cached EDID, reading it over DDC only if it was invalidated. */
+static struct edid *smi_connector_get_edid(struct drm_connector *connector)
+{
+	struct smi_connector *smi_connector = to_smi_connector(connector);
+	struct smi_device *sdev = connector->dev->dev_private;
+	unsigned int gen = atomic_read(&smi_connector->hpd_gen);
+	struct edid *edid = NULL;
+
+	if (smi_connector->edid && smi_connector->edid_gen == gen)
+		return smi_connector->edid;
+
+	if (sdev->specId == SPC_SM768 && connector->connector_type == DRM_MODE_CONNECTOR_HDMIA)
+		edid = smi_hdmi_read_edid(connector);
+	/* Fall back to bit-banging the DDC pins */
+	if (!edid)
+		edid = drm_get_edid(connector, &smi_connector->adapter);
+	smi_connector_set_edid(connector, edid);
+	/* A hotplug during the read leaves the cache stale */
+	smi_connector->edid_gen = gen;
+
+	return smi_connector->edid;
+}
+
+/*
+ * Presence check for detect(): read the 8 byte EDID header only, instead
+ * of the whole block. The cached EDID is dropped when the sink goes away
+ * or shows up again, not on every forced detect: the probe helper forces
+ * one before each get_modes.
+ */
+static bool smi_connector_probe_ddc(struct drm_connector *connector)
+{
+	struct smi_connector *smi_connector = to_smi_connector(connector);
+	unsigned char start = 0;
+	u8 header[8];
+	struct i2c_msg msgs[] = {
+		{
+			.addr = DDC_ADDR,
+			.flags = 0,
+			.len = 1,
+			.buf = &start,
+		}, {
+			.addr = DDC_ADDR,
+			.flags = I2C_M_RD,
+			.len = sizeof(header),
+			.buf = header,
+		}
+	};
+	bool present = false;
+	int retries;
+
+	for (retries = 0; retries < 2 && !present; retries++)
+		present = i2c_transfer(&smi_connector->adapter, msgs, 2) == 2 &&
+			  drm_edid_header_is_valid(header) == 8;
+
+	if (present != smi_connector->ddc_present)
+		atomic_inc(&smi_connector->hpd_gen);
+	smi_connector->ddc_present = present;
+
+	return present;
+}
+
+/*
+ * Modes offered to a sink without EDID. Digital outputs get the CVT reduced
+ * blanking timings that smi_crtc_program_mode() will program, so the pixel
+ * clocks that mode_valid and userspace see are the real ones.
+ */
+static int smi_add_builtin_modes(struct drm_connector *connector, int max_width, int max_height)
+{
+	static const struct { u16 w, h, hz; } sizes[] = {
+		{ 640, 480, 60 }, { 800, 600, 60 }, { 1024, 768, 60 },
+		{ 1280, 720, 60 }, { 1280, 800, 60 }, { 1280, 1024, 60 },
+		{ 1360, 768, 60 }, { 1440, 900, 60 }, { 1600, 900, 60 },
+		{ 1680, 1050, 60 }, { 1920, 1080, 60 }, { 1920, 1200, 60 },
+		{ 2560, 1440, 60 }, { 3840, 2160, 30 },
+	};
+	struct smi_device *sdev = connector->dev->dev_private;
+	struct drm_display_mode cvt_mode, *mode;
+	int i, rb, count = 0;
+
+	rb = smi_cvt_rb_version(sdev, true);
+	if (!rb)
+		return drm_add_modes_noedid(connector, max_width, max_height);
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		if (sizes[i].w > max_width || sizes[i].h > max_height)
+			continue;
+		if (hw768_cvt_mode(&cvt_mode, sizes[i].w, sizes[i].h, sizes[i].hz, rb))
+			continue;
+		mode = drm_mode_duplicate(connector->dev, &cvt_mode);
+		if (!mode)
+			break;
+		drm_mode_probed_add(connector, mode);
+		count++;
+	}
+
+	return count;
+}
+
 int smi_connector_get_modes(struct drm_connector *connector)
 {
 #ifdef USE_HDMICHIP
@@ -667,7 +987,6 @@ int smi_connector_get_modes(struct drm_connector *connector)
 	int count = 0;
 	void *edid_buf = NULL;
 	struct smi_device *sdev = connector->dev->dev_private;
-	struct smi_connector *smi_connector = to_smi_connector(connector);
 
 	ENTER();
 	dbg_msg("print connector type: [%d], DVI=%d, VGA=%d, HDMI=%d\n",
@@ -685,9 +1004,10 @@ int smi_connector_get_modes(struct drm_connector *connector)
 		{
 #ifdef USE_HDMICHIP
 
+			smi_wait_deferred_init(sdev);
 			edid_buf = sdev->si9022_edid;
-			if(ddk750_GetDDC_9022Access())
-				ret = ddk750_edidReadMonitorEx(SMI0_CTRL, edid_buf, 256, 0, 30, 31);
+			if(ddk750_GetDDC_9022Access(sdev->ddk750_ctx))
+				ret = ddk750_edidReadMonitorEx(sdev->ddk750_ctx, SMI0_CTRL, edid_buf, 256, 0, 30, 31);
 			ddk750_Release9022DDC();
 			if(ret){
               	drm_connector_update_edid_property(connector, sdev->si9022_edid);
@@ -704,14 +1024,13 @@ int smi_connector_get_modes(struct drm_connector *connector)
 
 
 #else
-			edid_buf = drm_get_edid(connector, &smi_connector->adapter);
+			edid_buf = smi_connector_get_edid(connector);
 
 			if(edid_buf)
 			{
 				dbg_msg("DVI get edid success.\n");
-				sdev->dvi_edid = edid_buf;
-				drm_connector_update_edid_property(connector, sdev->dvi_edid);
-				count = drm_add_edid_modes(connector, sdev->dvi_edid);
+				drm_connector_update_edid_property(connector, edid_buf);
+				count = drm_add_edid_modes(connector, edid_buf);
 			}
 			if (edid_buf == NULL || count == 0)
 			{
@@ -724,7 +1043,7 @@ int smi_connector_get_modes(struct drm_connector *connector)
 		}
 		if(connector->connector_type == DRM_MODE_CONNECTOR_VGA)
 		{
-			edid_buf = drm_get_edid(connector, &smi_connector->adapter);
+			edid_buf = smi_connector_get_edid(connector);
 
 		
 			
@@ -732,11 +1051,10 @@ int smi_connector_get_modes(struct drm_connector *connector)
 
 			if(edid_buf){
 			    dbg_msg("VGA get edid success.\n");
-				sdev->vga_edid = edid_buf;
 			
-				drm_connector_update_edid_property(connector, sdev->vga_edid); 
+				drm_connector_update_edid_property(connector, edid_buf); 
 
-				count = drm_add_edid_modes(connector, sdev->vga_edid);
+				count = drm_add_edid_modes(connector, edid_buf);
 			}
 			if (edid_buf == NULL || count == 0)
 			{
@@ -762,17 +1080,16 @@ int smi_connector_get_modes(struct drm_connector *connector)
 				drm_set_preferred_mode(connector, fixed_width, fixed_height);
 			}else{
 			
-				edid_buf = drm_get_edid(connector, &smi_connector->adapter);
+				edid_buf = smi_connector_get_edid(connector);
 
 
 
 				if(edid_buf){
 					dbg_msg("DVI get edid success.\n");
-					sdev->dvi_edid = edid_buf;
-
-					drm_connector_update_edid_property(connector, sdev->dvi_edid); 
+	
+					drm_connector_update_edid_property(connector, edid_buf); 
 
-					count = drm_add_edid_modes(connector, sdev->dvi_edid);
+					count = drm_add_edid_modes(connector, edid_buf);
 				}
 		
 				if (edid_buf == NULL || count == 0)
@@ -780,7 +1097,7 @@ int smi_connector_get_modes(struct drm_connector *connector)
 
 					drm_connector_update_edid_property(connector, NULL);
 
-					count = drm_add_modes_noedid(connector, 1920, 1080);
+					count = smi_add_builtin_modes(connector, 1920, 1080);
 					drm_set_preferred_mode(connector, fixed_width, fixed_height);
 				}
 			}
@@ -788,14 +1105,13 @@ int smi_connector_get_modes(struct drm_connector *connector)
 		}
 		if(connector->connector_type == DRM_MODE_CONNECTOR_VGA)
 		{
-			edid_buf = drm_get_edid(connector, &smi_connector->adapter);
+			edid_buf = smi_connector_get_edid(connector);
 
 			if (edid_buf)
 			{
 				dbg_msg("VGA get edid success.\n");
-				sdev->vga_edid = edid_buf;
-				drm_connector_update_edid_property(connector, sdev->vga_edid);
-				count = drm_add_edid_modes(connector, sdev->vga_edid);
+				drm_connector_update_edid_property(connector, edid_buf);
+				count = drm_add_edid_modes(connector, edid_buf);
 			}
 			if (edid_buf == NULL || count == 0)
 			{
@@ -808,25 +1124,27 @@ int smi_connector_get_modes(struct drm_connector *connector)
 		}
 		if(connector->connector_type == DRM_MODE_CONNECTOR_HDMIA)
 		{
-			edid_buf = drm_get_edid(connector, &smi_connector->adapter);
+			edid_buf = smi_connector_get_edid(connector);
 
-            //hw768_get_hdmi_edid(tmpedid);   // Too Slow..
 			if (edid_buf)
 			{
 				dbg_msg("HDMIA get edid success.\n");
-				sdev->hdmi_edid = edid_buf;
-				drm_connector_update_edid_property(connector, sdev->hdmi_edid);		
-				count = drm_add_edid_modes(connector, sdev->hdmi_edid);
-				sdev->is_hdmi = drm_detect_hdmi_monitor(sdev->hdmi_edid);
+				drm_connector_update_edid_property(connector, edid_buf);		
+				count = drm_add_edid_modes(connector, edid_buf);
+				sdev->is_hdmi = drm_detect_hdmi_monitor(edid_buf);
                 dbg_msg("HDMI connector is %s\n",(sdev->is_hdmi ? "HDMI monitor" : "DVI monitor"));
 			}
 			if (edid_buf == NULL || count == 0)
 			{
 				drm_connector_update_edid_property(connector, NULL);
-				count = drm_add_modes_noedid(connector, 1920, 1080);
+				count = smi_add_builtin_modes(connector, 1920, 1080);
 				drm_set_preferred_mode(connector, fixed_width, fixed_height);
 				sdev->is_hdmi = true;
 			}
+#ifndef NO_AUDIO
+			if (audio_en)
+				smi_audio_eld_notify(connector->dev);
+#endif
 
 		}
 
@@ -851,10 +1169,15 @@ static enum drm_mode_status smi_connector_mode_valid(struct drm_connector *conne
 		 return MODE_NOMODE;
 	
 	
-	if(mode->hdisplay > 1920) {
-		if ((sdev->m_connector == USE_DVI_HDMI) || (sdev->m_connector == USE_VGA_HDMI)||(sdev->specId == SPC_SM750))
-			return MODE_NOMODE;
-	}
+	/*
+	 * On SM768 whether two heads fit together is decided by the bandwidth
+	 * check at atomic_check time; here only refuse what cannot fit alone.
+	 */
+	if ((mode->hdisplay > 1920) && (sdev->specId == SPC_SM750))
+		return MODE_NOMODE;
+
+	if (sdev->mem_bandwidth && (u64)mode->clock * 1000 * 4 > sdev->mem_bandwidth)
+		return MODE_MEM;
 
 	if(connector->connector_type == DRM_MODE_CONNECTOR_DVII){
 		if(mode->clock >= 200000)
@@ -890,7 +1213,6 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 														  *connector,
 													  bool force)
 {
-	struct smi_connector *smi_connector = to_smi_connector(connector);
 	struct smi_device *sdev = connector->dev->dev_private;
 		
 #ifdef USE_HDMICHIP
@@ -911,8 +1233,9 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 					return connector_status_disconnected;
 			}
 #ifdef USE_HDMICHIP	
-			if (ddk750_GetDDC_9022Access())
-				ret = ddk750_edidReadMonitorEx(SMI0_CTRL, edid_buf, 128, 0, 30, 31);
+			smi_wait_deferred_init(sdev);
+			if (ddk750_GetDDC_9022Access(sdev->ddk750_ctx))
+				ret = ddk750_edidReadMonitorEx(sdev->ddk750_ctx, SMI0_CTRL, edid_buf, 128, 0, 30, 31);
 			ddk750_Release9022DDC();
 			if (ret)
 			{
@@ -928,7 +1251,7 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 
 
 
-			if (!drm_probe_ddc(&smi_connector->adapter))
+			if (!smi_connector_probe_ddc(connector))
 
 			{
 				dbg_msg("detect DVI/Panel DO NOT connected.\n");
@@ -963,7 +1286,7 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 			}
 
 #else
-			if(!drm_probe_ddc(&smi_connector->adapter))
+			if(!smi_connector_probe_ddc(connector))
 			{
 				dbg_msg("detect CRT DO NOT connected.\n");
 				return connector_status_disconnected;
@@ -991,7 +1314,7 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 					return connector_status_disconnected;
 			}
 
-			if (!drm_probe_ddc(&smi_connector->adapter))
+			if (!smi_connector_probe_ddc(connector))
 			{
 				dbg_msg("detect DVI DO NOT connected. \n");
 				sdev->m_connector = sdev->m_connector & (~USE_DVI);
@@ -1015,7 +1338,7 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 					return connector_status_disconnected;
 			}
 
-			if (!drm_probe_ddc(&smi_connector->adapter))
+			if (!smi_connector_probe_ddc(connector))
 			{
 				dbg_msg("detect CRT DO NOT connected. \n");
 				sdev->m_connector =sdev->m_connector&(~USE_VGA);
@@ -1034,7 +1357,9 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 
 			if ((sdev->m_connector == USE_DVI_VGA) || (sdev->m_connector == USE_ALL))
 			{
-				hw768_HDMI_Disable_Output();
+				mutex_lock(&sdev->hdmi_lock);
+				hw768_HDMI_Disable_Output(sdev->ddk768_ctx);
+				mutex_unlock(&sdev->hdmi_lock);
 				dbg_msg("set HDMI connector_status_disconnected because of VGA+DVI\n");
 				sdev->m_connector = sdev->m_connector&(~USE_HDMI);
 				return connector_status_disconnected;  //If VGA and DVI are both connected, disable HDMI
@@ -1051,14 +1376,14 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 #if 0//ndef AUDIO_EN
 			if (hdmi_hotplug_detect())
 #else
-			if (drm_probe_ddc(&smi_connector->adapter))
+			if (smi_connector_probe_ddc(connector))
 #endif
 			{
 				dbg_msg("detect HDMI connected(GPIO 8,9) \n");
 				sdev->m_connector = sdev->m_connector|USE_HDMI;
 				return connector_status_connected; 
 			}
-			else if(HDMI_connector_detect())
+			else if(HDMI_connector_detect(sdev->ddk768_ctx))
 			{
 			    dbg_msg("detect HDMI connected(HPG pull high) \n");
 				sdev->m_connector = sdev->m_connector|USE_HDMI;
@@ -1077,32 +1402,49 @@ static enum drm_connector_status smi_connector_detect(struct drm_connector
 	}
 }
 
+/*
+ * Bottom half of the HDMI interrupt: ack the transmitter, let the probe
+ * helper re-detect the connector, then unmask the source again.
+ */
+void smi_hdmi_hotplug_work(struct work_struct *work)
+{
+	struct smi_device *sdev = container_of(work, struct smi_device, hotplug_work);
+	struct drm_connector *connector = sdev->hdmi_connector;
+	int plugged;
+
+	mutex_lock(&sdev->hdmi_lock);
+	plugged = hw768_hdmi_hotplug_ack(sdev->ddk768_ctx);
+	mutex_unlock(&sdev->hdmi_lock);
+
+	if (plugged && connector) {
+		/* A different sink may be behind the same connector now */
+		atomic_inc(&to_smi_connector(connector)->hpd_gen);
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 15, 0)
+		drm_connector_helper_hpd_irq_event(connector);
+#else
+		drm_helper_hpd_irq_event(sdev->dev);
+#endif
+	}
+
+	hw768_mask_hdmi_interrupt(sdev->ddk768_ctx, 0);
+}
+
 static void smi_connector_destroy(struct drm_connector *connector)
 {
 	struct smi_device *sdev = connector->dev->dev_private;
-	if (connector->connector_type == DRM_MODE_CONNECTOR_HDMIA && sdev->hdmi_edid)
-	{
-		kfree(sdev->hdmi_edid);
-		sdev->hdmi_edid = NULL;
-	}
-	else if (connector->connector_type == DRM_MODE_CONNECTOR_DVII && sdev->dvi_edid)
-	{
-		kfree(sdev->dvi_edid);
-		sdev->dvi_edid = NULL;
-	}
-	else if (connector->connector_type == DRM_MODE_CONNECTOR_VGA && sdev->vga_edid)
-	{
-		kfree(sdev->vga_edid);
-		sdev->vga_edid = NULL;
-	}
+
+	if (sdev->hdmi_connector == connector)
+		sdev->hdmi_connector = NULL;
+
+	smi_connector_set_edid(connector, NULL);
 
 	if(sdev->specId == SPC_SM768)
 	{
-		hw768_AdaptI2CCleanBus(connector);
+		hw768_AdaptI2CCleanBus(sdev->ddk768_ctx, connector);
 	}
 	else
 	{
-		hw750_AdaptI2CCleanBus(connector);
+		hw750_AdaptI2CCleanBus(sdev->ddk750_ctx, connector);
 	}
 	drm_connector_unregister(connector);
 	drm_connector_cleanup(connector);
@@ -1158,15 +1500,21 @@ static struct drm_connector *smi_connector_init(struct drm_device *dev, int inde
 
 	if (sdev->specId == SPC_SM750) 
 	{
-		hw750_AdaptI2CInit(smi_connector);
+		hw750_AdaptI2CInit(sdev->ddk750_ctx, smi_connector);
 	}
 	else
 	{
-		hw768_AdaptI2CInit(smi_connector);
+		hw768_AdaptI2CInit(sdev->ddk768_ctx, smi_connector);
 	}
 
 	drm_connector_helper_add(connector, &smi_vga_connector_helper_funcs);
-	connector->polled = DRM_CONNECTOR_POLL_CONNECT | DRM_CONNECTOR_POLL_DISCONNECT;
+	if (sdev->specId == SPC_SM768 && connector->connector_type == DRM_MODE_CONNECTOR_HDMIA) {
+		/* The HDMI transmitter raises an interrupt on hot plug, see smi_hdmi_hotplug_work() */
+		connector->polled = DRM_CONNECTOR_POLL_HPD;
+		sdev->hdmi_connector = connector;
+	} else {
+		connector->polled = DRM_CONNECTOR_POLL_CONNECT | DRM_CONNECTOR_POLL_DISCONNECT;
+	}
 
 	drm_connector_register(connector);
 	
@@ -36,6 +36,7 @@
 #endif
 
 #include "smi_dbg.h"
+#include "smi_trace.h"
 
 #include "hw750.h"
 #include "hw768.h"
@@ -155,14 +156,14 @@ static void smi_cursor_atomic_update(struct drm_plane *plane, struct drm_plane_s
 	memcpy_toio(dst, src, fb->width * fb->height * fb->format->cpp[0]);
 #endif
 	if (sdev->specId == SPC_SM750) {
-			ddk750_initCursor(disp_ctrl, (u32)dst_off, BPP16_BLACK,
+			ddk750_initCursor(sdev->ddk750_ctx, disp_ctrl, (u32)dst_off, BPP16_BLACK,
 				BPP16_WHITE, BPP16_BLUE);
 			colorcur2monocur(dst);
-			ddk750_enableCursor(disp_ctrl, 1);
+			ddk750_enableCursor(sdev->ddk750_ctx, disp_ctrl, 1);
 		} else {
-		ddk768_initCursor(disp_ctrl, (u32)dst_off, BPP32_BLACK, BPP32_WHITE,
+		ddk768_initCursor(sdev->ddk768_ctx, disp_ctrl, (u32)dst_off, BPP32_BLACK, BPP32_WHITE,
 					  BPP32_BLUE);
-		ddk768_enableCursor(disp_ctrl, 3);
+		ddk768_enableCursor(sdev->ddk768_ctx, disp_ctrl, 3);
 	}
 
 	x = plane_state->crtc_x;
@@ -170,13 +171,15 @@ static void smi_cursor_atomic_update(struct drm_plane *plane, struct drm_plane_s
 
 	/* set cursor location */
 	if (sdev->specId == SPC_SM750) {
-		ddk750_setCursorPosition(disp_ctrl, x < 0 ? -x : x, y < 0 ? -y : y, y < 0 ? 1 : 0,
+		ddk750_setCursorPosition(sdev->ddk750_ctx, disp_ctrl, x < 0 ? -x : x, y < 0 ? -y : y, y < 0 ? 1 : 0,
 					 x < 0 ? 1 : 0);
 	} else if (sdev->specId == SPC_SM768) {
-		ddk768_setCursorPosition(disp_ctrl, x < 0 ? -x : x, y < 0 ? -y : y, y < 0 ? 1 : 0,
+		ddk768_setCursorPosition(sdev->ddk768_ctx, disp_ctrl, x < 0 ? -x : x, y < 0 ? -y : y, y < 0 ? 1 : 0,
 					 x < 0 ? 1 : 0);
 	}
 
+	trace_smi_cursor_update(crtc, x, y, fb->width * fb->height * fb->format->cpp[0]);
+	this_cpu_inc(to_smi_crtc(crtc)->perf->cursor_updates);
 }
 
 void smi_cursor_atomic_disable(struct drm_plane *plane, 
@@ -222,9 +225,9 @@ void smi_cursor_atomic_disable(struct drm_plane *plane,
 
 	
 	if (sdev->specId == SPC_SM750) {
-		ddk750_enableCursor(disp_ctrl, 0);
+		ddk750_enableCursor(sdev->ddk750_ctx, disp_ctrl, 0);
 	} else {
-		ddk768_enableCursor(disp_ctrl, 0);
+		ddk768_enableCursor(sdev->ddk768_ctx, disp_ctrl, 0);
 	}
 }
 
@@ -312,6 +315,10 @@ static void smi_primary_plane_atomic_update(struct drm_plane *plane, struct drm_
 	int i, ctrl_index = 0, max_enc = 0;
 	disp_control_t disp_ctrl;
 	struct smi_device *sdev = plane->dev->dev_private;
+	struct smi_crtc *smi_crtc;
+	unsigned int clips = 0;
+	unsigned long bytes = 0;
+	u64 start, duration;
 
 	if (!plane_state->crtc || !plane_state->fb)
 		return;
@@ -319,6 +326,8 @@ static void smi_primary_plane_atomic_update(struct drm_plane *plane, struct drm_
 	if (!plane_state->visible)
 		return;
 
+	start = ktime_get_ns();
+
 	if(sdev->specId == SPC_SM750)
 		max_enc = MAX_CRTC;
 	else
@@ -360,6 +369,8 @@ static void smi_primary_plane_atomic_update(struct drm_plane *plane, struct drm_
 #else
 		smi_handle_damage(smi_plane, fb, &damage);
 #endif
+		clips++;
+		bytes += drm_rect_width(&damage) * drm_rect_height(&damage) * fb->format->cpp[0];
 	}
 
 
@@ -371,10 +382,19 @@ static void smi_primary_plane_atomic_update(struct drm_plane *plane, struct drm_
 	offset = dst_off + y * fb->pitches[0] + x * fb->format->cpp[0];
 	
 	if (sdev->specId == SPC_SM750) {
-		hw750_set_base(disp_ctrl, fb->pitches[0], offset);
+		hw750_set_base(sdev->ddk750_ctx, disp_ctrl, fb->pitches[0], offset);
 	} else if (sdev->specId == SPC_SM768) {
-		hw768_set_base(disp_ctrl, fb->pitches[0], offset);
+		hw768_set_base(sdev->ddk768_ctx, disp_ctrl, fb->pitches[0], offset);
 	}
+
+	duration = ktime_get_ns() - start;
+	trace_smi_plane_update(plane_state->crtc, clips, bytes, duration);
+
+	smi_crtc = to_smi_crtc(plane_state->crtc);
+	this_cpu_inc(smi_crtc->perf->uploads);
+	this_cpu_add(smi_crtc->perf->upload_clips, clips);
+	this_cpu_add(smi_crtc->perf->upload_bytes, bytes);
+	this_cpu_inc(smi_crtc->perf->upload_hist[min_t(int, fls64(duration), SMI_PERF_BUCKETS - 1)]);
 	return;
 }
 
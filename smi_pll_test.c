@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0+
+// Copyright (c) 2023, SiliconMotion Inc.
+
+/*
+ * KUnit test of the SM768 and SM750 pixel PLL solvers: every CEA-861 and
+ * DMT pixel clock the driver can set must come out within a fixed ppm of
+ * the request.
+ */
+
+#include <linux/version.h>
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+
+#include <kunit/test.h>
+#include <linux/kernel.h>
+#include <linux/math64.h>
+#include "hw750.h"
+#include "hw768.h"
+
+/* INT.FRAC has 15 fractional bits, so only the rounding to the Hz is left */
+#define SM768_MAX_PPM	1
+/* Integer M/N; the worst listed clock is about 1700 ppm off */
+#define SM750_MAX_PPM	2000
+/* smi_connector_mode_valid() limits SM750 to 1920 wide */
+#define SM750_MAX_CLOCK	200000000
+
+/* Pixel clocks in Hz of the CEA-861 and DMT modes up to 3840x2160@30 */
+static const unsigned long smi_pll_test_clocks[] = {
+	25175000, 25200000, 27000000, 27027000, 31500000, 33750000,
+	35500000, 36000000, 40000000, 49500000, 50000000, 54000000,
+	56250000, 65000000, 68250000, 71000000, 73250000, 74176000,
+	74250000, 75000000, 78750000, 79500000, 83500000, 85500000,
+	88750000, 94500000, 101000000, 102250000, 106500000, 108000000,
+	117500000, 119000000, 121750000, 122500000, 135000000, 136750000,
+	140250000, 146250000, 148352000, 148500000, 154000000, 156000000,
+	157500000, 162000000, 175500000, 179500000, 187000000, 193250000,
+	202500000, 204750000, 214750000, 218250000, 229500000, 234000000,
+	241500000, 245250000, 261000000, 268250000, 281250000, 297000000,
+};
+
+static u64 smi_pll_test_ppm(unsigned long requested, unsigned long actual)
+{
+	unsigned long diff = actual > requested ? actual - requested : requested - actual;
+
+	return div_u64((u64)diff * 1000000, requested);
+}
+
+/* Half of either crystal selected by the strap pins */
+static void smi_pll_test_sm768(struct kunit *test)
+{
+	static const unsigned long inputs[] = { 24576000 / 2, 24000000 / 2 };
+	unsigned long requested, actual;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(inputs); i++) {
+		for (j = 0; j < ARRAY_SIZE(smi_pll_test_clocks); j++) {
+			requested = smi_pll_test_clocks[j];
+			actual = ddk768_testPixelPll(inputs[i], requested);
+			KUNIT_EXPECT_LE_MSG(test, smi_pll_test_ppm(requested, actual), SM768_MAX_PPM,
+					    "input %lu Hz, requested %lu Hz, got %lu Hz",
+					    inputs[i], requested, actual);
+		}
+	}
+}
+
+static void smi_pll_test_sm750(struct kunit *test)
+{
+	unsigned long requested, actual;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(smi_pll_test_clocks); i++) {
+		requested = smi_pll_test_clocks[i];
+		if (requested > SM750_MAX_CLOCK)
+			break;
+
+		actual = ddk750_testPixelPll(requested);
+		KUNIT_EXPECT_LE_MSG(test, smi_pll_test_ppm(requested, actual), SM750_MAX_PPM,
+				    "requested %lu Hz, got %lu Hz", requested, actual);
+	}
+}
+
+static struct kunit_case smi_pll_test_cases[] = {
+	KUNIT_CASE(smi_pll_test_sm768),
+	KUNIT_CASE(smi_pll_test_sm750),
+	{}
+};
+
+static struct kunit_suite smi_pll_test_suite = {
+	.name = "smifb-pll",
+	.test_cases = smi_pll_test_cases,
+};
+
+kunit_test_suite(smi_pll_test_suite);
+
+#endif
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0+
+// Copyright (c) 2023, SiliconMotion Inc.
+
+#ifndef __SMI_PM_H__
+#define __SMI_PM_H__
+
+/*
+ * Time spent in each phase of the register save/restore done by
+ * hw750_suspend()/hw768_suspend() and their resume counterparts, shown in
+ * the "pm" debugfs file. Shared by the driver and the hw layer, which
+ * cannot include each other's headers.
+ */
+#define PM_MAX_PHASES   10
+
+typedef struct _pm_phase_time_t
+{
+    const char *name;
+    unsigned long long save_ns;     /* last suspend */
+    unsigned long long restore_ns;  /* last resume */
+}
+pm_phase_time_t;
+
+/*
+ * Register save/restore across suspend. Each chip lists the MMIO it keeps
+ * as dword ranges, saved and restored in table order and timed per phase.
+ */
+#define REG_RANGE_PLL   0x0001  /* a PLL: let it settle before moving on */
+
+typedef struct _reg_range_t
+{
+    unsigned int phase;         /* index into the chip's phase names */
+    unsigned long offset;       /* MMIO offset of the first dword */
+    unsigned long count;        /* number of dwords */
+    unsigned long flags;
+}
+reg_range_t;
+
+#endif
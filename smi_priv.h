@@ -7,6 +7,24 @@ struct smi_mode_info {
 	/* pointer to fbdev info structure */
 };
 
+/*
+ * Work done for one CRTC, counted per CPU so that the hot paths never
+ * share a cache line; the "perf" debugfs file of the CRTC sums them.
+ */
+#define SMI_PERF_BUCKETS	32	/* upload time histogram, log2 of ns */
+
+struct smi_crtc_perf {
+	u64 commits;
+	u64 missed;		/* commits that took longer than a frame */
+	u64 flips;		/* vblank events sent to userspace */
+	u64 vblanks;		/* vsync interrupts */
+	u64 uploads;		/* primary plane updates */
+	u64 upload_clips;
+	u64 upload_bytes;
+	u64 cursor_updates;
+	u64 upload_hist[SMI_PERF_BUCKETS];
+};
+
 struct smi_crtc {
 	struct drm_crtc base;
 	u8 lut_r[256], lut_g[256], lut_b[256];
@@ -14,6 +32,14 @@ struct smi_crtc {
 	bool enabled;
 	int crtc_index;
 	int CursorOffset;
+	/* Plane updates of an atomic commit, run by smi_atomic_commit_tail() */
+	struct work_struct commit_work;
+	struct drm_atomic_state *commit_state;
+	struct smi_crtc_perf __percpu *perf;
+	/* Totals at the previous read of "perf", the rates are since then */
+	struct mutex perf_lock;
+	struct smi_crtc_perf perf_last;
+	u64 perf_last_ns;
 };
 
 #endif
\ No newline at end of file
@@ -29,37 +29,38 @@
 
 //#include <drm/drmP.h>
 #include <drm/drm_crtc_helper.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 4, 0)
+#include <sound/pcm_drm_eld.h>
+#endif
 
 
 #include "hw768.h"
 
 
-struct sm768chip *chip_irq_id=NULL;/*chip_irq_id is use for request and free irq*/
-int use_wm8978 = 0;
-
-static int SM768_AudioInit(unsigned long wordLength, unsigned long sampleRate)
+static int SM768_AudioInit(struct sm768chip *chip, unsigned long wordLength, unsigned long sampleRate)
 {
 	// Set up I2S and GPIO registers to transmit/receive data.
-    iisOpen(wordLength, sampleRate);
-    //Set I2S to DMA 256 DWord from SRAM starting at location 0 of SRAM
-    iisTxDmaSetup(0,SRAM_SECTION_SIZE);
+    iisOpen(chip->ddk768_ctx, wordLength, sampleRate);
+    //Set I2S to DMA one period at a time from SRAM starting at location 0 of SRAM
+    iisTxDmaSetup(chip->ddk768_ctx, 0, chip->period_bytes);
 
 
 	// Init audio codec
-	if(use_wm8978){
+	if(chip->use_wm8978){
 		printk("Use WM8978 Codec\n");
-		if (WM8978_Init())
+		if (WM8978_Init(chip->ddk768_ctx))
 		{			
 			printk("Init WM8978 Codec failed\n");
-			WM8978_DeInit();
+			WM8978_DeInit(chip->ddk768_ctx);
 			
 		}
+		WM8978_SampleRate_Set(chip->ddk768_ctx, sampleRate);
 	}else{
 		printk("Use UDA1345 Codec\n");
-		if(uda1345_init())
+		if(uda1345_init(chip->ddk768_ctx))
 		 {   
 		   printk("Init UDA1345 Codec failed\n");
-		   uda1345_deinit();
+		   uda1345_deinit(chip->ddk768_ctx);
 		 }
 	}
 
@@ -70,20 +71,20 @@ static int SM768_AudioInit(unsigned long wordLength, unsigned long sampleRate)
 /*
  * This function call iis driver interface iisStart() to start play audio. 
  */
-static int SM768_AudioStart(void)
+static int SM768_AudioStart(struct sm768chip *chip)
 {
 
 	
-	if(use_wm8978){
+	if(chip->use_wm8978){
   
 	}else{
-	    uda1345_setpower(ADCOFF_DACON);
-		uda1345_setmute(NO_MUTE);
+	    uda1345_setpower(chip->ddk768_ctx, ADCOFF_DACON);
+		uda1345_setmute(chip->ddk768_ctx, NO_MUTE);
 	}
 
-	HDMI_Audio_Unmute();
+	HDMI_Audio_Unmute(chip->ddk768_ctx);
 
-	iisStart();
+	iisStart(chip->ddk768_ctx);
 	
     return 0;
 }
@@ -91,38 +92,38 @@ static int SM768_AudioStart(void)
 /*
  * Stop audio. 
  */
-static int SM768_AudioStop(void)
+static int SM768_AudioStop(struct sm768chip *chip)
 {
 
-	if(use_wm8978){
+	if(chip->use_wm8978){
 	}else{
-		uda1345_setmute(MUTE);
-		uda1345_setpower(ADCOFF_DACOFF);
+		uda1345_setmute(chip->ddk768_ctx, MUTE);
+		uda1345_setpower(chip->ddk768_ctx, ADCOFF_DACOFF);
 	}
 
-	HDMI_Audio_Mute();
+	HDMI_Audio_Mute(chip->ddk768_ctx);
 	
-	iisStop();
+	iisStop(chip->ddk768_ctx);
 	
     return 0;
 }
 
 
 
-static int SM768_AudioDeinit(void)
+static int SM768_AudioDeinit(struct sm768chip *chip)
 {
 
-	iisStop();
-	iisClose();
+	iisStop(chip->ddk768_ctx);
+	iisClose(chip->ddk768_ctx);
 
-	if(use_wm8978)
-		WM8978_DeInit();
+	if(chip->use_wm8978)
+		WM8978_DeInit(chip->ddk768_ctx);
 	else
-		uda1345_deinit();
+		uda1345_deinit(chip->ddk768_ctx);
 	
-	sb_IRQMask(SB_IRQ_VAL_I2S);		
-	iisClearRawInt();
-    ddk768_enableI2S(0); 
+	sb_IRQMask(chip->ddk768_ctx, SB_IRQ_VAL_I2S);		
+	iisClearRawInt(chip->ddk768_ctx);
+    ddk768_enableI2S(chip->ddk768_ctx, 0); 
 
 	return 0;
 }
@@ -180,11 +181,11 @@ static int snd_falconi2s_put_hw_play_volume(struct snd_kcontrol *kcontrol,
 	if (chip->playback_vol!= ucontrol->value.integer.value[0]) {
 		vol = chip->playback_vol = ucontrol->value.integer.value[0];
 
-		if(use_wm8978){
-			WM8978_HPvol_Set(VolAuDrvToCodec(vol), VolAuDrvToCodec(vol));
-			WM8978_SPKvol_Set(VolAuDrvToCodec(vol));
+		if(chip->use_wm8978){
+			WM8978_HPvol_Set(chip->ddk768_ctx, VolAuDrvToCodec(vol), VolAuDrvToCodec(vol));
+			WM8978_SPKvol_Set(chip->ddk768_ctx, VolAuDrvToCodec(vol));
 		}else{
-			uda1345_setvolume(VolAuDrvToCodec(vol));
+			uda1345_setvolume(chip->ddk768_ctx, VolAuDrvToCodec(vol));
 		}
 		changed = 1;
 	}
@@ -216,11 +217,11 @@ static int snd_falconi2s_put_hw_capture_volume(struct snd_kcontrol *kcontrol,
 	if (chip->capture_vol!= ucontrol->value.integer.value[0]) {
 		vol = chip->capture_vol = ucontrol->value.integer.value[0];
 
-		if(use_wm8978){
-					WM8978_HPvol_Set(VolAuDrvToCodec(vol), VolAuDrvToCodec(vol));
-					WM8978_SPKvol_Set(VolAuDrvToCodec(vol));
+		if(chip->use_wm8978){
+					WM8978_HPvol_Set(chip->ddk768_ctx, VolAuDrvToCodec(vol), VolAuDrvToCodec(vol));
+					WM8978_SPKvol_Set(chip->ddk768_ctx, VolAuDrvToCodec(vol));
 		}else{
-					uda1345_setvolume(VolAuDrvToCodec(vol));
+					uda1345_setvolume(chip->ddk768_ctx, VolAuDrvToCodec(vol));
 		}
 
 		changed = 1;
@@ -255,54 +256,129 @@ static struct snd_kcontrol_new falconi2s_vol[] = {
 static struct snd_pcm_hardware snd_falconi2s_playback_hw = {
 	.info = (SNDRV_PCM_INFO_MMAP | SNDRV_PCM_INFO_INTERLEAVED | SNDRV_PCM_INFO_BLOCK_TRANSFER |
 		 SNDRV_PCM_INFO_MMAP_VALID),
-	.formats = SNDRV_PCM_FMTBIT_S16_LE,
-	//this value means both of 44100 and 48000 can work
-	.rates = SNDRV_PCM_RATE_48000,
-	.rate_min = 48000,
+	.formats = SNDRV_PCM_FMTBIT_S16_LE | SNDRV_PCM_FMTBIT_S24_LE | SNDRV_PCM_FMTBIT_S32_LE,
+	//narrowed down to what the I2S clock can make, see snd_falconi2s_init_rates()
+	.rates = SNDRV_PCM_RATE_32000 | SNDRV_PCM_RATE_44100 | SNDRV_PCM_RATE_48000,
+	.rate_min = 32000,
 	.rate_max = 48000,
 	.channels_min = 2,
 	.channels_max = 2,
 	//actually total length should less than 4096*1024.
-	.buffer_bytes_max = P_PERIOD_BYTE * P_PERIOD_MAX,
-	.period_bytes_min = P_PERIOD_BYTE,
-	.period_bytes_max = P_PERIOD_BYTE,
+	.buffer_bytes_max = P_BUFFER_BYTE_MAX,
+	.period_bytes_min = P_PERIOD_BYTE_MIN,
+	.period_bytes_max = P_PERIOD_BYTE_MAX * 2,	/* S32 */
 	.periods_min =	  P_PERIOD_MIN,
-	.periods_max =	  P_PERIOD_MAX,
+	.periods_max =	  P_BUFFER_BYTE_MAX / P_PERIOD_BYTE_MIN,
 };
 
-/* hardware definition */
+/* hardware definition, capture is only copied out of the SRAM a period at a time */
 static struct snd_pcm_hardware snd_falconi2s_capture_hw = {
 	.info = (SNDRV_PCM_INFO_MMAP | SNDRV_PCM_INFO_INTERLEAVED | SNDRV_PCM_INFO_BLOCK_TRANSFER |
-		 SNDRV_PCM_INFO_MMAP_VALID),
-	.formats = SNDRV_PCM_FMTBIT_S16_LE,
-	.rates = SNDRV_PCM_RATE_48000,
-	.rate_min = 48000,
+		 SNDRV_PCM_INFO_MMAP_VALID | SNDRV_PCM_INFO_BATCH),
+	.formats = SNDRV_PCM_FMTBIT_S16_LE | SNDRV_PCM_FMTBIT_S24_LE | SNDRV_PCM_FMTBIT_S32_LE,
+	.rates = SNDRV_PCM_RATE_32000 | SNDRV_PCM_RATE_44100 | SNDRV_PCM_RATE_48000,
+	.rate_min = 32000,
 	.rate_max = 48000,
 	.channels_min = 2,
 	.channels_max = 2,
 	//actually total length should less than 4096*1024.
-	.buffer_bytes_max = P_PERIOD_BYTE * P_PERIOD_MAX,
-	.period_bytes_min = P_PERIOD_BYTE,
-	.period_bytes_max = P_PERIOD_BYTE,
+	.buffer_bytes_max = P_BUFFER_BYTE_MAX,
+	.period_bytes_min = P_PERIOD_BYTE_MIN,
+	.period_bytes_max = P_PERIOD_BYTE_MAX * 2,	/* S32 */
 	.periods_min =	  P_PERIOD_MIN,
-	.periods_max =	  P_PERIOD_MAX,
+	.periods_max =	  P_BUFFER_BYTE_MAX / P_PERIOD_BYTE_MIN,
 
 };
 
+/*
+ * A period is one SRAM section, so it has to divide the 2 KB ring, and the
+ * copy wraps at the end of the buffer, so the buffer is whole periods. The
+ * SRAM holds 16-bit frames whatever the format, so the limits are in frames,
+ * and only the top 16 bits of an S24 or S32 sample reach the codec.
+ */
+static int snd_falconi2s_constrain(struct snd_pcm_runtime *runtime)
+{
+	int err;
+
+	err = snd_pcm_hw_constraint_msbits(runtime, 0, 32, 16);
+	if (err < 0)
+		return err;
+
+	err = snd_pcm_hw_constraint_minmax(runtime, SNDRV_PCM_HW_PARAM_PERIOD_SIZE,
+					   P_PERIOD_BYTE_MIN / SRAM_FRAME_BYTES,
+					   P_PERIOD_BYTE_MAX / SRAM_FRAME_BYTES);
+	if (err < 0)
+		return err;
+	err = snd_pcm_hw_constraint_pow2(runtime, 0, SNDRV_PCM_HW_PARAM_PERIOD_SIZE);
+	if (err < 0)
+		return err;
+	return snd_pcm_hw_constraint_integer(runtime, SNDRV_PCM_HW_PARAM_PERIODS);
+}
+
+static const unsigned int snd_falconi2s_rates[] = { 32000, 44100, 48000 };
+
+/*
+ * The I2S bit clock is an integer division of the crystal, so not every
+ * rate comes out right: offer those within 0.5%, and always the rate the
+ * board was designed for.
+ */
+static void snd_falconi2s_init_rates(struct sm768chip *chip)
+{
+	unsigned long actual;
+	unsigned int rate;
+	int i;
+
+	chip->rate_list.count = 0;
+	chip->rate_list.list = chip->rates;
+	chip->rate_list.mask = 0;
+
+	for (i = 0; i < ARRAY_SIZE(snd_falconi2s_rates); i++) {
+		rate = snd_falconi2s_rates[i];
+		actual = iisGetSampleRate(chip->ddk768_ctx, SAMPLE_BITS, rate);
+		if (rate != chip->rate && abs((long)actual - (long)rate) * 200 > rate) {
+			dbg_msg("%u Hz not supported, I2S would run at %lu Hz\n", rate, actual);
+			continue;
+		}
+		chip->rates[chip->rate_list.count++] = rate;
+	}
+}
+
   /* open callback */
 static int snd_falconi2s_playback_open(struct snd_pcm_substream *substream)
 {
 	struct sm768chip *chip = snd_pcm_substream_chip(substream);
 	struct snd_pcm_runtime *runtime = substream->runtime;
+	int err;
 	dbg_msg("snd_falconi2s_playback_open\n");
 
+	/*
+	 * The analog and HDMI PCMs share the one I2S output. Set the pointer
+	 * value of substream field in the chip record at open callback to hold
+	 * the current running substream pointer.
+	 */
+	spin_lock_irq(&chip->lock);
+	if (chip->play_substream) {
+		spin_unlock_irq(&chip->lock);
+		return -EBUSY;
+	}
+	chip->play_substream = substream;
+	spin_unlock_irq(&chip->lock);
 	
 	runtime->hw = snd_falconi2s_playback_hw;
-	/* set the pointer value of substream field in the chip record at 
-	 * open callback to hold the current running substream pointer */
-	chip->play_substream = substream;
+	err = snd_pcm_hw_constraint_list(runtime, 0, SNDRV_PCM_HW_PARAM_RATE, &chip->rate_list);
+	if (err < 0)
+		goto release;
+	err = snd_falconi2s_constrain(runtime);
+	if (err < 0)
+		goto release;
 	
 	return 0;
+
+release:
+	spin_lock_irq(&chip->lock);
+	chip->play_substream = NULL;
+	spin_unlock_irq(&chip->lock);
+	return err;
 }
 
   /* close callback */
@@ -312,7 +388,9 @@ static int snd_falconi2s_playback_close(struct snd_pcm_substream *substream)
 	/* the hardware-specific codes will be here */
 	dbg_msg("snd_falconi2s_playback_close\n");
 	/* reset the pointer value of substream field in the chip record at close callback */
-	chip->play_substream = NULL;			 
+	spin_lock_irq(&chip->lock);
+	chip->play_substream = NULL;
+	spin_unlock_irq(&chip->lock);
 	return 0;
 
 }
@@ -322,8 +400,15 @@ static int snd_falconi2s_capture_open(struct snd_pcm_substream *substream)
 {
 	struct sm768chip *chip = snd_pcm_substream_chip(substream);
 	struct snd_pcm_runtime *runtime = substream->runtime;
+	int err;
 
 	runtime->hw = snd_falconi2s_capture_hw;
+	err = snd_pcm_hw_constraint_list(runtime, 0, SNDRV_PCM_HW_PARAM_RATE, &chip->rate_list);
+	if (err < 0)
+		return err;
+	err = snd_falconi2s_constrain(runtime);
+	if (err < 0)
+		return err;
 
 	/* set the pointer value of substream field in the chip record at open callback to hold the current running substream pointer */
 	chip->capture_substream = substream;
@@ -343,11 +428,168 @@ static int snd_falconi2s_capture_close(struct snd_pcm_substream *substream)
 
 }
 
+/*
+ * Split the SRAM rings into sections of period_bytes: the I2S interrupts
+ * once per section. The DMA is repositioned to the start of the ring, which
+ * takes up to one trip around it.
+ */
+static void snd_falconi2s_set_period(struct sm768chip *chip, unsigned long period_bytes)
+{
+	unsigned long flags;
+
+	if (chip->period_bytes == period_bytes)
+		return;
+
+	iisTxDmaSetup(chip->ddk768_ctx, 0, period_bytes);
+
+	spin_lock_irqsave(&chip->lock, flags);
+	chip->period_bytes = period_bytes;
+	chip->sections = SRAM_OUTPUT_SIZE / period_bytes;
+	spin_unlock_irqrestore(&chip->lock, flags);
+
+	iisStart(chip->ddk768_ctx);
+}
+
+/*
+ * ELD of the sink on the HDMI connector, as the DRM core derived it from
+ * the EDID. Returns its size, 0 with no sink or no audio support.
+ */
+static int snd_falconi2s_get_eld(struct sm768chip *chip, u8 *eld)
+{
+	struct smi_device *sdev = chip->dev->dev_private;
+	struct drm_connector *connector = sdev->hdmi_connector;
+	int size = 0;
+
+	memset(eld, 0, MAX_ELD_BYTES);
+	if (connector == NULL)
+		return 0;
+
+	mutex_lock(&chip->dev->mode_config.mutex);
+	if (connector->status == connector_status_connected) {
+		size = min_t(int, drm_eld_size(connector->eld), MAX_ELD_BYTES);
+		memcpy(eld, connector->eld, size);
+	}
+	mutex_unlock(&chip->dev->mode_config.mutex);
+
+	return size;
+}
+
+/*
+ * The HDMI PCM plays through the same I2S as the analog one, to the HDMI
+ * transmitter only: the codec is muted while it is open, and the channels
+ * and rates are those the sink lists in its short audio descriptors.
+ */
+static int snd_falconi2s_hdmi_open(struct snd_pcm_substream *substream)
+{
+	struct sm768chip *chip = snd_pcm_substream_chip(substream);
+	struct snd_pcm_runtime *runtime = substream->runtime;
+	int err;
+
+	err = snd_falconi2s_playback_open(substream);
+	if (err < 0)
+		return err;
+
+	if (snd_falconi2s_get_eld(chip, chip->eld) > 0) {
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 4, 0)
+		err = snd_pcm_hw_constraint_eld(runtime, chip->eld);
+		if (err < 0) {
+			snd_falconi2s_playback_close(substream);
+			return err;
+		}
+#endif
+	} else {
+		dbg_msg("no ELD, the HDMI sink may not play audio\n");
+	}
+
+	if (chip->use_wm8978)
+		WM8978_Output_Cfg(chip->ddk768_ctx, 0, 0);
+	else
+		uda1345_setmute(chip->ddk768_ctx, MUTE);
+
+	return 0;
+}
+
+static int snd_falconi2s_hdmi_close(struct snd_pcm_substream *substream)
+{
+	struct sm768chip *chip = snd_pcm_substream_chip(substream);
+
+	if (chip->use_wm8978)
+		WM8978_Output_Cfg(chip->ddk768_ctx, 1, 0);
+	else
+		uda1345_setmute(chip->ddk768_ctx, NO_MUTE);
+
+	return snd_falconi2s_playback_close(substream);
+}
+
+static int snd_falconi2s_eld_info(struct snd_kcontrol *kcontrol,
+				  struct snd_ctl_elem_info *uinfo)
+{
+	uinfo->type = SNDRV_CTL_ELEM_TYPE_BYTES;
+	uinfo->count = MAX_ELD_BYTES;
+	return 0;
+}
+
+static int snd_falconi2s_eld_get(struct snd_kcontrol *kcontrol,
+				 struct snd_ctl_elem_value *ucontrol)
+{
+	struct sm768chip *chip = kcontrol->private_data;
+
+	snd_falconi2s_get_eld(chip, ucontrol->value.bytes.data);
+	return 0;
+}
+
+static struct snd_kcontrol_new falconi2s_eld = {
+	.access = SNDRV_CTL_ELEM_ACCESS_READ | SNDRV_CTL_ELEM_ACCESS_VOLATILE,
+	.iface = SNDRV_CTL_ELEM_IFACE_PCM,
+	.name = "ELD",
+	.device = SMI_PCM_HDMI,
+	.info = snd_falconi2s_eld_info,
+	.get = snd_falconi2s_eld_get,
+};
+
+/*
+ * Clock the I2S, the codec and the HDMI audio clock regeneration at a new
+ * sample rate.
+ */
+static void snd_falconi2s_set_rate(struct sm768chip *chip, unsigned int rate)
+{
+	struct smi_device *sdev = chip->dev->dev_private;
+
+	if (chip->rate == rate)
+		return;
+
+	iisStop(chip->ddk768_ctx);
+	iisSetSampleRate(chip->ddk768_ctx, SAMPLE_BITS, rate);
+	if (chip->use_wm8978)
+		WM8978_SampleRate_Set(chip->ddk768_ctx, rate);
+
+	mutex_lock(&sdev->hdmi_lock);
+	HDMI_Audio_Set_Rate(chip->ddk768_ctx, rate);
+	mutex_unlock(&sdev->hdmi_lock);
+
+	chip->rate = rate;
+	iisStart(chip->ddk768_ctx);
+}
+
   /* hw_params callback */
 static int snd_falconi2s_pcm_hw_params(struct snd_pcm_substream *substream,
                                struct snd_pcm_hw_params *hw_params)
 {
-	dbg_msg("snd_falconi2s_pcm_hw_params,malloc:%d\n",params_buffer_bytes(hw_params));
+	struct sm768chip *chip = snd_pcm_substream_chip(substream);
+	unsigned long period_bytes = params_period_size(hw_params) * SRAM_FRAME_BYTES;
+	unsigned int rate = params_rate(hw_params);
+
+	dbg_msg("snd_falconi2s_pcm_hw_params,malloc:%d, period:%lu, rate:%u\n",
+		params_buffer_bytes(hw_params), period_bytes, rate);
+
+	/* Playback and capture share the DMA and the clock, so the section size and rate */
+	if (chip->period_set[!substream->stream] &&
+	    (chip->period_bytes != period_bytes || chip->rate != rate))
+		return -EBUSY;
+
+	snd_falconi2s_set_rate(chip, rate);
+	snd_falconi2s_set_period(chip, period_bytes);
+	chip->period_set[substream->stream] = true;
 	   
 	return snd_pcm_lib_malloc_pages(substream,
                                      params_buffer_bytes(hw_params));
@@ -356,7 +598,10 @@ static int snd_falconi2s_pcm_hw_params(struct snd_pcm_substream *substream,
   /* hw_free callback */
 static int snd_falconi2s_pcm_hw_free(struct snd_pcm_substream *substream)
 {
+	struct sm768chip *chip = snd_pcm_substream_chip(substream);
+
 	dbg_msg("snd_falconi2s_pcm_hw_free\n");
+	chip->period_set[substream->stream] = false;
 	return snd_pcm_lib_free_pages(substream);
 }
 
@@ -391,6 +636,7 @@ static int snd_falconi2s_pcm_playback_trigger(struct snd_pcm_substream *substrea
                                     int cmd)
 {
 	struct sm768chip *chip = snd_pcm_substream_chip(substream);
+	unsigned long flags;
 	dbg_msg("snd_falconi2s_pcm_trigger\n");
 	dbg_msg("substream:%p\n",substream);
 
@@ -399,6 +645,10 @@ static int snd_falconi2s_pcm_playback_trigger(struct snd_pcm_substream *substrea
 	case SNDRV_PCM_TRIGGER_START:			
 		dbg_msg("PLAY SNDRV_PCM_TRIGGER_START\n");
 		memset_io(chip->pvReg + SRAM_OUTPUT_BASE, 0, SRAM_OUTPUT_SIZE);
+		spin_lock_irqsave(&chip->lock, flags);
+		chip->pqueued = 0;
+		chip->play_section = -1;
+		spin_unlock_irqrestore(&chip->lock, flags);
 		break;
 	case SNDRV_PCM_TRIGGER_STOP:
 		dbg_msg("PLAY SNDRV_PCM_TRIGGER_STOP\n");
@@ -448,6 +698,33 @@ static int snd_falconi2s_pcm_playback_trigger(struct snd_pcm_substream *substrea
 
 
 
+/*
+ * Playback position, to the sample: the data being played is one SRAM ring
+ * behind what has been copied, less what the DMA has already sent out of
+ * the current section. Once the interrupt for the next section is due but
+ * not handled, stay at the end of the current one.
+ */
+static unsigned long snd_falconi2s_play_position(struct sm768chip *chip,
+						 struct snd_pcm_runtime *runtime)
+{
+	unsigned long flags, dma, offset, pending, pos;
+
+	spin_lock_irqsave(&chip->lock, flags);
+	dma = iisDmaPointer(chip->ddk768_ctx) * 4;
+	if ((dma / chip->period_bytes) % chip->sections == chip->play_section)
+		offset = dma % chip->period_bytes;
+	else
+		offset = chip->period_bytes;
+	pending = SRAM_OUTPUT_SIZE - offset;
+	if (chip->pqueued < pending)
+		pending = chip->pqueued;	/* not started playing yet */
+	pos = chip->ppointer + frames_to_bytes(runtime, runtime->buffer_size) -
+	      frames_to_bytes(runtime, pending / SRAM_FRAME_BYTES);
+	spin_unlock_irqrestore(&chip->lock, flags);
+
+	return pos % frames_to_bytes(runtime, runtime->buffer_size);
+}
+
   /* pointer callback */
   static snd_pcm_uframes_t
 snd_falconi2s_pcm_pointer(struct snd_pcm_substream *substream)
@@ -456,8 +733,9 @@ snd_falconi2s_pcm_pointer(struct snd_pcm_substream *substream)
 	snd_pcm_uframes_t value = 0;
 
 	if (substream->stream == SNDRV_PCM_STREAM_PLAYBACK)
-		value = bytes_to_frames(substream->runtime, chip->ppointer);
+		value = bytes_to_frames(substream->runtime, snd_falconi2s_play_position(chip, substream->runtime));
 	else
+		/* Captured data only reaches the buffer a period at a time */
 		value = bytes_to_frames(substream->runtime, chip->cpointer);
 	
 	return value;
@@ -487,6 +765,18 @@ static struct snd_pcm_ops snd_falconi2s_capture_ops = {
           .pointer =     snd_falconi2s_pcm_pointer,
   };
 
+  /* operators */
+static struct snd_pcm_ops snd_falconi2s_hdmi_ops = {
+          .open =        snd_falconi2s_hdmi_open,
+          .close =       snd_falconi2s_hdmi_close,
+          .ioctl =       snd_pcm_lib_ioctl,
+          .hw_params =   snd_falconi2s_pcm_hw_params,
+          .hw_free =     snd_falconi2s_pcm_hw_free,
+          .prepare =     snd_falconi2s_pcm_prepare,
+          .trigger =     snd_falconi2s_pcm_trigger,
+          .pointer =     snd_falconi2s_pcm_pointer,
+  };
+
 
 
 
@@ -507,40 +797,85 @@ static int snd_falconi2s_dev_free(struct snd_device *device)
 }
 
 
-static int snd_smi_play_copy_data(struct sm768chip *chip,int sramTxSection)
+/*
+ * The I2S only carries 16 bits per channel: S24/S32 samples keep their top
+ * 16 bits on the way out and get zero low bits on the way in. A section is
+ * repacked through chip->bounce, so the SRAM still sees a single burst.
+ */
+static void snd_smi_pack(u32 *dst, const s32 *src, snd_pcm_format_t format,
+			 unsigned long frames)
+{
+	unsigned int shift = format == SNDRV_PCM_FORMAT_S24_LE ? 8 : 16;
+	unsigned long i;
+
+	for (i = 0; i < frames; i++)
+		dst[i] = ((u32)(src[2 * i] >> shift) & 0xffff) |
+			 ((u32)(src[2 * i + 1] >> shift) << 16);
+}
+
+static void snd_smi_unpack(s32 *dst, const u32 *src, snd_pcm_format_t format,
+			   unsigned long frames)
+{
+	unsigned int shift = format == SNDRV_PCM_FORMAT_S24_LE ? 8 : 0;
+	unsigned long i;
+
+	for (i = 0; i < frames; i++) {
+		dst[2 * i] = (s32)(src[i] << 16) >> shift;
+		dst[2 * i + 1] = (s32)(src[i] & 0xffff0000) >> shift;
+	}
+}
+
+static int snd_smi_play_copy_data(struct sm768chip *chip,int sramTxSection,unsigned long period_bytes)
 {
 		
 	struct snd_pcm_runtime *play_runtime;
 	struct snd_pcm_substream *play_substream;
+	void __iomem *sram = chip->pvReg + SRAM_OUTPUT_BASE + period_bytes * sramTxSection;
+	unsigned long flags, frames = period_bytes / SRAM_FRAME_BYTES;
+	void *src;
 
 	play_substream = chip->play_substream;
 
 	if(play_substream == NULL)
-		memset_io(chip->pvReg + SRAM_OUTPUT_BASE + SRAM_SECTION_SIZE * sramTxSection, 0x00, P_PERIOD_BYTE);
+		memset_io(sram, 0x00, period_bytes);
 	else{
 		play_runtime = play_substream->runtime;
 
 		if (play_runtime->dma_area == NULL) 
 			return 0;
 
-		memcpy_toio(chip->pvReg + SRAM_OUTPUT_BASE + SRAM_SECTION_SIZE * sramTxSection, play_runtime->dma_area + chip->ppointer, P_PERIOD_BYTE);
-		chip->ppointer+= P_PERIOD_BYTE;
-		chip->ppointer%= ((play_runtime->periods) * (P_PERIOD_BYTE));
+		src = play_runtime->dma_area + chip->ppointer;
+		if (play_runtime->format == SNDRV_PCM_FORMAT_S16_LE) {
+			memcpy_toio(sram, src, period_bytes);
+		} else {
+			snd_smi_pack(chip->bounce, src, play_runtime->format, frames);
+			memcpy_toio(sram, chip->bounce, period_bytes);
+		}
+		spin_lock_irqsave(&chip->lock, flags);
+		chip->ppointer+= frames_to_bytes(play_runtime, frames);
+		chip->ppointer%= frames_to_bytes(play_runtime, play_runtime->buffer_size);
+		if (chip->pqueued < SRAM_OUTPUT_SIZE)
+			chip->pqueued += period_bytes;
+		chip->play_section = (sramTxSection + 1) % chip->sections;
+		spin_unlock_irqrestore(&chip->lock, flags);
 		snd_pcm_period_elapsed(play_substream);
 	}
 	return 0;
 }
 
-static int snd_smi_capture_copy_data(struct sm768chip *chip,int sramTxSection)
+static int snd_smi_capture_copy_data(struct sm768chip *chip,int sramTxSection,unsigned long period_bytes)
 {
 		
 	struct snd_pcm_runtime *capture_runtime;
 	struct snd_pcm_substream *capture_substream;
+	void __iomem *sram = chip->pvReg + SRAM_INPUT_BASE + period_bytes * sramTxSection;
+	unsigned long frames = period_bytes / SRAM_FRAME_BYTES;
+	void *dst;
 
 	capture_substream = chip->capture_substream;
 
 	if(capture_substream == NULL)	
-		memset_io(chip->pvReg + SRAM_INPUT_BASE + SRAM_SECTION_SIZE * sramTxSection, 0x00,  P_PERIOD_BYTE);
+		memset_io(sram, 0x00,  period_bytes);
 		
 	else{
 		capture_runtime = capture_substream->runtime;
@@ -548,9 +883,15 @@ static int snd_smi_capture_copy_data(struct sm768chip *chip,int sramTxSection)
 		if (capture_runtime->dma_area == NULL) 
 			return 0;
 
-		memcpy_fromio(capture_runtime->dma_area + chip->cpointer, chip->pvReg + SRAM_INPUT_BASE + SRAM_SECTION_SIZE * sramTxSection,  P_PERIOD_BYTE);
-		chip->cpointer+= P_PERIOD_BYTE;
-		chip->cpointer%= ((capture_runtime->periods) * (P_PERIOD_BYTE));		
+		dst = capture_runtime->dma_area + chip->cpointer;
+		if (capture_runtime->format == SNDRV_PCM_FORMAT_S16_LE) {
+			memcpy_fromio(dst, sram, period_bytes);
+		} else {
+			memcpy_fromio(chip->bounce, sram, period_bytes);
+			snd_smi_unpack(dst, chip->bounce, capture_runtime->format, frames);
+		}
+		chip->cpointer+= frames_to_bytes(capture_runtime, frames);
+		chip->cpointer%= frames_to_bytes(capture_runtime, capture_runtime->buffer_size);
 		snd_pcm_period_elapsed(capture_substream);
 	}
 	return 0;
@@ -558,38 +899,50 @@ static int snd_smi_capture_copy_data(struct sm768chip *chip,int sramTxSection)
 
 
 /*
- * interrupt handler
+ * I2S interrupt, hard IRQ half: ack the I2S interrupt and note which
+ * SRAM section the DMA has left, then let the thread do the copy. The line
+ * is shared with the display, which shouldn't wait for 2 KB of MMIO.
  */
-static irqreturn_t snd_smi_interrupt(int irq, void *dev_id)
+static irqreturn_t snd_smi_interrupt(struct smi_device *sdev, void *data)
 {
 	
-	struct sm768chip *chip = dev_id;
+	struct sm768chip *chip = data;
+	unsigned long iParameter;
 
-	int sramTxSection = 0; 
+	iisClearRawInt(chip->ddk768_ctx); //clear int
 
-	if(hw768_check_iis_interrupt())
-	{
-		unsigned long iParameter = 0;
-		iisClearRawInt(); //clear int
+	iParameter = iisDmaPointer(chip->ddk768_ctx);
 
-		iParameter = iisDmaPointer();
-		
-		//SRAM is logically divided into 2 portions (1024 byte each)
-		//Check I2S DMA pointer to find out which portion is active.
-		if(iParameter >= 255)
-			//Fill top half SRAM if lower half is active
-			sramTxSection = 0;
-		else
-			//Fill lower half SRAM if top half is active
-			sramTxSection = 1;
-
-		snd_smi_play_copy_data(chip,sramTxSection);   
-		snd_smi_capture_copy_data(chip,sramTxSection);
-
-		return IRQ_HANDLED;
-	}
-	else
-		return IRQ_NONE;
+	spin_lock(&chip->lock);
+	//SRAM is logically divided into sections of one period each.
+	//The interrupt comes as the DMA finishes a section: refill that one,
+	//it is the furthest from being played again.
+	iParameter = ((iParameter + 1) * 4 / chip->period_bytes) % chip->sections;
+	chip->sram_section = (iParameter + chip->sections - 1) % chip->sections;
+	spin_unlock(&chip->lock);
+
+	return IRQ_WAKE_THREAD;
+}
+
+/*
+ * Interrupt thread: move one period between the DMA buffer and the SRAM
+ * section the I2S DMA isn't using, and report it to ALSA.
+ */
+static irqreturn_t snd_smi_irq_thread(struct smi_device *sdev, void *data)
+{
+	struct sm768chip *chip = data;
+	unsigned long flags, period_bytes;
+	int sramTxSection;
+
+	spin_lock_irqsave(&chip->lock, flags);
+	sramTxSection = chip->sram_section;
+	period_bytes = chip->period_bytes;
+	spin_unlock_irqrestore(&chip->lock, flags);
+
+	snd_smi_play_copy_data(chip,sramTxSection,period_bytes);   
+	snd_smi_capture_copy_data(chip,sramTxSection,period_bytes);
+
+	return IRQ_HANDLED;
 }
 
   /* chip-specific constructor
@@ -600,7 +953,6 @@ static int snd_falconi2s_create(struct snd_card *card,
                                          struct sm768chip **smichip)
 {
 	int err;
-	int sample_rate = 44100;
 	struct pci_dev *pdev;
 	struct smi_device *smi_device = dev->dev_private;
 	struct sm768chip *chip;
@@ -618,6 +970,11 @@ static int snd_falconi2s_create(struct snd_card *card,
 		return -ENOMEM;
 
 	chip->card = card;
+	chip->dev = dev;
+	chip->ddk768_ctx = smi_device->ddk768_ctx;
+	chip->use_wm8978 = (audio_en == 2);
+	chip->period_bytes = P_PERIOD_BYTE;
+	chip->sections = SRAM_OUTPUT_SIZE / P_PERIOD_BYTE;
 
 	err = snd_device_new(card, SNDRV_DEV_LOWLEVEL, chip, &ops);
 	if (err < 0) {
@@ -649,35 +1006,34 @@ static int snd_falconi2s_create(struct snd_card *card,
 
 	dbg_msg("Audio pci irq :%d\n",chip->irq);
 	
-	if (ddk768_getCrystalType())
-		sample_rate = 48000;
+	if (ddk768_getCrystalType(chip->ddk768_ctx))
+		chip->rate = 48000;
 	else
-		sample_rate = 44100;
+		chip->rate = 44100;
+	snd_falconi2s_init_rates(chip);
 
-	if(SM768_AudioInit(SAMPLE_BITS, sample_rate)) {
+	if(SM768_AudioInit(chip, SAMPLE_BITS, chip->rate)) {
 		dev_err(&pdev->dev, "Audio init failed!\n");
 		snd_falconi2s_free(chip);
 		return -1;
 	}
-	SM768_AudioStart();
+	SM768_AudioStart(chip);
 
 	//clear SRAM
 	memset_io(chip->pvReg + SRAM_OUTPUT_BASE, 0, SRAM_TOTAL_SIZE);
 	
-	chip_irq_id=chip;/*Record chip_irq_id which will use in free_irq*/
-	dbg_msg("chip_irq_id=%p\n", chip_irq_id);
-
-	iisClearRawInt();//clear int
+	iisClearRawInt(chip->ddk768_ctx);//clear int
 
 	//Setup ISR. The ISR will move more data from DDR to SRAM.
 	
-	if (request_irq(pdev->irq, snd_smi_interrupt, IRQF_SHARED,
-		KBUILD_MODNAME, chip_irq_id)) {
-		dev_err(&pdev->dev, "unable to grab IRQ %d\n", pdev->irq);
+	spin_lock_init(&chip->lock);
+	if (!smi_device->irq_enabled) {
+		dev_err(&pdev->dev, "no IRQ for the I2S DMA\n");
 		snd_falconi2s_free(chip);
 		return -EBUSY;
 	}
-	sb_IRQUnmask(SB_IRQ_VAL_I2S); 
+	smi_irq_register(smi_device, SMI_IRQ_I2S, snd_smi_interrupt, snd_smi_irq_thread, chip);
+	sb_IRQUnmask(chip->ddk768_ctx, SB_IRQ_VAL_I2S); 
 
 #if LINUX_VERSION_CODE <= KERNEL_VERSION(3,18,0)
 	snd_card_set_dev(card, &pdev->dev);
@@ -701,11 +1057,6 @@ int smi_audio_init(struct drm_device *dev)
 
 	pdev = to_pci_dev(dev->dev);
 
-	if(audio_en == 1)
-		use_wm8978 = 0;
-	else if(audio_en == 2)
-		use_wm8978 = 1;
-	
 	err = snd_card_new(&pdev->dev, SNDRV_DEFAULT_IDX1, SNDRV_DEFAULT_STR1, THIS_MODULE, 0, &card); 
 
 
@@ -723,8 +1074,9 @@ int smi_audio_init(struct drm_device *dev)
 	strcpy(card->shortname, "smi-audio");
 	strcpy(card->longname, "SiliconMotion Audio");
 
-	snd_pcm_new(card,"smiaudio_pcm",0,1,1,&pcm);
+	snd_pcm_new(card,"smiaudio_pcm",SMI_PCM_ANALOG,1,1,&pcm);
 	pcm->private_data = chip;
+	card->private_data = chip;
 
       
 	/* set operators */
@@ -739,7 +1091,25 @@ int smi_audio_init(struct drm_device *dev)
 #else
 					      snd_dma_pci_data(pdev),
 #endif
-						P_PERIOD_BYTE*P_PERIOD_MIN, P_PERIOD_BYTE*P_PERIOD_MAX);
+						P_PERIOD_BYTE*P_PERIOD_MIN, P_BUFFER_BYTE_MAX);
+
+	/* Playback to the HDMI sink only */
+	err = snd_pcm_new(card, "smiaudio_hdmi", SMI_PCM_HDMI, 1, 0, &pcm);
+	if (err < 0) {
+		snd_card_free(card);
+		return err;
+	}
+	pcm->private_data = chip;
+	strcpy(pcm->name, "SiliconMotion HDMI");
+	snd_pcm_set_ops(pcm, SNDRV_PCM_STREAM_PLAYBACK,
+                          &snd_falconi2s_hdmi_ops);
+	snd_pcm_lib_preallocate_pages_for_all(pcm, SNDRV_DMA_TYPE_DEV,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 5, 0)
+					      &pdev->dev,
+#else
+					      snd_dma_pci_data(pdev),
+#endif
+						P_PERIOD_BYTE*P_PERIOD_MIN, P_BUFFER_BYTE_MAX);
 
 	strcpy(card->mixername, "SiliconMotion Audio Mixer Control");
 	
@@ -749,6 +1119,12 @@ int smi_audio_init(struct drm_device *dev)
 			return err;
 		}
 	}
+	chip->eld_ctl = snd_ctl_new1(&falconi2s_eld, chip);
+	err = snd_ctl_add(card, chip->eld_ctl);
+	if (err < 0) {
+		snd_card_free(card);
+		return err;
+	}
 
 	
 	err = snd_card_register(card);
@@ -763,48 +1139,55 @@ int smi_audio_init(struct drm_device *dev)
 
 }
 
+/* The HDMI sink changed: let the mixer know the ELD did too */
+void smi_audio_eld_notify(struct drm_device *dev)
+{
+	struct smi_device *sdev = dev->dev_private;
+	struct sm768chip *chip;
+
+	if (sdev->card == NULL)
+		return;
+
+	chip = sdev->card->private_data;
+	snd_ctl_notify(sdev->card, SNDRV_CTL_EVENT_MASK_VALUE, &chip->eld_ctl->id);
+}
+
 void smi_audio_remove(struct drm_device *dev)
 {
-	struct pci_dev *pdev;
 	struct smi_device *sdev = dev->dev_private;
 	struct snd_card *card = sdev->card;
+	struct sm768chip *chip = card->private_data;
 
+	SM768_AudioStop(chip);
+	SM768_AudioDeinit(chip);
 
-	pdev = to_pci_dev(dev->dev);
-	
-	dbg_msg("perpare to free irq, pci irq:%u, chip_irq_id=0x%p\n", pdev->irq, chip_irq_id);
-	if(pdev->irq){				
-		free_irq(pdev->irq, chip_irq_id);
-		dbg_msg("free irq\n");
-	}
-	SM768_AudioStop();
-	SM768_AudioDeinit();
+	/* AudioDeinit masked the source */
+	smi_irq_unregister(sdev, SMI_IRQ_I2S);
+	dbg_msg("I2S interrupt unregistered, chip=0x%p\n", chip);
 
 	snd_card_free(card);
 
 }
 
-void smi_audio_resume()
+void smi_audio_resume(struct drm_device *dev)
 {
+	struct smi_device *sdev = dev->dev_private;
+	struct sm768chip *chip = sdev->card->private_data;
 
-	int sample_rate = 44100;
-	
-	if (ddk768_getCrystalType())
-			sample_rate = 48000;
-		else
-			sample_rate = 44100;
-	
-	SM768_AudioInit(SAMPLE_BITS, sample_rate);
-	SM768_AudioStart();
+	SM768_AudioInit(chip, SAMPLE_BITS, chip->rate);
+	SM768_AudioStart(chip);
 
-	sb_IRQUnmask(SB_IRQ_VAL_I2S);
+	sb_IRQUnmask(chip->ddk768_ctx, SB_IRQ_VAL_I2S);
 }
 
 
-void smi_audio_suspend()
+void smi_audio_suspend(struct drm_device *dev)
 {
-	SM768_AudioStop();
-	SM768_AudioDeinit();
+	struct smi_device *sdev = dev->dev_private;
+	struct sm768chip *chip = sdev->card->private_data;
+
+	SM768_AudioStop(chip);
+	SM768_AudioDeinit(chip);
 }
 
 
@@ -12,16 +12,54 @@
 #include <sound/core.h>
 #include <sound/initval.h>
 #include <sound/pcm.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 6, 0)
+#include <drm/drm_eld.h>
+#else
+#include <drm/drm_edid.h>
+#endif
+
+/* The I2S moves 16 bits per channel, so one dword per stereo frame in the SRAM */
+#define SRAM_FRAME_BYTES	  4
+
+/* PCM devices of the card */
+#define SMI_PCM_ANALOG		  0	/* I2S codec, also mirrored to HDMI */
+#define SMI_PCM_HDMI		  1	/* HDMI transmitter only */
+
+/* For playback hw parameter*/
+#define P_PERIOD_BYTE 		  1024	/* default, until hw_params picks one */
+#define P_PERIOD_BYTE_MIN	  256	/* of SRAM: a period is as many frames */
+#define P_PERIOD_BYTE_MAX	  1024	/* I2S_SRAM_DMA SIZE is 8 bits of dwords */
+#define P_PERIOD_MIN 		  16
+#define P_BUFFER_BYTE_MAX	  (P_PERIOD_BYTE * 256)
+
+#define FEATURES	          2/* 1:only output; 2:output and input */
+#define SRAM_TOTAL_SIZE	  	  0x1000
+#define SAMPLE_BITS		  	  32
+#define STEREO			  	  2
+#define MONO				  1
+
+/* The DMA address is 9 bits of dwords: it wraps every 2 KB */
+#define SRAM_OUTPUT_SIZE	  (SRAM_TOTAL_SIZE/FEATURES)
+#define SRAM_INPUT_SIZE	  	  (SRAM_TOTAL_SIZE/FEATURES)
 
 /* definition of the chip-specific record */
+struct _ddk768_context_t;
+struct drm_device;
+
 struct sm768chip {
 	struct snd_card *card;
+	struct drm_device *dev;
+	struct _ddk768_context_t *ddk768_ctx;
 	int irq;
+	int use_wm8978;
 
 	struct snd_pcm_substream *play_substream;
 	struct snd_pcm_substream *capture_substream;
 	unsigned long ppointer;
 	unsigned long cpointer;
+	unsigned long pqueued;	/* playback bytes in the SRAM ring, up to its size */
+	int play_section;	/* SRAM section being played, -1 before the first interrupt */
 	
 	void __iomem *pvReg;
 	void __iomem *pvMem;
@@ -32,6 +70,21 @@ struct sm768chip {
 	unsigned long vidmem_size;
 
 	spinlock_t lock;
+	/* SRAM section to fill, handed from the hard IRQ to the IRQ thread */
+	int sram_section;
+	/* SRAM layout: each direction is a ring of sections of one period */
+	unsigned long period_bytes;
+	int sections;
+	bool period_set[2];	/* per stream direction, between hw_params and hw_free */
+	/* One section repacked to or from S24/S32, used by the IRQ thread */
+	u32 bounce[P_PERIOD_BYTE_MAX / SRAM_FRAME_BYTES];
+	/* Sample rate of both directions, and the rates the I2S clock can make */
+	unsigned int rate;
+	unsigned int rates[3];
+	struct snd_pcm_hw_constraint_list rate_list;
+	/* ELD of the HDMI sink, read when the HDMI PCM is opened */
+	u8 eld[MAX_ELD_BYTES];
+	struct snd_kcontrol *eld_ctl;
 
 	//master playback volume and capture volume
 	u8 playback_vol;//only record one channel, right=left
@@ -57,23 +110,4 @@ struct sm768_runtime_data {
 };
 #endif
 
-/* For playback hw parameter*/
-#define P_PERIOD_BYTE 		  1024
-#define P_PERIOD_MIN 		  16
-#define P_PERIOD_MAX 		  256
-
-#define FEATURES	          2/* 1:only output; 2:output and input */
-#define SRAM_TOTAL_SIZE	  	  0x1000
-#define SAMPLE_BITS		  	  32
-#define SECTIONS_NUM	  	  2
-#define STEREO			  	  2
-#define MONO				  1
-
-#define SRAM_OUTPUT_SIZE	  (SRAM_TOTAL_SIZE/FEATURES)
-#define SRAM_INPUT_SIZE	  	  (SRAM_TOTAL_SIZE/FEATURES)
-#define SRAM_SECTION_SIZE     (SRAM_OUTPUT_SIZE/OUTPUT_SRAM_SECTIONS_NUM)
-#define SRAM_SECTION_SIZE_DWORDS  ((SRAM_SECTION_SIZE/4)-1)
-#define OUTPUT_SRAM_SECTIONS_NUM  SECTIONS_NUM
-
-
 #endif				/* __SMI_DRV_H__ */
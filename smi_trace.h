@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0+
+// Copyright (c) 2023, SiliconMotion Inc.
+
+#if !defined(_SMI_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define _SMI_TRACE_H_
+
+#include <linux/tracepoint.h>
+#include <linux/types.h>
+#include <drm/drm_crtc.h>
+#include <drm/drm_modes.h>
+#include "smi_irq.h"
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM smifb
+#define TRACE_INCLUDE_FILE smi_trace
+
+/*
+ * Hot path tracepoints, unlike dbg_msg they cost nothing until enabled:
+ *
+ *   trace-cmd record -e smifb
+ *   perf record -e 'smifb:*'
+ *
+ * The running totals are in the per-CRTC "perf" debugfs files.
+ */
+
+TRACE_EVENT(smi_mode_set,
+	TP_PROTO(struct drm_crtc *crtc, const struct drm_display_mode *mode, u64 duration_ns),
+	TP_ARGS(crtc, mode, duration_ns),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, crtc)
+		__field(int, hdisplay)
+		__field(int, vdisplay)
+		__field(int, vrefresh)
+		__field(u64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__entry->crtc = drm_crtc_index(crtc);
+		__entry->hdisplay = mode->hdisplay;
+		__entry->vdisplay = mode->vdisplay;
+		__entry->vrefresh = drm_mode_vrefresh(mode);
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("crtc=%u mode=%dx%d@%d duration=%llu ns",
+		  __entry->crtc, __entry->hdisplay, __entry->vdisplay,
+		  __entry->vrefresh, __entry->duration_ns)
+);
+
+TRACE_EVENT(smi_plane_update,
+	TP_PROTO(struct drm_crtc *crtc, unsigned int clips, unsigned long bytes, u64 duration_ns),
+	TP_ARGS(crtc, clips, bytes, duration_ns),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, crtc)
+		__field(unsigned int, clips)
+		__field(unsigned long, bytes)
+		__field(u64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__entry->crtc = drm_crtc_index(crtc);
+		__entry->clips = clips;
+		__entry->bytes = bytes;
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("crtc=%u clips=%u bytes=%lu duration=%llu ns",
+		  __entry->crtc, __entry->clips, __entry->bytes, __entry->duration_ns)
+);
+
+TRACE_EVENT(smi_cursor_update,
+	TP_PROTO(struct drm_crtc *crtc, int x, int y, unsigned long bytes),
+	TP_ARGS(crtc, x, y, bytes),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, crtc)
+		__field(int, x)
+		__field(int, y)
+		__field(unsigned long, bytes)
+	),
+
+	TP_fast_assign(
+		__entry->crtc = drm_crtc_index(crtc);
+		__entry->x = x;
+		__entry->y = y;
+		__entry->bytes = bytes;
+	),
+
+	TP_printk("crtc=%u pos=%d,%d bytes=%lu",
+		  __entry->crtc, __entry->x, __entry->y, __entry->bytes)
+);
+
+/* A vsync interrupt, handed to drm_handle_vblank() */
+TRACE_EVENT(smi_vblank,
+	TP_PROTO(unsigned int pipe),
+	TP_ARGS(pipe),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, pipe)
+	),
+
+	TP_fast_assign(
+		__entry->pipe = pipe;
+	),
+
+	TP_printk("pipe=%u", __entry->pipe)
+);
+
+/* A page flip or modeset completion event sent to userspace */
+TRACE_EVENT(smi_vblank_event,
+	TP_PROTO(struct drm_crtc *crtc),
+	TP_ARGS(crtc),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, crtc)
+	),
+
+	TP_fast_assign(
+		__entry->crtc = drm_crtc_index(crtc);
+	),
+
+	TP_printk("crtc=%u", __entry->crtc)
+);
+
+/* One pending source of an interrupt, and what its handler returned */
+TRACE_EVENT(smi_irq,
+	TP_PROTO(unsigned int source, int ret),
+	TP_ARGS(source, ret),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, source)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__entry->source = source;
+		__entry->ret = ret;
+	),
+
+	TP_printk("source=%s ret=%d",
+		  __print_symbolic(__entry->source,
+				   { SMI_IRQ_VSYNC0, "vsync0" },
+				   { SMI_IRQ_VSYNC1, "vsync1" },
+				   { SMI_IRQ_HDMI, "hdmi" },
+				   { SMI_IRQ_I2S, "i2s" },
+				   { SMI_IRQ_DE, "2d" },
+				   { SMI_IRQ_PWM, "pwm" },
+				   { SMI_IRQ_TIMER, "timer" }),
+		  __entry->ret)
+);
+
+#endif
+
+/* This part must be outside protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#include <trace/define_trace.h>